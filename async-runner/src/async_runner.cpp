@@ -18,13 +18,22 @@
 #include "./async_runner.hpp"
 
 #include <UniLog/UniLog.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
+#include <limits>
 #include <thread>
 #include <mutex>
 #include <numeric>
+#include <set>
+#include <tuple>
 
 #include "../../runner/src/runner_helper.hpp"
 #include "./batch_tensor_buffer.hpp"
+#include "vart/runner_ext.hpp"
 #include "vitis/ai/collection_helper.hpp"
 #include "vitis/ai/env_config.hpp"
 #include "vitis/ai/weak.hpp"
@@ -37,37 +46,66 @@ DEF_ENV_PARAM(XLNX_ASYNC_RUNNER_PERF, "0");
 
 namespace {
 
-class AsyncRunner : public vart::Runner {
+// requests are served by priority class first, 0 is the most urgent, e.g.
+// interactive requests at 0 and batch traffic at 2 or 3.
+static constexpr int NUM_OF_PRIORITY_CLASSES = 4;
+static constexpr int DEFAULT_PRIORITY = 1;
+// execute_async() status besides 0.
+static constexpr int STATUS_SHUTTING_DOWN = -1;
+static constexpr int STATUS_DEADLINE_REJECTED = -2;
+static constexpr int STATUS_QUEUE_FULL = -3;
+
+// per-request scheduling options, from the attrs "async_priority" (int,
+// 0 to NUM_OF_PRIORITY_CLASSES - 1) and "async_deadline_ms" (int, relative
+// to the submission, 0 for no deadline) given when the runner is created or
+// via set_run_attrs().
+struct run_options_t {
+  int priority = DEFAULT_PRIORITY;
+  int deadline_ms = 0;
+};
+
+static bool update_run_options(const xir::Attrs* attrs,
+                               run_options_t& options) {
+  auto found = false;
+  if (attrs != nullptr && attrs->has_attr("async_priority")) {
+    auto priority = attrs->get_attr<int>("async_priority");
+    options.priority =
+        std::min(std::max(priority, 0), NUM_OF_PRIORITY_CLASSES - 1);
+    found = true;
+  }
+  if (attrs != nullptr && attrs->has_attr("async_deadline_ms")) {
+    options.deadline_ms =
+        std::max(attrs->get_attr<int>("async_deadline_ms"), 0);
+    found = true;
+  }
+  return found;
+}
+
+class AsyncRunnerImpl;
+
+class AsyncRunner : public vart::RunnerExt {
  public:
-  explicit AsyncRunner(std::shared_ptr<vart::Runner> r) : real_runner_{r} {
-    LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
-        << "AsyncRunner@" << (void*)this << " created.";
-  };
+  explicit AsyncRunner(std::shared_ptr<AsyncRunnerImpl> r, xir::Attrs* attrs);
   AsyncRunner(const AsyncRunner& other) = delete;
 
  private:
-  virtual ~AsyncRunner() {
-    real_runner_.reset();
-    LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
-        << "AsyncRunner@" << (void*)this << " destroyed.";
-  }
+  virtual ~AsyncRunner();
   virtual std::pair<uint32_t, int> execute_async(
       const std::vector<vart::TensorBuffer*>& input,
-      const std::vector<vart::TensorBuffer*>& output) override {
-    return real_runner_->execute_async(input, output);
-  }
-  virtual int wait(int jobid, int timeout) override {
-    return real_runner_->wait(jobid, timeout);
-  }
-  virtual std::vector<const xir::Tensor*> get_input_tensors() override {
-    return real_runner_->get_input_tensors();
-  }
-  virtual std::vector<const xir::Tensor*> get_output_tensors() override {
-    return real_runner_->get_output_tensors();
-  }
+      const std::vector<vart::TensorBuffer*>& output) override;
+  virtual int wait(int jobid, int timeout) override;
+  virtual std::vector<const xir::Tensor*> get_input_tensors() override;
+  virtual std::vector<const xir::Tensor*> get_output_tensors() override;
+  virtual std::vector<vart::TensorBuffer*> get_inputs() override;
+  virtual std::vector<vart::TensorBuffer*> get_outputs() override;
+  virtual int set_run_attrs(std::unique_ptr<xir::Attrs>& attrs) override;
 
  private:
-  std::shared_ptr<vart::Runner> real_runner_;
+  std::shared_ptr<AsyncRunnerImpl> real_runner_;
+  std::mutex mtx_;
+  run_options_t options_;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> inputs_;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> outputs_;
 };
 
 class AsyncRunnerImpl : public vart::Runner {
@@ -77,7 +115,11 @@ class AsyncRunnerImpl : public vart::Runner {
   AsyncRunnerImpl(const AsyncRunnerImpl& other) = delete;
   virtual ~AsyncRunnerImpl();
 
- private:
+ public:
+  std::pair<uint32_t, int> submit(
+      const std::vector<vart::TensorBuffer*>& input,
+      const std::vector<vart::TensorBuffer*>& output,
+      const run_options_t& options);
   virtual std::pair<uint32_t, int> execute_async(
       const std::vector<vart::TensorBuffer*>& input,
       const std::vector<vart::TensorBuffer*>& output) override;
@@ -92,19 +134,85 @@ class AsyncRunnerImpl : public vart::Runner {
     std::unique_ptr<xir::Attrs> attrs;
     size_t batch_size;
     size_t runner_idx;
+    // wall time of one run, averaged over recent runs, 0 means not
+    // measured yet. a run costs about the same whether or not the batch is
+    // full, so it is tracked per run instead of per request.
+    std::atomic<int64_t> service_time_us{0};
+    // when the last run is dispatched, used to estimate when a busy runner
+    // is available again.
+    std::atomic<int64_t> start_time_us{0};
+    // utilization counters
+    std::atomic<uint64_t> num_of_runs{0};
+    std::atomic<uint64_t> num_of_requests{0};
+    std::atomic<uint64_t> busy_time_us{0};
   };
   struct queue_element_type_t {
     std::vector<vart::TensorBuffer*> input;
     std::vector<vart::TensorBuffer*> output;
     int job_id;
+    int priority;
+    // absolute, in us, max for no deadline.
+    int64_t deadline_us;
+    int64_t submit_time_us;
+    uint64_t seq;
   };
   struct job_slot_t {
     std::promise<int> promise;
     int job_id;
   };
+  // pending requests, ordered by priority class, then earliest deadline,
+  // then arrival, so requests without a deadline are FIFO in their class.
+  // requests of lower priority do not count against the capacity of a
+  // request, i.e. batch traffic cannot block interactive requests.
+  class RequestQueue {
+   public:
+    explicit RequestQueue(size_t capacity)
+        : capacity_{capacity}, num_of_requests_{} {}
+    // the request is consumed unless the queue is still full for its
+    // priority after `timeout`.
+    bool send(std::unique_ptr<queue_element_type_t>& request,
+              std::chrono::microseconds timeout);
+    // nullptr if the queue is still empty after `timeout`.
+    std::unique_ptr<queue_element_type_t> recv(
+        std::chrono::microseconds timeout);
+    // the number of pending requests served before a new request.
+    size_t num_of_ahead(int priority, int64_t deadline_us) const;
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+
+   private:
+    struct order_t {
+      bool operator()(const std::unique_ptr<queue_element_type_t>& a,
+                      const std::unique_ptr<queue_element_type_t>& b) const {
+        return std::make_tuple(a->priority, a->deadline_us, a->seq) <
+               std::make_tuple(b->priority, b->deadline_us, b->seq);
+      }
+    };
+    bool is_full(int priority) const;
+
+   private:
+    const size_t capacity_;
+    std::array<size_t, NUM_OF_PRIORITY_CLASSES> num_of_requests_;
+    mutable std::mutex mtx_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::multiset<std::unique_ptr<queue_element_type_t>, order_t> requests_;
+  };
+  struct class_stats_t {
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> rejected_deadline{0};
+    std::atomic<uint64_t> rejected_full{0};
+    std::atomic<uint64_t> completed{0};
+    // completed after the deadline, the prediction was wrong.
+    std::atomic<uint64_t> missed{0};
+    std::atomic<uint64_t> latency_us{0};
+  };
 
  private:
   void thread_main();
+  size_t pick_runner();
+  void get_ready_time(std::vector<int64_t>& ready, int64_t now);
+  int64_t predict_completion_us(size_t num_of_ahead);
   void start_one_runner(
       runner_t& runner,
       std::vector<std::unique_ptr<queue_element_type_t>> args);
@@ -113,6 +221,8 @@ class AsyncRunnerImpl : public vart::Runner {
   void delete_job_slot(int job_id);
   size_t num_of_running_runners();
   std::string runners_state_as_string();
+  std::string runners_utilization_as_string();
+  std::string stats_as_string();
   void notify_completion(
       const std::vector<std::unique_ptr<queue_element_type_t>>& args, int ret);
 
@@ -124,8 +234,13 @@ class AsyncRunnerImpl : public vart::Runner {
   std::vector<runner_t> runners_;
   std::vector<std::unique_ptr<xir::Tensor>> inputs_;
   std::vector<std::unique_ptr<xir::Tensor>> outputs_;
-  std::unique_ptr<vitis::ai::ErlMsgBox<queue_element_type_t>> queue_;
-  std::unique_ptr<vitis::ai::ErlMsgBox<size_t>> runners_idx_q_;
+  std::unique_ptr<RequestQueue> queue_;
+  std::atomic<uint64_t> seq_{0};
+  std::array<class_stats_t, NUM_OF_PRIORITY_CLASSES> stats_;
+  // guards state transitions from and to IDLE, see pick_runner()
+  std::mutex mtx_for_runners_;
+  std::condition_variable cv_for_idle_runner_;
+  std::chrono::steady_clock::time_point created_;
   std::shared_ptr<vitis::ai::ThreadPool> the_pool_;
   std::thread my_thread_;
   volatile bool running_;
@@ -169,6 +284,37 @@ static size_t get_batch_size(vart::Runner* runner) {
   }
   return (size_t)batch_size;
 }
+// runners may have different batch sizes, e.g. DPU cores of different
+// sizes, but requests are shaped after runners_[0], so all other dimensions
+// must agree.
+static void check_tensor_shapes(vart::Runner* first, vart::Runner* runner) {
+  for (auto input_or_output : {0, 1}) {
+    auto expected = input_or_output == 0 ? first->get_input_tensors()
+                                         : first->get_output_tensors();
+    auto actual = input_or_output == 0 ? runner->get_input_tensors()
+                                       : runner->get_output_tensors();
+    UNI_LOG_CHECK(expected.size() == actual.size(),
+                  VART_RUNNER_CONSTRUCTION_FAIL)
+        << " all runners must have the same number of tensors: "
+        << expected.size() << " vs " << actual.size();
+    for (auto i = 0u; i < expected.size(); ++i) {
+      auto dims0 = expected[i]->get_shape();
+      auto dims = actual[i]->get_shape();
+      UNI_LOG_CHECK(dims0.size() == dims.size() &&
+                        std::equal(dims0.begin() + 1, dims0.end(),
+                                   dims.begin() + 1),
+                    VART_RUNNER_CONSTRUCTION_FAIL)
+          << " all runners must have the same tensor shape except the batch "
+             "size: tensor="
+          << expected[i]->get_name() << " vs " << actual[i]->get_name();
+    }
+  }
+}
+static int64_t now_in_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
 AsyncRunnerImpl::AsyncRunnerImpl(vart::Runner* (*init_fun)(const xir::Subgraph*,
                                                            xir::Attrs*),
                                  const xir::Subgraph* subgraph,
@@ -182,9 +328,15 @@ AsyncRunnerImpl::AsyncRunnerImpl(vart::Runner* (*init_fun)(const xir::Subgraph*,
           ? attrs->get_attr<size_t>("num_of_dpu_runners")
           : 10u;
   runners_ = std::vector<AsyncRunnerImpl::runner_t>(num_of_dpu_runners);
-  for (auto i = 0u; i < runners_.size(); ++i) {
+  UNI_LOG_CHECK(!runners_.empty(), VART_RUNNER_CONSTRUCTION_FAIL)
+      << " please check attr \"num_of_dpu_runners\"";
+  auto start = std::chrono::steady_clock::now();
+  auto create_runner = [this, init_fun, subgraph, attrs](size_t i) {
     // TODO: remove black list
     runners_[i].attrs = xir::Attrs::clone(attrs);
+    // lets a runner tell which instance it is, e.g. dummy runners configured
+    // with different batch sizes and latencies.
+    runners_[i].attrs->set_attr("async_runner_idx", i);
     // it is important not to share attrs for creating real runners,
     // otherwise, they might always use the same device cu index.
     runners_[i].runner = std::unique_ptr<vart::Runner>(
@@ -192,21 +344,35 @@ AsyncRunnerImpl::AsyncRunnerImpl(vart::Runner* (*init_fun)(const xir::Subgraph*,
     runners_[i].state = IDLE;
     runners_[i].batch_size = get_batch_size(runners_[i].runner.get());
     runners_[i].runner_idx = i;
+  };
+  // the first runner loads the code and parameters all runners share, the
+  // others are created in parallel, see Runner::create_runners_with_attrs()
+  create_runner(0u);
+  auto futures = std::vector<std::future<void>>();
+  for (auto i = 1u; i < runners_.size(); ++i) {
+    futures.emplace_back(std::async(std::launch::async, create_runner, i));
   }
-  UNI_LOG_CHECK(!runners_.empty(), VART_RUNNER_CONSTRUCTION_FAIL)
-      << " please check attr \"num_of_dpu_runners\"";
+  for (auto& f : futures) {
+    f.get();
+  }
+  for (auto i = 1u; i < runners_.size(); ++i) {
+    check_tensor_shapes(runners_[0].runner.get(), runners_[i].runner.get());
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
+      << "@" << (void*)this << " " << runners_.size()
+      << " dpu runners are created in "
+      << std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count()
+      << "ms";
   inputs_ = clone_and_change_dims_for_tensors(
       runners_[0].runner->get_input_tensors());
   outputs_ = clone_and_change_dims_for_tensors(
       runners_[0].runner->get_output_tensors());
-  queue_ = std::make_unique<vitis::ai::ErlMsgBox<queue_element_type_t>>(
+  queue_ = std::make_unique<RequestQueue>(
       std::accumulate(runners_.begin(), runners_.end(), 0,
                       [](int s, runner_t& r) { return s + r.batch_size; }));
-  runners_idx_q_ =
-      std::make_unique<vitis::ai::ErlMsgBox<size_t>>(runners_.size());
-  for (auto i = 0u; i < runners_.size(); ++i) {
-    runners_idx_q_->emplace_send(i);
-  }
+  created_ = std::chrono::steady_clock::now();
   the_pool_ = vitis::ai::WeakStore<std::string, vitis::ai::ThreadPool>::create(
       std::string("async_runner"), ENV_PARAM(XLNX_NUM_OF_RUNNER_THREADS));
   running_ = true;
@@ -244,6 +410,11 @@ AsyncRunnerImpl::~AsyncRunnerImpl() {
       << " states: " << runners_state_as_string() << " qlen=" << queue_->size()
       << " qcap=" << queue_->capacity()
       << " if #slots is not zero, there might be some resource leak";
+  LOG_IF(INFO,
+         ENV_PARAM(DEBUG_ASYNC_RUNNER) || ENV_PARAM(XLNX_ASYNC_RUNNER_PERF))
+      << "AsyncRunnerImpl@" << (void*)this
+      << " utilization: " << runners_utilization_as_string()
+      << "\n\tper priority class: " << stats_as_string();
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
       << "AsyncRunnerImpl@" << (void*)this << "  says BYEBYE.";
   the_pool_ = nullptr;  // release the thread pool.
@@ -252,21 +423,117 @@ AsyncRunnerImpl::~AsyncRunnerImpl() {
 std::pair<uint32_t, int> AsyncRunnerImpl::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
-  auto job_id = allocate_job_id();
+  return submit(input, output, run_options_t());
+}
+
+// a request with a deadline is admitted only if it is predicted to complete
+// in time, and it is rejected instead of blocking when the queue is full.
+// requests without a deadline block until there is room, as before.
+std::pair<uint32_t, int> AsyncRunnerImpl::submit(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output,
+    const run_options_t& options) {
   if (!running_) {
     LOG(WARNING) << "runner is shutting down, reject new request";
-    std::make_pair(0xFFFFFFFF, -1);
+    return std::make_pair(0xFFFFFFFF, STATUS_SHUTTING_DOWN);
   }
+  auto& stats = stats_[options.priority];
+  stats.submitted++;
+  auto now = now_in_us();
+  auto has_deadline = options.deadline_ms > 0;
+  auto deadline_us = has_deadline
+                         ? now + (int64_t)options.deadline_ms * 1000
+                         : std::numeric_limits<int64_t>::max();
+  if (has_deadline) {
+    auto predicted = predict_completion_us(
+        queue_->num_of_ahead(options.priority, deadline_us));
+    if (predicted > deadline_us) {
+      stats.rejected_deadline++;
+      LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 2)
+          << "request of priority " << options.priority << " is rejected,"
+          << " predicted completion in " << predicted - now
+          << "us, deadline in " << deadline_us - now << "us";
+      return std::make_pair(0xFFFFFFFF, STATUS_DEADLINE_REJECTED);
+    }
+  }
+  auto job_id = allocate_job_id();
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 2)
       << "job id " << job_id << " is allocated for inputs=" << to_string(input)
       << ",outputs=" << to_string(output);
-  queue_->emplace_send(queue_element_type_t{input, output, job_id});
+  auto request = std::unique_ptr<queue_element_type_t>(
+      new queue_element_type_t{input, output, job_id, options.priority,
+                               deadline_us, now, seq_++});
+  if (has_deadline) {
+    if (!queue_->send(request, std::chrono::microseconds(0))) {
+      delete_job_slot(job_id);
+      stats.rejected_full++;
+      return std::make_pair(0xFFFFFFFF, STATUS_QUEUE_FULL);
+    }
+  } else {
+    while (!queue_->send(request, std::chrono::milliseconds(1000))) {
+      // empty body
+    }
+  }
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 2)
       << "job id " << job_id << " is submitted. qlen=" << queue_->size()
       << " qcap=" << queue_->capacity();
   return std::make_pair((uint32_t)job_id, 0);
 }
 
+bool AsyncRunnerImpl::RequestQueue::send(
+    std::unique_ptr<queue_element_type_t>& request,
+    std::chrono::microseconds timeout) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto priority = request->priority;
+  if (!not_full_.wait_for(lock, timeout,
+                          [this, priority]() { return !is_full(priority); })) {
+    return false;
+  }
+  num_of_requests_[priority]++;
+  requests_.emplace(std::move(request));
+  not_empty_.notify_one();
+  return true;
+}
+
+bool AsyncRunnerImpl::RequestQueue::is_full(int priority) const {
+  auto n = std::accumulate(num_of_requests_.begin(),
+                           num_of_requests_.begin() + priority + 1, size_t(0));
+  return n >= capacity_;
+}
+
+std::unique_ptr<AsyncRunnerImpl::queue_element_type_t>
+AsyncRunnerImpl::RequestQueue::recv(std::chrono::microseconds timeout) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (!not_empty_.wait_for(lock, timeout,
+                           [this]() { return !requests_.empty(); })) {
+    return nullptr;
+  }
+  auto ret = std::move(requests_.extract(requests_.begin()).value());
+  num_of_requests_[ret->priority]--;
+  // senders of different priorities wait for different conditions.
+  not_full_.notify_all();
+  return ret;
+}
+
+size_t AsyncRunnerImpl::RequestQueue::num_of_ahead(int priority,
+                                                   int64_t deadline_us) const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto ret = 0u;
+  for (auto& r : requests_) {
+    if (std::make_pair(r->priority, r->deadline_us) >
+        std::make_pair(priority, deadline_us)) {
+      break;
+    }
+    ret++;
+  }
+  return ret;
+}
+
+size_t AsyncRunnerImpl::RequestQueue::size() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return requests_.size();
+}
+
 AsyncRunnerImpl::job_slot_t* AsyncRunnerImpl::find_job_slot(int jobid) {
   std::lock_guard<std::mutex> lock(mtx_for_slots_);
   auto job = slots_.find(jobid);
@@ -297,6 +564,41 @@ std::string AsyncRunnerImpl::runners_state_as_string() {
   return str.str();
 }
 
+std::string AsyncRunnerImpl::runners_utilization_as_string() {
+  auto lifetime_us = std::max<int64_t>(
+      1, std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - created_)
+             .count());
+  std::ostringstream str;
+  for (auto& r : runners_) {
+    auto runs = r.num_of_runs.load();
+    auto requests = r.num_of_requests.load();
+    str << "\n\trunner[" << r.runner_idx << "] batch=" << r.batch_size
+        << " runs=" << runs << " requests=" << requests << " fill="
+        << (runs == 0 ? 0.0 : 100.0 * requests / (runs * r.batch_size))
+        << "% service=" << r.service_time_us << "us busy="
+        << 100.0 * r.busy_time_us / lifetime_us << "%";
+  }
+  return str.str();
+}
+
+std::string AsyncRunnerImpl::stats_as_string() {
+  std::ostringstream str;
+  for (auto i = 0; i < NUM_OF_PRIORITY_CLASSES; ++i) {
+    auto& c = stats_[i];
+    if (c.submitted == 0u) {
+      continue;
+    }
+    auto completed = c.completed.load();
+    str << "\n\tpriority[" << i << "] submitted=" << c.submitted
+        << " rejected_deadline=" << c.rejected_deadline
+        << " rejected_full=" << c.rejected_full << " completed=" << completed
+        << " missed=" << c.missed << " latency="
+        << (completed == 0u ? 0u : c.latency_us / completed) << "us";
+  }
+  return str.str();
+}
+
 size_t AsyncRunnerImpl::num_of_running_runners() {
   size_t ret = 0;
   for (auto& r : runners_) {
@@ -413,7 +715,14 @@ void AsyncRunnerImpl::notify_completion(
     const std::vector<std::unique_ptr<AsyncRunnerImpl::queue_element_type_t>>&
         args,
     int ret) {
+  auto now = now_in_us();
   for (auto& arg : args) {
+    auto& stats = stats_[arg->priority];
+    stats.completed++;
+    stats.latency_us += now - arg->submit_time_us;
+    if (now > arg->deadline_us) {
+      stats.missed++;
+    }
     {
       std::lock_guard<std::mutex> lock(mtx_for_slots_);
       slots_[arg->job_id]->promise.set_value(ret);
@@ -431,26 +740,81 @@ void AsyncRunnerImpl::start_one_runner(
       << " jobs " << jobs_to_string(args) << " are ready for run.";
 
   runner.state = WAITING;
+  runner.start_time_us = now_in_us();
   the_pool_->async([this, &runner, args = std::move(args)]() mutable {
     LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
         << " jobs " << jobs_to_string(args) << " are started.";
     runner.state = RUNNING;
+    auto start = now_in_us();
     auto ret = start_one_runner_real(runner.runner.get(), args);
+    auto elapsed = std::max<int64_t>(1, now_in_us() - start);
     LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
-        << " jobs " << jobs_to_string(args) << " are completed.";
+        << " jobs " << jobs_to_string(args) << " are completed in "
+        << elapsed << "us";
+    auto service_time = runner.service_time_us.load();
+    runner.service_time_us =
+        service_time == 0 ? elapsed : (service_time * 3 + elapsed) / 4;
+    runner.num_of_runs++;
+    runner.num_of_requests += args.size();
+    runner.busy_time_us += elapsed;
     notify_completion(args, ret);
-    runner.state = IDLE;
-    runners_idx_q_->emplace_send(runner.runner_idx);
+    {
+      std::lock_guard<std::mutex> lock(mtx_for_runners_);
+      runner.state = IDLE;
+    }
+    cv_for_idle_runner_.notify_one();
   });
   return;
 }
 
-void AsyncRunnerImpl::thread_main() {
-  std::unique_ptr<size_t> cur_runner;
-  do {
-    // round robin
-    cur_runner = runners_idx_q_->recv(std::chrono::milliseconds(100));
-    if (cur_runner == nullptr) {
+// plans how the pending requests would be served: runs are assigned one by
+// one to the runner which completes its next run first, given when busy
+// runners are available again and the measured service time of each runner.
+// a run takes up to batch_size requests. the first idle runner in the plan
+// is picked. if the plan serves all pending requests with busy runners only,
+// e.g. a straggler is better served by a fast runner finishing soon than by
+// a slow idle one, it waits and plans again. so a burst spreads over all
+// runners, big batch runners included, and a straggler goes to the runner
+// with the shortest latency. runners not measured yet cost nothing, so that
+// every runner is measured once.
+size_t AsyncRunnerImpl::pick_runner() {
+  std::unique_lock<std::mutex> lock(mtx_for_runners_);
+  auto ready = std::vector<int64_t>(runners_.size());
+  while (true) {
+    get_ready_time(ready, now_in_us());
+    // the caller holds the first request.
+    auto num_of_pending = 1u + queue_->size();
+    auto wait_time = std::numeric_limits<int64_t>::max();
+    for (auto remaining = num_of_pending; remaining > 0u;) {
+      auto next = runners_.size();
+      auto next_finish = std::numeric_limits<int64_t>::max();
+      for (auto& r : runners_) {
+        auto finish = ready[r.runner_idx] + r.service_time_us;
+        if (finish < next_finish) {
+          next = r.runner_idx;
+          next_finish = finish;
+        }
+      }
+      auto& r = runners_[next];
+      if (r.state == IDLE && ready[next] == 0) {
+        r.state = COLLECTING;
+        LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
+            << "pick runner[" << next << "] for " << num_of_pending
+            << " pending requests, states=" << runners_state_as_string();
+        return next;
+      }
+      wait_time = std::min(wait_time, ready[next]);
+      ready[next] = next_finish;
+      remaining -= std::min(remaining, r.batch_size);
+    }
+    auto timeout =
+        std::chrono::microseconds(std::max<int64_t>(wait_time, 1000));
+    if (num_of_running_runners() == runners_.size()) {
+      timeout = std::chrono::milliseconds(100);
+    }
+    if (cv_for_idle_runner_.wait_for(lock, timeout) ==
+            std::cv_status::timeout &&
+        num_of_running_runners() == runners_.size()) {
       LOG_IF(WARNING, ENV_PARAM(DEBUG_ASYNC_RUNNER))
           << " cannot find an idle runner withing 100ms: states="
           << runners_state_as_string() << " try again."
@@ -459,54 +823,90 @@ void AsyncRunnerImpl::thread_main() {
           << ": XLNX_NUM_OF_RUNNER_THREADS="
           << ENV_PARAM(XLNX_NUM_OF_RUNNER_THREADS)
           << " num_of_dpu_runners=" << runners_.size();
+    }
+  }
+}
+
+// when each runner is available again, relative to `now`. the caller holds
+// mtx_for_runners_.
+void AsyncRunnerImpl::get_ready_time(std::vector<int64_t>& ready,
+                                     int64_t now) {
+  for (auto& r : runners_) {
+    ready[r.runner_idx] =
+        r.state == IDLE
+            ? 0
+            : std::max<int64_t>(0, r.start_time_us + r.service_time_us - now);
+  }
+}
+
+// the same plan as pick_runner(), for `num_of_ahead` requests served first
+// and then the new one. runners not measured yet cost nothing, so nothing is
+// rejected before the service times are known.
+int64_t AsyncRunnerImpl::predict_completion_us(size_t num_of_ahead) {
+  std::lock_guard<std::mutex> lock(mtx_for_runners_);
+  auto now = now_in_us();
+  auto ready = std::vector<int64_t>(runners_.size());
+  get_ready_time(ready, now);
+  auto finish = int64_t(0);
+  for (auto remaining = num_of_ahead + 1u; remaining > 0u;) {
+    auto next = 0u;
+    finish = std::numeric_limits<int64_t>::max();
+    for (auto& r : runners_) {
+      if (ready[r.runner_idx] + r.service_time_us < finish) {
+        next = r.runner_idx;
+        finish = ready[r.runner_idx] + r.service_time_us;
+      }
+    }
+    ready[next] = finish;
+    remaining -= std::min(remaining, runners_[next].batch_size);
+  }
+  return now + finish;
+}
+
+void AsyncRunnerImpl::thread_main() {
+  do {
+    auto max_waiting_time = std::chrono::microseconds(
+        ENV_PARAM(XLNX_MAX_WAITING_TIME_IN_MS) * 1000);
+    auto first = queue_->recv(max_waiting_time);
+    if (first == nullptr) {
+      // thread is alive if it is running or there are still some quests in
+      // the queue.
       continue;
     }
-    LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) >= 3)
-        << "weakup runner[" << *cur_runner << "]";
-    auto& runner = runners_[*cur_runner];
-    CHECK_EQ(runner.state, IDLE)
-        << " *cur_runner=" << *cur_runner
-        << " something wrong. please check queue_.capacity is as same "
-           "as sizeof runners. states:"
-        << runners_state_as_string();
+    auto& runner = runners_[pick_runner()];
     auto batch_size = runner.batch_size;
-    size_t batch_idx = 0u;
     std::vector<std::unique_ptr<queue_element_type_t>> args;
-    args.resize(batch_size);
-    do {
-      runner.state = COLLECTING;
-      for (batch_idx = 0u; batch_idx < batch_size; ++batch_idx) {
-        auto arg = queue_->recv(
-            std::chrono::milliseconds(ENV_PARAM(XLNX_MAX_WAITING_TIME_IN_MS)));
-        if (arg) {
-          args[batch_idx] = std::move(arg);
-        } else {
-          break;
-        }
+    args.reserve(batch_size);
+    // the batch is collected within a window which closes early enough
+    // for the most urgent request collected so far to meet its deadline.
+    auto latest_start = std::numeric_limits<int64_t>::max();
+    auto collect = [&](std::unique_ptr<queue_element_type_t> arg) {
+      if (arg->deadline_us != std::numeric_limits<int64_t>::max()) {
+        latest_start = std::min(latest_start,
+                                arg->deadline_us - runner.service_time_us);
       }
-      if (ENV_PARAM(DEBUG_ASYNC_RUNNER)) {
-        if (batch_idx != 0) {
-          LOG_IF(INFO, batch_idx != batch_size)
-              << " throughput might be degraded. "      //
-              << " we need increase the queue length."  //
-              << " batch_size " << batch_size << " "    //
-              << " batch_idx = " << batch_idx << " *cur_runner= " << *cur_runner
-              << " running_= " << running_
-              << " queue_.capacity = " << queue_->capacity()
-              << " queue_.size() = " << queue_->size();
-        }
+      args.emplace_back(std::move(arg));
+    };
+    collect(std::move(first));
+    while (args.size() < batch_size) {
+      auto window = std::min<int64_t>(max_waiting_time.count(),
+                                      latest_start - now_in_us());
+      auto arg = queue_->recv(
+          std::chrono::microseconds(std::max<int64_t>(window, 0)));
+      if (arg == nullptr) {
+        break;
       }
-    } while (batch_idx == 0u &&
-             // thread is alive if it is running or there are still some
-             // quests in the queue.
-             (running_ || queue_->size() != 0));
-    if (batch_idx > 0u) {
-      args.resize(batch_idx);
-      start_one_runner(runner, std::move(args));
-    } else {
-      runner.state = IDLE;
-      runners_idx_q_->send_ptr(std::move(cur_runner));
+      collect(std::move(arg));
     }
+    LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER) && args.size() != batch_size)
+        << " throughput might be degraded. "      //
+        << " we need increase the queue length."  //
+        << " batch_size " << batch_size << " "    //
+        << " requests = " << args.size()
+        << " runner_idx = " << runner.runner_idx << " running_= " << running_
+        << " queue_.capacity = " << queue_->capacity()
+        << " queue_.size() = " << queue_->size();
+    start_one_runner(runner, std::move(args));
   } while ((running_ || queue_->size() != 0));
   LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
       << "async runner main_thread say good bye";
@@ -514,11 +914,73 @@ void AsyncRunnerImpl::thread_main() {
 }
 }  // namespace
 
+namespace {
+AsyncRunner::AsyncRunner(std::shared_ptr<AsyncRunnerImpl> r, xir::Attrs* attrs)
+    : real_runner_{r}, mtx_{}, options_{}, inputs_{}, outputs_{} {
+  update_run_options(attrs, options_);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
+      << "AsyncRunner@" << (void*)this << " created."
+      << " priority=" << options_.priority
+      << " deadline=" << options_.deadline_ms << "ms";
+}
+
+AsyncRunner::~AsyncRunner() {
+  real_runner_.reset();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_ASYNC_RUNNER))
+      << "AsyncRunner@" << (void*)this << " destroyed.";
+}
+
+std::pair<uint32_t, int> AsyncRunner::execute_async(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output) {
+  auto options = run_options_t();
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    options = options_;
+  }
+  return real_runner_->submit(input, output, options);
+}
+
+int AsyncRunner::wait(int jobid, int timeout) {
+  return real_runner_->wait(jobid, timeout);
+}
+
+std::vector<const xir::Tensor*> AsyncRunner::get_input_tensors() {
+  return real_runner_->get_input_tensors();
+}
+
+std::vector<const xir::Tensor*> AsyncRunner::get_output_tensors() {
+  return real_runner_->get_output_tensors();
+}
+
+// host buffers of batch 1, allocated on the first use.
+std::vector<vart::TensorBuffer*> AsyncRunner::get_inputs() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (inputs_.empty()) {
+    inputs_ = vart::alloc_cpu_flat_tensor_buffers(get_input_tensors());
+  }
+  return vitis::ai::vector_unique_ptr_get(inputs_);
+}
+
+std::vector<vart::TensorBuffer*> AsyncRunner::get_outputs() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (outputs_.empty()) {
+    outputs_ = vart::alloc_cpu_flat_tensor_buffers(get_output_tensors());
+  }
+  return vitis::ai::vector_unique_ptr_get(outputs_);
+}
+
+int AsyncRunner::set_run_attrs(std::unique_ptr<xir::Attrs>& attrs) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  return update_run_options(attrs.get(), options_) ? 0 : 1;
+}
+}  // namespace
+
 // main entry
 extern "C" vart::Runner* create_runner_with_attrs(vart::init_function_t f,
                                                   const xir::Subgraph* subgraph,
                                                   xir::Attrs* attrs) {
   auto r = vitis::ai::WeakStore<const xir::Subgraph*, AsyncRunnerImpl>::create(
       subgraph, f, subgraph, attrs);
-  return std::unique_ptr<vart::Runner>(new AsyncRunner(r)).release();
+  return std::unique_ptr<vart::Runner>(new AsyncRunner(r, attrs)).release();
 }
@@ -19,7 +19,6 @@
 #include <map>
 
 #include "vart/runner.hpp"
-#include "vitis/ai/erl_msg_box.hpp"
 #include "vitis/ai/thread_pool.hpp"
 namespace vart {
 using init_function_t = vart::Runner* (*)(const xir::Subgraph*, xir::Attrs*);
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "./buffer_object.hpp"
+namespace xir {
+
+/**
+ * @brief a sub-allocator which carves small buffer objects out of large
+ * regions.
+ *
+ * Every BufferObject::create() costs a driver call and a mmap, and the size
+ * is rounded up to pages. The pool creates regions of a few MB and hands out
+ * slices of them, each slice is a BufferObject whose phy(), sync_for_read()
+ * and sync_for_write() are translated to the slice range of its region.
+ * Sizes are rounded up to size classes, a released slice goes to the free
+ * list of its class and is reused by the next allocation of the same class.
+ * A reused slice is cleared, as a new buffer object is.
+ * Regions are released when the pool and all slices are gone.
+ *
+ * Slices carry no XRT buffer handle, so if a region has one, i.e.
+ * get_xcl_bo() is needed, the pool creates a buffer object per allocation
+ * instead. This is probed with a small buffer object on the first
+ * allocation.
+ */
+class BufferObjectPool {
+ public:
+  using region_factory_t =
+      std::function<std::unique_ptr<BufferObject>(size_t size)>;
+  struct stat_t {
+    size_t num_of_regions;
+    size_t region_bytes;
+    /// all allocations, reused ones included
+    size_t num_of_allocations;
+    /// allocations served from a free list
+    size_t num_of_reused;
+    /// allocations too large for a region, or not sliceable
+    size_t num_of_direct;
+    size_t num_of_live_slices;
+    /// sizes asked for by live slices
+    size_t requested_bytes;
+    /// size class rounding of live slices, plus free lists and region tails
+    size_t wasted_bytes;
+    /// time spent in creating regions and direct buffer objects
+    uint64_t creation_time_us;
+  };
+
+ public:
+  /// the pool shared by all users of the device, it is released when the
+  /// last user and the last slice are gone.
+  static VART_BUFFER_OBJECT_DLLSPEC std::shared_ptr<BufferObjectPool> get(
+      size_t device_id, const std::string& cu_name);
+  /// region_size == 0 means env XLNX_BO_POOL_REGION_SIZE.
+  static VART_BUFFER_OBJECT_DLLSPEC std::shared_ptr<BufferObjectPool> create(
+      region_factory_t region_factory, size_t region_size = 0u);
+
+ public:
+  explicit BufferObjectPool() = default;
+  BufferObjectPool(const BufferObjectPool&) = delete;
+  BufferObjectPool& operator=(const BufferObjectPool& other) = delete;
+  virtual ~BufferObjectPool() = default;
+
+ public:
+  /// thread-safe. the returned buffer object keeps the pool alive.
+  virtual std::unique_ptr<BufferObject> allocate(size_t size) = 0;
+  virtual stat_t get_stat() const = 0;
+};
+}  // namespace xir
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <memory>
+#include <string>
+
+#include "./buffer_object.hpp"
+namespace xir {
+
+/**
+ * @brief a host buffer object which is shared among processes by name.
+ *
+ * The first process which creates a name is the owner, it fills the buffer
+ * and then calls mark_ready(). Other processes block in create() until the
+ * buffer is ready and map the same pages. The name is removed when the last
+ * process releases its buffer object.
+ *
+ * There is no device memory behind it, phy() returns the address in the
+ * calling process, so a device cannot be programmed with it. The device
+ * tensor buffers do not use it, it is for host-only consumers.
+ */
+class SharedBufferObject : public BufferObject {
+ public:
+  static VART_BUFFER_OBJECT_DLLSPEC std::unique_ptr<SharedBufferObject> create(
+      const std::string& name, size_t size);
+
+ public:
+  explicit SharedBufferObject() = default;
+  virtual ~SharedBufferObject() = default;
+
+ public:
+  /// true if the calling process created the buffer and must initialize it.
+  virtual bool is_owner() const = 0;
+  /// publish the content to other processes, only the owner calls it.
+  virtual void mark_ready() = 0;
+};
+}  // namespace xir
@@ -21,6 +21,7 @@
 #include <map>
 
 #include "vitis/ai/env_config.hpp"
+#include "xir/shared_buffer_object.hpp"
 DEF_ENV_PARAM(DEBUG_BUFFER_OBJECT, "0");
 
 // DECLARE_INJECTION_NULLPTR(xir::BufferObject, size_t&);
@@ -34,4 +35,13 @@ std::unique_ptr<BufferObject> BufferObject::create(size_t size,
 }
 
 XclBo BufferObject::get_xcl_bo() const { return XclBo{nullptr, 0}; }
+
+#if defined(_WIN32)
+// see buffer_object_shm.cpp for linux.
+std::unique_ptr<SharedBufferObject> SharedBufferObject::create(
+    const std::string& name, size_t size) {
+  LOG(FATAL) << "shared buffer object is not supported on windows";
+  return nullptr;
+}
+#endif
 }  // namespace xir
@@ -20,46 +20,17 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 #include <cassert>
-#include <unordered_map>
+
+#include "vitis/ai/weak.hpp"
 namespace vitis {
 namespace xir {
-template <typename T>
-struct WeakSingleton {
-  template <typename... Args>
-  static std::shared_ptr<T> create(Args&&... args) {
-    static std::weak_ptr<T> the_instance_;
-    std::shared_ptr<T> ret;
-    if (the_instance_.expired()) {
-      ret = std::make_shared<T>(std::forward<Args>(args)...);
-      the_instance_ = ret;
-    }
-    ret = the_instance_.lock();
-    assert(ret != nullptr);
-    return ret;
-  }
-};
-
-template <typename K, typename T>
-struct WeakStore {
-  template <typename... Args>
-  static std::shared_ptr<T> create(const K& key, Args&&... args) {
-    static std::unordered_map<K, std::weak_ptr<T>> the_store_;
-    std::shared_ptr<T> ret;
-    if (the_store_[key].expired()) {
-      ret = std::make_shared<T>(std::forward<Args>(args)...);
-      the_store_[key] = ret;
-    }
-    ret = the_store_[key].lock();
-    assert(ret != nullptr);
-    return ret;
-  }
-};
-
 std::shared_ptr<buffer_object_fd> buffer_object_fd::create(
     const std::string& name, int flags) {
   // return std::make_shared<buffer_object_fd>(name, flags);
-  return WeakStore<std::string, buffer_object_fd>::create(name, name, flags);
+  return vitis::ai::WeakStore<std::string, buffer_object_fd>::create(
+      name, name, flags);
 }
 
 static int my_open(const std::string& name, int flags) {
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "xir/buffer_object_pool.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "./buffer_object_view.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/weak.hpp"
+
+DEF_ENV_PARAM(DEBUG_BUFFER_OBJECT, "0")
+DEF_ENV_PARAM_2(XLNX_BO_POOL_REGION_SIZE, "4194304", size_t)
+
+namespace {
+// slices are as aligned as buffer objects created for tensor buffers, and
+// never share a cache line, so that syncing one slice does not touch its
+// neighbours.
+static constexpr size_t ALIGNMENT = 1024u;
+
+static size_t align(size_t a, size_t b) { return (a + b - 1u) / b * b; }
+
+// multiples of ALIGNMENT up to 8 * ALIGNMENT, then 8 classes per power of
+// two, so that rounding wastes less than 1/8.
+static size_t size_class(size_t size) {
+  auto ret = align(std::max(size, (size_t)1u), ALIGNMENT);
+  if (ret <= 8u * ALIGNMENT) {
+    return ret;
+  }
+  auto power_of_two = ret;
+  while ((power_of_two & (power_of_two - 1u)) != 0u) {
+    power_of_two = power_of_two & (power_of_two - 1u);
+  }
+  return align(ret, power_of_two / 8u);
+}
+
+static uint64_t elapsed_us(std::chrono::steady_clock::time_point start) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+class BufferObjectPoolImp;
+
+class BufferObjectSlice : public xir::BufferObjectView {
+ public:
+  explicit BufferObjectSlice(std::shared_ptr<BufferObjectPoolImp> pool,
+                             xir::BufferObject* region, size_t region_idx,
+                             size_t offset, size_t size, size_t size_class)
+      : xir::BufferObjectView(region, offset, size),
+        pool_{std::move(pool)},
+        region_idx_{region_idx},
+        offset_{offset},
+        size_{size},
+        size_class_{size_class} {}
+  virtual ~BufferObjectSlice();
+
+ private:
+  std::shared_ptr<BufferObjectPoolImp> pool_;
+  size_t region_idx_;
+  size_t offset_;
+  size_t size_;
+  size_t size_class_;
+};
+
+class BufferObjectPoolImp
+    : public xir::BufferObjectPool,
+      public std::enable_shared_from_this<BufferObjectPoolImp> {
+ public:
+  explicit BufferObjectPoolImp(region_factory_t region_factory,
+                               size_t region_size)
+      : xir::BufferObjectPool(),
+        region_factory_{std::move(region_factory)},
+        region_size_{align(region_size == 0u
+                               ? ENV_PARAM(XLNX_BO_POOL_REGION_SIZE)
+                               : region_size,
+                           ALIGNMENT)},
+        probed_{false},
+        sliceable_{true},
+        regions_{},
+        used_{0u},
+        free_lists_{},
+        stat_{} {}
+  virtual ~BufferObjectPoolImp();
+
+ public:
+  virtual std::unique_ptr<xir::BufferObject> allocate(size_t size) override;
+  virtual stat_t get_stat() const override;
+  void release(size_t region_idx, size_t offset, size_t size,
+               size_t size_class);
+
+ private:
+  std::unique_ptr<xir::BufferObject> create_direct(size_t size);
+  void probe();
+  void add_region();
+
+ private:
+  const region_factory_t region_factory_;
+  const size_t region_size_;
+  // false if regions are XRT buffer objects, see get_xcl_bo(). it is known
+  // once probed_ is set.
+  bool probed_;
+  bool sliceable_;
+  std::vector<std::unique_ptr<xir::BufferObject>> regions_;
+  // bytes handed out from the last region
+  size_t used_;
+  // size class => (region index, offset)
+  std::map<size_t, std::vector<std::pair<size_t, size_t>>> free_lists_;
+  stat_t stat_;
+  mutable std::mutex mtx_;
+};
+
+BufferObjectSlice::~BufferObjectSlice() {
+  pool_->release(region_idx_, offset_, size_, size_class_);
+}
+
+BufferObjectPoolImp::~BufferObjectPoolImp() {
+  auto stat = get_stat();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_BUFFER_OBJECT))
+      << "buffer object pool @" << (void*)this << " destroyed:"
+      << " regions=" << stat.num_of_regions << " "
+      << " region_bytes=" << stat.region_bytes << " "
+      << " allocations=" << stat.num_of_allocations << " "
+      << " reused=" << stat.num_of_reused << " "
+      << " direct=" << stat.num_of_direct << " "
+      << " creation_time=" << stat.creation_time_us << "us";
+}
+
+std::unique_ptr<xir::BufferObject> BufferObjectPoolImp::create_direct(
+    size_t size) {
+  auto start = std::chrono::steady_clock::now();
+  auto ret = region_factory_(size);
+  std::lock_guard<std::mutex> lock(mtx_);
+  stat_.num_of_allocations++;
+  stat_.num_of_direct++;
+  stat_.creation_time_us += elapsed_us(start);
+  return ret;
+}
+
+void BufferObjectPoolImp::probe() {
+  // a buffer object of the smallest class tells whether the regions would
+  // have an XRT buffer handle, without creating a whole region.
+  auto start = std::chrono::steady_clock::now();
+  sliceable_ = region_factory_(ALIGNMENT)->get_xcl_bo().bo_handle == nullptr;
+  probed_ = true;
+  stat_.creation_time_us += elapsed_us(start);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_BUFFER_OBJECT) && !sliceable_)
+      << "buffer object pool @" << (void*)this
+      << " regions have an XRT buffer handle, slicing is disabled.";
+}
+
+void BufferObjectPoolImp::add_region() {
+  auto start = std::chrono::steady_clock::now();
+  auto region = region_factory_(region_size_);
+  stat_.creation_time_us += elapsed_us(start);
+  // the tail of the previous region is left unused.
+  regions_.emplace_back(std::move(region));
+  used_ = 0u;
+  stat_.num_of_regions++;
+  stat_.region_bytes += region_size_;
+}
+
+std::unique_ptr<xir::BufferObject> BufferObjectPoolImp::allocate(size_t size) {
+  auto cls = size_class(size);
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (!probed_) {
+    probe();
+  }
+  if (!sliceable_ || cls > region_size_ / 4u) {
+    lock.unlock();
+    return create_direct(size);
+  }
+  auto& free_list = free_lists_[cls];
+  auto slice = std::make_pair((size_t)0u, (size_t)0u);
+  auto reused = !free_list.empty();
+  if (reused) {
+    slice = free_list.back();
+    free_list.pop_back();
+    stat_.num_of_reused++;
+  } else {
+    if (regions_.empty() || used_ + cls > region_size_) {
+      add_region();
+    }
+    slice = std::make_pair(regions_.size() - 1u, used_);
+    used_ += cls;
+  }
+  stat_.num_of_allocations++;
+  stat_.num_of_live_slices++;
+  stat_.requested_bytes += size;
+  LOG_IF(INFO, ENV_PARAM(DEBUG_BUFFER_OBJECT) >= 2)
+      << "allocate " << size << " bytes from region " << slice.first
+      << " offset " << slice.second << " size_class " << cls;
+  std::unique_ptr<xir::BufferObject> ret = std::make_unique<BufferObjectSlice>(
+      shared_from_this(), regions_[slice.first].get(), slice.first,
+      slice.second, size, cls);
+  lock.unlock();
+  // a new buffer object is cleared, so is a slice which held other data.
+  if (reused) {
+    memset(ret->data_w(), 0, size);
+    ret->sync_for_write(0u, size);
+  }
+  return ret;
+}
+
+void BufferObjectPoolImp::release(size_t region_idx, size_t offset,
+                                  size_t size, size_t size_class) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  free_lists_[size_class].emplace_back(region_idx, offset);
+  stat_.num_of_live_slices--;
+  stat_.requested_bytes -= size;
+}
+
+xir::BufferObjectPool::stat_t BufferObjectPoolImp::get_stat() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto ret = stat_;
+  ret.wasted_bytes = ret.region_bytes - ret.requested_bytes;
+  return ret;
+}
+}  // namespace
+
+namespace xir {
+std::shared_ptr<BufferObjectPool> BufferObjectPool::get(
+    size_t device_id, const std::string& cu_name) {
+  auto factory = [device_id, cu_name](size_t size) {
+    return BufferObject::create(size, device_id, cu_name);
+  };
+  return vitis::ai::WeakStore<std::string, BufferObjectPoolImp>::create(
+      std::to_string(device_id) + ":" + cu_name, factory, (size_t)0u);
+}
+
+std::shared_ptr<BufferObjectPool> BufferObjectPool::create(
+    region_factory_t region_factory, size_t region_size) {
+  return std::make_shared<BufferObjectPoolImp>(std::move(region_factory),
+                                               region_size);
+}
+}  // namespace xir
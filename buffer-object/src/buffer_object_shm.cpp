@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "./buffer_object_shm.hpp"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vitis/ai/env_config.hpp>
+
+DEF_ENV_PARAM(DEBUG_BUFFER_OBJECT, "0")
+// how long a process waits for the owner to initialize a shared buffer. an
+// owner which dies before that is detected at once, its buffer is recreated.
+DEF_ENV_PARAM(XLNX_SHARED_BUFFER_OBJECT_TIMEOUT_MS, "60000")
+
+namespace {
+
+static constexpr uint64_t SHM_MAGIC = 0x314d485354524156ull;  // "VARTSHM1"
+
+static size_t align(size_t a, size_t b) {
+  if (a % b == 0) {
+    return a;
+  }
+  return (a / b + 1) * b;
+}
+
+static std::string shm_name(const std::string& name) {
+  return name.empty() || name[0] != '/' ? std::string("/") + name : name;
+}
+
+BufferObjectShm::BufferObjectShm(const std::string& name, size_t size)
+    : SharedBufferObject(),
+      name_{shm_name(name)},
+      size_{size},
+      mapped_size_{align(sizeof(shm_header_t), getpagesize()) +
+                   align(size, getpagesize())},
+      owner_{false},
+      fd_{-1},
+      base_{nullptr},
+      header_{nullptr},
+      data_{nullptr} {
+  auto timeout = std::chrono::milliseconds(
+      ENV_PARAM(XLNX_SHARED_BUFFER_OBJECT_TIMEOUT_MS));
+  auto start = std::chrono::steady_clock::now();
+  // a segment might be created by another process or removed by the last
+  // user in the meanwhile, retry until we hold a live and ready one.
+  for (;;) {
+    CHECK(std::chrono::steady_clock::now() - start < timeout)
+        << "timeout opening " << name_;
+    fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    owner_ = fd_ >= 0;
+    if (!owner_) {
+      PCHECK(errno == EEXIST) << "cannot create " << name_;
+      fd_ = shm_open(name_.c_str(), O_RDWR, 0600);
+      if (fd_ < 0 && errno == ENOENT) {
+        continue;
+      }
+      PCHECK(fd_ >= 0) << "cannot open " << name_;
+    }
+    // the owner keeps the lock until mark_ready(), others wait for it here.
+    if (!lock_until(start + timeout)) {
+      close(fd_);
+      LOG(FATAL) << "timeout waiting for " << name_
+                 << ", the owner might be hung";
+    }
+    struct stat st;
+    PCHECK(fstat(fd_, &st) == 0) << "cannot stat " << name_;
+    auto retry = st.st_nlink == 0u || (!owner_ && st.st_size == 0);
+    if (retry) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+    if (owner_) {
+      PCHECK(ftruncate(fd_, mapped_size_) == 0) << "cannot resize " << name_;
+    } else {
+      CHECK_EQ((size_t)st.st_size, mapped_size_)
+          << "size mismatch, name=" << name_;
+    }
+    base_ = mmap(NULL, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                 0);
+    PCHECK(base_ != MAP_FAILED) << "cannot map " << name_;
+    if (owner_) {
+      header_ = new (base_) shm_header_t();
+      header_->magic = SHM_MAGIC;
+      header_->size = size_;
+      header_->ready.store(0u);
+      header_->refcount.store(1);
+      break;
+    }
+    header_ = static_cast<shm_header_t*>(base_);
+    CHECK_EQ(header_->magic, SHM_MAGIC) << "not a shared buffer " << name_;
+    CHECK_EQ(header_->size, size_) << "size mismatch, name=" << name_;
+    if (header_->ready.load(std::memory_order_acquire) == 0u) {
+      // the lock was released before mark_ready(), i.e. the owner died.
+      // the name still refers to this segment since st_nlink > 0, remove it
+      // and create a new one, processes mapping the stale one keep it alive.
+      LOG(WARNING) << "the owner of " << name_ << " died before it was "
+                   << "ready, recreate it";
+      shm_unlink(name_.c_str());
+      flock(fd_, LOCK_UN);
+      munmap(base_, mapped_size_);
+      close(fd_);
+      base_ = nullptr;
+      header_ = nullptr;
+      continue;
+    }
+    header_->refcount.fetch_add(1);
+    flock(fd_, LOCK_UN);
+    break;
+  }
+  data_ = static_cast<char*>(base_) +
+          align(sizeof(shm_header_t), getpagesize());
+  LOG_IF(INFO, ENV_PARAM(DEBUG_BUFFER_OBJECT))
+      << "shared buffer object " << name_ << " "   //
+      << "size " << size_ << " "                   //
+      << "owner " << owner_ << " "                 //
+      << "refcount " << header_->refcount.load();  //
+}
+
+BufferObjectShm::~BufferObjectShm() {
+  // the owner still holds the lock if it never called mark_ready().
+  flock(fd_, LOCK_EX);
+  auto refcount = header_->refcount.fetch_sub(1) - 1;
+  struct stat st;
+  if (refcount == 0 && fstat(fd_, &st) == 0 && st.st_nlink > 0u) {
+    shm_unlink(name_.c_str());
+  }
+  flock(fd_, LOCK_UN);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_BUFFER_OBJECT))
+      << "shared buffer object " << name_ << " released, "
+      << "refcount " << refcount;
+  munmap(base_, mapped_size_);
+  close(fd_);
+}
+
+bool BufferObjectShm::lock_until(
+    std::chrono::steady_clock::time_point deadline) {
+  while (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+    PCHECK(errno == EWOULDBLOCK) << "cannot lock " << name_;
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+bool BufferObjectShm::is_owner() const { return owner_; }
+
+void BufferObjectShm::mark_ready() {
+  CHECK(owner_) << "only the owner initializes " << name_;
+  if (header_->ready.load(std::memory_order_relaxed) == 0u) {
+    header_->ready.store(1u, std::memory_order_release);
+    flock(fd_, LOCK_UN);
+  }
+}
+
+const void* BufferObjectShm::data_r() const {  //
+  return data_;
+}
+
+void* BufferObjectShm::data_w() {  //
+  return data_;
+}
+
+size_t BufferObjectShm::size() { return size_; }
+
+uint64_t BufferObjectShm::phy(size_t offset) {
+  // host only, there is no physical address.
+  return reinterpret_cast<uint64_t>(data_) + offset;
+}
+
+void BufferObjectShm::sync_for_read(uint64_t offset, size_t size) {
+  CHECK_LE(offset + size, size_) << " out of range";
+}
+
+void BufferObjectShm::sync_for_write(uint64_t offset, size_t size) {
+  CHECK_LE(offset + size, size_) << " out of range";
+}
+
+void BufferObjectShm::copy_from_host(const void* buf, size_t size,
+                                     size_t offset) {
+  CHECK_LE(offset + size, size_) << " out of range";
+  memcpy(data_ + offset, buf, size);
+}
+
+void BufferObjectShm::copy_to_host(void* buf, size_t size, size_t offset) {
+  CHECK_LE(offset + size, size_) << " out of range";
+  memcpy(buf, data_ + offset, size);
+}
+
+}  // namespace
+
+namespace xir {
+std::unique_ptr<SharedBufferObject> SharedBufferObject::create(
+    const std::string& name, size_t size) {
+  return std::make_unique<BufferObjectShm>(name, size);
+}
+}  // namespace xir
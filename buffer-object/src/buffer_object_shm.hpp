@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "xir/shared_buffer_object.hpp"
+namespace /* anonympous */ {
+// it lives in the first page of the shared memory segment.
+struct shm_header_t {
+  uint64_t magic;
+  uint64_t size;
+  std::atomic<uint32_t> ready;
+  std::atomic<int32_t> refcount;
+};
+
+class BufferObjectShm : public ::xir::SharedBufferObject {
+ public:
+  explicit BufferObjectShm(const std::string& name, size_t size);
+  BufferObjectShm(const BufferObjectShm&) = delete;
+  BufferObjectShm& operator=(const BufferObjectShm& other) = delete;
+
+  virtual ~BufferObjectShm();
+
+ public:
+  virtual bool is_owner() const override;
+  virtual void mark_ready() override;
+
+ private:
+  virtual void* data_w() override;
+  virtual const void* data_r() const override;
+
+  virtual size_t size() override;
+  virtual uint64_t phy(size_t offset = 0) override;
+  virtual void sync_for_read(uint64_t offset, size_t size) override;
+  virtual void sync_for_write(uint64_t offset, size_t size) override;
+  virtual void copy_from_host(const void* buf, size_t size,
+                              size_t offset) override;
+  virtual void copy_to_host(void* buf, size_t size, size_t offset) override;
+
+ private:
+  // flock(LOCK_EX) on fd_, false on timeout.
+  bool lock_until(std::chrono::steady_clock::time_point deadline);
+
+ private:
+  const std::string name_;
+  const size_t size_;
+  size_t mapped_size_;
+  bool owner_;
+  // kept open, it is locked while the refcount is updated, and by the owner
+  // until mark_ready(). the kernel drops the lock if the owner dies.
+  int fd_;
+  void* base_;
+  shm_header_t* header_;
+  char* data_;
+};
+}  // namespace
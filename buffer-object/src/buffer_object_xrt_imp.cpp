@@ -25,6 +25,7 @@
 #include <glog/logging.h>
 
 #include <UniLog/UniLog.hpp>
+#include <atomic>
 #include <cstring>
 #include <string>
 
@@ -71,7 +72,7 @@ BufferObjectXrtEdgeImp::BufferObjectXrtEdgeImp(size_t size, size_t device_id,
   if (ENV_PARAM(DRAM_ADDRESS_MAPPING)) {
     int num_of_bank = ENV_PARAM(DRAM_NUM_OF_BANK);
     size_t range_per_bank = ENV_PARAM(DRAM_BANK_RANGE);
-    static int bo_idx = 0;
+    static std::atomic<int> bo_idx{0};
     if (size > range_per_bank) {
       bo_size_ = size + (range_per_bank * num_of_bank);
       bank_offset_ = ((bo_idx++) % num_of_bank) * range_per_bank;
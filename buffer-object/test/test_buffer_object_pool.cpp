@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// allocates many small buffer objects from a pool backed by host memory and
+// checks that slices do not overlap, keep their content, sync their own
+// range of the region and are reused, cleared, after release. the same
+// allocations without the pool are measured for comparison.
+//
+// usage: test_buffer_object_pool [num_of_buffer_objects] [max_size]
+#include <glog/logging.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "xir/buffer_object_pool.hpp"
+
+// phy() is the virtual address, syncs are recorded. it is cleared as the
+// buffer objects of devices are.
+class HostBufferObject : public xir::BufferObject {
+ public:
+  explicit HostBufferObject(size_t size)
+      : size_{size},
+        data_{aligned_alloc(4096u, (size + 4095u) / 4096u * 4096u)} {
+    memset(data_, 0, size_);
+    num_of_created++;
+  }
+  virtual ~HostBufferObject() { free(data_); }
+  virtual size_t size() override { return size_; }
+  virtual void* data_w() override { return data_; }
+  virtual const void* data_r() const override { return data_; }
+  virtual uint64_t phy(size_t offset) override {
+    return (uint64_t)data_ + offset;
+  }
+  virtual void sync_for_read(uint64_t offset, size_t size) override {
+    CHECK_LE(offset + size, size_);
+    last_sync = std::make_pair(phy(offset), size);
+  }
+  virtual void sync_for_write(uint64_t offset, size_t size) override {
+    CHECK_LE(offset + size, size_);
+    last_sync = std::make_pair(phy(offset), size);
+  }
+  virtual void copy_from_host(const void* buf, size_t size,
+                              size_t offset) override {
+    memcpy((char*)data_ + offset, buf, size);
+  }
+  virtual void copy_to_host(void* buf, size_t size, size_t offset) override {
+    memcpy(buf, (char*)data_ + offset, size);
+  }
+
+ public:
+  static size_t num_of_created;
+  static std::pair<uint64_t, size_t> last_sync;
+
+ private:
+  size_t size_;
+  void* data_;
+};
+size_t HostBufferObject::num_of_created = 0u;
+std::pair<uint64_t, size_t> HostBufferObject::last_sync;
+
+static std::unique_ptr<xir::BufferObject> create_host_bo(size_t size) {
+  return std::make_unique<HostBufferObject>(size);
+}
+
+template <typename F>
+static double measure_us(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_buffer_objects = argc > 1 ? std::stoi(argv[1]) : 4000;
+  auto max_size = argc > 2 ? (size_t)std::stoul(argv[2]) : (size_t)65536u;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<size_t> dist(1u, max_size);
+  auto sizes = std::vector<size_t>(num_of_buffer_objects);
+  for (auto& size : sizes) {
+    size = dist(rng);
+  }
+
+  auto direct = std::vector<std::unique_ptr<xir::BufferObject>>();
+  auto direct_us = measure_us([&]() {
+    for (auto size : sizes) {
+      direct.emplace_back(create_host_bo(size));
+    }
+  });
+  direct.clear();
+
+  auto ok = true;
+  HostBufferObject::num_of_created = 0u;
+  auto pool = xir::BufferObjectPool::create(create_host_bo);
+  auto slices = std::vector<std::unique_ptr<xir::BufferObject>>();
+  auto pool_us = measure_us([&]() {
+    for (auto size : sizes) {
+      slices.emplace_back(pool->allocate(size));
+    }
+  });
+  for (auto i = 0u; i < slices.size(); ++i) {
+    memset(slices[i]->data_w(), (int)(i & 0xff), sizes[i]);
+  }
+  auto ranges = std::vector<std::pair<uint64_t, uint64_t>>();
+  for (auto i = 0u; i < slices.size() && ok; ++i) {
+    auto& bo = slices[i];
+    auto p = bo->get_r<uint8_t>();
+    ok = bo->size() == sizes[i] && bo->phy() % 1024u == 0u &&
+         std::all_of(p, p + sizes[i],
+                     [i](uint8_t c) { return c == (uint8_t)(i & 0xff); });
+    LOG_IF(ERROR, !ok) << "slice " << i << " is corrupted";
+    ranges.emplace_back(bo->phy(), bo->phy() + sizes[i]);
+    auto offset = sizes[i] / 2u;
+    bo->sync_for_write(offset, sizes[i] - offset);
+    ok = ok && HostBufferObject::last_sync ==
+                   std::make_pair(bo->phy(offset), sizes[i] - offset);
+    LOG_IF(ERROR, !ok) << "slice " << i << " syncs a wrong range";
+  }
+  std::sort(ranges.begin(), ranges.end());
+  for (auto i = 1u; i < ranges.size() && ok; ++i) {
+    ok = ranges[i - 1].second <= ranges[i].first;
+    LOG_IF(ERROR, !ok) << "slices overlap";
+  }
+  auto stat = pool->get_stat();
+  std::cout << "allocations=" << stat.num_of_allocations
+            << " regions=" << stat.num_of_regions
+            << " direct=" << stat.num_of_direct
+            << " requested=" << stat.requested_bytes
+            << " wasted=" << stat.wasted_bytes << " ("
+            << 100.0 * stat.wasted_bytes / stat.region_bytes << "%)"
+            << " region_creation=" << stat.creation_time_us << "us"
+            << std::endl;
+  std::cout << "buffer objects created: pool="
+            << HostBufferObject::num_of_created << " direct=" << sizes.size()
+            << ", allocation time: pool="
+            << pool_us << "us direct=" << direct_us << "us" << std::endl;
+
+  // release every other slice and allocate the same sizes again, all of
+  // them come from the free lists, except those too large for a region.
+  for (auto i = 0u; i < slices.size(); i += 2u) {
+    slices[i] = nullptr;
+  }
+  for (auto i = 0u; i < slices.size(); i += 2u) {
+    slices[i] = pool->allocate(sizes[i]);
+    auto p = slices[i]->get_r<uint8_t>();
+    ok = ok && std::all_of(p, p + sizes[i], [](uint8_t c) { return c == 0u; });
+    LOG_IF(ERROR, !ok) << "slice " << i << " is not cleared";
+  }
+  auto stat2 = pool->get_stat();
+  auto reused = stat2.num_of_reused - stat.num_of_reused;
+  auto direct2 = stat2.num_of_direct - stat.num_of_direct;
+  std::cout << "reused=" << reused << " direct=" << direct2
+            << " regions=" << stat2.num_of_regions << std::endl;
+  ok = ok && reused + direct2 == (slices.size() + 1u) / 2u &&
+       stat2.num_of_regions == stat.num_of_regions;
+  std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
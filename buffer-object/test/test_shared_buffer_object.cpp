@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// several processes attach the same shared buffer object, only one of them
+// initializes it and all of them must see the same content. an owner which
+// dies before the buffer is ready is left behind first, the buffer must be
+// recreated by the other processes. all processes stay attached until
+// every one of them has attached, so that exactly one of them is the owner.
+//
+// usage: test_shared_buffer_object [num_of_processes] [size]
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "xir/shared_buffer_object.hpp"
+
+static int run_child(const std::string& name, size_t size, int attached_fd,
+                     int release_fd) {
+  auto bo = xir::SharedBufferObject::create(name, size);
+  if (bo->is_owner()) {
+    auto p = bo->get_w<uint8_t>();
+    for (auto i = 0u; i < size; ++i) {
+      p[i] = (uint8_t)(i * 7u + 3u);
+    }
+    bo->sync_for_write(0u, size);
+    bo->mark_ready();
+  }
+  bo->sync_for_read(0u, size);
+  auto p = bo->get_r<uint8_t>();
+  for (auto i = 0u; i < size; ++i) {
+    if (p[i] != (uint8_t)(i * 7u + 3u)) {
+      LOG(ERROR) << "pid " << getpid() << " mismatch at " << i;
+      return 1;
+    }
+  }
+  // stay attached until the parent has seen every process attached.
+  PCHECK(write(attached_fd, "a", 1) == 1) << "write failed";
+  char c;
+  while (read(release_fd, &c, 1) > 0) {
+  }
+  return bo->is_owner() ? 2 : 0;
+}
+
+int main(int argc, char* argv[]) {
+  auto num_of_processes = argc > 1 ? std::stoi(argv[1]) : 8;
+  auto size = argc > 2 ? (size_t)std::stoul(argv[2]) : (size_t)(1u << 20);
+  auto name = std::string("vart_test_shared_bo_") + std::to_string(getpid());
+  // the owner dies before mark_ready(), without releasing its reference.
+  auto dead = fork();
+  PCHECK(dead >= 0) << "fork failed";
+  if (dead == 0) {
+    auto bo = xir::SharedBufferObject::create(name, size);
+    _exit(bo->is_owner() ? 0 : 1);
+  }
+  int dead_status = 0;
+  waitpid(dead, &dead_status, 0);
+  int attached[2];
+  int release[2];
+  PCHECK(pipe(attached) == 0) << "pipe failed";
+  PCHECK(pipe(release) == 0) << "pipe failed";
+  auto pids = std::vector<pid_t>();
+  for (auto i = 0; i < num_of_processes; ++i) {
+    auto pid = fork();
+    PCHECK(pid >= 0) << "fork failed";
+    if (pid == 0) {
+      close(attached[0]);
+      close(release[1]);
+      _exit(run_child(name, size, attached[1], release[0]));
+    }
+    pids.push_back(pid);
+  }
+  close(attached[1]);
+  close(release[0]);
+  // a process which fails does not write, the read ends when all have exited.
+  auto num_of_attached = 0;
+  char c;
+  while (num_of_attached < num_of_processes && read(attached[0], &c, 1) > 0) {
+    num_of_attached++;
+  }
+  close(release[1]);
+  close(attached[0]);
+  auto num_of_owners = 0;
+  auto ok = true;
+  for (auto pid : pids) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    auto code = WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+    num_of_owners += code == 2;
+    ok = ok && (code == 0 || code == 2);
+  }
+  // the last process removes the name.
+  auto fd = shm_open(("/" + name).c_str(), O_RDONLY, 0600);
+  auto removed = fd < 0;
+  if (!removed) {
+    close(fd);
+    shm_unlink(("/" + name).c_str());
+  }
+  std::cout << "processes=" << num_of_processes << " size=" << size
+            << " owners=" << num_of_owners << " removed=" << removed
+            << std::endl;
+  ok = ok && num_of_attached == num_of_processes && num_of_owners == 1 &&
+       removed && WIFEXITED(dead_status) &&
+       WEXITSTATUS(dead_status) == 0;
+  std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -62,6 +62,13 @@ class CPUOPBase {
 
   virtual uint64_t get_workload() { return 0; }
 
+  // elementwise ops compute output[i] from input[i] only, so any range
+  // [start_index, end_index) of output can be computed once the same range
+  // of input is ready. it is used to fuse op chains, see fused_op.hpp
+  virtual bool is_elementwise() const { return false; }
+  virtual void run_range(std::uint32_t start_index, std::uint32_t end_index) {
+  }
+
   // useful routines to get op basic information
  public:
   const xir::Subgraph* get_xir_subg() const { return xir_subg_; }
@@ -43,6 +43,7 @@ class CPURunner : public RunnerExt {
 
  public:
   void create_ops_and_tbs();
+  void fuse_ops(bool enable);
   virtual std::pair<uint32_t, int>  // pair<jodid, status>
   execute_async(
       const std::vector<TensorBuffer*>& sbug_input_tbs,
@@ -61,7 +62,9 @@ class CPURunner : public RunnerExt {
   vector<TensorBuffer*> get_output_tbs();
   TensorBuffer* get_tb(const xir::Tensor* tensor);
 
-  void run();
+  // returns -1 if a dump is diff from its golden file and
+  // XLNX_CPU_RUNNER_GOLDEN_STOP is set, see DumpWriter
+  int run();
   void set_subg_input_tbs(const std::vector<TensorBuffer*>& sbug_input_tbs);
   void set_subg_output_tbs(const std::vector<TensorBuffer*>& subg_output_tbs);
   void set_subg_input_data();
@@ -84,6 +87,9 @@ class CPURunner : public RunnerExt {
   const xir::Graph* g_;
 
   std::vector<CPUOPBase*> cpu_ops_;
+  // cpu_ops_ with elementwise chains replaced by fused ops, used to run
+  std::vector<CPUOPBase*> run_ops_;
+  std::vector<std::unique_ptr<CPUOPBase>> fused_ops_;
   std::vector<xir::Op*> xir_ops_;
   mutable std::unordered_map<const xir::Op*, CPUOPBase*> cpu_op_map_;
 
@@ -92,7 +98,9 @@ class CPURunner : public RunnerExt {
 
   std::vector<std::string> assign_tensors_;
   std::vector<std::string> run_from_tensors_;
-  std::future<void> fut_;
+  std::future<int> fut_;
+  // dumps without a golden file are reported once
+  bool no_golden_reported_{false};
 
   std::unordered_map<const xir::Tensor*, CPUTensorBuffer*> outer_tbs_map_;
 };
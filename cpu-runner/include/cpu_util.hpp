@@ -179,6 +179,13 @@ void SaveDec(const string& save_name, const T* data, uint64_t size,
 void SaveBin(const string& save_name, const char* data, uint64_t size,
              int mode = SM_TRUNC);
 
+// compare data with the contents of a file, which is read in chunks of
+// chunk_size bytes instead of loading it in full. returns the byte offset of
+// the first difference, or min(size, file size) if one is a prefix of the
+// other, i.e. size if they are the same.
+uint64_t CompareBin(const string& golden_name, const char* data,
+                    uint64_t size, uint64_t chunk_size = 1U << 20);
+
 // misc
 template <typename T>
 T Random(T low, T high) {
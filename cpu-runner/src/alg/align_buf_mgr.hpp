@@ -21,6 +21,7 @@
 #include "cpu_std_inc.hpp"
 #include "pair_hash.hpp"
 #include "spin_lock.hpp"
+#include "vart/host_memory.hpp"
 
 namespace vart {
 namespace cpu {
@@ -28,8 +29,18 @@ namespace cpu {
 class AlignBuf {
 public:
   AlignBuf(uint64_t size, uint64_t align)
-    : size_(size), align_(align), space_(align + size) {
-
+    : size_(size), align_(align), space_(align + size), raw_ptr_(nullptr) {
+
+    // temporary buffers are first touched by the op which allocates them
+    // anyway, only go through the host memory policy when hugepages or a
+    // node binding is asked for, see vart/host_memory.hpp
+    auto policy = vart::get_host_memory_policy();
+    if (policy.numa != vart::host_memory_policy_t::numa_t::FIRST_TOUCH ||
+        policy.page != vart::host_memory_policy_t::page_t::NORMAL) {
+      memory_ = vart::HostMemory::allocate(size_, policy, align_);
+      align_ptr_ = memory_->data();
+      return;
+    }
     raw_ptr_ = new char [align_ + size_];
     align_ptr_ = raw_ptr_;
     std::align(align_, size_, align_ptr_, space_);
@@ -51,6 +62,7 @@ private:
   size_t space_;
   char* raw_ptr_;
   void* align_ptr_;
+  unique_ptr<vart::HostMemory> memory_;
 
   class AlignBufMgr;
   friend class AlignBufMgr;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_dump_writer.hpp"
+
+#include "vitis/ai/env_config.hpp"
+
+// memory the queued dumps may take, in MB
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_DUMP_QUEUE_MB, "256")
+// compare every dump with the file of the same name in this folder
+DEF_ENV_PARAM_2(XLNX_CPU_RUNNER_GOLDEN_PATH, "", std::string)
+// stop comparing at the first dump which is different from its golden file,
+// the runner fails
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_GOLDEN_STOP, "0")
+
+namespace vart {
+namespace cpu {
+
+static thread_local const void* g_owner = nullptr;
+
+static const string FIX_SUFFIX = ".fix.bin";
+
+static bool is_fix_dump(const string& name) {
+  return name.size() > FIX_SUFFIX.size() &&
+         name.compare(name.size() - FIX_SUFFIX.size(), FIX_SUFFIX.size(),
+                      FIX_SUFFIX) == 0;
+}
+
+// <tensor>.fix.bin -> <tensor>.bin
+static string fix_to_float(const string& name) {
+  return name.substr(0, name.size() - FIX_SUFFIX.size()) + ".bin";
+}
+
+DumpWriter::DumpWriter()
+    : queue_limit_(uint64_t(ENV_PARAM(XLNX_CPU_RUNNER_DUMP_QUEUE_MB)) << 20) {
+  set_golden_path(ENV_PARAM(XLNX_CPU_RUNNER_GOLDEN_PATH));
+  thread_ = std::thread([this]() { write_loop(); });
+}
+
+DumpWriter::~DumpWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void DumpWriter::set_owner(const void* owner) { g_owner = owner; }
+
+void DumpWriter::save(const string& save_name, const char* data,
+                      uint64_t size, int mode, uint32_t ele_bits) {
+  auto dump = dump_t{save_name, vector<char>(data, data + size), mode,
+                     std::max(ele_bits, 1U), g_owner, true};
+  std::unique_lock<std::mutex> lock(mtx_);
+  // a dump larger than the limit is queued once the queue is empty
+  cv_.wait(lock, [this, size]() {
+    return queue_bytes_ == 0 || queue_bytes_ + size <= queue_limit_;
+  });
+  queue_bytes_ += size;
+  auto& owner = owners_[g_owner];
+  owner.num_of_pending++;
+  // a fix op saves <tensor>.fix.bin and then its float <tensor>.bin, both
+  // would be compared with the golden <tensor>.bin
+  dump.compare = save_name != owner.fix_sibling;
+  owner.fix_sibling = is_fix_dump(save_name) ? fix_to_float(save_name) : "";
+  queue_.emplace_back(std::move(dump));
+  cv_.notify_all();
+}
+
+DumpWriter::flush_result_t DumpWriter::flush() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto owner = g_owner;
+  cv_.wait(lock, [this, owner]() {
+    auto it = owners_.find(owner);
+    return it == owners_.end() || it->second.num_of_pending == 0;
+  });
+  auto it = owners_.find(owner);
+  if (it == owners_.end()) {
+    return flush_result_t{};
+  }
+  auto ret = it->second.result;
+  owners_.erase(it);
+  return ret;
+}
+
+void DumpWriter::set_golden_path(const string& golden_path) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  golden_path_ = golden_path;
+  if (!golden_path_.empty() && golden_path_.back() != '/') {
+    golden_path_ += "/";
+  }
+}
+
+void DumpWriter::set_queue_limit(uint64_t queue_limit) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  queue_limit_ = queue_limit;
+}
+
+void DumpWriter::write_loop() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  for (;;) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    auto dump = std::move(queue_.front());
+    queue_.pop_front();
+    auto golden_path = owners_[dump.owner].result.stopped || !dump.compare
+                           ? string()
+                           : golden_path_;
+    lock.unlock();
+
+    auto result = compare(dump, golden_path);
+    SaveBin(dump.save_name, dump.data.data(), dump.data.size(), dump.mode);
+
+    lock.lock();
+    queue_bytes_ -= dump.data.size();
+    auto& owner = owners_[dump.owner];
+    owner.num_of_pending--;
+    if (result == DIFF) {
+      owner.result.num_of_diffs++;
+      owner.result.stopped = ENV_PARAM(XLNX_CPU_RUNNER_GOLDEN_STOP) != 0;
+    } else if (result == NO_GOLDEN) {
+      owner.result.num_of_missing++;
+    }
+    cv_.notify_all();
+  }
+}
+
+DumpWriter::compare_result_t DumpWriter::compare(const dump_t& dump,
+                                                 const string& golden_path) {
+  // appended files, i.e. diff.sh, have no golden
+  if (golden_path.empty() || dump.mode != SM_TRUNC) {
+    return SAME;
+  }
+  auto pos = dump.save_name.rfind('/');
+  auto name = dump.save_name.substr(pos == string::npos ? 0 : pos + 1);
+  // the dump of a fix op is compared with the golden of its tensor
+  if (is_fix_dump(name)) {
+    name = fix_to_float(name);
+  }
+  auto golden_name = golden_path + name;
+  if (!ChkFile(golden_name)) {
+    return NO_GOLDEN;
+  }
+
+  auto size = dump.data.size();
+  auto golden_size = GetFileSize(golden_name);
+  auto diff = CompareBin(golden_name, dump.data.data(), size);
+  if (diff == size && golden_size == size) {
+    return SAME;
+  }
+  if (diff == std::min(size, golden_size)) {
+    UNI_LOG_WARNING << "The size of " << dump.save_name << " (" << size
+                    << ") not match " << golden_name << " (" << golden_size
+                    << ")";
+  } else {
+    UNI_LOG_WARNING << dump.save_name << " is diff from " << golden_name
+                    << " at element " << diff * 8 / dump.ele_bits
+                    << " (byte " << diff << ")";
+  }
+  return DIFF;
+}
+
+}  // namespace cpu
+}  // namespace vart
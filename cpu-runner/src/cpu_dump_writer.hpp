@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+
+#include "cpu_std_inc.hpp"
+#include "cpu_util.hpp"
+
+namespace vart {
+namespace cpu {
+
+// Writes the debug dumps of the ops on a background thread, so that the ops
+// do not wait for the disk. The data is copied into a queue, which holds at
+// most XLNX_CPU_RUNNER_DUMP_QUEUE_MB, save() blocks while it is full. Files
+// are written in the order they are saved, appending to a file is safe.
+//
+// If XLNX_CPU_RUNNER_GOLDEN_PATH is set, every dump is compared with the
+// file of the same name in it, see CompareBin(), before it is written. The
+// golden of <tensor>.fix.bin is <tensor>.bin, as in diff.sh, so the float
+// <tensor>.bin saved right after it by a fix op is not compared. The first
+// different element of a dump is reported. If XLNX_CPU_RUNNER_GOLDEN_STOP
+// is set, the following dumps of the owner are not compared and flush()
+// reports the stop. Dumps without a golden file are counted.
+//
+// Dumps belong to the owner of the thread saving them, see set_owner(), so
+// that runners running at the same time only wait for and count their own.
+class DumpWriter {
+ private:
+  DumpWriter();
+  ~DumpWriter();
+  DumpWriter(const DumpWriter&) = delete;
+  DumpWriter& operator=(const DumpWriter&) = delete;
+
+ public:
+  static DumpWriter& Instance() {
+    static DumpWriter writer;
+    return writer;
+  }
+
+ public:
+  // the dumps saved by the calling thread from now on belong to owner, e.g.
+  // the runner whose ops the thread runs. it is nullptr by default.
+  static void set_owner(const void* owner);
+
+  // ele_bits is the size of an element in the file, to report the index of
+  // the first different element
+  void save(const string& save_name, const char* data, uint64_t size,
+            int mode = SM_TRUNC, uint32_t ele_bits = 8);
+  struct flush_result_t {
+    // dumps different from their golden files
+    uint64_t num_of_diffs{0};
+    // dumps without a golden file
+    uint64_t num_of_missing{0};
+    // a dump is different and XLNX_CPU_RUNNER_GOLDEN_STOP is set
+    bool stopped{false};
+  };
+  // wait until every dump saved so far by the owner of the calling thread is
+  // written, returns what the golden compare found in them
+  flush_result_t flush();
+
+  // override XLNX_CPU_RUNNER_GOLDEN_PATH and XLNX_CPU_RUNNER_DUMP_QUEUE_MB
+  void set_golden_path(const string& golden_path);
+  void set_queue_limit(uint64_t queue_limit);
+
+ private:
+  struct dump_t {
+    string save_name;
+    vector<char> data;
+    int mode;
+    uint32_t ele_bits;
+    const void* owner;
+    bool compare;
+  };
+  struct owner_stat_t {
+    // saved but not written yet, including the dump being written
+    uint64_t num_of_pending{0};
+    flush_result_t result;
+    // the float dump of the last <tensor>.fix.bin, i.e. <tensor>.bin
+    string fix_sibling;
+  };
+  enum compare_result_t { SAME, DIFF, NO_GOLDEN };
+  void write_loop();
+  compare_result_t compare(const dump_t& dump, const string& golden_path);
+
+ private:
+  uint64_t queue_limit_;
+  string golden_path_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  deque<dump_t> queue_;
+  uint64_t queue_bytes_{0};
+  // an owner is removed when it is flushed
+  std::map<const void*, owner_stat_t> owners_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_parallel.hpp"
+
+#include "vitis/ai/thread_pool.hpp"
+
+namespace vart {
+namespace cpu {
+
+std::uint32_t get_parallel_thread_num() {
+  if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+      CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+    return std::max(CPU_NUM, 1L);
+  }
+  return 1U;
+}
+
+// the pool is re-created when CPU_NUM changes, ops which are running keep the
+// old one alive through their shared_ptr
+static std::shared_ptr<vitis::ai::ThreadPool> get_thread_pool(
+    std::uint32_t thread_num) {
+  static std::mutex mtx;
+  static std::shared_ptr<vitis::ai::ThreadPool> pool;
+  static std::uint32_t pool_size = 0U;
+  std::lock_guard<std::mutex> lock(mtx);
+  if (pool == nullptr || pool_size != thread_num - 1) {
+    pool_size = thread_num - 1;
+    pool = vitis::ai::ThreadPool::create(pool_size);
+  }
+  return pool;
+}
+
+static thread_local bool in_parallel_for = false;
+
+void parallel_for_impl(
+    std::uint32_t total, std::uint32_t grain,
+    const std::function<void(std::uint32_t, std::uint32_t)>& func) {
+  grain = std::max(grain, 1U);
+  auto grain_num = (total + grain - 1) / grain;
+  auto thread_num = std::min(get_parallel_thread_num(), grain_num);
+  if (thread_num <= 1 || in_parallel_for) {
+    if (total > 0) {
+      func(0, total);
+    }
+    return;
+  }
+
+  auto workload = (grain_num + thread_num - 1) / thread_num * grain;
+  auto pool = get_thread_pool(get_parallel_thread_num());
+  auto run = [&func, total, workload](std::uint32_t start) {
+    in_parallel_for = true;
+    func(start, std::min(start + workload, total));
+    in_parallel_for = false;
+  };
+
+  vector<std::future<void>> futs;
+  for (auto start = workload; start < total; start += workload) {
+    futs.emplace_back(pool->async(run, start));
+  }
+  run(0U);
+  for (auto& fut : futs) {
+    fut.get();
+  }
+}
+
+BroadcastIter::BroadcastIter(const Dimension& out, const Dimension& in)
+    : ndims_(out.ndims()),
+      out_dims_(out.vdims()),
+      in_dims_(ndims_, 1),
+      strides_(ndims_, 0),
+      out_coord_(ndims_, 0),
+      in_coord_(ndims_, 0) {
+  auto delta = std::max(out.ndims() - in.ndims(), 0);
+  for (auto d = delta; d < ndims_; d++) {
+    in_dims_[d] = in.dim(d - delta);
+    strides_[d] = in.cod(d - delta);
+  }
+}
+
+void BroadcastIter::seek(std::uint32_t pos) {
+  offset_ = 0U;
+  for (auto d = ndims_ - 1; d >= 0; d--) {
+    out_coord_[d] = pos % out_dims_[d];
+    pos /= out_dims_[d];
+    in_coord_[d] = out_coord_[d] % in_dims_[d];
+    offset_ += in_coord_[d] * strides_[d];
+  }
+}
+
+}  // namespace cpu
+}  // namespace vart
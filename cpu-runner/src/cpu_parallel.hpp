@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "cpu_base_inc.hpp"
+
+namespace vart {
+namespace cpu {
+
+// grain of parallel_for() for ops which do a few operations per element
+constexpr std::uint32_t ELEMENTWISE_GRAIN = 1024U;
+
+// number of threads parallel_for() splits work among, CPU_NUM in the
+// NORMAL_THREAD and GEMM_THREAD run modes, 1 otherwise.
+std::uint32_t get_parallel_thread_num();
+
+void parallel_for_impl(
+    std::uint32_t total, std::uint32_t grain,
+    const std::function<void(std::uint32_t, std::uint32_t)>& func);
+
+// Split [0, total) into one contiguous range per thread, every range but the
+// last one is a multiple of grain, and call func(start, end) on each range.
+// The calling thread takes the first range, the others run on a thread pool
+// which is shared by all ops. Work smaller than two grains and nested calls
+// run on the calling thread.
+//
+// The partition only depends on total, grain and the thread number, so an op
+// whose elements are independent gets the same result with any thread number.
+template <typename Func>
+void parallel_for(std::uint32_t total, std::uint32_t grain, Func&& func) {
+  parallel_for_impl(total, grain, std::forward<Func>(func));
+}
+
+// Walks the elements an elementwise op reads from one of its inputs, in the
+// order of the output. For every output dim the input coordinate is
+// output coordinate % input dim, dims missing in the input are broadcast.
+// The input offset is updated incrementally instead of converting every
+// output position to a coordinate and back.
+class BroadcastIter {
+ public:
+  BroadcastIter(const Dimension& out, const Dimension& in);
+
+  // move to output position pos
+  void seek(std::uint32_t pos);
+  // move to the next output position
+  inline void next() {
+    for (auto d = ndims_ - 1; d >= 0; d--) {
+      offset_ += strides_[d];
+      if (++in_coord_[d] == in_dims_[d]) {
+        in_coord_[d] = 0;
+        offset_ -= in_dims_[d] * strides_[d];
+      }
+      if (++out_coord_[d] < out_dims_[d]) {
+        return;
+      }
+      out_coord_[d] = 0;
+      offset_ -= in_coord_[d] * strides_[d];
+      in_coord_[d] = 0;
+    }
+  }
+  inline std::uint32_t offset() const { return offset_; }
+
+  static inline void next(vector<BroadcastIter>& iters) {
+    for (auto& iter : iters) {
+      iter.next();
+    }
+  }
+
+ private:
+  int ndims_;
+  vector<int> out_dims_;
+  vector<int> in_dims_;
+  vector<int> strides_;
+  vector<int> out_coord_;
+  vector<int> in_coord_;
+  std::uint32_t offset_{0};
+};
+
+}  // namespace cpu
+}  // namespace vart
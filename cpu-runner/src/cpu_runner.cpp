@@ -18,19 +18,27 @@
 #include "cpu_runner.hpp"
 
 #include "check_param_visitor.hpp"
+#include "cpu_dump_writer.hpp"
 #include "cpu_op_base.hpp"
 #include "cpu_reg_func.hpp"
 #include "cpu_tb_factory.hpp"
 #include "cpu_tensor_buffer.hpp"
+#include "fused_op.hpp"
 #include "op_schedule.hpp"
 #include "oplist_visitor.hpp"
 #include "print_param_visitor.hpp"
 #include "read_visitor.hpp"
 #include "run_visitor.hpp"
 #include "save_visitor.hpp"
+#include "vart/xir_helper.hpp"
 #include "vitis/ai/plugin.hpp"
 #include "workload_visitor.hpp"
 
+// fuse elementwise op chains, e.g. conv2d-fix + eltwise-fix + fix, so that
+// they run tile by tile, set it to 0 to run every op on its own. the runner
+// attr "cpu_runner_fusion" overrides it.
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_FUSION, "1")
+
 namespace vart {
 namespace cpu {
 
@@ -88,6 +96,9 @@ CPURunner::CPURunner(const xir::Subgraph* subgraph, const xir::Attrs* attrs)
 
   // build all op's tbs and inference ops
   create_ops_and_tbs();
+  fuse_ops(attrs != nullptr && attrs->has_attr("cpu_runner_fusion")
+               ? attrs->get_attr<bool>("cpu_runner_fusion")
+               : bool(ENV_PARAM(XLNX_CPU_RUNNER_FUSION)));
 }
 
 CPURunner::~CPURunner() = default;
@@ -98,12 +109,6 @@ std::pair<uint32_t, int> CPURunner::execute_async(
   set_subg_input_tbs(subg_input_tbs);
   set_subg_output_tbs(subg_output_tbs);
 
-  auto debug_path = CPUCfg::Instance().get_debug_path();
-  ChkFolder(debug_path);
-  SaveBin(debug_path + CPUOPBase::SUBG_DIFF_SCRIPT,
-          CPUOPBase::SUBG_DIFF_SCRIPT_HEADER.data(),
-          CPUOPBase::SUBG_DIFF_SCRIPT_HEADER.size(), SM_TRUNC);
-
   fut_ = async(std::launch::async, &CPURunner::run, this);
 
   static int jobid = 0;
@@ -125,7 +130,7 @@ int CPURunner::wait(int jobid, int ms) {
     UNI_LOG_ERROR(VART_EXEC_ERROR) << "Executing deferred!" << endl;
     abort();
   }
-  return 0;
+  return fut_.get();
 }
 
 std::vector<const xir::Tensor*> CPURunner::get_input_tensors() {
@@ -144,12 +149,25 @@ std::vector<const xir::Tensor*> CPURunner::get_output_tensors() {
   return outputs;
 }
 
-void CPURunner::run() {
+int CPURunner::run() {
   if (VART_DEBUG) {
     UNI_LOG_DEBUG_INFO << "CPURunner begin to run ..." << endl;
     PRINT_DIVIDING_LINE();
   }
 
+  // the ops save their dumps on this thread, they are flushed below
+  DumpWriter::set_owner(this);
+  // diff.sh is only written by debug runs which save the outputs of the ops,
+  // the ops append to it after the header
+  if (VART_DEBUG && CPUCfg::Instance().get_save_bin()) {
+    auto debug_path = CPUCfg::Instance().get_debug_path();
+    ChkFolder(debug_path);
+    DumpWriter::Instance().save(debug_path + CPUOPBase::SUBG_DIFF_SCRIPT,
+                                CPUOPBase::SUBG_DIFF_SCRIPT_HEADER.data(),
+                                CPUOPBase::SUBG_DIFF_SCRIPT_HEADER.size(),
+                                SM_TRUNC);
+  }
+
   // You can install supported visitors in vis folder,
   // each visitor can do special work, of course you
   // can extend your own visitor.
@@ -168,9 +186,31 @@ void CPURunner::run() {
     set_subg_output_data();
   } else {
     set_subg_input_data();
-    s->install(RunVisitor::make());
+    // elementwise op chains run fused, see fuse_ops()
+    make_unique<OPSchedule>(run_ops_)->install(RunVisitor::make());
     set_subg_output_data();
   }
+
+  // the dumps are written in the background, they are complete when the job
+  // is done. other runners may still be saving theirs.
+  if (VART_DEBUG) {
+    auto result = DumpWriter::Instance().flush();
+    if (result.num_of_missing > 0 && !no_golden_reported_) {
+      no_golden_reported_ = true;
+      UNI_LOG_INFO << result.num_of_missing << " dumps of subgraph "
+                   << subg_->get_name() << " have no golden";
+    }
+    if (result.num_of_diffs > 0) {
+      UNI_LOG_WARNING << result.num_of_diffs << " dumps of subgraph "
+                      << subg_->get_name() << " are diff from golden";
+    }
+    if (result.stopped) {
+      UNI_LOG_ERROR(VART_EXEC_ERROR)
+          << "stop at the first diff, XLNX_CPU_RUNNER_GOLDEN_STOP is set";
+      return -1;
+    }
+  }
+  return 0;
 }
 
 std::vector<TensorBuffer*> CPURunner::get_input_tbs() {
@@ -300,6 +340,61 @@ void CPURunner::create_ops_and_tbs() {
   }
 }
 
+// next can join the chain ending with prev if it is elementwise, consumes
+// prev's output and reads every op of the chain at its own positions, i.e.
+// without broadcast. the head op of the chain is complete before the chain
+// runs, so next can read it in any way.
+static bool can_fuse(const vector<CPUOPBase*>& chain, CPUOPBase* next) {
+  if (!next->is_elementwise()) {
+    return false;
+  }
+  auto* prev_op = chain.back()->get_xir_op();
+  auto output_shape = next->get_xir_tensor()->get_shape();
+  auto consume_prev = false;
+  for (auto* input_op : vec_input_ops(next->get_xir_op()->get_input_ops())) {
+    consume_prev |= (input_op == prev_op);
+    auto in_chain =
+        std::find_if(chain.begin() + 1, chain.end(), [=](CPUOPBase* op) {
+          return op->get_xir_op() == input_op;
+        }) != chain.end();
+    if (in_chain &&
+        input_op->get_output_tensor()->get_shape() != output_shape) {
+      return false;
+    }
+  }
+  return consume_prev;
+}
+
+void CPURunner::fuse_ops(bool enable) {
+  if (!enable) {
+    run_ops_ = cpu_ops_;
+    return;
+  }
+
+  // cpu_ops_ is in topological order, only adjacent ops are fused so that
+  // all other inputs of the chain are ready before the fused op runs
+  for (auto i = 0U; i < cpu_ops_.size();) {
+    vector<CPUOPBase*> chain = {cpu_ops_[i++]};
+    while (i < cpu_ops_.size() && can_fuse(chain, cpu_ops_[i])) {
+      chain.push_back(cpu_ops_[i++]);
+    }
+    if (chain.size() == 1) {
+      run_ops_.push_back(chain.front());
+      continue;
+    }
+
+    auto* head = chain.front();
+    chain.erase(chain.begin());
+    fused_ops_.emplace_back(std::make_unique<FusedOP>(head, chain));
+    run_ops_.push_back(fused_ops_.back().get());
+    if (VART_DEBUG) {
+      UNI_LOG_DEBUG_INFO << "fuse " << head->get_name() << "("
+                         << head->get_type() << ") with " << chain.size()
+                         << " elementwise ops" << endl;
+    }
+  }
+}
+
 string CPURunner::get_name() const { return subg_->get_name(); }
 
 string CPURunner::get_device() const {
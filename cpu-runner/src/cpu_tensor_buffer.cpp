@@ -17,6 +17,7 @@
 
 #include "cpu_tensor_buffer.hpp"
 
+#include "cpu_dump_writer.hpp"
 #include "cpu_op_base.hpp"
 #include "vart/mm/host_flat_tensor_buffer.hpp"
 #include "vart/util_4bit.hpp"
@@ -349,8 +350,9 @@ void CPUTensorBuffer::save_bin() {
       // for auto diff using following bash script
       auto diff_phrase = "diff ./" + tensor_name + ".fix.bin ${GOLDEN_PATH}/" +
                          tensor_name + ".bin\n";
-      SaveBin(debug_path + CPUOPBase::SUBG_DIFF_SCRIPT,
-              (char*)diff_phrase.data(), diff_phrase.size(), SM_APPEND);
+      DumpWriter::Instance().save(debug_path + CPUOPBase::SUBG_DIFF_SCRIPT,
+                                  diff_phrase.data(), diff_phrase.size(),
+                                  SM_APPEND);
     }
   }
 
@@ -426,7 +428,8 @@ void CPUTensorBuffer::internal_save_txt(const string& fname) {
 void CPUTensorBuffer::internal_save_float_bin(const string& fname) {
   if (dtype_ != xir::DataType::FLOAT) return;
 
-  SaveBin(fname, data_ptr_, get_data_size());
+  DumpWriter::Instance().save(fname, data_ptr_, get_data_size(), SM_TRUNC,
+                              bit_width_);
 }
 
 void CPUTensorBuffer::internal_save_bfloat16_bin(const string& fname) {
@@ -436,7 +439,8 @@ void CPUTensorBuffer::internal_save_bfloat16_bin(const string& fname) {
   for (uint32_t i = 0; i < data_num_; i++) {
     save_buf.data()[i] = static_cast<uint16_t>(p[i]>>16);
   }
-  SaveBin(fname, (const char*)save_buf.data(), save_buf.size() * 2);
+  DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                              save_buf.size() * 2, SM_TRUNC, 16);
 }
 
 void CPUTensorBuffer::internal_save_4bit_bin(const string& fname) {
@@ -447,12 +451,14 @@ void CPUTensorBuffer::internal_save_4bit_bin(const string& fname) {
     vector<int8_t> save_buf(std::ceil(data_num_ / 2.0));
     dt_2_signed4bit<int32_t>(p, save_buf.data(), data_num_,
                              tensor_->get_shape(), get_stride(tensor_, true));
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size());
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size(), SM_TRUNC, 4);
   } else {
     vector<uint8_t> save_buf(std::ceil(data_num_ / 2.0));
     dt_2_unsigned4bit<int32_t>(p, save_buf.data(), data_num_,
                                tensor_->get_shape(), get_stride(tensor_, true));
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size());
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size(), SM_TRUNC, 4);
   }
 }
 
@@ -463,11 +469,13 @@ void CPUTensorBuffer::internal_save_8bit_bin(const string& fname) {
   if (if_signed_) {
     vector<int8_t> save_buf(data_num_);
     dta_2_dtb<int32_t, int8_t>(p, save_buf.data(), data_num_);
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size());
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size(), SM_TRUNC, 8);
   } else {
     vector<uint8_t> save_buf(data_num_);
     dta_2_dtb<int32_t, uint8_t>(p, save_buf.data(), data_num_);
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size());
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size(), SM_TRUNC, 8);
   }
 }
 
@@ -478,18 +486,21 @@ void CPUTensorBuffer::internal_save_16bit_bin(const string& fname) {
   if (if_signed_) {
     vector<int16_t> save_buf(data_num_);
     dta_2_dtb<int32_t, int16_t>(p, save_buf.data(), data_num_);
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size() * 2);
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size() * 2, SM_TRUNC, 16);
   } else {
     vector<uint16_t> save_buf(data_num_);
     dta_2_dtb<int32_t, uint16_t>(p, save_buf.data(), data_num_);
-    SaveBin(fname, (const char*)save_buf.data(), save_buf.size() * 2);
+    DumpWriter::Instance().save(fname, (const char*)save_buf.data(),
+                                save_buf.size() * 2, SM_TRUNC, 16);
   }
 }
 
 void CPUTensorBuffer::internal_save_32bit_bin(const string& fname) {
   if (bit_width_ != 32) return;
 
-  SaveBin(fname, data_ptr_, get_data_size());
+  DumpWriter::Instance().save(fname, data_ptr_, get_data_size(), SM_TRUNC,
+                              32);
 }
 
 void CPUTensorBuffer::internal_save_64bit_bin(const string& fname) {
@@ -498,8 +509,9 @@ void CPUTensorBuffer::internal_save_64bit_bin(const string& fname) {
   for (unsigned i = 0; i < get_data_num(); i++)
     d.push_back(static_cast<int64_t>(((int32_t*)data_ptr_)[i]));
 
-  SaveBin(fname, (const char*)d.data(),
-          d.size() * sizeof(int64_t) / sizeof(char));
+  DumpWriter::Instance().save(fname, (const char*)d.data(),
+                              d.size() * sizeof(int64_t) / sizeof(char),
+                              SM_TRUNC, 64);
 }
 
 void CPUTensorBuffer::internal_save_float_txt(const string& fname) {
@@ -534,8 +546,9 @@ void CPUTensorBuffer::internal_save_fix_bin(const string& fname) {
     vector<int8_t> save_buf(fix_data_num_);
     if (save_weights_fmt == WeightsFmt::OC_KH_KW_IC) {
       dta_2_dtb<int32_t, int8_t>(fix_data_ptr_, save_buf.data(), fix_data_num_);
-      SaveBin(fname + ".ohwi.bin", (const char*)save_buf.data(),
-              save_buf.size());
+      DumpWriter::Instance().save(fname + ".ohwi.bin",
+                                  (const char*)save_buf.data(),
+                                  save_buf.size());
     } else {
       abort();
     }
@@ -546,12 +559,16 @@ void CPUTensorBuffer::internal_save_fix_bin(const string& fname) {
         dt_2_signed4bit<int32_t>(fix_data_ptr_, save_buf.data(), fix_data_num_,
                                  tensor_->get_shape(),
                                  get_stride(tensor_, true));
-        SaveBin(fname + ".bin", (const char*)save_buf.data(), save_buf.size());
+        DumpWriter::Instance().save(fname + ".bin",
+                                    (const char*)save_buf.data(),
+                                    save_buf.size(), SM_TRUNC, 4);
       } else {
         vector<int8_t> save_buf(fix_data_num_);
         dta_2_dtb<int32_t, int8_t>(fix_data_ptr_, save_buf.data(),
                                    fix_data_num_);
-        SaveBin(fname + ".bin", (const char*)save_buf.data(), save_buf.size());
+        DumpWriter::Instance().save(fname + ".bin",
+                                    (const char*)save_buf.data(),
+                                    save_buf.size(), SM_TRUNC, 8);
       }
     } else {
       if (xir_op_->get_attr<int>("bit_width") == 4) {
@@ -559,12 +576,16 @@ void CPUTensorBuffer::internal_save_fix_bin(const string& fname) {
         dt_2_unsigned4bit<int32_t>(fix_data_ptr_, save_buf.data(),
                                    fix_data_num_, tensor_->get_shape(),
                                    get_stride(tensor_, true));
-        SaveBin(fname + ".bin", (const char*)save_buf.data(), save_buf.size());
+        DumpWriter::Instance().save(fname + ".bin",
+                                    (const char*)save_buf.data(),
+                                    save_buf.size(), SM_TRUNC, 4);
       } else {
         vector<uint8_t> save_buf(fix_data_num_);
         dta_2_dtb<int32_t, uint8_t>(fix_data_ptr_, save_buf.data(),
                                     fix_data_num_);
-        SaveBin(fname + ".bin", (const char*)save_buf.data(), save_buf.size());
+        DumpWriter::Instance().save(fname + ".bin",
+                                    (const char*)save_buf.data(),
+                                    save_buf.size(), SM_TRUNC, 8);
       }
     }
   }
@@ -17,6 +17,7 @@
 
 #include "cpu_util.hpp"
 
+#include <cstring>
 #include <filesystem>
 #include <system_error>
 
@@ -130,6 +131,31 @@ uint64_t LoadBin(const string& load_name, char* data, uint64_t size) {
 
   return fsize;
 }
+uint64_t CompareBin(const string& golden_name, const char* data,
+                    uint64_t size, uint64_t chunk_size) {
+  auto fsize = GetFileSize(golden_name);
+  std::ifstream f(golden_name, std::ios_base::in | std::ios_base::binary);
+  ChkOpen(f, golden_name);
+
+  auto total = std::min(size, fsize);
+  vector<char> chunk(std::min(std::max(chunk_size, uint64_t(1)), total));
+  uint64_t pos = 0;
+  while (pos < total) {
+    auto n = std::min(uint64_t(chunk.size()), total - pos);
+    f.read(chunk.data(), n);
+    UNI_LOG_CHECK(uint64_t(f.gcount()) == n, VART_FILE_ERROR)
+        << "read " << golden_name << " error at " << pos;
+    // memcmp is vectorized, the difference is only searched in a chunk which
+    // has one
+    if (memcmp(chunk.data(), data + pos, n) != 0) {
+      auto diff = std::mismatch(chunk.begin(), chunk.begin() + n, data + pos);
+      return pos + (diff.first - chunk.begin());
+    }
+    pos += n;
+  }
+  return total;
+}
+
 #ifdef _WIN32
 void replaceAll(std::string& str, const std::string& oldSubstr,
                 const std::string& newSubstr) {
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fused_op.hpp"
+
+#include "cpu_parallel.hpp"
+#include "vitis/ai/env_config.hpp"
+
+// number of elements every op of the chain computes before the next op of
+// the chain takes over, the outputs of a tile should fit in L2 cache.
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_FUSION_TILE_SIZE, "4096")
+
+namespace vart {
+namespace cpu {
+
+FusedOP::FusedOP(CPUOPBase* head, const vector<CPUOPBase*>& chain)
+    : CPUOPBase(head->get_xir_subg(), head->get_xir_op(), {}, nullptr),
+      head_(head),
+      chain_(chain) {
+  UNI_LOG_CHECK(!chain_.empty(), VART_SIZE_ERROR);
+  FMAP_SIZE = chain_.front()->get_xir_tensor()->get_element_num();
+  for (auto* op : chain_) {
+    UNI_LOG_CHECK(op->is_elementwise(), VART_INVALID_VALUE)
+        << ", " << op->get_name() << "(" << op->get_type()
+        << ") is not elementwise";
+    UNI_LOG_CHECK((std::uint32_t)op->get_xir_tensor()->get_element_num() ==
+                      FMAP_SIZE,
+                  VART_SIZE_ERROR)
+        << ", " << op->get_name() << " "
+        << op->get_xir_tensor()->get_element_num() << " != " << FMAP_SIZE;
+  }
+  TILE_SIZE = std::max(ENV_PARAM(XLNX_CPU_RUNNER_FUSION_TILE_SIZE), 1);
+}
+
+void FusedOP::run() {
+  head_->run();
+
+  // whole tiles per thread, so the tiling is the same as in the NORMAL mode
+  parallel_for(FMAP_SIZE, TILE_SIZE,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 run_chain(start_index, end_index);
+               });
+}
+
+void FusedOP::run_chain(std::uint32_t start_index, std::uint32_t end_index) {
+  for (auto start = start_index; start < end_index; start += TILE_SIZE) {
+    auto end = std::min(start + TILE_SIZE, end_index);
+    for (auto* op : chain_) {
+      op->run_range(start, end);
+    }
+  }
+}
+
+void FusedOP::print_param() {
+  head_->print_param();
+  for (auto* op : chain_) {
+    UNI_LOG_DEBUG_INFO << "fused " << op->get_name() << "(" << op->get_type()
+                       << ")" << endl;
+    op->print_param();
+  }
+  UNI_LOG_DEBUG_INFO << "FMAP_SIZE = " << FMAP_SIZE << endl;
+  UNI_LOG_DEBUG_INFO << "TILE_SIZE = " << TILE_SIZE << endl;
+}
+
+void FusedOP::check_param() {
+  head_->check_param();
+  for (auto* op : chain_) {
+    op->check_param();
+  }
+}
+
+// read() of the fusable ops only resolves their buffers (EltwiseFix also
+// copies its first input, which only L2NORM uses), so the chain can be read
+// before the head op runs
+void FusedOP::read() {
+  head_->read();
+  for (auto* op : chain_) {
+    op->read();
+  }
+}
+
+void FusedOP::save() {
+  head_->save();
+  for (auto* op : chain_) {
+    op->save();
+  }
+}
+
+uint64_t FusedOP::get_workload() {
+  auto workload = head_->get_workload();
+  for (auto* op : chain_) {
+    workload += op->get_workload();
+  }
+  return workload;
+}
+
+}  // namespace cpu
+}  // namespace vart
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "cpu_op_base.hpp"
+
+namespace vart {
+namespace cpu {
+
+// A head op followed by a chain of elementwise ops, every op of the chain
+// consumes the output of the op before it. The head op runs as usual, then
+// the chain runs tile by tile, so the output of an op is still in cache when
+// the next op of the chain reads it.
+//
+// Every op keeps its own output buffer and computes each element with its own
+// code, so outputs and dumps are bit-exact with the unfused run.
+class FusedOP : public CPUOPBase {
+ public:
+  explicit FusedOP(CPUOPBase* head, const vector<CPUOPBase*>& chain);
+  virtual ~FusedOP() = default;
+  VART_DISABLE_COPY_AND_ASSIGN(FusedOP);
+
+ public:
+  virtual void run() override final;
+
+  virtual void print_param() override final;
+  virtual void check_param() override final;
+
+  virtual void read() override final;
+  virtual void save() override final;
+
+  virtual uint64_t get_workload() override final;
+
+ private:
+  void run_chain(std::uint32_t start_index, std::uint32_t end_index);
+
+ private:
+  CPUOPBase* head_;
+  vector<CPUOPBase*> chain_;
+
+  std::uint32_t FMAP_SIZE;
+  std::uint32_t TILE_SIZE;
+};
+
+}  // namespace cpu
+}  // namespace vart
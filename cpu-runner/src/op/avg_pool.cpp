@@ -81,30 +81,7 @@ void AvgPool<DType>::acc_pool_normal() {
 
 template <typename DType>
 void AvgPool<DType>::acc_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                acc_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  this->for_each_pos([this](int n, int h, int w) { acc_pool_one(n, h, w); });
 }
 
 template <typename DType>
@@ -142,14 +119,12 @@ void AvgPool<DType>::avg_pool() {
         << "Only support float data type in avgpool!" << endl;
     abort();
   }
-  avg_pool_normal();
-
-
-  // if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
-  //     CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
-  //   avg_pool_thread();
-  // } else {
-  // }
+  if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+      CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
+    avg_pool_thread();
+  } else {
+    avg_pool_normal();
+  }
 }
 
 template <typename DType>
@@ -165,30 +140,7 @@ void AvgPool<DType>::avg_pool_normal() {
 
 template <typename DType>
 void AvgPool<DType>::avg_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                avg_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  this->for_each_pos([this](int n, int h, int w) { avg_pool_one(n, h, w); });
 }
 
 template <typename DType>
@@ -111,22 +111,10 @@ void Add<DType>::add_normal() {
 
 template <typename DType>
 void Add<DType>::add_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(
-        std::launch::async,
-        [this](decltype(start_index) start_index,
-               decltype(end_index) end_index) { add(start_index, end_index); },
-        start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 add(start_index, end_index);
+               });
 }
 
 template <typename DType>
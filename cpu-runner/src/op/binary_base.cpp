@@ -68,23 +68,10 @@ void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::calculate_normal() {
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
 void BinaryBase<DTypeIn0, DTypeIn1, DTypeOut>::calculate_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(
-        std::launch::async,
-        [this](decltype(start_index) start_index, decltype(end_index) end_index,
-               decltype(no_broadcast_) no_broadcast_) {
-          calculate(start_index, end_index, no_broadcast_);
-        },
-        start_index, end_index, no_broadcast_);
-  }
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 calculate(start_index, end_index, no_broadcast_);
+               });
 }
 
 template <typename DTypeIn0, typename DTypeIn1, typename DTypeOut>
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "conv2d.hpp"
+#include "fix_kernel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -58,6 +59,11 @@ class Conv2dFix : public Conv2d<DType, WType> {
   DType data_min_;
   DType data_max_;
 
+  // selected in the constructor, see fix_kernel.hpp
+  fix_conv_acc_t<DType> fix_conv_acc_{nullptr};
+  fix_output_t<DType> fix_output_{nullptr};
+  FixOutputParam<DType> fix_output_param_;
+
   using ConvBase<DType, WType>::has_bias_;
   using ConvBase<DType, WType>::fmap_i_;
   using ConvBase<DType, WType>::fmap_w_;
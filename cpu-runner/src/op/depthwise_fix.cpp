@@ -19,6 +19,36 @@
 
 namespace vart {
 namespace cpu {
+namespace {
+// ADD sums x * 2^shift_read of the inputs, MUL multiplies them, the result
+// is scaled by 2^shift_write
+template <typename DType, bool MUL, bool BROADCAST>
+void depthwise_acc(const vector<DType*>& inputs,
+                   const vector<double>& read_scale, double write_scale,
+                   vector<BroadcastIter>& iters, std::uint32_t start,
+                   std::uint32_t num, double* acc) {
+  std::fill_n(acc, num, MUL ? 1.0 : 0.0);
+  for (auto i = 0U; i < inputs.size(); i++) {
+    auto* in = inputs[i];
+    auto scale = read_scale[i];
+    for (auto j = 0U; j < num; j++) {
+      auto pos = start + j;
+      if constexpr (BROADCAST) {
+        pos = iters[i].offset();
+        iters[i].next();
+      }
+      if constexpr (MUL) {
+        acc[j] *= in[pos];
+      } else {
+        acc[j] += in[pos] * scale;
+      }
+    }
+  }
+  for (auto j = 0U; j < num; j++) {
+    acc[j] *= write_scale;
+  }
+}
+}  // namespace
 
 template <typename DType>
 const vector<string> DepthwiseFix<DType>::ITName = {
@@ -69,6 +99,26 @@ DepthwiseFix<DType>::DepthwiseFix(const xir::Subgraph* subg, const xir::Op* op,
 
   THREAD_NUM = CPU_NUM;
   THREAD_WORKLOAD = ceil((float)fmap_o_.num() / THREAD_NUM);
+
+  if (dpt_type_ == "ADD" || dpt_type_ == "MUL") {
+    fix_output_ = select_fix_output<DType>(CPUOPBase::round_mode_,
+                                           FixNonlinear::NONE);
+  }
+  if (fix_output_ != nullptr) {
+    fix_output_param_ = make_fix_output_param<DType>(
+        CPUOPBase::data_min_, CPUOPBase::data_max_, 0.0, fp_output_);
+    for (auto i = 0; i < input_num_; i++) {
+      read_scale_.push_back(pow(2.0, shift_read_[i]));
+    }
+    write_scale_ = pow(2.0, shift_write_);
+    if (dpt_type_ == "ADD") {
+      depthwise_acc_ = broadcast_ ? depthwise_acc<DType, false, true>
+                                  : depthwise_acc<DType, false, false>;
+    } else {
+      depthwise_acc_ = broadcast_ ? depthwise_acc<DType, true, true>
+                                  : depthwise_acc<DType, true, false>;
+    }
+  }
 }
 
 template <typename DType>
@@ -146,6 +196,23 @@ uint64_t DepthwiseFix<DType>::get_workload() {
 template <typename DType>
 void DepthwiseFix<DType>::depthwise(std::uint32_t start_index,
                                     std::uint32_t end_index) {
+  if (depthwise_acc_ != nullptr) {
+    vector<BroadcastIter> iters;
+    if (broadcast_) {
+      for (auto i = 0; i < input_num_; i++) {
+        iters.emplace_back(fmap_o_, fmap_i_[i]);
+        iters.back().seek(start_index);
+      }
+    }
+    double acc[FIX_TILE];
+    for (auto pos = start_index; pos < end_index; pos += FIX_TILE) {
+      auto num = std::min(FIX_TILE, end_index - pos);
+      depthwise_acc_(data_in_, read_scale_, write_scale_, iters, pos, num,
+                     acc);
+      fix_output_(fix_output_param_, acc, data_out_ + pos, num);
+    }
+    return;
+  }
   auto dst_coord = fmap_o_.pos2coord(0);
   auto src_coord = dst_coord;
   for (auto pos_iter = start_index; pos_iter < end_index; pos_iter++) {
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "fix_kernel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -71,6 +72,18 @@ class DepthwiseFix : public CPUOPBase {
 
   uint32_t THREAD_NUM;
   uint32_t THREAD_WORKLOAD;
+
+  // ADD and MUL are specialized on the type and the broadcast in the
+  // constructor, nullptr for the other types
+  using depthwise_acc_t = void (*)(const vector<DType*>&,
+                                   const vector<double>&, double,
+                                   vector<BroadcastIter>&, std::uint32_t,
+                                   std::uint32_t, double*);
+  depthwise_acc_t depthwise_acc_{nullptr};
+  vector<double> read_scale_;
+  double write_scale_{1.0};
+  fix_output_t<DType> fix_output_{nullptr};
+  FixOutputParam<DType> fix_output_param_;
 };
 
 }  // namespace cpu
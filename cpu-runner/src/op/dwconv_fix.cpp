@@ -75,6 +75,12 @@ DWConvFix<DType, WType>::DWConvFix(const xir::Subgraph* subg, const xir::Op* op,
     UNI_LOG_FATAL(VART_NOT_SUPPORT)
         << "Unsupported nonlinear type: " << nonlinear_type_str << ".";
   }
+  fix_conv_acc_ = select_fix_conv_acc<DType>(false, has_bias_);
+  fix_output_ = select_fix_output<DType>(CPUOPBase::round_mode_,
+                                         to_fix_nonlinear(nonlinear_type_));
+  fix_output_param_ = make_fix_output_param<DType>(
+      CPUOPBase::data_min_, CPUOPBase::data_max_, prelu_alpha_, fp_output_,
+      hsigmoid_in_, shift_hsigmoid_, shift_hswish_);
 }
 
 template <typename DType, typename WType>
@@ -116,51 +122,24 @@ void DWConvFix<DType, WType>::fix() {
   //}
 
   // do fix for output
-  auto factor = pow(2, shift_cut_ + 1);
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    double tmp = data_out_ptr_[i];
-    tmp *= 2;
-    if (has_bias_) {
-      // do fix for bias
-      auto pos = i % fmap_o_.c;
-      tmp += 2.0 * bias_ptr_[pos] * pow(2.0, shift_bias_);
-    }
-
-    tmp /= factor;
-    if (nonlinear_type_ == 1) {
-      if (tmp < 0) tmp = 0;
-    } else if (nonlinear_type_ == 2) {
-      if (tmp < 0) tmp = tmp * prelu_alpha_;
-    } else if (nonlinear_type_ == 3) {
-      if (tmp < 0) tmp = tmp * prelu_alpha_;
-    } else if (nonlinear_type_ == 4) {
-      if (tmp < 0) tmp = 0;
-      if (fp_output_ <= 4) {
-        auto thr6 = 6 << 4;
-        if (tmp >= thr6) tmp = thr6;
-      }
-    } else if (nonlinear_type_ == 5) {
-      tmp =
-        double(round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_, CPUOPBase::data_max_));
-      tmp = std::min(
-                pow(2, 32),
-                std::max(0.0, (tmp * 2731 + 3 * 2731 * pow(2, hsigmoid_in_)))) *
-            pow(2, -shift_hsigmoid_);
-    } else if (nonlinear_type_ == 6) {
-      auto x =
-        double(round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_, CPUOPBase::data_max_));
-      double hsigmoid_x =
-          std::min(
-                 pow(2, 32),
-                 std::max(0.0, (x * 2731 + 3 * 2731 * pow(2, hsigmoid_in_)))) *
-             pow(2, -shift_hsigmoid_);
-      hsigmoid_x =
-        double(round_normal<DType>(CPUOPBase::round_mode_, hsigmoid_x, CPUOPBase::data_min_, CPUOPBase::data_max_));
-      tmp = x * hsigmoid_x * pow(2, -shift_hswish_);
+  UNI_LOG_CHECK(fix_output_ != nullptr, VART_NOT_SUPPORT)
+      << "Not supported round mode " << CPUOPBase::round_mode_;
+  vector<double> bias;
+  if (has_bias_) {
+    bias.resize(fmap_o_.c);
+    for (auto c = 0; c < fmap_o_.c; c++) {
+      bias[c] = 2.0 * bias_ptr_[c] * pow(2.0, shift_bias_);
     }
-    data_out_ptr_[i] =
-        round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_,
-                            CPUOPBase::data_max_);
+  }
+  auto param = FixConvParam<DType>{data_out_ptr_, bias.data(),
+                                   static_cast<std::uint32_t>(fmap_o_.c),
+                                   pow(2, shift_cut_ + 1)};
+  std::uint32_t num = fmap_o_.num();
+  double acc[FIX_TILE];
+  for (auto i = 0U; i < num; i += FIX_TILE) {
+    auto n = std::min(FIX_TILE, num - i);
+    fix_conv_acc_(param, i, n, acc);
+    fix_output_(fix_output_param_, acc, data_out_ptr_ + i, n);
   }
 }
 
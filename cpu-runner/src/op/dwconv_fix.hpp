@@ -18,6 +18,7 @@
 #pragma once
 
 #include "dwconv.hpp"
+#include "fix_kernel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -55,6 +56,11 @@ class DWConvFix : public DWConv<DType, WType> {
   double prelu_alpha_{0.1015625};
 
   int nonlinear_type_;
+
+  // selected in the constructor, see fix_kernel.hpp
+  fix_conv_acc_t<DType> fix_conv_acc_{nullptr};
+  fix_output_t<DType> fix_output_{nullptr};
+  FixOutputParam<DType> fix_output_param_;
 };
 
 }  // namespace cpu
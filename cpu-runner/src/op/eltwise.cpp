@@ -151,22 +151,26 @@ uint64_t Eltwise<DType>::get_workload() {
   return fmap_o_.num();
 }
 
+template <typename DType>
+vector<BroadcastIter> Eltwise<DType>::broadcast_iters(std::uint32_t pos) const {
+  vector<BroadcastIter> iters;
+  if (broadcast_) {
+    for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
+      iters.emplace_back(fmap_o_, fmap_i_[input_iter]);
+      iters.back().seek(pos);
+    }
+  }
+  return iters;
+}
+
 template <typename DType>
 void Eltwise<DType>::eltwise(std::uint32_t start_index,
                              std::uint32_t end_index) {
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
+  auto iters = broadcast_iters(start_index);
+  for (auto pos_iter = start_index; pos_iter < end_index;
+       ++pos_iter, BroadcastIter::next(iters)) {
     for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-      auto pos = pos_iter;
-      if (broadcast_) {
-        fmap_o_.pos2coord(pos_iter, dst_coord);
-        for (auto dim_iter = 0U; dim_iter < src_coord.size(); dim_iter++) {
-          src_coord[dim_iter] =
-              dst_coord[dim_iter] % fmap_i_[input_iter][dim_iter];
-        }
-        pos = fmap_i_[input_iter].coord2pos(src_coord);
-      }
+      auto pos = broadcast_ ? iters[input_iter].offset() : pos_iter;
       if ("MUL" == elt_type_) {
         if (shift) {
           data_out_[pos_iter] *= floor(data_in_[input_iter][pos] *
@@ -195,23 +199,10 @@ void Eltwise<DType>::eltwise_normal() {
 
 template <typename DType>
 void Eltwise<DType>::eltwise_thread() {
-  vector<std::future<void>> fut(THREAD_NUM);
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; ++thread_id) {
-    auto start_index = thread_id * THREAD_WORKLOAD;
-    auto FMAP_SIZE = fmap_o_.num();
-    auto end_index =
-        std::min<uint32_t>(FMAP_SIZE, start_index + THREAD_WORKLOAD);
-    fut[thread_id] = std::async(std::launch::async,
-                                [this](decltype(start_index) start_index,
-                                       decltype(end_index) end_index) {
-                                  eltwise(start_index, end_index);
-                                },
-                                start_index, end_index);
-  }
-
-  for (auto thread_id = 0U; thread_id < THREAD_NUM; thread_id++) {
-    fut[thread_id].wait();
-  }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 eltwise(start_index, end_index);
+               });
 }
 
 INSTANTIATE_TPCLASS(Eltwise);
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "cpu_parallel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -50,6 +51,8 @@ class Eltwise : public CPUOPBase {
 
  protected:
   virtual void eltwise(std::uint32_t start_index, std::uint32_t end_index);
+  // one iterator per input at output position pos, empty without broadcast
+  vector<BroadcastIter> broadcast_iters(std::uint32_t pos) const;
   vector<Dimension> fmap_i_;
   Dimension fmap_o_;
 
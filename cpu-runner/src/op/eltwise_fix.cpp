@@ -320,6 +320,62 @@ EltwiseFix<DType>::EltwiseFix(const xir::Subgraph* subg, const xir::Op* op,
       shift_write_ = fp_min - hsigmoid_in_;
     }
   }
+  select_kernels();
+}
+
+template <typename DType>
+void EltwiseFix<DType>::select_kernels() {
+  auto op = FixEltwiseOp::ADD;
+  if (elt_type_ == "ADD" || elt_type_ == "RELU" || elt_type_ == "RELU6" ||
+      (elt_type_ == "PRELU" && input_num_ == 1) ||
+      elt_type_ == "LEAKY-RELU") {
+    op = FixEltwiseOp::ADD;
+  } else if (elt_type_ == "SUB") {
+    op = FixEltwiseOp::SUB;
+  } else if (elt_type_ == "MUL") {
+    op = FixEltwiseOp::MUL;
+  } else if (elt_type_ == "MAX") {
+    op = FixEltwiseOp::MAX;
+  } else if (elt_type_ == "MIN") {
+    op = FixEltwiseOp::MIN;
+  } else {
+    return;
+  }
+
+  // the same precedence as in eltwise()
+  auto nonlinear = FixNonlinear::NONE;
+  if (elt_type_ == "RELU" ||
+      nonlinear_type_ == EltwiseNonlinearType::NONLINEAR_RELU) {
+    nonlinear = FixNonlinear::RELU;
+  } else if ((elt_type_ == "PRELU" && input_num_ == 1) ||
+             nonlinear_type_ == EltwiseNonlinearType::NONLINEAR_PRELU ||
+             elt_type_ == "LEAKY-RELU" ||
+             nonlinear_type_ == EltwiseNonlinearType::NONLINEAR_LEAKY_RELU) {
+    nonlinear = FixNonlinear::PRELU;
+  } else if (elt_type_ == "RELU6" ||
+             nonlinear_type_ == EltwiseNonlinearType::NONLINEAR_RELU6) {
+    nonlinear = FixNonlinear::RELU6;
+  } else if (nonlinear_type_ == EltwiseNonlinearType::NONLINEAR_HSIGMOID) {
+    nonlinear = FixNonlinear::HSIGMOID;
+  }
+  fix_output_ = select_fix_output<DType>(output_round_, nonlinear);
+  if (fix_output_ == nullptr) {
+    return;
+  }
+  fix_output_param_ = make_fix_output_param<DType>(
+      CPUOPBase::data_min_, CPUOPBase::data_max_, prelu_alpha_, fp_output_,
+      hsigmoid_in_, shift_hsigmoid_);
+
+  fix_eltwise_param_.read_scale.clear();
+  for (auto i = 0; i < input_num_; i++) {
+    fix_eltwise_param_.read_scale.push_back(
+        op == FixEltwiseOp::MUL ? pow(2.0, shift_read_[i])
+                                : pow(2.0, 7 - shift_read_[i]));
+  }
+  fix_eltwise_param_.write_div = pow(2.0, shift_write_);
+  fix_eltwise_param_.post_div =
+      op == FixEltwiseOp::MUL ? pow(4, fmap_i_.size()) : pow(2, 7);
+  fix_eltwise_acc_ = select_fix_eltwise_acc<DType>(op, broadcast_);
 }
 
 template <typename DType>
@@ -410,33 +466,19 @@ void EltwiseFix<DType>::calculate_pow() {
   }
 }
 
-template <typename DType>
-uint32_t EltwiseFix<DType>::broadcast_pos(uint32_t pos_iter, int input_iter) {
-  auto get_sub_coord = [](coord_t coord, int start) {
-    return coord_t(coord.begin() + start, coord.end());
-  };
-  auto pos = pos_iter;
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  if (broadcast_) {
-    fmap_o_.pos2coord(pos_iter, dst_coord);
-    int delta = 0;
-    for (auto dim_iter = 0U; dim_iter < dst_coord.size(); dim_iter++) {
-      if (fmap_i_[input_iter].ndims() < int(dst_coord.size())) {
-        delta = dst_coord.size() - fmap_i_[input_iter].ndims();
-      }
-      if (int(dim_iter) >= delta)
-        src_coord[dim_iter] =
-            dst_coord[dim_iter] % fmap_i_[input_iter][dim_iter - delta];
-    }
-    pos = fmap_i_[input_iter].coord2pos(get_sub_coord(src_coord, delta));
-  }
-  return pos;
-}
-
 template <typename DType>
 void EltwiseFix<DType>::eltwise(std::uint32_t start_index,
                                 std::uint32_t end_index) {
+  if (fix_eltwise_acc_ != nullptr) {
+    auto iters = this->broadcast_iters(start_index);
+    double acc[FIX_TILE];
+    for (auto pos = start_index; pos < end_index; pos += FIX_TILE) {
+      auto num = std::min(FIX_TILE, end_index - pos);
+      fix_eltwise_acc_(fix_eltwise_param_, data_in_, iters, pos, num, acc);
+      fix_output_(fix_output_param_, acc, data_out_ + pos, num);
+    }
+    return;
+  }
   // for (auto fp_iter = 0U; fp_iter < fmap_i_.size(); fp_iter++) {
   //   std::string name = "add" + std::to_string(fp_iter) + ".bin";
   //   FILE* fp_add = fopen(name.data(), "wb");
@@ -445,16 +487,15 @@ void EltwiseFix<DType>::eltwise(std::uint32_t start_index,
   //   }
   //   fclose(fp_add);
   // }
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
-  for (auto pos_iter = start_index; pos_iter < end_index; pos_iter++) {
+  auto iters = this->broadcast_iters(start_index);
+  for (auto pos_iter = start_index; pos_iter < end_index;
+       pos_iter++, BroadcastIter::next(iters)) {
     double tmp = (elt_type_ == "MUL" || elt_type_ == "DIV") ? 1 : 0;
     double tmp_float = 0.0;
     float tmp_float_norm = 0.0;
     // int tmp_int = 0;
     for (auto fp_iter = 0U; fp_iter < fmap_i_.size(); fp_iter++) {
-      // dim_t pos;
-      auto pos = broadcast_pos(pos_iter, fp_iter);
+      auto pos = broadcast_ ? iters[fp_iter].offset() : pos_iter;
       if (elt_type_ == "ADD" || elt_type_ == "RELU" || elt_type_ == "RELU6" ||
           (elt_type_ == "PRELU" && input_num_ == 1) ||
           elt_type_ == "LEAKY-RELU") {
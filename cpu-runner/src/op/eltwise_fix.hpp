@@ -18,6 +18,7 @@
 #pragma once
 
 #include "eltwise.hpp"
+#include "fix_kernel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -46,8 +47,20 @@ class EltwiseFix : public Eltwise<DType> {
   void calculate_pow();
   void run() override;
 
+  // L2NORM reduces over axis_ in calculate_pow() and GELU writes to the
+  // broadcast position, neither of them is elementwise on the output
+  virtual bool is_elementwise() const override final {
+    return elt_type_ != "L2NORM" && elt_type_ != "GELU";
+  }
+  virtual void run_range(std::uint32_t start_index,
+                         std::uint32_t end_index) override final {
+    eltwise(start_index, end_index);
+  }
+
+ private:
+  void select_kernels();
+
  private:
-  uint32_t broadcast_pos(uint32_t, int);
   EltwiseNonlinearType nonlinear_type_;
 
   vector<int> fp_inputs_;
@@ -75,6 +88,13 @@ class EltwiseFix : public Eltwise<DType> {
   double prelu_alpha_ = 0.f;
   std::vector<int32_t> axis_;
 
+  // ADD, SUB, MUL, MAX, MIN, RELU, RELU6, LEAKY-RELU and PRELU with one
+  // input run the kernels of fix_kernel.hpp, nullptr for the other types
+  fix_eltwise_acc_t<DType> fix_eltwise_acc_{nullptr};
+  FixEltwiseParam fix_eltwise_param_;
+  fix_output_t<DType> fix_output_{nullptr};
+  FixOutputParam<DType> fix_output_param_;
+
   using Eltwise<DType>::broadcast_;
   using Eltwise<DType>::fmap_i_;
   using Eltwise<DType>::fmap_o_;
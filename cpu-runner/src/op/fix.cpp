@@ -67,7 +67,7 @@ Fix<DType, FixType>::Fix(const xir::Subgraph* subg, const xir::Op* op,
   upper_bound_ = upper_bound_base_ / step_;
 
   FMAP_SIZE = get_vec_mul(fmap_o_);
-  THREAD_NUM = (CPU_NUM == 1) ? 1 : ceil(std::log(CPU_NUM));
+  THREAD_NUM = get_parallel_thread_num();
   THREAD_WORKLOAD = ceil((float)FMAP_SIZE / THREAD_NUM);
 }
 
@@ -138,6 +138,33 @@ uint64_t Fix<DType, FixType>::get_workload() {
   return 0;
 }
 
+// float2fix and fix2float of element i only touch element i, so do both in
+// one pass over the range
+template <typename DType, typename FixType>
+void Fix<DType, FixType>::run_range(std::uint32_t start_index,
+                                    std::uint32_t end_index) {
+  if (round_mode_ == "STD_ROUND") {
+    for (auto i = start_index; i < end_index; i++) {
+      float2fix_std_round(i);
+      fix2float_std_round(i);
+    }
+  } else if (round_mode_ == "DPU_ROUND") {
+    for (auto i = start_index; i < end_index; i++) {
+      float2fix_dpu_round(i);
+      fix2float_dpu_round(i);
+    }
+  } else if (round_mode_ == "PY3_ROUND") {
+    for (auto i = start_index; i < end_index; i++) {
+      float2fix_py3_round(i);
+      fix2float_py3_round(i);
+    }
+  } else {
+    UNI_LOG_ERROR(VART_NOT_SUPPORT)
+        << "Not supported round mode " << round_mode_ << endl;
+    abort();
+  }
+}
+
 template <typename DType, typename FixType>
 void Fix<DType, FixType>::float2fix() {
   if (CPU_RUN_MODE == CPURunMode::NORMAL) {
@@ -162,16 +189,30 @@ void Fix<DType, FixType>::fix2float() {
 
 template <typename DType, typename FixType>
 void Fix<DType, FixType>::float2fix_normal() {
+  float2fix_range(0, FMAP_SIZE);
+}
+
+template <typename DType, typename FixType>
+void Fix<DType, FixType>::float2fix_thread() {
+  parallel_for(FMAP_SIZE, ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 float2fix_range(start_index, end_index);
+               });
+}
+
+template <typename DType, typename FixType>
+void Fix<DType, FixType>::float2fix_range(std::uint32_t start_index,
+                                          std::uint32_t end_index) {
   if (round_mode_ == "STD_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       float2fix_std_round(i);
     }
   } else if (round_mode_ == "DPU_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       float2fix_dpu_round(i);
     }
   } else if (round_mode_ == "PY3_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       float2fix_py3_round(i);
     }
   } else {
@@ -182,64 +223,31 @@ void Fix<DType, FixType>::float2fix_normal() {
 }
 
 template <typename DType, typename FixType>
-void Fix<DType, FixType>::float2fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              if (round_mode_ == "STD_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_std_round(pos);
-                                }
-                              } else if (round_mode_ == "DPU_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_dpu_round(pos);
-                                }
-                              } else if (round_mode_ == "PY3_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  float2fix_py3_round(pos);
-                                }
-                              } else {
-                                UNI_LOG_ERROR(VART_NOT_SUPPORT)
-                                    << "Not supported round mode "
-                                    << round_mode_ << endl;
-                                abort();
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
+void Fix<DType, FixType>::fix2float_normal() {
+  fix2float_range(0, FMAP_SIZE);
+}
 
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+template <typename DType, typename FixType>
+void Fix<DType, FixType>::fix2float_thread() {
+  parallel_for(FMAP_SIZE, ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 fix2float_range(start_index, end_index);
+               });
 }
 
 template <typename DType, typename FixType>
-void Fix<DType, FixType>::fix2float_normal() {
+void Fix<DType, FixType>::fix2float_range(std::uint32_t start_index,
+                                          std::uint32_t end_index) {
   if (round_mode_ == "STD_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       fix2float_std_round(i);
     }
   } else if (round_mode_ == "DPU_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       fix2float_dpu_round(i);
     }
   } else if (round_mode_ == "PY3_ROUND") {
-    for (auto i = 0U; i < FMAP_SIZE; i++) {
+    for (auto i = start_index; i < end_index; i++) {
       fix2float_py3_round(i);
     }
   } else {
@@ -249,53 +257,6 @@ void Fix<DType, FixType>::fix2float_normal() {
   }
 }
 
-template <typename DType, typename FixType>
-void Fix<DType, FixType>::fix2float_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              if (round_mode_ == "STD_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_std_round(pos);
-                                }
-                              } else if (round_mode_ == "DPU_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_dpu_round(pos);
-                                }
-                              } else if (round_mode_ == "PY3_ROUND") {
-                                for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                  auto pos = BASE_POS + j;
-                                  if (pos >= FMAP_SIZE) break;
-
-                                  fix2float_py3_round(pos);
-                                }
-                              } else {
-                                UNI_LOG_ERROR(VART_NOT_SUPPORT)
-                                    << "Not supported round mode "
-                                    << round_mode_ << endl;
-                                abort();
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
-}
-
 INSTANTIATE_TPCLASS(Fix);
 REG_OP_INSTANCE_FUNC("fix", Fix);
 
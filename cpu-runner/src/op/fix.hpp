@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "cpu_parallel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -47,6 +48,10 @@ class Fix : public CPUOPBase {
 
   virtual uint64_t get_workload() override final;
 
+  virtual bool is_elementwise() const override { return true; }
+  virtual void run_range(std::uint32_t start_index,
+                         std::uint32_t end_index) override;
+
  protected:
   void float2fix();
   void fix2float();
@@ -54,9 +59,11 @@ class Fix : public CPUOPBase {
  private:
   void float2fix_normal();
   void float2fix_thread();
+  void float2fix_range(std::uint32_t start_index, std::uint32_t end_index);
 
   void fix2float_normal();
   void fix2float_thread();
+  void fix2float_range(std::uint32_t start_index, std::uint32_t end_index);
 
   inline void float2fix_std_round(int i) {
     auto fin = data_in_ptr_[i] * step_;
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <type_traits>
+
+#include "cpu_parallel.hpp"
+#include "cpu_util.hpp"
+
+namespace vart {
+namespace cpu {
+
+// Inner loops of the fix-point ops, specialized at compile time.
+//
+// The round mode, the nonlinearity, the eltwise type and the broadcast are
+// template parameters instead of per element branches. An op selects its
+// kernels once in the constructor and runs them on tiles of FIX_TILE
+// elements: the op specific kernel computes the accumulators of a tile in
+// double, fix_output() applies the nonlinearity and rounds them to the
+// output range. The arithmetic is the same as in the per element code, so
+// the results are bit-exact, see test/test_fix_kernel.cpp.
+
+constexpr std::uint32_t FIX_TILE = 256U;
+
+enum class FixRound { STD_ROUND, DPU_ROUND, PY3_ROUND };
+
+// PRELU and LEAKYRELU only differ in how alpha is computed
+enum class FixNonlinear { NONE, RELU, PRELU, RELU6, HSIGMOID, HSWISH };
+
+// nonlinear_type_ of the conv-fix ops, 0 NONE, 1 RELU, 2 PRELU,
+// 3 LEAKYRELU, 4 RELU6, 5 HSIGMOID, 6 HSWISH
+inline FixNonlinear to_fix_nonlinear(int nonlinear_type) {
+  static const FixNonlinear nonlinears[] = {
+      FixNonlinear::NONE,  FixNonlinear::RELU,     FixNonlinear::PRELU,
+      FixNonlinear::PRELU, FixNonlinear::RELU6,    FixNonlinear::HSIGMOID,
+      FixNonlinear::HSWISH};
+  UNI_LOG_CHECK(nonlinear_type >= 0 && nonlinear_type <= 6,
+                VART_INVALID_VALUE)
+      << "invalid nonlinear type " << nonlinear_type;
+  return nonlinears[nonlinear_type];
+}
+
+template <typename DType>
+struct FixOutputParam {
+  DType data_min;
+  DType data_max;
+  double prelu_alpha{0.0};
+  // RELU6 only clips at 6 if the output has at most 4 fraction bits
+  bool relu6_clip{false};
+  // 3 * 2731 * 2^hsigmoid_in
+  double hsigmoid_offset{0.0};
+  // 2^-shift_hsigmoid
+  double hsigmoid_scale{1.0};
+  // 2^-shift_hswish
+  double hswish_scale{1.0};
+};
+
+template <typename DType>
+FixOutputParam<DType> make_fix_output_param(DType data_min, DType data_max,
+                                            double prelu_alpha, int fp_output,
+                                            int hsigmoid_in = 0,
+                                            int shift_hsigmoid = 0,
+                                            int shift_hswish = 0) {
+  FixOutputParam<DType> param;
+  param.data_min = data_min;
+  param.data_max = data_max;
+  param.prelu_alpha = prelu_alpha;
+  param.relu6_clip = fp_output <= 4;
+  param.hsigmoid_offset = 3 * 2731 * pow(2, hsigmoid_in);
+  param.hsigmoid_scale = pow(2, -shift_hsigmoid);
+  param.hswish_scale = pow(2, -shift_hswish);
+  return param;
+}
+
+// round_normal() with the round mode resolved at compile time
+template <typename DType, FixRound ROUND>
+inline DType fix_round(double data, DType data_min, DType data_max) {
+  if constexpr (!std::is_integral<DType>::value) {
+    return DType(data);
+  } else if constexpr (ROUND == FixRound::STD_ROUND) {
+    return STDRound(data, data_min, data_max);
+  } else if constexpr (ROUND == FixRound::DPU_ROUND) {
+    return DPURound(data, data_min, data_max);
+  } else {
+    return Py3Round(data, data_min, data_max);
+  }
+}
+
+template <typename DType>
+inline double fix_hsigmoid(const FixOutputParam<DType>& param, double x) {
+  // 4294967296 is 2^32
+  return std::min(4294967296.0,
+                  std::max(0.0, (x * 2731 + param.hsigmoid_offset))) *
+         param.hsigmoid_scale;
+}
+
+template <typename DType, FixRound ROUND, FixNonlinear NONLINEAR>
+void fix_output(const FixOutputParam<DType>& param, const double* acc,
+                DType* out, std::uint32_t num) {
+  for (auto i = 0U; i < num; i++) {
+    auto tmp = acc[i];
+    if constexpr (NONLINEAR == FixNonlinear::RELU) {
+      if (tmp < 0) tmp = 0;
+    } else if constexpr (NONLINEAR == FixNonlinear::PRELU) {
+      if (tmp < 0) tmp = tmp * param.prelu_alpha;
+    } else if constexpr (NONLINEAR == FixNonlinear::RELU6) {
+      if (tmp < 0) tmp = 0;
+      auto thr6 = 6 << 4;
+      if (param.relu6_clip && tmp >= thr6) tmp = thr6;
+    } else if constexpr (NONLINEAR == FixNonlinear::HSIGMOID) {
+      tmp = double(
+          fix_round<DType, ROUND>(tmp, param.data_min, param.data_max));
+      tmp = fix_hsigmoid(param, tmp);
+    } else if constexpr (NONLINEAR == FixNonlinear::HSWISH) {
+      auto x = double(
+          fix_round<DType, ROUND>(tmp, param.data_min, param.data_max));
+      auto hsigmoid_x = double(fix_round<DType, ROUND>(
+          fix_hsigmoid(param, x), param.data_min, param.data_max));
+      tmp = x * hsigmoid_x * param.hswish_scale;
+    }
+    out[i] = fix_round<DType, ROUND>(tmp, param.data_min, param.data_max);
+  }
+}
+
+template <typename DType>
+using fix_output_t = void (*)(const FixOutputParam<DType>&, const double*,
+                              DType*, std::uint32_t);
+
+template <typename DType, FixRound ROUND>
+fix_output_t<DType> select_fix_output(FixNonlinear nonlinear) {
+  switch (nonlinear) {
+    case FixNonlinear::NONE:
+      return fix_output<DType, ROUND, FixNonlinear::NONE>;
+    case FixNonlinear::RELU:
+      return fix_output<DType, ROUND, FixNonlinear::RELU>;
+    case FixNonlinear::PRELU:
+      return fix_output<DType, ROUND, FixNonlinear::PRELU>;
+    case FixNonlinear::RELU6:
+      return fix_output<DType, ROUND, FixNonlinear::RELU6>;
+    case FixNonlinear::HSIGMOID:
+      return fix_output<DType, ROUND, FixNonlinear::HSIGMOID>;
+    case FixNonlinear::HSWISH:
+      return fix_output<DType, ROUND, FixNonlinear::HSWISH>;
+  }
+  return nullptr;
+}
+
+// nullptr for an unknown round mode, round_normal() fails on it at run time.
+// The round mode is ignored by floating point outputs, they share one
+// instantiation.
+template <typename DType>
+fix_output_t<DType> select_fix_output(const std::string& round_mode,
+                                      FixNonlinear nonlinear) {
+  if (!std::is_integral<DType>::value || round_mode == "STD_ROUND") {
+    return select_fix_output<DType, FixRound::STD_ROUND>(nonlinear);
+  } else if (round_mode == "DPU_ROUND") {
+    return select_fix_output<DType, FixRound::DPU_ROUND>(nonlinear);
+  } else if (round_mode == "PY3_ROUND") {
+    return select_fix_output<DType, FixRound::PY3_ROUND>(nonlinear);
+  }
+  return nullptr;
+}
+
+// conv-fix and dwconv-fix: unless the conv is dirty, the accumulator is
+// doubled and the bias is added, then it is divided by 2^(shift_cut + 1),
+// or by 2^shift_cut for a dirty conv.
+enum class FixConvAcc { DIRTY, CLEAN, CLEAN_BIAS };
+
+template <typename DType>
+struct FixConvParam {
+  const DType* data;
+  // 2 * bias * 2^shift_bias per output channel, only read by CLEAN_BIAS
+  const double* bias;
+  std::uint32_t channel;
+  double factor;
+};
+
+template <typename DType, FixConvAcc ACC>
+void fix_conv_acc(const FixConvParam<DType>& param, std::uint32_t start,
+                  std::uint32_t num, double* acc) {
+  auto c = start % param.channel;
+  for (auto i = 0U; i < num; i++) {
+    double tmp = param.data[start + i];
+    if constexpr (ACC != FixConvAcc::DIRTY) {
+      tmp *= 2;
+    }
+    if constexpr (ACC == FixConvAcc::CLEAN_BIAS) {
+      tmp += param.bias[c];
+      if (++c == param.channel) c = 0;
+    }
+    acc[i] = tmp / param.factor;
+  }
+}
+
+template <typename DType>
+using fix_conv_acc_t = void (*)(const FixConvParam<DType>&, std::uint32_t,
+                                std::uint32_t, double*);
+
+template <typename DType>
+fix_conv_acc_t<DType> select_fix_conv_acc(bool conv_dirty, bool has_bias) {
+  if (conv_dirty) return fix_conv_acc<DType, FixConvAcc::DIRTY>;
+  if (has_bias) return fix_conv_acc<DType, FixConvAcc::CLEAN_BIAS>;
+  return fix_conv_acc<DType, FixConvAcc::CLEAN>;
+}
+
+// eltwise-fix: every input is read as floor(x * 2^(7 - shift_read)), or as
+// floor(x * 4 / 2^shift_read) for MUL, the inputs are combined and the
+// result is divided by 2^shift_write and by 2^7, or by 4^input_num for MUL.
+enum class FixEltwiseOp { ADD, SUB, MUL, MAX, MIN };
+
+struct FixEltwiseParam {
+  // 2^(7 - shift_read), 2^shift_read for MUL, per input
+  vector<double> read_scale;
+  double write_div;
+  double post_div;
+};
+
+template <FixEltwiseOp OP, bool FIRST>
+inline double fix_eltwise_combine(double acc, double x) {
+  if constexpr (OP == FixEltwiseOp::ADD) {
+    return acc + x;
+  } else if constexpr (OP == FixEltwiseOp::MUL) {
+    return acc * x;
+  } else if constexpr (FIRST) {
+    return x;
+  } else if constexpr (OP == FixEltwiseOp::SUB) {
+    return acc - x;
+  } else if constexpr (OP == FixEltwiseOp::MAX) {
+    return acc > x ? acc : x;
+  } else {
+    return acc > x ? x : acc;
+  }
+}
+
+template <typename DType, FixEltwiseOp OP, bool BROADCAST, bool FIRST>
+void fix_eltwise_input(const DType* in, double scale, BroadcastIter* iter,
+                       std::uint32_t start, std::uint32_t num, double* acc) {
+  for (auto i = 0U; i < num; i++) {
+    auto pos = start + i;
+    if constexpr (BROADCAST) {
+      pos = iter->offset();
+      iter->next();
+    }
+    double x;
+    if constexpr (OP == FixEltwiseOp::MUL) {
+      x = floor((double)in[pos] * 4 / scale);
+    } else {
+      x = floor((double)in[pos] * scale);
+    }
+    acc[i] = fix_eltwise_combine<OP, FIRST>(acc[i], x);
+  }
+}
+
+// inputs are walked by the iterators if BROADCAST, one per input, which are
+// at output position start and are moved past the tile
+template <typename DType, FixEltwiseOp OP, bool BROADCAST>
+void fix_eltwise_acc(const FixEltwiseParam& param,
+                     const vector<DType*>& inputs, vector<BroadcastIter>& iters,
+                     std::uint32_t start, std::uint32_t num, double* acc) {
+  std::fill_n(acc, num, OP == FixEltwiseOp::MUL ? 1.0 : 0.0);
+  for (auto i = 0U; i < inputs.size(); i++) {
+    auto* iter = BROADCAST ? &iters[i] : nullptr;
+    if (i == 0U) {
+      fix_eltwise_input<DType, OP, BROADCAST, true>(
+          inputs[i], param.read_scale[i], iter, start, num, acc);
+    } else {
+      fix_eltwise_input<DType, OP, BROADCAST, false>(
+          inputs[i], param.read_scale[i], iter, start, num, acc);
+    }
+  }
+  for (auto i = 0U; i < num; i++) {
+    acc[i] /= param.write_div;
+    acc[i] /= param.post_div;
+  }
+}
+
+template <typename DType>
+using fix_eltwise_acc_t = void (*)(const FixEltwiseParam&,
+                                   const vector<DType*>&,
+                                   vector<BroadcastIter>&, std::uint32_t,
+                                   std::uint32_t, double*);
+
+template <typename DType, bool BROADCAST>
+fix_eltwise_acc_t<DType> select_fix_eltwise_acc(FixEltwiseOp op) {
+  switch (op) {
+    case FixEltwiseOp::ADD:
+      return fix_eltwise_acc<DType, FixEltwiseOp::ADD, BROADCAST>;
+    case FixEltwiseOp::SUB:
+      return fix_eltwise_acc<DType, FixEltwiseOp::SUB, BROADCAST>;
+    case FixEltwiseOp::MUL:
+      return fix_eltwise_acc<DType, FixEltwiseOp::MUL, BROADCAST>;
+    case FixEltwiseOp::MAX:
+      return fix_eltwise_acc<DType, FixEltwiseOp::MAX, BROADCAST>;
+    case FixEltwiseOp::MIN:
+      return fix_eltwise_acc<DType, FixEltwiseOp::MIN, BROADCAST>;
+  }
+  return nullptr;
+}
+
+template <typename DType>
+fix_eltwise_acc_t<DType> select_fix_eltwise_acc(FixEltwiseOp op,
+                                                bool broadcast) {
+  return broadcast ? select_fix_eltwise_acc<DType, true>(op)
+                   : select_fix_eltwise_acc<DType, false>(op);
+}
+
+}  // namespace cpu
+}  // namespace vart
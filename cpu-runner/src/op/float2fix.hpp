@@ -32,6 +32,9 @@ public:
 
   virtual void read() override final;
 
+  // only half of Fix::run_range() applies, not fused
+  virtual bool is_elementwise() const override final { return false; }
+
 private:
   using Fix<float, int32_t>::data_in_ptr_;
   using Fix<float, int32_t>::fix_rlt_ptr_;
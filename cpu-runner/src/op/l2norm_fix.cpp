@@ -108,65 +108,75 @@ void L2NormFix<DType>::run() {
     auto cur_cod = fmap_i_.cod(dim);
     auto chunk_size = cur_dim * cur_cod;
     auto n_chunk = fmap_i_.num() / chunk_size;
-    std::vector<std::vector<float>> acc_buf(cur_cod, std::vector<float>(16, 0));
-
-    for (auto i = 0; i < n_chunk; i++) {
-      float* prlt = data_in_buf_ptr_ + i * cur_dim * cur_cod;
-      // init: first element's square
-      for (auto k = 0; k < cur_cod; k++) {
-        for (auto l = 0; l < 16; l++) {
-          acc_buf[k][l] = 0;
-        }
-        prlt[k] = f_to_bf(prlt[k] * pow(0.5, shift_read_));
-        acc_buf[k][0] = f_to_bf(prlt[k]) * f_to_bf(prlt[k]);
-      }
 
-      // accumulate
-      for (auto j = 1; j < cur_dim; j++) {
-        float* pcur = prlt + j * cur_cod;
+    // chunks are independent, every thread accumulates its chunks in its
+    // own acc_buf
+    auto grain = std::max<std::uint32_t>(1U, ELEMENTWISE_GRAIN / chunk_size);
+    parallel_for(n_chunk, grain, [&](std::uint32_t start_index,
+                                     std::uint32_t end_index) {
+      std::vector<std::vector<float>> acc_buf(cur_cod,
+                                              std::vector<float>(16, 0));
+      for (auto i = start_index; i < end_index; i++) {
+        float* prlt = data_in_buf_ptr_ + i * cur_dim * cur_cod;
+        // init: first element's square
         for (auto k = 0; k < cur_cod; k++) {
-          pcur[k] = f_to_bf(pcur[k] * pow(0.5, shift_read_));
-          acc_buf[k][j % 16] += f_to_bf(pcur[k]) * f_to_bf(pcur[k]);
+          for (auto l = 0; l < 16; l++) {
+            acc_buf[k][l] = 0;
+          }
+          prlt[k] = f_to_bf(prlt[k] * pow(0.5, shift_read_));
+          acc_buf[k][0] = f_to_bf(prlt[k]) * f_to_bf(prlt[k]);
         }
-      }
 
-      for (auto k = 0; k < cur_cod; k++) {
-        prlt[k] = 0;
-        for (auto l = 0; l < 16; l++) {
-          prlt[k] += f_to_bf(acc_buf[k][l]);
+        // accumulate
+        for (auto j = 1; j < cur_dim; j++) {
+          float* pcur = prlt + j * cur_cod;
+          for (auto k = 0; k < cur_cod; k++) {
+            pcur[k] = f_to_bf(pcur[k] * pow(0.5, shift_read_));
+            acc_buf[k][j % 16] += f_to_bf(pcur[k]) * f_to_bf(pcur[k]);
+          }
+        }
+
+        for (auto k = 0; k < cur_cod; k++) {
+          prlt[k] = 0;
+          for (auto l = 0; l < 16; l++) {
+            prlt[k] += f_to_bf(acc_buf[k][l]);
+          }
+          prlt[k] = f_to_bf(prlt[k]);
         }
-        prlt[k] = f_to_bf(prlt[k]);
       }
-    }
+    });
   }
 
   // copy calculation result from data_in_buf_ptr_ into data_out_ptr_
-  for (auto pos = 0; pos < fmap_o_.num(); pos++) {
-    auto coord = fmap_o_.pos2coord(pos);
-    for (auto k = 0U; k < axis_.size(); k++) {
-      auto dim = axis_[k];
-      coord[dim] = 0;
-    }
-    auto src_pos = fmap_i_.coord2pos(coord);
-    float tmp = f_to_bf((float)data_in_ptr_[pos] * pow(0.5, shift_read_));
-
-    if (data_in_buf_ptr_[src_pos] < SUBSTITUTE_FOR_0) {
-      tmp = f_to_bf(f_to_bf(tmp) * f_to_bf(1 / sqrt(SUBSTITUTE_FOR_0)));
-    } else {
-      tmp =
-          f_to_bf(f_to_bf(tmp) * f_to_bf(1 / sqrt(data_in_buf_ptr_[src_pos])));
-    }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN, [&](std::uint32_t start_index,
+                                                     std::uint32_t end_index) {
+    for (auto pos = start_index; pos < end_index; pos++) {
+      auto coord = fmap_o_.pos2coord(pos);
+      for (auto k = 0U; k < axis_.size(); k++) {
+        auto dim = axis_[k];
+        coord[dim] = 0;
+      }
+      auto src_pos = fmap_i_.coord2pos(coord);
+      float tmp = f_to_bf((float)data_in_ptr_[pos] * pow(0.5, shift_read_));
+
+      if (data_in_buf_ptr_[src_pos] < SUBSTITUTE_FOR_0) {
+        tmp = f_to_bf(f_to_bf(tmp) * f_to_bf(1 / sqrt(SUBSTITUTE_FOR_0)));
+      } else {
+        tmp = f_to_bf(f_to_bf(tmp) *
+                      f_to_bf(1 / sqrt(data_in_buf_ptr_[src_pos])));
+      }
 
-    tmp = f_to_bf(tmp * pow(2.0, shift_write_));
-    if (CPUOPBase::round_mode_ == "PY3_ROUND") {
-      data_out_ptr_[pos] =
-        round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_,
-                            CPUOPBase::data_max_);
-    } else {
-      data_out_ptr_[pos] =
-        DPURoundEven<DType>(tmp, CPUOPBase::data_min_, CPUOPBase::data_max_);
+      tmp = f_to_bf(tmp * pow(2.0, shift_write_));
+      if (CPUOPBase::round_mode_ == "PY3_ROUND") {
+        data_out_ptr_[pos] =
+          round_normal<DType>(CPUOPBase::round_mode_, tmp, CPUOPBase::data_min_,
+                              CPUOPBase::data_max_);
+      } else {
+        data_out_ptr_[pos] =
+          DPURoundEven<DType>(tmp, CPUOPBase::data_min_, CPUOPBase::data_max_);
+      }
     }
-  }
+  });
 }
 
 template <typename DType>
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "cpu_parallel.hpp"
 
 namespace vart {
 namespace cpu {
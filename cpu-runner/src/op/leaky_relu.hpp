@@ -31,10 +31,14 @@ public:
 
   virtual void run() override final;
 
+  virtual bool is_elementwise() const override final { return true; }
+  virtual void run_range(std::uint32_t start_index,
+                         std::uint32_t end_index) override final;
+
   virtual void print_param() override;
 
 private:
-  void leaky_relu();
+  void leaky_relu(std::uint32_t start_index, std::uint32_t end_index);
 
 private:
   float alpha_;
@@ -57,30 +57,7 @@ void MaxPool<DType>::max_pool_normal() {
 
 template <typename DType>
 void MaxPool<DType>::max_pool_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos % fmap_o_.c != 0) continue;
-                                if (pos >= FMAP_SIZE) break;
-
-                                auto fmap = fmap_o_.pos2coord(pos);
-                                max_pool_one(fmap.n, fmap.h, fmap.w);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  this->for_each_pos([this](int n, int h, int w) { max_pool_one(n, h, w); });
 }
 
 template <typename DType>
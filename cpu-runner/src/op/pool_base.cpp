@@ -76,7 +76,7 @@ PoolBase<DType>::PoolBase(const xir::Subgraph* subg,
   fmap_i_.w += pad_.l + pad_.r;
 
   FMAP_SIZE = fmap_o_.num();
-  THREAD_NUM = (CPU_NUM==1) ? 1 : ceil(std::log(CPU_NUM));
+  THREAD_NUM = get_parallel_thread_num();
   THREAD_WORKLOAD = ceil((float)FMAP_SIZE / THREAD_NUM);
 }
 
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "cpu_parallel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -50,6 +51,12 @@ public:
 
   virtual uint64_t get_workload() override final;
 
+protected:
+  // call func(n, h, w) for every output position, positions are independent
+  // and split among threads by parallel_for()
+  template <typename Func>
+  void for_each_pos(Func func);
+
 protected:
   int pool_type_;
 
@@ -74,6 +81,21 @@ protected:
   uint32_t FMAP_SIZE;
 };
 
+template <typename DType>
+template <typename Func>
+void PoolBase<DType>::for_each_pos(Func func) {
+  auto grain = std::max<std::uint32_t>(1U, ELEMENTWISE_GRAIN / fmap_o_.c);
+  parallel_for(fmap_o_.n * fmap_o_.h * fmap_o_.w, grain,
+               [&](std::uint32_t start_index, std::uint32_t end_index) {
+                 for (auto pos = start_index; pos < end_index; pos++) {
+                   int w = pos % fmap_o_.w;
+                   int h = pos / fmap_o_.w % fmap_o_.h;
+                   int n = pos / fmap_o_.w / fmap_o_.h;
+                   func(n, h, w);
+                 }
+               });
+}
+
 } // namespace cpu
 } // namespace vart
 
@@ -103,6 +103,13 @@ PoolFix<DType>::PoolFix(const xir::Subgraph* subg, const xir::Op* op,
   fp_output_ = xir_tensor_o->get_attr<int>("fix_point");
   shift_pool_ = fp_output_ - fp_input_;
   pow_shift_ = pow(2.0, shift_pool_);
+  if (pool_type_ == PoolBase<DType>::AVG_POOL) {
+    avg_coefficient_ = get_avgpool_dpu_coefficient({kernel_.h, kernel_.w});
+  }
+  fix_output_ = select_fix_output<DType>(CPUOPBase::round_mode_,
+                                         FixNonlinear::NONE);
+  fix_output_param_ = make_fix_output_param<DType>(
+      CPUOPBase::data_min_, CPUOPBase::data_max_, 0.0, fp_output_);
 }
 
 template <typename DType>
@@ -152,38 +159,15 @@ void PoolFix<DType>::max_pool_fix() {
 
 template <typename DType>
 void PoolFix<DType>::max_pool_fix_normal() {
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    data_out_ptr_[i] = round_normal<DType>(
-        CPUOPBase::round_mode_, data_out_ptr_[i] * pow_shift_,
-        CPUOPBase::data_min_, CPUOPBase::data_max_);
-  }
+  pool_fix_range(0, fmap_o_.num());
 }
 
 template <typename DType>
 void PoolFix<DType>::max_pool_fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos >= FMAP_SIZE) break;
-                                data_out_ptr_[pos] = round_normal<DType>(
-                                    CPUOPBase::round_mode_,
-                                    data_out_ptr_[pos] * pow_shift_,
-                                    CPUOPBase::data_min_, CPUOPBase::data_max_);
-                              }
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(FMAP_SIZE, ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 pool_fix_range(start_index, end_index);
+               });
 }
 
 template <typename DType>
@@ -198,46 +182,38 @@ void PoolFix<DType>::avg_pool_fix() {
 
 template <typename DType>
 void PoolFix<DType>::avg_pool_fix_normal() {
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    avg_pool_fix_one(i);
-  }
+  pool_fix_range(0, fmap_o_.num());
 }
 
 template <typename DType>
 void PoolFix<DType>::avg_pool_fix_thread() {
-  vector<std::future<int>> thr_fut(THREAD_NUM);
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    // thr_fut[i] = std::async(std::launch::async | std::launch::deferred,
-    thr_fut[i] = std::async(std::launch::async,
-                            [this](decltype(i) i) {
-                              auto BASE_POS = i * THREAD_WORKLOAD;
-                              for (auto j = 0U; j < THREAD_WORKLOAD; j++) {
-                                auto pos = BASE_POS + j;
-                                if (pos >= FMAP_SIZE) break;
-
-                                avg_pool_fix_one(pos);
-                              }
-
-                              return 0;
-                            },
-                            i);
-  }
-
-  for (auto i = 0U; i < THREAD_NUM; i++) {
-    thr_fut[i].wait();
-  }
+  parallel_for(FMAP_SIZE, ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 pool_fix_range(start_index, end_index);
+               });
 }
 
 template <typename DType>
-void PoolFix<DType>::avg_pool_fix_one(int i) {
-  auto tmp = 0.f;
-
-  tmp = (float)data_out_ptr_[i] *
-        get_avgpool_dpu_coefficient({kernel_.h, kernel_.w});
-
-  data_out_ptr_[i] = round_normal<DType>(CPUOPBase::round_mode_, tmp * pow_shift_, CPUOPBase::data_min_,
-                              CPUOPBase::data_max_);
+void PoolFix<DType>::pool_fix_range(std::uint32_t start_index,
+                                    std::uint32_t end_index) {
+  UNI_LOG_CHECK(fix_output_ != nullptr, VART_NOT_SUPPORT)
+      << "Not supported round mode " << CPUOPBase::round_mode_;
+  double acc[FIX_TILE];
+  for (auto pos = start_index; pos < end_index; pos += FIX_TILE) {
+    auto num = std::min(FIX_TILE, end_index - pos);
+    auto* data = data_out_ptr_ + pos;
+    if (pool_type_ == PoolBase<DType>::MAX_POOL) {
+      for (auto i = 0U; i < num; i++) {
+        acc[i] = data[i] * pow_shift_;
+      }
+    } else {
+      for (auto i = 0U; i < num; i++) {
+        auto tmp = (float)data[i] * avg_coefficient_;
+        acc[i] = tmp * pow_shift_;
+      }
+    }
+    fix_output_(fix_output_param_, acc, data, num);
+  }
 }
 
 INSTANTIATE_TPCLASS(PoolFix);
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "avg_pool.hpp"
+#include "fix_kernel.hpp"
 #include "max_pool.hpp"
 
 namespace vart {
@@ -42,7 +43,7 @@ protected:
   void avg_pool_fix();
   void avg_pool_fix_normal();
   void avg_pool_fix_thread();
-  inline void avg_pool_fix_one(int i);
+  void pool_fix_range(std::uint32_t start_index, std::uint32_t end_index);
 
 protected:
   int fix_width_{8};
@@ -51,6 +52,10 @@ protected:
   std::string output_round_;
   int shift_pool_;
   float pow_shift_;
+  // the dpu approximation of 1 / (kernel_h * kernel_w)
+  float avg_coefficient_{0.f};
+  fix_output_t<DType> fix_output_{nullptr};
+  FixOutputParam<DType> fix_output_param_;
 
   using PoolBase<DType>::pool_type_;
   using PoolBase<DType>::raw_fmap_i_;
@@ -264,6 +264,20 @@ QLinearEltwise<DType>::QLinearEltwise(const xir::Subgraph* subg,
            "y_scale";
   }
 
+  static const std::map<std::string, EltType> elt_ops{
+      {"ADD", EltType::ADD},
+      {"SUB", EltType::SUB},
+      {"MUL", EltType::MUL},
+      {"DIV", EltType::DIV},
+      {"REQUANTIZE", EltType::REQUANTIZE},
+      {"RELU", EltType::RELU},
+      {"LEAKY-RELU", EltType::LEAKY_RELU},
+      {"TANH", EltType::TANH}};
+  auto it = elt_ops.find(elt_type_);
+  if (it != elt_ops.end()) {
+    elt_op_ = it->second;
+  }
+
   THREAD_NUM = CPU_NUM;
   THREAD_WORKLOAD = ceil((float)fmap_o_.num() / THREAD_NUM);
 }
@@ -279,14 +293,16 @@ void QLinearEltwise<DType>::align_dim() {
 
 template <typename DType>
 void QLinearEltwise<DType>::run() {
-  // if (CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
-  //     CPU_RUN_MODE == CPURunMode::GEMM_THREAD) {
-  //    eltwise_thread();
-  //    todo
-  // } else {
-  //   eltwise_normal();
-  // }
-  eltwise_normal();
+  // eltwise() accumulates into the output, so it is initialized here
+  read();
+  // L2NORM reduces over axis, it is always computed on the whole tensor
+  if ((CPU_RUN_MODE == CPURunMode::NORMAL_THREAD ||
+       CPU_RUN_MODE == CPURunMode::GEMM_THREAD) &&
+      "L2NORM" != elt_type_) {
+    eltwise_thread();
+  } else {
+    eltwise_normal();
+  }
 }
 
 template <typename DType>
@@ -364,9 +380,6 @@ std::int64_t right_shift(std::int64_t val, std::int32_t shift_val) {
 template <typename DType>
 void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
                                     std::uint32_t end_index) {
-  read();
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
   std::vector<std::int32_t> FP{FP_0 - FP_2, FP_1 - FP_2};
   std::vector<std::int32_t> C{C_0, C_1, C_2, C_3};
   int fpmax = 0;
@@ -391,27 +404,56 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
 
   int cmin = std::min({FP_0, FP_1, FP_2, FP_3});
   std::vector<std::int32_t> FP1{FP_0 - cmin, FP_1 - cmin, FP_2 - cmin};
-  for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
+  // the attrs are read once, not per element
+  std::int64_t mul_zp1 = 0;
+  std::int64_t mul_zp2 = 0;
+  if (EltType::MUL == elt_op_) {
+    mul_zp1 = xir_op_->template get_attr<int32_t>("a_zero_point");
+    mul_zp2 = xir_op_->template get_attr<int32_t>("b_zero_point");
+  }
+  int a_zp = 0;
+  int y_zp = 0;
+  float a_s = 0.f;
+  float y_s = 0.f;
+  if (EltType::LEAKY_RELU == elt_op_ || EltType::TANH == elt_op_) {
+    a_zp = xir_op_->get_attr<std::vector<int>>("a_zero_point").front();
+    y_zp = xir_op_->get_attr<std::vector<int>>("y_zero_point").front();
+  }
+  if (EltType::TANH == elt_op_) {
+    a_s = xir_op_->get_attr<std::vector<float>>("a_scale").front();
+    y_s = xir_op_->get_attr<std::vector<float>>("y_scale").front();
+  }
+  int32_t div_zp1 = 0;
+  int32_t div_zp2 = 0;
+  int32_t div_zp3 = 0;
+  float div_coeff = 0.f;
+  if (EltType::DIV == elt_op_) {
+    div_zp1 = xir_op_->template get_attr<int32_t>("a_zero_point");
+    div_zp2 = xir_op_->template get_attr<int32_t>("b_zero_point");
+    div_zp3 = xir_op_->template get_attr<int32_t>("y_zero_point");
+    div_coeff = xir_op_->template get_attr<float>("coeff0_f");
+  }
+  auto iters = broadcast_iters(start_index);
+  for (auto pos_iter = start_index; pos_iter < end_index;
+       ++pos_iter, BroadcastIter::next(iters)) {
     std::int64_t temp_add = 0;
     // float temp_add_bf16 = 0.0;
     std::int64_t temp_add1 = 1;
     std::int64_t temp_relu = 0;
     std::int64_t final_sum = 0;
     for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-      auto pos = broadcast_pos(pos_iter,input_iter);
-      if ("MUL" == elt_type_) {
-        int64_t zp1 = xir_op_->template get_attr<int32_t>("a_zero_point");
-        int64_t zp2 = xir_op_->template get_attr<int32_t>("b_zero_point");
+      auto pos = broadcast_ ? iters[input_iter].offset() : pos_iter;
+      if (EltType::MUL == elt_op_) {
         int final_shift = (FP_0 > FP_1) ? (FP_0 - FP_1) : 0;
         int c1_sft = (FP_0 > FP_1) ? 0 : (FP_1 - FP_0);
         if (FP1[input_iter] >= 0) {
           if (input_iter == 0) {
             temp_add1 *= static_cast<std::int64_t>(data_in_[input_iter][pos]);
-            temp_add = zp2 * data_in_[input_iter][pos];
+            temp_add = mul_zp2 * data_in_[input_iter][pos];
           }
           if (input_iter == 1) {
             temp_add1 *= static_cast<std::int64_t>(data_in_[input_iter][pos]);
-            temp_add += zp1 * data_in_[input_iter][pos];
+            temp_add += mul_zp1 * data_in_[input_iter][pos];
             int64_t final_sum1 = temp_add1 - temp_add;
             int64_t co_mul =
                 int64_t(round_even(final_sum1, 0, INT32_MAX, INT32_MIN)) * C_0;
@@ -426,7 +468,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
             }
           }
         }
-      } else if ("RELU" == elt_type_) {
+      } else if (EltType::RELU == elt_op_) {
         int FP_min = std::min(FP_0, FP_2);
         temp_relu = (static_cast<std::int64_t>(data_in_[input_iter][pos]) *
                      (static_cast<std::int64_t>(C_0) >> (FP_0 - FP_min))) +
@@ -440,9 +482,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
         } else {
           data_out_[pos_iter] = tmp1;
         }
-      } else if ("LEAKY-RELU" == elt_type_) {
-        int a_zp = xir_op_->get_attr<std::vector<int>>("a_zero_point").front();
-        int y_zp = xir_op_->get_attr<std::vector<int>>("y_zero_point").front();
+      } else if (EltType::LEAKY_RELU == elt_op_) {
         auto data_max = data_max_ - y_zp;
         auto data_min = data_min_ - y_zp;
 
@@ -450,7 +490,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
         auto v1 = round_even(C_0 * tmp_0, FP_0, data_max, data_min) + y_zp;
         auto v2 = round_even(C_1 * tmp_0, FP_1, data_max, data_min) + y_zp;
         data_out_[pos_iter] = tmp_0 > 0 ? v1 : v2;
-      } else if ("ADD" == elt_type_) {
+      } else if (EltType::ADD == elt_op_) {
         if (FP_minus_max[input_iter] >= 0) {
           temp_add += ((static_cast<std::int64_t>(C[input_iter])
                         << FP_minus_max[input_iter]) *
@@ -460,7 +500,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
                         (-1 * FP_minus_max[input_iter])) *
                        static_cast<std::int64_t>(data_in_[input_iter][pos]));
         }
-      } else if ("SUB" == elt_type_) {
+      } else if (EltType::SUB == elt_op_) {
         if (0 == input_iter) {
           temp_add = (right_shift(static_cast<std::int64_t>(C[input_iter]),
                                   FP1[input_iter]) *
@@ -471,7 +511,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
                        static_cast<std::int64_t>(data_in_[input_iter][pos]));
           temp_add += right_shift(static_cast<std::int64_t>(C_2), FP1[2]);
         }
-      } else if ("REQUANTIZE" == elt_type_) {
+      } else if (EltType::REQUANTIZE == elt_op_) {
         if (FP_2 - FP_0 >= 0) {
           temp_add = (static_cast<std::int64_t>(C_0) *
                       static_cast<std::int64_t>(data_in_[input_iter][pos])) +
@@ -481,12 +521,7 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
                       static_cast<std::int64_t>(data_in_[input_iter][pos])) +
                      (static_cast<std::int64_t>(C_2) << (FP_0 - FP_2));
         }
-      } else if ("TANH" == elt_type_) {
-        // get attrs
-        int a_zp = xir_op_->get_attr<std::vector<int>>("a_zero_point").front();
-        int y_zp = xir_op_->get_attr<std::vector<int>>("y_zero_point").front();
-        float a_s = xir_op_->get_attr<std::vector<float>>("a_scale").front();
-        float y_s = xir_op_->get_attr<std::vector<float>>("y_scale").front();
+      } else if (EltType::TANH == elt_op_) {
         if (bit_width_ == 8) {
           float y_lower = float(data_min_) - y_zp;
           float y_upper = float(data_max_) - y_zp;
@@ -508,31 +543,27 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
           // rnd and saturate
           data_out_[pos_iter] = round_to_even<DType>(out, data_min_, data_max_);
         }
-      } else if ("DIV" == elt_type_) {
-        int32_t zp1 = xir_op_->template get_attr<int32_t>("a_zero_point");
-        int32_t zp2 = xir_op_->template get_attr<int32_t>("b_zero_point");
-        int32_t zp3 = xir_op_->template get_attr<int32_t>("y_zero_point");
-        float coeff = xir_op_->template get_attr<float>("coeff0_f");
-
+      } else if (EltType::DIV == elt_op_) {
         if (0 == input_iter) {
           temp_add = static_cast<std::int64_t>(data_in_[input_iter][pos]);
         } else {
           auto temp2 = static_cast<std::int64_t>(data_in_[input_iter][pos]);
-          float tmp2 = f_to_bf(coeff) *
-                       fast_div(float(temp_add - zp1), float(temp2 - zp2));
+          float tmp2 =
+              f_to_bf(div_coeff) *
+              fast_div(float(temp_add - div_zp1), float(temp2 - div_zp2));
           data_out_[pos_iter] = round_to_even<DType>(
-              round_to_even<int32_t>(tmp2) + zp3, data_min_, data_max_);
+              round_to_even<int32_t>(tmp2) + div_zp3, data_min_, data_max_);
         }
       }
     }
-    if ("REQUANTIZE" == elt_type_) {
+    if (EltType::REQUANTIZE == elt_op_) {
       data_out_[pos_iter] = round_even(temp_add, FP_0, data_max_, data_min_);
-    } else if ("ADD" == elt_type_) {
+    } else if (EltType::ADD == elt_op_) {
       temp_add += (static_cast<std::int64_t>(C_2) << FP_minus_max[2]);
       data_out_[pos_iter] = round_even(temp_add, fpmax, data_max_, data_min_);
-    } else if ("SUB" == elt_type_) {
+    } else if (EltType::SUB == elt_op_) {
       data_out_[pos_iter] = round_even(temp_add, cmin, data_max_, data_min_);
-    } else if ("MUL" == elt_type_) {
+    } else if (EltType::MUL == elt_op_) {
       if (8 == bit_width_)
         data_out_[pos_iter] = round_even(final_sum, FP_0, data_max_, data_min_);
       else
@@ -542,50 +573,41 @@ void QLinearEltwise<DType>::eltwise(std::uint32_t start_index,
 }
 
 template <typename DType>
-uint32_t QLinearEltwise<DType>::broadcast_pos(uint32_t pos_iter,
-                                              int input_iter) {
-  auto get_sub_coord = [](coord_t coord, int start) {
-    return coord_t(coord.begin() + start, coord.end());
-  };
-  auto pos = pos_iter;
-  auto dst_coord = fmap_o_.pos2coord(0);
-  auto src_coord = dst_coord;
+vector<BroadcastIter> QLinearEltwise<DType>::broadcast_iters(
+    std::uint32_t pos) const {
+  vector<BroadcastIter> iters;
   if (broadcast_) {
-    fmap_o_.pos2coord(pos_iter, dst_coord);
-    int delta = 0;
-    for (auto dim_iter = 0U; dim_iter < dst_coord.size(); dim_iter++) {
-      if (fmap_i_[input_iter].ndims() < int(dst_coord.size())) {
-        delta = dst_coord.size() - fmap_i_[input_iter].ndims();
-      }
-      if (int(dim_iter) >= delta)
-        src_coord[dim_iter] =
-            dst_coord[dim_iter] % fmap_i_[input_iter][dim_iter - delta];
+    for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
+      iters.emplace_back(fmap_o_, fmap_i_[input_iter]);
+      iters.back().seek(pos);
     }
-    pos = fmap_i_[input_iter].coord2pos(get_sub_coord(src_coord, delta));
   }
-  return pos;
+  return iters;
 }
 
 template <>
 void QLinearEltwise<float>::eltwise(std::uint32_t start_index,
                                     std::uint32_t end_index) {
-  read();
   if ("ADD" == elt_type_) {
-    auto dst_coord = fmap_o_.pos2coord(0);
-    auto src_coord = dst_coord;
-    for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
+    // the nonlinear is looked up once, not per element
+    auto leaky_relu =
+        xir_op_->has_attr("nonlinear") &&
+        xir_op_->get_attr<std::string>("nonlinear") == "LEAKYRELU" &&
+        xir_op_->has_attr("LEAKYRELU_alpha");
+    auto alpha =
+        leaky_relu ? xir_op_->get_attr<float>("LEAKYRELU_alpha") : 0.0f;
+    auto iters = broadcast_iters(start_index);
+    for (auto pos_iter = start_index; pos_iter < end_index;
+         ++pos_iter, BroadcastIter::next(iters)) {
       for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-        auto pos = broadcast_pos(pos_iter, input_iter);
+        auto pos = broadcast_ ? iters[input_iter].offset() : pos_iter;
         data_out_[pos_iter] += data_in_[input_iter][pos];
       }
       data_out_[pos_iter] = f_to_bf_aie2p(data_out_[pos_iter]);
       if (data_out_[pos_iter] == -0) {
         data_out_[pos_iter]  = 0.0f;
       }
-      if (xir_op_->has_attr("nonlinear") &&
-          xir_op_->get_attr<std::string>("nonlinear") == "LEAKYRELU" &&
-          xir_op_->has_attr("LEAKYRELU_alpha")) {
-            auto alpha = xir_op_->get_attr<float>("LEAKYRELU_alpha");
+      if (leaky_relu) {
             if (data_out_[pos_iter] < 0) {
               data_out_[pos_iter] = f_to_bf_aie2p(data_out_[pos_iter] * alpha);
             }
@@ -593,15 +615,21 @@ void QLinearEltwise<float>::eltwise(std::uint32_t start_index,
     }
   } 
   else if ("LEAKY-RELU" == elt_type_) {
+    auto bf16 = "BFLOAT16" ==
+                xir_op_->get_output_tensor()->get_data_type().to_string();
+    int a_zp = 0;
+    int y_zp = 0;
+    if (!bf16) {
+      a_zp = xir_op_->get_attr<std::vector<int>>("a_zero_point").front();
+      y_zp = xir_op_->get_attr<std::vector<int>>("y_zero_point").front();
+    }
     for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
       auto pos = pos_iter;
       for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-        if ("BFLOAT16" == xir_op_->get_output_tensor()->get_data_type().to_string() ) {
+        if (bf16) {
           float tmp_0 = data_in_[input_iter][pos];
           data_out_[pos_iter] = tmp_0 > 0 ? tmp_0 : f_to_bf_aie2p(tmp_0*leaky_relu_alpha);
         } else {
-          int a_zp = xir_op_->get_attr<std::vector<int>>("a_zero_point").front();
-          int y_zp = xir_op_->get_attr<std::vector<int>>("y_zero_point").front();
           auto data_max = data_max_ - y_zp;
           auto data_min = data_min_ - y_zp;
           int64_t tmp_0 = data_in_[input_iter][pos] - a_zp;
@@ -692,10 +720,12 @@ void QLinearEltwise<float>::eltwise(std::uint32_t start_index,
     std::array<std::uint32_t, 2> u32_in;
     std::uint32_t u32_out = 0;
 
-    for (auto pos_iter = start_index; pos_iter < end_index; ++pos_iter) {
+    auto iters = broadcast_iters(start_index);
+    for (auto pos_iter = start_index; pos_iter < end_index;
+         ++pos_iter, BroadcastIter::next(iters)) {
       skip_convert = false;
       for (auto input_iter = 0; input_iter < input_num_; input_iter++) {
-        auto pos = broadcast_pos(pos_iter, input_iter);
+        auto pos = broadcast_ ? iters[input_iter].offset() : pos_iter;
         u32_in[input_iter] = bit_cast<uint32_t>(data_in_[input_iter][pos]);
         data_out_[pos_iter] *= data_in_[input_iter][pos];
       }
@@ -722,6 +752,14 @@ void QLinearEltwise<DType>::eltwise_normal() {
   eltwise(0, fmap_o_.num());
 }
 
+template <typename DType>
+void QLinearEltwise<DType>::eltwise_thread() {
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 eltwise(start_index, end_index);
+               });
+}
+
 INSTANTIATE_TPCLASS(QLinearEltwise);
 REG_OP_INSTANCE_FUNC("qlinear-eltwise", QLinearEltwise);
 
@@ -45,7 +45,8 @@ class QLinearEltwise : public CPUOPBase {
 
   virtual uint64_t get_workload() override final;
  private:
-  uint32_t broadcast_pos(uint32_t, int);
+  // one iterator per input at output position pos, empty without broadcast
+  vector<BroadcastIter> broadcast_iters(std::uint32_t pos) const;
   void align_dim();
   void eltwise_normal();
   void eltwise_thread();
@@ -67,6 +68,19 @@ class QLinearEltwise : public CPUOPBase {
   uint32_t THREAD_WORKLOAD;
 
  private:
+  // elt_type_, so that the inner loops do not compare strings
+  enum class EltType {
+    ADD,
+    SUB,
+    MUL,
+    DIV,
+    REQUANTIZE,
+    RELU,
+    LEAKY_RELU,
+    TANH,
+    OTHER,
+  };
+  EltType elt_op_{EltType::OTHER};
   bool shift;
   vector<std::int32_t> fp_inputs_;
   vector<std::int32_t> shift_factor_;
@@ -66,12 +66,16 @@ void ReduceBase<DType>::run() {
   calculate();
 
   // copy calculation result from data_in_ptr_ into data_out_ptr_
-  for (auto pos = 0; pos < fmap_o_.num(); pos++) {
-    auto coord = fmap_o_.pos2coord(pos);
-    auto src_pos = fmap_i_.coord2pos(coord);
-
-    data_out_ptr_[pos] = data_in_ptr_[src_pos];
-  }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [this](std::uint32_t start_index, std::uint32_t end_index) {
+                 auto coord = fmap_o_.pos2coord(start_index);
+                 for (auto pos = start_index; pos < end_index; pos++) {
+                   fmap_o_.pos2coord(pos, coord);
+                   auto src_pos = fmap_i_.coord2pos(coord);
+
+                   data_out_ptr_[pos] = data_in_ptr_[src_pos];
+                 }
+               });
 }
 
 extern template string Vec2Str<string>(const vector<string>& v,
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cpu_op_base.hpp"
+#include "cpu_parallel.hpp"
 
 namespace vart {
 namespace cpu {
@@ -60,6 +61,13 @@ public:
 protected:
   virtual void calculate() {}
 
+  // prlt[k] = func(prlt[k], pcur[k]) along dim idx of data_in_ptr_
+  template <typename Func>
+  void reduce_dim(int idx, Func func);
+  // data_in_ptr_[i] = func(data_in_ptr_[i]) for every element
+  template <typename Func>
+  void transform(Func func);
+
 protected:
   Dimension fmap_i_;
   Dimension fmap_o_;
@@ -76,6 +84,51 @@ protected:
   DType* data_out_ptr_{nullptr};
 };
 
+template <typename DType>
+template <typename Func>
+void ReduceBase<DType>::reduce_dim(int idx, Func func) {
+  auto cur_dim = fmap_i_.dim(idx);
+  auto cur_cod = fmap_i_.cod(idx);
+  auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
+
+  // the (chunk, k) columns are independent and every column is still
+  // accumulated in the order of j, so the result is the same with any
+  // number of threads
+  auto grain = std::max<std::uint32_t>(1U, ELEMENTWISE_GRAIN / cur_dim);
+  parallel_for(
+      n_cur_chunk * cur_cod, grain,
+      [&](std::uint32_t start_index, std::uint32_t end_index) {
+        for (auto col = start_index; col < end_index;) {
+          auto i = col / cur_cod;
+          auto k_start = col % cur_cod;
+          auto k_end = std::min<std::uint32_t>(cur_cod,
+                                               k_start + end_index - col);
+          DType* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
+
+          for (auto j = 1; j < cur_dim; j++) {
+            DType* pcur = prlt + j * cur_cod;
+
+            // accumulate
+            for (auto k = k_start; k < k_end; k++) {
+              prlt[k] = func(prlt[k], pcur[k]);
+            }
+          }
+          col += k_end - k_start;
+        }
+      });
+}
+
+template <typename DType>
+template <typename Func>
+void ReduceBase<DType>::transform(Func func) {
+  parallel_for(fmap_i_.num(), ELEMENTWISE_GRAIN,
+               [&](std::uint32_t start_index, std::uint32_t end_index) {
+                 for (auto i = start_index; i < end_index; i++) {
+                   data_in_ptr_[i] = func(data_in_ptr_[i]);
+                 }
+               });
+}
+
 } // namespace cpu
 } // namespace vart
 
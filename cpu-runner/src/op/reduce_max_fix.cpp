@@ -46,11 +46,10 @@ void ReduceMaxFix<DType>::print_param() {
 template <typename DType>
 void ReduceMaxFix<DType>::calculate() {
   ReduceMax<DType>::calculate();
-  for (auto i = 0; i < fmap_i_.num(); i++) {
-    data_in_ptr_[i] = round_normal<DType>(
-        CPUOPBase::round_mode_, data_in_ptr_[i] * pow_shift_,
-        CPUOPBase::data_min_, CPUOPBase::data_max_);
-  }
+  this->transform([this](DType x) {
+    return round_normal<DType>(CPUOPBase::round_mode_, x * pow_shift_,
+                               CPUOPBase::data_min_, CPUOPBase::data_max_);
+  });
 }
 
 INSTANTIATE_TPCLASS(ReduceMaxFix);
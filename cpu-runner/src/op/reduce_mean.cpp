@@ -56,25 +56,10 @@ void ReduceMean<DType>::calculate() {
     auto factors = get_mean_dpu_factors(cur_dim);
     factor *= (double)(factors.first);
 	pow_shift *= std::exp2(factors.second);
-    auto cur_cod = fmap_i_.cod(idx);
-    auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
-
-    for (auto i = 0; i < n_cur_chunk; i++) {
-      DType* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
-
-      for (auto j = 1; j < cur_dim; j++) {
-        DType* pcur = prlt + j * cur_cod;
-
-        // accumulate
-        for (auto k = 0; k < cur_cod; k++) {
-          prlt[k] += pcur[k];
-        }
-      }
-    }
-  }
-  for (auto i = 0; i < fmap_i_.num(); i++) {
-    data_in_ptr_[i] *= factor / pow_shift;
+    this->reduce_dim(idx, [](DType a, DType b) { return a + b; });
   }
+  auto scale = factor / pow_shift;
+  this->transform([scale](DType x) -> DType { return x * scale; });
 }
 
 INSTANTIATE_TPCLASS(ReduceMean);
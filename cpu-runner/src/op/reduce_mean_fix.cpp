@@ -80,29 +80,14 @@ void ReduceMeanFix<DType>::calculate() {
     auto factors = get_mean_dpu_fix_factors(cur_dim);
     factor *= (double)(factors.first);
 	pow_shift *= std::exp2(factors.second);
-    auto cur_cod = fmap_i_.cod(idx);
-    auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
-
-    for (auto i = 0; i < n_cur_chunk; i++) {
-      DType* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
-
-      for (auto j = 1; j < cur_dim; j++) {
-        DType* pcur = prlt + j * cur_cod;
-
-        // accumulate
-        for (auto k = 0; k < cur_cod; k++) {
-          prlt[k] += pcur[k];
-        }
-      }
-    }
+    this->reduce_dim(idx, [](DType a, DType b) { return a + b; });
   }
-  for (auto i = 0; i < fmap_i_.num(); i++) {
+  this->transform([&](DType x) {
     double tmp = 0.f;
-    tmp = (double)data_in_ptr_[i] * factor / pow_shift;
-    data_in_ptr_[i] =
-        round_normal<DType>(CPUOPBase::round_mode_, tmp * pow_shift_,
-                            CPUOPBase::data_min_, CPUOPBase::data_max_);
-  }
+    tmp = (double)x * factor / pow_shift;
+    return round_normal<DType>(CPUOPBase::round_mode_, tmp * pow_shift_,
+                               CPUOPBase::data_min_, CPUOPBase::data_max_);
+  });
 }
 
 INSTANTIATE_TPCLASS(ReduceMeanFix);
@@ -24,22 +24,7 @@ template <typename DType>
 void ReduceMin<DType>::calculate() {
   // caculate
   for (auto idx : reduce_dims_) {
-    auto cur_dim = fmap_i_.dim(idx);
-    auto cur_cod = fmap_i_.cod(idx);
-    auto n_cur_chunk = fmap_i_.num() / (cur_dim * cur_cod);
-
-    for (auto i = 0; i < n_cur_chunk; i++) {
-      DType* prlt = data_in_ptr_ + i * cur_dim * cur_cod;
-
-      for (auto j = 1; j < cur_dim; j++) {
-        DType* pcur = prlt + j * cur_cod;
-
-        // accumulate
-        for (auto k = 0; k < cur_cod; k++) {
-          prlt[k] = std::min(prlt[k], pcur[k]);
-        }
-      }
-    }
+    this->reduce_dim(idx, [](DType a, DType b) { return std::min(a, b); });
   }
 }
 
@@ -35,17 +35,24 @@ void Relu6<DType>::run() {
   // this->read();
 
   // do relu6
-  relu6();
+  relu6(0, fmap_o_.num());
 
   // // do save, debug...
   // this->save();
 }
 
 template <typename DType>
-void Relu6<DType>::relu6() {
-  copy_n(data_in_ptr_, fmap_o_.num(), data_out_ptr_);
+void Relu6<DType>::run_range(std::uint32_t start_index,
+                             std::uint32_t end_index) {
+  relu6(start_index, end_index);
+}
+
+template <typename DType>
+void Relu6<DType>::relu6(std::uint32_t start_index, std::uint32_t end_index) {
+  copy_n(data_in_ptr_ + start_index, end_index - start_index,
+         data_out_ptr_ + start_index);
 
-  for (auto i = 0; i < fmap_o_.num(); i++) {
+  for (auto i = start_index; i < end_index; i++) {
     if (data_out_ptr_[i] < 0) {
       data_out_ptr_[i] = 0;
     } else if (data_out_ptr_[i] > 6) {
@@ -31,8 +31,12 @@ public:
 
   virtual void run() override final;
 
+  virtual bool is_elementwise() const override final { return true; }
+  virtual void run_range(std::uint32_t start_index,
+                         std::uint32_t end_index) override final;
+
 private:
-  void relu6();
+  void relu6(std::uint32_t start_index, std::uint32_t end_index);
 
 private:
   using ReluBase<DType>::fmap_i_;
@@ -55,11 +55,14 @@ void ResizeFix<DType>::print_param() {
 template <typename DType>
 void ResizeFix<DType>::fix() {
   double factor = pow(2, shift_);
-  for (auto i = 0; i < fmap_o_.num(); i++) {
-    data_out_ptr_[i] =
-        round_normal<DType>(CPUOPBase::round_mode_, this->output_f_[i] * factor,
-                            CPUOPBase::data_min_, CPUOPBase::data_max_);
-  }
+  parallel_for(fmap_o_.num(), ELEMENTWISE_GRAIN,
+               [&](std::uint32_t start_index, std::uint32_t end_index) {
+                 for (auto i = start_index; i < end_index; i++) {
+                   data_out_ptr_[i] = round_normal<DType>(
+                       CPUOPBase::round_mode_, this->output_f_[i] * factor,
+                       CPUOPBase::data_min_, CPUOPBase::data_max_);
+                 }
+               });
 }
 
 INSTANTIATE_TPCLASS(ResizeFix);
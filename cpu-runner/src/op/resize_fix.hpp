@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "cpu_parallel.hpp"
 #include "resize.hpp"
 
 namespace vart {
@@ -42,7 +42,7 @@ public:
 
     op->run();
 
-    // TODO: use single thread to do following
+    // the dump is written by DumpWriter in the background
     op->save();
   }
 
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Time every op of the cpu subgraphs of an xmodel with 1, 4 and 16 threads in
+// the NORMAL_THREAD run mode, e.g.
+//   bench_cpu_ops -m resnet50.xmodel
+// thread numbers are clamped to the number of cores, see set_cpu_num().
+
+#include <chrono>
+#include <iomanip>
+
+#include "cpu_op_base.hpp"
+#include "cpu_runner.hpp"
+#include "glob_init.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_LOOPS, "10");
+
+static double run_us(vart::cpu::CPUOPBase* op, int loops) {
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; i++) {
+    op->read();
+    op->run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         loops;
+}
+
+int main(int argc, char* argv[]) {
+  auto gi = GlobInit::make(argc, argv, "./log/");
+
+  auto xmodel = vart::cpu::CPUCfg::Instance().get_model_name();
+  auto random_seed = vart::cpu::CPUCfg::Instance().get_input_random_seed();
+  vart::cpu::CPUCfg::Instance().set_cpu_run_mode(
+      vart::cpu::CPURunMode::NORMAL_THREAD);
+
+  auto g = xir::Graph::deserialize(xmodel);
+  auto subgs = g->get_root_subgraph()->children_topological_sort();
+  const vector<int> thread_nums{1, 4, 16};
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+
+  for (auto* subg : subgs) {
+    if (!subg->has_attr("device") ||
+        subg->get_attr<string>("device") != "CPU") {
+      continue;
+    }
+    auto runner = make_unique<vart::cpu::CPURunner>(subg);
+    for (auto* tb : runner->get_input_tbs()) {
+      vart::cpu::Random(vart::cpu::TBPTR(tb), vart::cpu::TBSIZE(tb),
+                        static_cast<char>(-16), static_cast<char>(16),
+                        random_seed);
+    }
+
+    cout << "subgraph " << subg->get_name() << endl;
+    cout << std::left << std::setw(48) << "op" << std::setw(24) << "type";
+    for (auto n : thread_nums) {
+      cout << std::right << std::setw(12) << (to_string(n) + "T(us)");
+    }
+    cout << std::right << std::setw(10) << "speedup" << endl;
+
+    // ops are topologically sorted, the last run of an op leaves its output
+    // ready for the ops behind it
+    for (auto* op : runner->get_cpu_ops()) {
+      vector<double> us;
+      for (auto n : thread_nums) {
+        vart::cpu::set_cpu_num(n);
+        us.push_back(run_us(op, loops));
+      }
+      cout << std::left << std::setw(48) << op->get_name() << std::setw(24)
+           << op->get_type() << std::right << std::fixed
+           << std::setprecision(1);
+      for (auto t : us) {
+        cout << std::setw(12) << t;
+      }
+      cout << std::setw(10) << std::setprecision(2) << us.front() / us.back()
+           << endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Run the same subgraph with and without the fusion of elementwise op chains
+// and compare the outputs, which must be the same bit by bit, e.g.
+//   test_cpu_runner_fusion [batch] [height] [width] [channel]
+// the default shape is not a multiple of the tile size of the fused op.
+
+#include "cpu_runner.hpp"
+
+using namespace vart::cpu;
+
+static xir::Op* add_op(xir::Graph* g, const string& name, const string& type,
+                       std::unique_ptr<xir::Attrs> attrs, xir::Op* input) {
+  auto input_ops = std::map<string, vector<xir::Op*>>{};
+  if (input != nullptr) {
+    input_ops["input"] = {input};
+  }
+  return g->add_op(name, type, std::move(attrs), input_ops);
+}
+
+// data -> relu -> leaky-relu -> relu6 -> fix, all but data are elementwise,
+// so fuse_ops() turns them into a single fused op
+static std::unique_ptr<xir::Graph> make_graph(const vector<int>& shape) {
+  auto g = xir::Graph::create("test_cpu_runner_fusion");
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<vector<int>>("shape", shape);
+  attrs->set_attr<string>("data_type", "float32");
+  auto* data = add_op(g.get(), "data", "data", std::move(attrs), nullptr);
+
+  auto* op = add_op(g.get(), "relu", "relu", xir::Attrs::create(), data);
+  attrs = xir::Attrs::create();
+  attrs->set_attr<float>("alpha", 0.1015625f);
+  op = add_op(g.get(), "leaky_relu", "leaky-relu", std::move(attrs), op);
+  op = add_op(g.get(), "relu6", "relu6", xir::Attrs::create(), op);
+  attrs = xir::Attrs::create();
+  attrs->set_attr<int>("fix_point", 5);
+  attrs->set_attr<int>("bit_width", 8);
+  attrs->set_attr<bool>("if_signed", true);
+  attrs->set_attr<string>("round_mode", "DPU_ROUND");
+  add_op(g.get(), "fix", "fix", std::move(attrs), op);
+
+  // data is fed by the user, the other ops run on the cpu
+  auto* root = g->get_root_subgraph();
+  root->create_children();
+  auto children = root->get_children();
+  children.erase(root->find_op(data));
+  root->find_op(data)->set_attr<string>("device", "USER");
+  root->merge_children(children)->set_attr<string>("device", "CPU");
+  return g;
+}
+
+static vector<char> run(const xir::Subgraph* subg, bool fusion,
+                        const vector<float>& input) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr<bool>("cpu_runner_fusion", fusion);
+  auto runner = std::make_unique<CPURunner>(subg, attrs.get());
+  auto inputs = runner->get_inputs();
+  auto outputs = runner->get_outputs();
+  UNI_LOG_CHECK(inputs.size() == 1U && outputs.size() == 1U, VART_SIZE_ERROR);
+  UNI_LOG_CHECK(TBSIZE(inputs[0]) == input.size() * sizeof(float),
+                VART_SIZE_ERROR);
+  memcpy(TBPTR(inputs[0]), input.data(), TBSIZE(inputs[0]));
+  auto job = runner->execute_async(inputs, outputs);
+  runner->wait(job.first, -1);
+  auto* out = TBPTR(outputs[0]);
+  return vector<char>(out, out + TBSIZE(outputs[0]));
+}
+
+int main(int argc, char* argv[]) {
+  auto shape = vector<int>{2, 30, 30, 15};
+  for (auto i = 1; i < argc && i <= 4; i++) {
+    shape[i - 1] = std::stoi(argv[i]);
+  }
+  auto g = make_graph(shape);
+  const xir::Subgraph* subg = nullptr;
+  for (auto* child : g->get_root_subgraph()->children_topological_sort()) {
+    if (child->get_attr<string>("device") == "CPU") {
+      subg = child;
+    }
+  }
+  UNI_LOG_CHECK(subg != nullptr, VART_NULL_PTR);
+
+  // values around 0 and beyond the range of relu6
+  auto size = 1U;
+  for (auto dim : shape) {
+    size *= dim;
+  }
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> dis(-10.f, 10.f);
+  auto input = vector<float>(size);
+  for (auto& x : input) {
+    x = dis(rng);
+  }
+
+  auto unfused = run(subg, false, input);
+  auto fused = run(subg, true, input);
+  auto ok = unfused.size() == fused.size() &&
+            memcmp(unfused.data(), fused.data(), fused.size()) == 0;
+  cout << "shape " << Vec2Str(shape, "x") << ", "
+       << (ok ? "test pass" : "test fail, fused outputs are different")
+       << endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Check CompareBin() and the golden compare of DumpWriter, e.g.
+//   test_dump_writer ./dump_writer_test/
+// the folder is created and holds a golden and a dump sub folder. run it
+// with XLNX_CPU_RUNNER_GOLDEN_STOP=1 to check the stop at the first diff.
+
+#include <chrono>
+#include <thread>
+
+#include "cpu_dump_writer.hpp"
+#include "vitis/ai/env_config.hpp"
+
+// the same as in cpu_dump_writer.cpp
+DEF_ENV_PARAM(XLNX_CPU_RUNNER_GOLDEN_STOP, "0")
+
+using namespace vart::cpu;
+
+static vector<char> make_data(uint64_t size, int seed) {
+  std::mt19937 rng(seed);
+  vector<char> ret(size);
+  for (auto& x : ret) {
+    x = char(rng());
+  }
+  return ret;
+}
+
+static int check(bool ok, const string& what) {
+  if (!ok) {
+    cout << what << " FAIL" << endl;
+  }
+  return ok ? 0 : 1;
+}
+
+// a difference is found at the right offset, wherever it is in the chunks
+static int test_compare_bin(const string& path) {
+  auto fails = 0;
+  const uint64_t size = 10000U;
+  auto golden = make_data(size, 0);
+  auto fname = path + "golden.bin";
+  SaveBin(fname, golden.data(), golden.size());
+  for (auto chunk_size : {uint64_t(1), uint64_t(7), uint64_t(4096),
+                          uint64_t(1) << 20}) {
+    auto tag = "chunk " + std::to_string(chunk_size);
+    fails += check(CompareBin(fname, golden.data(), size, chunk_size) == size,
+                   tag + " same");
+    for (auto pos : {uint64_t(0), uint64_t(4095), uint64_t(4096), size - 1}) {
+      auto data = golden;
+      data[pos] ^= 0x10;
+      fails += check(CompareBin(fname, data.data(), size, chunk_size) == pos,
+                     tag + " diff at " + std::to_string(pos));
+    }
+    fails += check(CompareBin(fname, golden.data(), 100, chunk_size) == 100,
+                   tag + " prefix");
+    auto longer = golden;
+    longer.resize(size + 10);
+    fails += check(
+        CompareBin(fname, longer.data(), longer.size(), chunk_size) == size,
+        tag + " longer");
+  }
+  return fails;
+}
+
+// dumps larger than the queue are written in order, and those which are
+// different from their golden files are counted
+static int test_dump_writer(const string& path) {
+  auto fails = 0;
+  auto golden_path = path + "golden/";
+  auto dump_path = path + "dump/";
+  ChkFolder(golden_path);
+  ChkFolder(dump_path);
+  const auto num = 32;
+  const uint64_t size = 300U << 10;
+  vector<vector<char>> data;
+  for (auto i = 0; i < num; i++) {
+    data.emplace_back(make_data(size, i));
+    auto golden = data.back();
+    // every 4th dump is diff at element i of 16 bits
+    if (i % 4 == 0) {
+      golden[i * 2 + 1] ^= 1;
+    }
+    // dumps 1, 6, 11, ... have no golden
+    if (i % 5 != 1) {
+      SaveBin(golden_path + std::to_string(i) + ".bin", golden.data(),
+              golden.size());
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto& writer = DumpWriter::Instance();
+  for (auto i = 0; i < num; i++) {
+    writer.save(dump_path + std::to_string(i) + ".bin", data[i].data(),
+                data[i].size(), SM_TRUNC, 16);
+    auto line = std::to_string(i) + "\n";
+    writer.save(dump_path + "list.txt", line.data(), line.size(),
+                i == 0 ? SM_TRUNC : SM_APPEND);
+  }
+  auto save_us = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+  auto result = writer.flush();
+  auto flush_us = std::chrono::duration<double, std::micro>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  // 0, 4, 8, 12, 16, 20, 24, 28, but 16 has no golden
+  fails += check(result.num_of_diffs == 7,
+                 "number of diffs " + std::to_string(result.num_of_diffs));
+  // 1, 6, 11, 16, 21, 26, 31 and list.txt
+  fails += check(result.num_of_missing == 8,
+                 "number of missing " + std::to_string(result.num_of_missing));
+  fails += check(!result.stopped, "not stopped");
+  fails += check(writer.flush().num_of_diffs == 0, "diffs are reset by flush");
+
+  string list;
+  for (auto i = 0; i < num; i++) {
+    auto fname = dump_path + std::to_string(i) + ".bin";
+    fails += check(CompareBin(fname, data[i].data(), size) == size &&
+                       GetFileSize(fname) == size,
+                   fname);
+    list += std::to_string(i) + "\n";
+  }
+  fails += check(CompareBin(dump_path + "list.txt", list.data(),
+                            list.size()) == list.size(),
+                 "appended in order");
+  cout << "saved " << num << " dumps of " << size << " bytes in " << save_us
+       << "us, written in " << flush_us << "us" << endl;
+  return fails;
+}
+
+// the dump of a fix op, <tensor>.fix.bin, is compared with <tensor>.bin, the
+// float <tensor>.bin saved after it is not
+static int test_fix_golden(const string& path) {
+  auto fails = 0;
+  const uint64_t size = 1000U;
+  auto data = make_data(size, 100);
+  auto golden = data;
+  golden[10] ^= 1;
+  SaveBin(path + "golden/fix_op.bin", golden.data(), golden.size());
+  SaveBin(path + "golden/same_fix_op.bin", data.data(), data.size());
+  auto float_data = make_data(size * 4, 101);
+  auto& writer = DumpWriter::Instance();
+  writer.save(path + "dump/fix_op.fix.bin", data.data(), data.size());
+  writer.save(path + "dump/fix_op.bin", float_data.data(), float_data.size());
+  auto result = writer.flush();
+  fails += check(result.num_of_diffs == 1, "fix dump is compared");
+  writer.save(path + "dump/same_fix_op.fix.bin", data.data(), data.size());
+  writer.save(path + "dump/same_fix_op.bin", float_data.data(),
+              float_data.size());
+  // the float dump would be a size mismatch
+  result = writer.flush();
+  fails += check(result.num_of_diffs == 0, "float dump of fix op is skipped");
+  writer.save(path + "dump/no_golden.fix.bin", data.data(), data.size());
+  writer.save(path + "dump/no_golden.bin", float_data.data(),
+              float_data.size());
+  result = writer.flush();
+  fails += check(result.num_of_diffs == 0 && result.num_of_missing == 1,
+                 "fix dump without golden");
+  return fails;
+}
+
+// with XLNX_CPU_RUNNER_GOLDEN_STOP, dumps after the first diff are not
+// compared and flush() reports the stop, the process goes on
+static int test_stop(const string& path) {
+  auto fails = 0;
+  ChkFolder(path + "golden/");
+  ChkFolder(path + "dump/");
+  const uint64_t size = 1000U;
+  auto& writer = DumpWriter::Instance();
+  for (auto run = 0; run < 2; run++) {
+    for (auto i = 0; i < 3; i++) {
+      auto name = "stop" + std::to_string(i) + ".bin";
+      auto data = make_data(size, 300 + i);
+      auto golden = data;
+      // dumps 1 and 2 are diff
+      if (i > 0) {
+        golden[i] ^= 1;
+      }
+      SaveBin(path + "golden/" + name, golden.data(), golden.size());
+      writer.save(path + "dump/" + name, data.data(), data.size());
+    }
+    auto result = writer.flush();
+    auto tag = "run " + std::to_string(run);
+    fails += check(result.num_of_diffs == 1, tag + " first diff only");
+    fails += check(result.stopped, tag + " stopped");
+  }
+  return fails;
+}
+
+// threads of different owners, i.e. runners, only wait for and count their
+// own dumps
+static int test_owners(const string& path) {
+  const auto num = 8;
+  const uint64_t size = 100U << 10;
+  auto data = vector<vector<char>>();
+  auto fails = std::vector<int>(2, 0);
+  for (auto owner = 0; owner < 2; owner++) {
+    for (auto i = 0; i < num; i++) {
+      data.emplace_back(make_data(size, 200 + owner * num + i));
+      auto golden = data.back();
+      // owner 0 has 4 diffs, owner 1 has 2
+      if (i % (owner == 0 ? 2 : 4) == 0) {
+        golden[i] ^= 1;
+      }
+      SaveBin(path + "golden/owner" + std::to_string(owner) + "_" +
+                  std::to_string(i) + ".bin",
+              golden.data(), golden.size());
+    }
+  }
+  auto run = [&](int owner) {
+    DumpWriter::set_owner(&fails[owner]);
+    auto& writer = DumpWriter::Instance();
+    for (auto i = 0; i < num; i++) {
+      auto& d = data[owner * num + i];
+      writer.save(path + "dump/owner" + std::to_string(owner) + "_" +
+                      std::to_string(i) + ".bin",
+                  d.data(), d.size());
+      // owner 1 is still saving when owner 0 flushes
+      if (owner == 1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    }
+    auto num_of_diffs = writer.flush().num_of_diffs;
+    fails[owner] += check(num_of_diffs == (owner == 0 ? 4U : 2U),
+                          "owner " + std::to_string(owner) + " diffs " +
+                              std::to_string(num_of_diffs));
+    DumpWriter::set_owner(nullptr);
+  };
+  auto t1 = std::thread(run, 1);
+  auto t0 = std::thread(run, 0);
+  t0.join();
+  t1.join();
+  return fails[0] + fails[1];
+}
+
+int main(int argc, char* argv[]) {
+  string path = argc > 1 ? argv[1] : "./dump_writer_test/";
+  if (path.back() != '/') {
+    path += "/";
+  }
+  ChkFolder(path);
+  // the queue is smaller than the dumps saved by test_dump_writer()
+  DumpWriter::Instance().set_queue_limit(1U << 20);
+  DumpWriter::Instance().set_golden_path(path + "golden");
+
+  auto fails = 0;
+  fails += test_compare_bin(path);
+  if (ENV_PARAM(XLNX_CPU_RUNNER_GOLDEN_STOP)) {
+    fails += test_stop(path);
+  } else {
+    fails += test_dump_writer(path);
+    fails += test_fix_golden(path);
+    fails += test_owners(path);
+  }
+  cout << (fails == 0 ? "test pass" : "test fail") << endl;
+  return fails == 0 ? 0 : 1;
+}
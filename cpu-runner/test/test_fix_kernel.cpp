@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Check that the kernels of op/fix_kernel.hpp are bit-exact with the per
+// element loops they replace in conv2d-fix and eltwise-fix, for every round
+// mode, nonlinearity, eltwise type and 4, 8 and 16 bit outputs, with and
+// without broadcast, and print the time of both, e.g.
+//   test_fix_kernel
+// The reference loops are transcribed from the ops as they were before.
+
+#include <chrono>
+#include <cstring>
+
+#include "op/fix_kernel.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_ELEMENTS, "16384");
+DEF_ENV_PARAM(NUM_OF_LOOPS, "1");
+
+using namespace vart::cpu;
+
+static const vector<string> round_modes{"STD_ROUND", "DPU_ROUND",
+                                        "PY3_ROUND"};
+// {data_min, data_max} of signed 4, 8 and 16 bit outputs
+static const vector<pair<int, int>> bit_ranges{
+    {-8, 7}, {-128, 127}, {-32768, 32767}};
+
+struct ref_param_t {
+  string round_mode;
+  int nonlinear_type;
+  int data_min;
+  int data_max;
+  double prelu_alpha;
+  int fp_output;
+  int hsigmoid_in;
+  int shift_hsigmoid;
+  int shift_hswish;
+};
+
+// the tail of Conv2dFix::fix(), after tmp /= factor
+template <typename DType>
+static DType ref_output(const ref_param_t& p, double tmp) {
+  DType data_min = p.data_min;
+  DType data_max = p.data_max;
+  if (p.nonlinear_type == 1) {
+    if (tmp < 0) tmp = 0;
+  } else if (p.nonlinear_type == 2) {
+    if (tmp < 0) tmp = tmp * p.prelu_alpha;
+  } else if (p.nonlinear_type == 3) {
+    if (tmp < 0) tmp = tmp * p.prelu_alpha;
+  } else if (p.nonlinear_type == 4) {
+    if (tmp < 0) tmp = 0;
+    if (p.fp_output <= 4) {
+      auto thr6 = 6 << 4;
+      if (tmp >= thr6) tmp = thr6;
+    }
+  } else if (p.nonlinear_type == 5) {
+    tmp = double(round_normal<DType>(p.round_mode, tmp, data_min, data_max));
+    tmp = std::min(pow(2, 32),
+                   std::max(0.0, (tmp * 2731 +
+                                  3 * 2731 * pow(2, p.hsigmoid_in)))) *
+          pow(2, -p.shift_hsigmoid);
+  } else if (p.nonlinear_type == 6) {
+    auto x = double(round_normal<DType>(p.round_mode, tmp, data_min, data_max));
+    double hsigmoid_x =
+        std::min(pow(2, 32),
+                 std::max(0.0, (x * 2731 + 3 * 2731 * pow(2, p.hsigmoid_in)))) *
+        pow(2, -p.shift_hsigmoid);
+    hsigmoid_x = double(
+        round_normal<DType>(p.round_mode, hsigmoid_x, data_min, data_max));
+    tmp = x * hsigmoid_x * pow(2, -p.shift_hswish);
+  }
+  return round_normal<DType>(p.round_mode, tmp, data_min, data_max);
+}
+
+template <typename DType>
+static void ref_conv(const ref_param_t& p, bool dirty, bool has_bias,
+                     const vector<DType>& bias, int shift_bias, int shift_cut,
+                     vector<DType>& data) {
+  auto channel = bias.size();
+  auto factor = pow(2, shift_cut + (!dirty ? 1 : 0));
+  for (auto i = 0U; i < data.size(); i++) {
+    double tmp = data[i];
+    if (!dirty) {
+      tmp *= 2;
+      if (has_bias) {
+        auto pos = i % channel;
+        tmp += 2.0 * bias[pos] * pow(2.0, shift_bias);
+      }
+    }
+    tmp /= factor;
+    data[i] = ref_output<DType>(p, tmp);
+  }
+}
+
+template <typename DType>
+static void fix_conv(const ref_param_t& p, bool dirty, bool has_bias,
+                     const vector<DType>& bias, int shift_bias, int shift_cut,
+                     vector<DType>& data) {
+  auto fix_conv_acc = select_fix_conv_acc<DType>(dirty, has_bias);
+  auto fix_output = select_fix_output<DType>(
+      p.round_mode, to_fix_nonlinear(p.nonlinear_type));
+  auto param = make_fix_output_param<DType>(
+      p.data_min, p.data_max, p.prelu_alpha, p.fp_output, p.hsigmoid_in,
+      p.shift_hsigmoid, p.shift_hswish);
+  vector<double> bias_fix(bias.size());
+  for (auto c = 0U; c < bias.size(); c++) {
+    bias_fix[c] = 2.0 * bias[c] * pow(2.0, shift_bias);
+  }
+  auto conv_param = FixConvParam<DType>{
+      data.data(), bias_fix.data(), static_cast<std::uint32_t>(bias.size()),
+      pow(2, shift_cut + (!dirty ? 1 : 0))};
+  std::uint32_t num = data.size();
+  double acc[FIX_TILE];
+  for (auto i = 0U; i < num; i += FIX_TILE) {
+    auto n = std::min(FIX_TILE, num - i);
+    fix_conv_acc(conv_param, i, n, acc);
+    fix_output(param, acc, data.data() + i, n);
+  }
+}
+
+static const vector<string> elt_types{"ADD", "SUB", "MUL", "MAX", "MIN"};
+
+// the ADD, SUB, MUL, MAX and MIN paths of EltwiseFix::eltwise(), offsets
+// of the broadcast inputs are computed from the output coordinate
+template <typename DType>
+static void ref_eltwise(const ref_param_t& p, const string& elt_type,
+                        const vector<int>& out_dims,
+                        const vector<vector<int>>& in_dims,
+                        const vector<int>& shift_read, int shift_write,
+                        const vector<vector<DType>>& data_in,
+                        vector<DType>& data_out) {
+  for (auto pos_iter = 0U; pos_iter < data_out.size(); pos_iter++) {
+    double tmp = elt_type == "MUL" ? 1 : 0;
+    for (auto fp_iter = 0U; fp_iter < data_in.size(); fp_iter++) {
+      auto& dims = in_dims[fp_iter];
+      auto delta = out_dims.size() - dims.size();
+      auto pos = 0U;
+      auto rest = pos_iter;
+      auto stride = 1U;
+      for (auto d = (int)out_dims.size() - 1; d >= (int)delta; d--) {
+        auto coord = rest % out_dims[d];
+        rest /= out_dims[d];
+        pos += coord % dims[d - delta] * stride;
+        stride *= dims[d - delta];
+      }
+      auto x = floor((double)data_in[fp_iter][pos] *
+                     pow(2.0, 7 - shift_read[fp_iter]));
+      if (elt_type == "ADD") {
+        tmp += x;
+      } else if (elt_type == "MUL") {
+        tmp *= floor((double)data_in[fp_iter][pos] * 4 /
+                     pow(2.0, shift_read[fp_iter]));
+      } else if (fp_iter == 0U) {
+        tmp = x;
+      } else if (elt_type == "SUB") {
+        tmp -= x;
+      } else if (elt_type == "MAX") {
+        tmp = tmp > x ? tmp : x;
+      } else {
+        tmp = tmp > x ? x : tmp;
+      }
+    }
+    tmp /= pow(2.0, shift_write);
+    if (elt_type == "MUL") {
+      tmp /= pow(4, data_in.size());
+    } else {
+      tmp /= pow(2, 7);
+    }
+    data_out[pos_iter] = ref_output<DType>(p, tmp);
+  }
+}
+
+static FixEltwiseOp to_fix_eltwise_op(const string& elt_type) {
+  static const map<string, FixEltwiseOp> ops{{"ADD", FixEltwiseOp::ADD},
+                                             {"SUB", FixEltwiseOp::SUB},
+                                             {"MUL", FixEltwiseOp::MUL},
+                                             {"MAX", FixEltwiseOp::MAX},
+                                             {"MIN", FixEltwiseOp::MIN}};
+  return ops.at(elt_type);
+}
+
+template <typename DType>
+static void fix_eltwise(const ref_param_t& p, const string& elt_type,
+                        const vector<int>& out_dims,
+                        const vector<vector<int>>& in_dims,
+                        const vector<int>& shift_read, int shift_write,
+                        const vector<vector<DType>>& data_in,
+                        vector<DType>& data_out) {
+  auto op = to_fix_eltwise_op(elt_type);
+  auto broadcast = false;
+  for (auto& dims : in_dims) {
+    broadcast = broadcast || dims != out_dims;
+  }
+  auto fix_eltwise_acc = select_fix_eltwise_acc<DType>(op, broadcast);
+  auto fix_output = select_fix_output<DType>(
+      p.round_mode, to_fix_nonlinear(p.nonlinear_type));
+  auto param = make_fix_output_param<DType>(
+      p.data_min, p.data_max, p.prelu_alpha, p.fp_output, p.hsigmoid_in,
+      p.shift_hsigmoid, p.shift_hswish);
+  FixEltwiseParam elt_param;
+  vector<DType*> inputs;
+  vector<BroadcastIter> iters;
+  for (auto i = 0U; i < data_in.size(); i++) {
+    elt_param.read_scale.push_back(op == FixEltwiseOp::MUL
+                                       ? pow(2.0, shift_read[i])
+                                       : pow(2.0, 7 - shift_read[i]));
+    inputs.push_back(const_cast<DType*>(data_in[i].data()));
+    if (broadcast) {
+      iters.emplace_back(Dimension(out_dims), Dimension(in_dims[i]));
+      iters.back().seek(0U);
+    }
+  }
+  elt_param.write_div = pow(2.0, shift_write);
+  elt_param.post_div =
+      op == FixEltwiseOp::MUL ? pow(4, data_in.size()) : pow(2, 7);
+  std::uint32_t num = data_out.size();
+  double acc[FIX_TILE];
+  for (auto pos = 0U; pos < num; pos += FIX_TILE) {
+    auto n = std::min(FIX_TILE, num - pos);
+    fix_eltwise_acc(elt_param, inputs, iters, pos, n, acc);
+    fix_output(param, acc, data_out.data() + pos, n);
+  }
+}
+
+template <typename DType>
+static bool same(const vector<DType>& a, const vector<DType>& b) {
+  return a.size() == b.size() &&
+         memcmp(a.data(), b.data(), a.size() * sizeof(DType)) == 0;
+}
+
+template <typename Func>
+static double run_us(Func&& func) {
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; i++) {
+    func();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         loops;
+}
+
+template <typename DType>
+static vector<DType> random_data(std::mt19937& rng, int num, int range) {
+  std::uniform_int_distribution<int> dist(-range, range - 1);
+  vector<DType> ret(num);
+  for (auto& x : ret) {
+    x = dist(rng);
+  }
+  return ret;
+}
+
+static ref_param_t make_ref_param(const string& round_mode, int nonlinear,
+                                  pair<int, int> range, int fp_output) {
+  // prelu_alpha as computed from prelu_in = 26 and prelu_shift = 8
+  return ref_param_t{round_mode,  nonlinear, range.first, range.second,
+                     26.0 / 256,  fp_output, 2,           3,
+                     5};
+}
+
+// bit-exact for every combination, the perf report is the total time of
+// the reference and of the specialized kernels
+template <typename DType>
+static int test_conv(const string& type_name) {
+  std::mt19937 rng(0);
+  auto num = ENV_PARAM(NUM_OF_ELEMENTS);
+  auto fails = 0;
+  auto ref_us = 0.0;
+  auto fix_us = 0.0;
+  for (auto& round_mode : round_modes) {
+    for (auto nonlinear = 0; nonlinear <= 6; nonlinear++) {
+      for (auto& range : bit_ranges) {
+        for (auto acc = 0; acc < 3; acc++) {
+          auto dirty = acc == 0;
+          auto has_bias = acc == 2;
+          auto p = make_ref_param(round_mode, nonlinear, range, acc + 3);
+          auto bias = random_data<DType>(rng, 17, range.second);
+          auto data = random_data<DType>(rng, num, 64 * range.second);
+          auto ref = data;
+          auto out = data;
+          ref_us += run_us([&]() {
+            ref = data;
+            ref_conv(p, dirty, has_bias, bias, 1, 6, ref);
+          });
+          fix_us += run_us([&]() {
+            out = data;
+            fix_conv(p, dirty, has_bias, bias, 1, 6, out);
+          });
+          if (!same(ref, out)) {
+            fails++;
+            cout << "conv-fix " << type_name << " " << round_mode
+                 << " nonlinear " << nonlinear << " [" << range.first << ", "
+                 << range.second << "] acc " << acc << " FAIL" << endl;
+          }
+        }
+      }
+    }
+  }
+  cout << "conv-fix " << type_name << ": reference " << ref_us
+       << "us, specialized " << fix_us << "us" << endl;
+  return fails;
+}
+
+template <typename DType>
+static int test_eltwise(const string& type_name) {
+  std::mt19937 rng(1);
+  auto num = ENV_PARAM(NUM_OF_ELEMENTS);
+  const vector<int> out_dims{num / 256, 8, 32};
+  // same shapes, and the second input broadcast along the first two dims
+  const vector<vector<vector<int>>> in_dims{
+      {out_dims, out_dims}, {out_dims, {32}}, {{num / 256, 1, 32}, out_dims}};
+  // nonlinear types of the eltwise-fix op, NONE, RELU, PRELU, RELU6 and
+  // HSIGMOID
+  const vector<int> nonlinears{0, 1, 2, 4, 5};
+  auto fails = 0;
+  auto ref_us = 0.0;
+  auto fix_us = 0.0;
+  for (auto& round_mode : round_modes) {
+    for (auto& elt_type : elt_types) {
+      for (auto nonlinear : nonlinears) {
+        for (auto& range : bit_ranges) {
+          for (auto& dims : in_dims) {
+            auto p = make_ref_param(round_mode, nonlinear, range, 4);
+            vector<vector<DType>> data_in;
+            for (auto& d : dims) {
+              auto n = 1;
+              for (auto x : d) n *= x;
+              data_in.emplace_back(random_data<DType>(rng, n, range.second));
+            }
+            const vector<int> shift_read{2, 3};
+            auto shift_write = elt_type == "MUL" ? -3 : 1;
+            vector<DType> ref(num);
+            vector<DType> out(num);
+            ref_us += run_us([&]() {
+              ref_eltwise(p, elt_type, out_dims, dims, shift_read, shift_write,
+                          data_in, ref);
+            });
+            fix_us += run_us([&]() {
+              fix_eltwise(p, elt_type, out_dims, dims, shift_read, shift_write,
+                          data_in, out);
+            });
+            if (!same(ref, out)) {
+              fails++;
+              cout << "eltwise-fix " << type_name << " " << elt_type << " "
+                   << round_mode << " nonlinear " << nonlinear << " ["
+                   << range.first << ", " << range.second << "] FAIL" << endl;
+            }
+          }
+        }
+      }
+    }
+  }
+  cout << "eltwise-fix " << type_name << ": reference " << ref_us
+       << "us, specialized " << fix_us << "us" << endl;
+  return fails;
+}
+
+int main(int argc, char* argv[]) {
+  auto fails = 0;
+  fails += test_conv<int32_t>("int32");
+  fails += test_conv<float>("float");
+  fails += test_conv<double>("double");
+  fails += test_eltwise<int32_t>("int32");
+  fails += test_eltwise<float>("float");
+  fails += test_eltwise<double>("double");
+  cout << (fails == 0 ? "test pass" : "test fail") << endl;
+  return fails == 0 ? 0 : 1;
+}
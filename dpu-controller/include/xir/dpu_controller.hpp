@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #pragma once
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -64,5 +65,30 @@ class DpuController {
   // device_core_id in [0, get_num_of_dpus());
   virtual void run(size_t device_core_idx, const uint64_t code,
                    const std::vector<uint64_t>& gen_reg) = 0;
+
+ public:
+  // profiling registers of a core, the number of instructions started and
+  // finished by the load/conv/save/misc engines and the number of cycles.
+  struct Counter {
+    uint64_t load_start;
+    uint64_t load_end;
+    uint64_t conv_start;
+    uint64_t conv_end;
+    uint64_t save_start;
+    uint64_t save_end;
+    uint64_t misc_start;
+    uint64_t misc_end;
+    uint64_t cycle;
+  };
+  /** @brief the counters of the last run() on `device_core_id` issued by
+   * the calling thread.
+   *
+   * counters are only collected when XLNX_ENABLE_DPU_METRICS is set, return
+   * false if they are not collected or not supported by the controller.
+   */
+  virtual bool get_last_counter(size_t device_core_id,
+                                Counter& counter) const {
+    return false;
+  }
 };
 }  // namespace xir
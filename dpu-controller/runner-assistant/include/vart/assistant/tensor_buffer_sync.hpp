@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <cstdint>
+namespace vart {
+namespace assistant {
+/** @brief process-wide counters of cache maintenance on host-phy tensor
+ * buffers. */
+struct TensorBufferSyncStat {
+  uint64_t num_of_device_writes;
+  uint64_t num_of_syncs;
+  uint64_t bytes_synced;
+  /// requested by sync_for_write but not written through data()
+  uint64_t bytes_skipped;
+};
+
+/** @brief runners call it after the device may have written host-phy tensor
+ * buffers, e.g. after a DPU run.
+ *
+ * it only counts device writes, with DEBUG_TENSOR_BUFFER_SYNC=1 the syncs
+ * since the previous call are logged, i.e. per inference.
+ */
+void notify_device_write();
+
+TensorBufferSyncStat get_tensor_buffer_sync_stat();
+}  // namespace assistant
+}  // namespace vart
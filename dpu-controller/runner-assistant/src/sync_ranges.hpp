@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vart {
+namespace assistant {
+/// a set of byte ranges [begin, end) of a buffer object, kept sorted and
+/// coalesced, so that one sync call covers each run of adjacent ranges.
+class SyncRanges {
+ public:
+  using range_t = std::pair<uint64_t, uint64_t>;
+
+ public:
+  bool empty() const { return ranges_.empty(); }
+  void clear() { ranges_.clear(); }
+  const std::vector<range_t>& ranges() const { return ranges_; }
+
+  void add(uint64_t begin, uint64_t end) {
+    if (begin >= end) {
+      return;
+    }
+    auto it = std::lower_bound(
+        ranges_.begin(), ranges_.end(), begin,
+        [](const range_t& r, uint64_t x) { return r.second < x; });
+    auto last = it;
+    while (last != ranges_.end() && last->first <= end) {
+      begin = std::min(begin, last->first);
+      end = std::max(end, last->second);
+      ++last;
+    }
+    it = ranges_.erase(it, last);
+    ranges_.insert(it, range_t{begin, end});
+  }
+
+  void remove(uint64_t begin, uint64_t end) {
+    auto ret = std::vector<range_t>();
+    for (auto& r : ranges_) {
+      if (r.first < begin) {
+        ret.emplace_back(r.first, std::min(r.second, begin));
+      }
+      if (r.second > end) {
+        ret.emplace_back(std::max(r.first, end), r.second);
+      }
+    }
+    ranges_.swap(ret);
+  }
+
+  /// parts of [begin, end) which are in this set.
+  std::vector<range_t> intersect(uint64_t begin, uint64_t end) const {
+    auto ret = std::vector<range_t>();
+    for (auto& r : ranges_) {
+      auto b = std::max(begin, r.first);
+      auto e = std::min(end, r.second);
+      if (b < e) {
+        ret.emplace_back(b, e);
+      }
+    }
+    return ret;
+  }
+
+  /// parts of [begin, end) which are not in this set.
+  std::vector<range_t> subtract(uint64_t begin, uint64_t end) const {
+    auto ret = std::vector<range_t>();
+    for (auto& r : ranges_) {
+      if (r.second <= begin) {
+        continue;
+      }
+      if (r.first >= end) {
+        break;
+      }
+      if (r.first > begin) {
+        ret.emplace_back(begin, r.first);
+      }
+      begin = std::max(begin, r.second);
+    }
+    if (begin < end) {
+      ret.emplace_back(begin, end);
+    }
+    return ret;
+  }
+
+ private:
+  std::vector<range_t> ranges_;
+};
+
+void add_tensor_buffer_sync_stat(uint64_t num_of_syncs, uint64_t bytes_synced,
+                                 uint64_t bytes_skipped);
+}  // namespace assistant
+}  // namespace vart
@@ -18,6 +18,7 @@
 #include "./tensor_buffer_allocator_imp.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -118,9 +119,40 @@ struct reg_info_t {
   size_t device_core_id;
   std::string cu_name;
   std::shared_ptr<vart::TensorBuffer> reg_tensor_buffer;
-  std::shared_ptr<std::vector<char>> content;
+  vart::dpu::TensorBufferExtImpHostPhy::content_loader_t content_loader;
   const xir::Subgraph* subgraph;
 };
+
+// CONST reg values of a subgraph. They are copied out of the subgraph attrs
+// at most once per allocation and only when a reg backstore is created; the
+// values of each reg are handed out as views of that single copy.
+class parameter_values_t {
+ public:
+  explicit parameter_values_t(const xir::Subgraph* subgraph)
+      : subgraph_{subgraph} {}
+
+  std::shared_ptr<const std::vector<char>> get(const std::string& reg_id) {
+    using values_t = std::map<std::string, std::vector<char>>;
+    std::call_once(once_, [this]() {
+      values_ = subgraph_->has_attr("reg_id_to_parameter_value")
+                    ? std::make_shared<const values_t>(
+                          subgraph_->get_attr<values_t>(
+                              "reg_id_to_parameter_value"))
+                    : std::make_shared<const values_t>();
+    });
+    auto it = values_->find(reg_id);
+    UNI_LOG_CHECK(it != values_->end(), VART_XMODEL_ERROR)
+        << "cannot find CONST REG values:"
+        << " subgraph name= " << subgraph_->get_name()
+        << " reg_id = " << reg_id;
+    return std::shared_ptr<const std::vector<char>>(values_, &it->second);
+  }
+
+ private:
+  const xir::Subgraph* subgraph_;
+  std::once_flag once_;
+  std::shared_ptr<const std::map<std::string, std::vector<char>>> values_;
+};
 static std::string to_string(const reg_info_t& reg_info) {
   std::ostringstream str;
   str << "reg_info_t{";
@@ -140,18 +172,6 @@ static std::string to_string(const reg_info_t& reg_info) {
   return str.str();
 }
 
-static std::string get_allocator_key(const xir::Subgraph* subgraph,
-                                     const xir::Attrs* attrs, size_t reg_id) {
-  std::string suffix = "";
-  // if(attrs->has_attr ("__subgraph_suffix__")) TODO: for U50, we
-  // need to add a suffix, so that there are parameters for each
-  // device core.
-  //
-  std::ostringstream str;
-  str << "reg" << reg_id << "_sg_";
-  str << (void*)subgraph;
-  return str.str();
-}
 static std::vector<std::unique_ptr<reg_info_t>>
 extract_reg_info_from_subgraph_and_attrs(const xir::Subgraph* subgraph_,
                                          const xir::Attrs* attrs) {
@@ -166,12 +186,7 @@ extract_reg_info_from_subgraph_and_attrs(const xir::Subgraph* subgraph_,
       << "cu_name " << cu_name << " "                //
       ;
   auto ret = std::vector<std::unique_ptr<reg_info_t>>();
-  auto reg_id_to_parameter_value = std::map<std::string, std::vector<char>>();
-  if (subgraph_->has_attr("reg_id_to_parameter_value")) {
-    reg_id_to_parameter_value =
-        subgraph_->get_attr<std::map<std::string, std::vector<char>>>(
-            "reg_id_to_parameter_value");
-  }
+  auto parameter_values = std::make_shared<parameter_values_t>(subgraph_);
   auto basic_infos = vart::extract_reg_info_from_subgraph(subgraph_);
   ret.resize(basic_infos.size());
   for (auto i = 0u; i < basic_infos.size(); ++i) {
@@ -189,8 +204,6 @@ extract_reg_info_from_subgraph_and_attrs(const xir::Subgraph* subgraph_,
     auto reg_type = ret[i]->basic_info_.type;
     auto reg_size = ret[i]->basic_info_.size;
     auto reg_id_int = reg_id;
-    auto allocator_key =
-        get_allocator_key(subgraph_, attrs, (size_t)reg_id_int);
     auto& reg_info = *ret[reg_id_int].get();
     {  // begin initialize the reg_info_t
       auto ok = true;
@@ -203,17 +216,10 @@ extract_reg_info_from_subgraph_and_attrs(const xir::Subgraph* subgraph_,
       reg_info.cu_name = cu_name;
       reg_info.subgraph = subgraph_;
       if (reg_type == vart::reg_type_t::CONST) {
-        static std::mutex mtx;
-        std::lock_guard<std::mutex> lock(mtx);
-        auto it_value = reg_id_to_parameter_value.find(std::string("REG_") +
-                                                       std::to_string(reg_id));
-        CHECK(it_value != reg_id_to_parameter_value.end());
-        reg_info.content =
-            vitis::ai::WeakStore<std::string, std::vector<char>>::create(
-                allocator_key);
-        if (reg_info.content->empty()) {
-          *reg_info.content = std::move(it_value->second);
-        }
+        auto reg_name = std::string("REG_") + std::to_string(reg_id);
+        reg_info.content_loader = [parameter_values, reg_name]() {
+          return parameter_values->get(reg_name);
+        };
       }
       CHECK(ok);
     }  // end initialization
@@ -272,7 +278,7 @@ static std::vector<std::unique_ptr<reg_info_t>> collect_reg_info(
 }
 
 static std::string get_reg_tensor_buffer_key(const reg_info_t& reg_info) {
-  static uint64_t counter = 0u;
+  static std::atomic<uint64_t> counter{0u};
   std::ostringstream str;
   str << "reg_" << reg_info.basic_info_.reg_id;
   switch (reg_info.basic_info_.type) {
@@ -303,9 +309,15 @@ static std::string get_reg_tensor_buffer_key(const reg_info_t& reg_info) {
   return str.str();
 }
 
+static bool is_shared(const reg_info_t& reg_info) {
+  return reg_info.basic_info_.type == reg_type_t::CONST ||
+         reg_info.basic_info_.type == reg_type_t::DATA_GLOBAL;
+}
+
 static std::shared_ptr<vart::TensorBuffer> create_tensor_buffer_for_reg(
     reg_info_t& reg_info) {
-  // this function is thread-safe, protected by a mutex.
+  // this function is thread-safe. shared backstores are created once under
+  // the WeakStore lock, private ones are allocated concurrently.
   auto ret = std::shared_ptr<vart::TensorBuffer>();
   auto location = reg_info.location;
   // key is important, it determines which scope the tensor buffer is shared.
@@ -327,11 +339,17 @@ static std::shared_ptr<vart::TensorBuffer> create_tensor_buffer_for_reg(
       tensor->set_attr<int>("reg_id", reg_info.basic_info_.reg_id);
       tensor->set_attr<int>("ddr_addr", 0);
       tensor->set_attr<int>("location", 1);
+      if (!is_shared(reg_info)) {
+        ret = std::make_shared<vart::dpu::TensorBufferExtImpHostPhy>(
+            tensor.get(), location, reg_info.device_id, reg_info.cu_name,
+            reg_info.content_loader);
+        break;
+      }
       ret = vitis::ai::
           WeakStore<std::string, vart::dpu::TensorBufferExtImpHostPhy>::create(
               key,  // key is important
               tensor.get(), location, reg_info.device_id, reg_info.cu_name,
-              reg_info.content);
+              reg_info.content_loader);
       break;
   }
   return ret;
@@ -339,9 +357,6 @@ static std::shared_ptr<vart::TensorBuffer> create_tensor_buffer_for_reg(
 
 static void create_tensor_buffer_for_reg(
     std::vector<std::unique_ptr<reg_info_t>>& reg_infos) {
-  static std::mutex mtx;
-  std::lock_guard<std::mutex> lock(mtx);
-
   for (auto& reg_info : reg_infos) {
     if (reg_info == nullptr) {
       continue;
@@ -389,9 +404,8 @@ static std::unique_ptr<vart::TensorBuffer> create_tensor_buffer(
       } else {
         auto device_id = get_device_id(attrs);
         auto cu_name = get_cu_name(attrs);
-        auto content = std::shared_ptr<std::vector<char>>();
         ret = std::make_unique<vart::dpu::TensorBufferExtImpHostPhy>(
-            tensor, location, device_id, cu_name, content);
+            tensor, location, device_id, cu_name, nullptr);
       }
       break;
   }
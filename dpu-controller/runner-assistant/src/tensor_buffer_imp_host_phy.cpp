@@ -18,13 +18,25 @@
 #include "./tensor_buffer_imp_host_phy.hpp"
 
 #include <UniLog/UniLog.hpp>
+#include <mutex>
 #include <sstream>
+#include <xir/buffer_object_pool.hpp>
 #include <xir/tensor/tensor.hpp>
 
 #include "vitis/ai/dim_calc.hpp"
 #include "vitis/ai/env_config.hpp"
 
 DEF_ENV_PARAM(DEBUG_TENSOR_BUFFER_ALLOCATOR, "0");
+// with 1, sync_for_write() skips ranges the cpu did not get a pointer to
+// with data() since they were flushed. it is off by default, a client must
+// then call data() again before it writes through a pointer kept across
+// sync_for_write(). sync_for_read() always invalidates, other devices, e.g.
+// a softmax cu, may write the buffer as well.
+DEF_ENV_PARAM(XLNX_ENABLE_SYNC_TRACKING, "0");
+// carve buffer objects out of large regions instead of creating one per batch
+// slot per tensor, see xir::BufferObjectPool. it is off by default, slices
+// of a region share its driver buffer, i.e. its lifetime and its mapping.
+DEF_ENV_PARAM(XLNX_ENABLE_BO_POOL, "0");
 namespace vart {
 namespace dpu {
 static size_t align(size_t a, size_t b) {
@@ -40,32 +52,44 @@ static std::vector<std::unique_ptr<xir::BufferObject>> create_bo(
   size = align(size, 1024u);
   auto ret =
       std::vector<std::unique_ptr<xir::BufferObject>>(num_of_buffer_objects);
+  auto pool = ENV_PARAM(XLNX_ENABLE_BO_POOL)
+                  ? xir::BufferObjectPool::get(device_id, cu_name)
+                  : nullptr;
   for (auto i = 0u; i < num_of_buffer_objects; ++i) {
-    ret[i] = xir::BufferObject::create(size, device_id, cu_name);
+    ret[i] = pool ? pool->allocate(size)
+                  : xir::BufferObject::create(size, device_id, cu_name);
   }
   return ret;
 }
 
 TensorBufferExtImpHostPhy::TensorBufferExtImpHostPhy(
     const xir::Tensor* tensor, location_t location, size_t device_id,
-    const std::string& cu_name, std::shared_ptr<std::vector<char>> content)
+    const std::string& cu_name, content_loader_t content_loader)
     : TensorBufferExt(xir::Tensor::clone(tensor).release()),
       location_{location},
       tensor_{
           std::unique_ptr<xir::Tensor>(const_cast<xir::Tensor*>(get_tensor()))},
-      buffer_objects_(
-          create_bo((size_t)tensor->get_shape()[0],
-                    tensor->get_data_size() / tensor->get_shape()[0],  //
-                    device_id, cu_name)) {
+      buffer_objects_{},
+      sync_states_{} {
   LOG_IF(INFO, ENV_PARAM(DEBUG_TENSOR_BUFFER_ALLOCATOR))
       << "TensorBufferExtImpHostPhy "
       << "@" << (void*)this << " created";
-  if (content != nullptr && !content->empty()) {
+  auto content = content_loader ? content_loader()
+                                : std::shared_ptr<const std::vector<char>>();
+  auto has_content = content != nullptr && !content->empty();
+  for (auto& bo :
+       create_bo((size_t)tensor->get_shape()[0],
+                 tensor->get_data_size() / tensor->get_shape()[0],  //
+                 device_id, cu_name)) {
+    buffer_objects_.emplace_back(std::move(bo));
+  }
+  sync_states_.resize(buffer_objects_.size());
+  if (has_content) {
     LOG_IF(INFO, ENV_PARAM(DEBUG_TENSOR_BUFFER_ALLOCATOR))
         << " init phy tensor buffer with " << content->size() << " bytes";
     UNI_LOG_CHECK(buffer_objects_.size() == 1u, VART_TENSOR_INFO_ERROR)
         << " for constant buffer object, we do not support batch ";
-    buffer_objects_[0]->copy_from_host(&(*content)[0], content->size(), 0u);
+    copy_from_host(0u, content->data(), content->size(), 0u);
   }
 }
 TensorBufferExtImpHostPhy::~TensorBufferExtImpHostPhy() {
@@ -98,6 +122,11 @@ std::pair<uint64_t, size_t> TensorBufferExtImpHostPhy::data_x(
     ret = ((uint64_t)buffer_objects_[batch_idx]->phy()) + offset;
   } else {
     ret = ((uint64_t)buffer_objects_[batch_idx]->data_r()) + offset;
+    // the caller might write the rest of the batch slot from now on.
+    auto end = std::max((uint64_t)offset,
+                        (uint64_t)(get_tensor()->get_data_size() / batch));
+    std::lock_guard<std::mutex> lock(mtx_for_sync_);
+    sync_states_[batch_idx].written.add(offset, end);
   }
   return std::make_pair(ret, size);
 }
@@ -116,16 +145,34 @@ std::pair<std::uint64_t, std::size_t> TensorBufferExtImpHostPhy::data(
 }
 
 void TensorBufferExtImpHostPhy::sync_for_read(uint64_t offset, size_t size) {
-  auto num_of_buffer_objects = buffer_objects_.size();
-  for (auto i = 0u; i < num_of_buffer_objects; ++i) {
-    buffer_objects_[i]->sync_for_read(offset, size);
+  for (auto& bo : buffer_objects_) {
+    bo->sync_for_read(offset, size);
   }
 }
 
 void TensorBufferExtImpHostPhy::sync_for_write(uint64_t offset, size_t size) {
   auto num_of_buffer_objects = buffer_objects_.size();
+  if (!ENV_PARAM(XLNX_ENABLE_SYNC_TRACKING)) {
+    for (auto i = 0u; i < num_of_buffer_objects; ++i) {
+      buffer_objects_[i]->sync_for_write(offset, size);
+      vart::assistant::add_tensor_buffer_sync_stat(1u, size, 0u);
+    }
+    return;
+  }
+  // copy_from_host() flushes by itself, so only ranges written through
+  // data() need flushing. batch slots not used are skipped.
+  std::lock_guard<std::mutex> lock(mtx_for_sync_);
   for (auto i = 0u; i < num_of_buffer_objects; ++i) {
-    buffer_objects_[i]->sync_for_write(offset, size);
+    uint64_t synced = 0u;
+    auto& written = sync_states_[i].written;
+    auto ranges = written.intersect(offset, offset + size);
+    for (auto& r : ranges) {
+      buffer_objects_[i]->sync_for_write(r.first, r.second - r.first);
+      synced += r.second - r.first;
+    }
+    written.remove(offset, offset + size);
+    vart::assistant::add_tensor_buffer_sync_stat(ranges.size(), synced,
+                                                 size - synced);
   }
 }
 
@@ -15,18 +15,30 @@
  * limitations under the License.
  */
 #pragma once
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vart/tensor_buffer.hpp>
 #include <xir/buffer_object.hpp>
 #include <xir/tensor/tensor.hpp>
 
+#include "./sync_ranges.hpp"
+
 namespace vart {
 namespace dpu {
 class TensorBufferExtImpHostPhy : public vart::TensorBufferExt {
  public:
-  explicit TensorBufferExtImpHostPhy(
-      const xir::Tensor* tensor, location_t location, size_t device_id,
-      const std::string& cu_name, std::shared_ptr<std::vector<char>> content);
+  // returns the initial content of a constant buffer. it is only invoked
+  // when the buffer is actually created, so that parameter values are not
+  // read for buffers which are shared already.
+  using content_loader_t =
+      std::function<std::shared_ptr<const std::vector<char>>()>;
+
+ public:
+  explicit TensorBufferExtImpHostPhy(const xir::Tensor* tensor,
+                                     location_t location, size_t device_id,
+                                     const std::string& cu_name,
+                                     content_loader_t content_loader);
   virtual ~TensorBufferExtImpHostPhy();
   TensorBufferExtImpHostPhy(const TensorBufferExtImpHostPhy& other) = delete;
   TensorBufferExtImpHostPhy& operator=(const TensorBufferExtImpHostPhy& rhs) =
@@ -48,10 +60,20 @@ class TensorBufferExtImpHostPhy : public vart::TensorBufferExt {
                                      int phy);
   virtual XclBo get_xcl_bo(int batch_index) const override;
 
+ private:
+  // per buffer object, see XLNX_ENABLE_SYNC_TRACKING.
+  struct sync_state_t {
+    // ranges the cpu might have written, i.e. returned by data() since they
+    // were flushed last time.
+    vart::assistant::SyncRanges written;
+  };
+
  private:
   const location_t location_;
   std::unique_ptr<xir::Tensor> tensor_;
   std::vector<std::unique_ptr<xir::BufferObject>> buffer_objects_;
+  std::vector<sync_state_t> sync_states_;
+  std::mutex mtx_for_sync_;
 };
 }  // namespace dpu
 }  // namespace vart
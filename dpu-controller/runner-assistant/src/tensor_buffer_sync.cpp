@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/assistant/tensor_buffer_sync.hpp"
+
+#include <glog/logging.h>
+
+#include <atomic>
+
+#include "./sync_ranges.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_TENSOR_BUFFER_SYNC, "0");
+
+namespace vart {
+namespace assistant {
+static std::atomic<uint64_t> num_of_device_writes{0u};
+static std::atomic<uint64_t> num_of_syncs{0u};
+static std::atomic<uint64_t> bytes_synced{0u};
+static std::atomic<uint64_t> bytes_skipped{0u};
+
+void notify_device_write() {
+  auto n = ++num_of_device_writes;
+  if (ENV_PARAM(DEBUG_TENSOR_BUFFER_SYNC)) {
+    // since the previous device write, i.e. per inference.
+    static std::atomic<uint64_t> last_synced{0u};
+    static std::atomic<uint64_t> last_skipped{0u};
+    static std::atomic<uint64_t> last_syncs{0u};
+    auto synced = bytes_synced.load();
+    auto skipped = bytes_skipped.load();
+    auto syncs = num_of_syncs.load();
+    LOG(INFO) << "device write #" << n << ": "
+              << syncs - last_syncs.exchange(syncs) << " syncs, "
+              << synced - last_synced.exchange(synced) << " bytes synced, "
+              << skipped - last_skipped.exchange(skipped)
+              << " bytes skipped";
+  }
+}
+
+TensorBufferSyncStat get_tensor_buffer_sync_stat() {
+  return TensorBufferSyncStat{num_of_device_writes.load(),
+                              num_of_syncs.load(), bytes_synced.load(),
+                              bytes_skipped.load()};
+}
+
+void add_tensor_buffer_sync_stat(uint64_t syncs, uint64_t synced,
+                                 uint64_t skipped) {
+  num_of_syncs += syncs;
+  bytes_synced += synced;
+  bytes_skipped += skipped;
+}
+}  // namespace assistant
+}  // namespace vart
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// checks which syncs of a host-phy tensor buffer reach its buffer objects.
+// the buffer objects are mocks in host memory which record their syncs. run
+// it with XLNX_ENABLE_SYNC_TRACKING=1 as well, to check the tracking.
+#include <glog/logging.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <xir/buffer_object.hpp>
+#include <xir/tensor/tensor.hpp>
+
+#include "../src/tensor_buffer_imp_host_phy.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/with_injection.hpp"
+
+DEF_ENV_PARAM(XLNX_ENABLE_SYNC_TRACKING, "0");
+
+struct sync_t {
+  bool write;
+  size_t bo;
+  uint64_t offset;
+  size_t size;
+  bool operator==(const sync_t& other) const {
+    return write == other.write && bo == other.bo && offset == other.offset &&
+           size == other.size;
+  }
+};
+static std::vector<sync_t> g_syncs;
+
+class MockBufferObject : public xir::BufferObject {
+ public:
+  explicit MockBufferObject(size_t size, size_t device_id,
+                            const std::string& cu_name)
+      : id_{num_of_created++}, data_(size) {}
+  virtual ~MockBufferObject() = default;
+
+  virtual size_t size() override { return data_.size(); }
+  virtual void* data_w() override { return data_.data(); }
+  virtual const void* data_r() const override { return data_.data(); }
+  virtual uint64_t phy(size_t offset) override {
+    return (uint64_t)data_.data() + offset;
+  }
+  virtual void sync_for_read(uint64_t offset, size_t size) override {
+    CHECK_LE(offset + size, data_.size());
+    g_syncs.push_back(sync_t{false, id_, offset, size});
+  }
+  virtual void sync_for_write(uint64_t offset, size_t size) override {
+    CHECK_LE(offset + size, data_.size());
+    g_syncs.push_back(sync_t{true, id_, offset, size});
+  }
+  virtual void copy_from_host(const void* buf, size_t size,
+                              size_t offset) override {
+    memcpy(&data_[offset], buf, size);
+  }
+  virtual void copy_to_host(void* buf, size_t size, size_t offset) override {
+    memcpy(buf, &data_[offset], size);
+  }
+
+ public:
+  static size_t num_of_created;
+
+ private:
+  size_t id_;
+  std::vector<char> data_;
+};
+size_t MockBufferObject::num_of_created = 0u;
+
+// prior to the device backends
+REGISTER_INJECTION_BEGIN(xir::BufferObject, 100, MockBufferObject, size_t&,
+                         size_t&, const std::string&) {
+  return true;
+}
+REGISTER_INJECTION_END
+
+static std::string to_string(const std::vector<sync_t>& v) {
+  std::ostringstream str;
+  for (auto& s : v) {
+    str << (s.write ? " write" : " read") << " bo " << s.bo << " ["
+        << s.offset << "," << s.offset + s.size << ")";
+  }
+  return str.str();
+}
+
+// the syncs recorded since the previous call
+static std::vector<sync_t> take_syncs() {
+  auto ret = std::vector<sync_t>();
+  ret.swap(g_syncs);
+  return ret;
+}
+
+using v = std::vector<sync_t>;
+const int size = 1000;
+
+// without tracking every sync_for_write() reaches every buffer object, a
+// pointer kept from an earlier data() call is flushed as well.
+static void test_untracked(vart::TensorBuffer* tb) {
+  tb->data({0, 100});
+  for (auto i = 0; i < 2; ++i) {
+    tb->sync_for_write(0u, size);
+    auto syncs = take_syncs();
+    CHECK(syncs == (v{{true, 0u, 0u, 1000u}, {true, 1u, 0u, 1000u}}))
+        << to_string(syncs);
+  }
+}
+
+// only the ranges handed out by data() since they were flushed are flushed
+static void test_tracked(vart::TensorBuffer* tb) {
+  // only the range handed out by data() is flushed, and only once
+  tb->data({0, 100});
+  tb->sync_for_write(0u, size);
+  auto syncs = take_syncs();
+  CHECK(syncs == (v{{true, 0u, 100u, 900u}})) << to_string(syncs);
+  tb->sync_for_write(0u, size);
+  syncs = take_syncs();
+  CHECK(syncs.empty()) << to_string(syncs);
+
+  // a partial flush leaves the rest of the range written
+  tb->data({1, 0});
+  tb->sync_for_write(0u, 500u);
+  syncs = take_syncs();
+  CHECK(syncs == (v{{true, 1u, 0u, 500u}})) << to_string(syncs);
+  tb->sync_for_write(0u, size);
+  syncs = take_syncs();
+  CHECK(syncs == (v{{true, 1u, 500u, 500u}})) << to_string(syncs);
+
+  // copy_from_host() flushes by itself
+  auto buf = std::vector<char>(size, 1);
+  tb->copy_from_host(0u, buf.data(), buf.size(), 0u);
+  tb->sync_for_write(0u, size);
+  syncs = take_syncs();
+  CHECK(syncs.empty()) << to_string(syncs);
+}
+
+int main(int argc, char* argv[]) {
+  auto tensor = xir::Tensor::create("t", {2, size},
+                                    xir::DataType{xir::DataType::XINT, 8});
+  auto imp = std::make_unique<vart::dpu::TensorBufferExtImpHostPhy>(
+      tensor.get(), vart::TensorBuffer::location_t::HOST_PHY, 0u, "DPU",
+      nullptr);
+  vart::TensorBuffer* tb = imp.get();
+  CHECK_EQ(MockBufferObject::num_of_created, 2u);
+  if (ENV_PARAM(XLNX_ENABLE_SYNC_TRACKING)) {
+    test_tracked(tb);
+  } else {
+    test_untracked(tb);
+  }
+
+  // every sync_for_read() reaches the buffer objects, there might be writers
+  // other than the dpu, e.g. a softmax cu
+  for (auto i = 0; i < 2; ++i) {
+    tb->sync_for_read(0u, size);
+    auto syncs = take_syncs();
+    CHECK(syncs == (v{{false, 0u, 0u, 1000u}, {false, 1u, 0u, 1000u}}))
+        << to_string(syncs);
+  }
+  std::cout << "test_host_phy_sync PASS" << std::endl;
+  return 0;
+}
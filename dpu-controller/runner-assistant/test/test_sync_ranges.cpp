@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <iostream>
+#include <sstream>
+
+#include "../src/sync_ranges.hpp"
+
+using vart::assistant::SyncRanges;
+using range_list_t = std::vector<SyncRanges::range_t>;
+
+static std::string to_string(const range_list_t& v) {
+  std::ostringstream str;
+  str << "{";
+  for (auto& r : v) {
+    str << " [" << r.first << "," << r.second << ")";
+  }
+  str << " }";
+  return str.str();
+}
+
+int main(int argc, char* argv[]) {
+  auto ranges = SyncRanges();
+  ranges.add(100u, 200u);
+  ranges.add(300u, 400u);
+  ranges.add(0u, 50u);
+  CHECK_EQ(ranges.ranges().size(), 3u) << to_string(ranges.ranges());
+  // adjacent and overlapping ranges are merged
+  ranges.add(200u, 250u);
+  ranges.add(240u, 310u);
+  CHECK(ranges.ranges() == (range_list_t{{0u, 50u}, {100u, 400u}}))
+      << to_string(ranges.ranges());
+  ranges.add(10u, 20u);
+  CHECK(ranges.ranges() == (range_list_t{{0u, 50u}, {100u, 400u}}))
+      << to_string(ranges.ranges());
+  ranges.add(5u, 5u);
+  CHECK_EQ(ranges.ranges().size(), 2u) << to_string(ranges.ranges());
+
+  CHECK(ranges.intersect(40u, 150u) ==
+        (range_list_t{{40u, 50u}, {100u, 150u}}))
+      << to_string(ranges.intersect(40u, 150u));
+  CHECK(ranges.intersect(50u, 100u).empty());
+  CHECK(ranges.subtract(40u, 150u) == (range_list_t{{50u, 100u}}))
+      << to_string(ranges.subtract(40u, 150u));
+  CHECK(ranges.subtract(0u, 500u) == (range_list_t{{50u, 100u}, {400u, 500u}}))
+      << to_string(ranges.subtract(0u, 500u));
+  CHECK(ranges.subtract(120u, 130u).empty());
+
+  // removing splits and trims ranges
+  ranges.remove(120u, 130u);
+  ranges.remove(30u, 110u);
+  CHECK(ranges.ranges() ==
+        (range_list_t{{0u, 30u}, {110u, 120u}, {130u, 400u}}))
+      << to_string(ranges.ranges());
+  ranges.remove(0u, 400u);
+  CHECK(ranges.empty()) << to_string(ranges.ranges());
+
+  ranges.add(0u, 1000u);
+  CHECK(ranges.ranges() == (range_list_t{{0u, 1000u}}))
+      << to_string(ranges.ranges());
+  ranges.clear();
+  CHECK(ranges.empty());
+  CHECK(ranges.subtract(0u, 10u) == (range_list_t{{0u, 10u}}));
+  std::cout << "test_sync_ranges PASS" << std::endl;
+  return 0;
+}
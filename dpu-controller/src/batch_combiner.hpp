@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace xir {
+
+/**
+ * @brief coalesces requests of concurrent callers into batches.
+ *
+ * submit() queues a request and blocks until the batch holding it has run.
+ * There is no worker thread, the first waiting caller becomes the combiner
+ * and runs batches on behalf of the others until its own request is done,
+ * requests arriving meanwhile are picked up by the next batch. The callers
+ * still waiting then elect a new combiner.
+ *
+ * A batch starts with the oldest request, the others join it in queue order
+ * if accept() allows, the rest keep their place. If run() throws, every
+ * request of the batch fails with the exception, it is rethrown by submit()
+ * in each caller, and the combiner steps down as usual.
+ */
+template <typename Request>
+class BatchCombiner {
+ public:
+  /// whether request may join batch, which is never empty
+  using accept_t = std::function<bool(const std::vector<Request*>& batch,
+                                      const Request* request)>;
+  using run_t = std::function<void(const std::vector<Request*>& batch)>;
+
+  explicit BatchCombiner(accept_t accept, run_t run)
+      : accept_{std::move(accept)}, run_{std::move(run)} {}
+  BatchCombiner(const BatchCombiner& other) = delete;
+  BatchCombiner& operator=(const BatchCombiner& rhs) = delete;
+
+ public:
+  void submit(Request* request) {
+    auto entry = entry_t{request, false, nullptr};
+    std::unique_lock<std::mutex> lock(mutex_);
+    queue_.push_back(&entry);
+    while (!entry.done) {
+      if (combining_) {
+        cv_.wait(lock);
+        continue;
+      }
+      combining_ = true;
+      // step down even if run() throws, otherwise the others wait forever
+      auto guard = step_down_t{this};
+      while (!entry.done) {
+        auto batch = take_batch();
+        auto requests = std::vector<Request*>(batch.size());
+        for (auto i = 0u; i < batch.size(); ++i) {
+          requests[i] = batch[i]->request;
+        }
+        auto error = std::exception_ptr();
+        lock.unlock();
+        try {
+          run_(requests);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        lock.lock();
+        for (auto e : batch) {
+          e->error = error;
+          e->done = true;
+        }
+        cv_.notify_all();
+      }
+    }
+    if (entry.error) {
+      std::rethrow_exception(entry.error);
+    }
+  }
+
+ private:
+  struct entry_t {
+    Request* request;
+    bool done;
+    std::exception_ptr error;
+  };
+
+  // called with mutex_ held, so it resets combining_ under the lock
+  struct step_down_t {
+    BatchCombiner* self;
+    ~step_down_t() {
+      self->combining_ = false;
+      self->cv_.notify_all();
+    }
+  };
+
+  std::vector<entry_t*> take_batch() {
+    auto ret = std::vector<entry_t*>{queue_.front()};
+    auto requests = std::vector<Request*>{queue_.front()->request};
+    queue_.pop_front();
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (accept_(requests, (*it)->request)) {
+        ret.push_back(*it);
+        requests.push_back((*it)->request);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    return ret;
+  }
+
+ private:
+  const accept_t accept_;
+  const run_t run_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<entry_t*> queue_;
+  bool combining_ = false;
+};
+
+}  // namespace xir
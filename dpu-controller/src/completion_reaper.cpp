@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "./completion_reaper.hpp"
+
+#include <glog/logging.h>
+
+#include <vitis/ai/env_config.hpp>
+
+DEF_ENV_PARAM(DEBUG_COMPLETION_REAPER, "0");
+
+namespace xir {
+
+CompletionReaper::CompletionReaper(std::unique_ptr<Backend> backend)
+    : backend_{std::move(backend)}, cus_{}, stop_{false} {
+  auto num_of_cu = backend_->get_num_of_cu();
+  cus_.reserve(num_of_cu);
+  for (auto i = 0u; i < num_of_cu; ++i) {
+    cus_.emplace_back(std::make_unique<cu_t>());
+  }
+  for (auto i = 0u; i < num_of_cu; ++i) {
+    cus_[i]->thread = std::thread([this, i]() { reap(i); });
+  }
+}
+
+CompletionReaper::~CompletionReaper() {
+  // running commands are waited for, queued jobs are cancelled.
+  for (auto i = 0u; i < cus_.size(); ++i) {
+    cancel(i);
+  }
+  stop_ = true;
+  for (auto& cu : cus_) {
+    {
+      std::lock_guard<std::mutex> lock(cu->mtx);
+      cu->cv.notify_all();
+    }
+    cu->thread.join();
+  }
+}
+
+std::future<CompletionReaper::status_t> CompletionReaper::submit(
+    size_t cu_idx, job_t job) {
+  CHECK_LT(cu_idx, cus_.size()) << "invalid cu index";
+  auto& cu = *cus_[cu_idx];
+  auto pending = pending_t{std::move(job), std::promise<status_t>()};
+  auto ret = pending.promise.get_future();
+  {
+    std::lock_guard<std::mutex> lock(cu.mtx);
+    cu.queue.emplace_back(std::move(pending));
+    cu.cv.notify_one();
+  }
+  return ret;
+}
+
+size_t CompletionReaper::cancel(size_t cu_idx) {
+  CHECK_LT(cu_idx, cus_.size()) << "invalid cu index";
+  auto& cu = *cus_[cu_idx];
+  std::deque<pending_t> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(cu.mtx);
+    cancelled.swap(cu.queue);
+  }
+  for (auto& pending : cancelled) {
+    finish(cu_idx, pending, status_t::CANCELLED);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_COMPLETION_REAPER) && !cancelled.empty())
+      << "cu " << cu_idx << " cancelled " << cancelled.size() << " jobs";
+  return cancelled.size();
+}
+
+bool CompletionReaper::is_stuck(size_t cu_idx) const {
+  CHECK_LT(cu_idx, cus_.size()) << "invalid cu index";
+  std::lock_guard<std::mutex> lock(cus_[cu_idx]->mtx);
+  return cus_[cu_idx]->stuck;
+}
+
+size_t CompletionReaper::get_num_of_cu() const { return cus_.size(); }
+
+void CompletionReaper::reap(size_t cu_idx) {
+  auto& cu = *cus_[cu_idx];
+  for (;;) {
+    pending_t pending;
+    {
+      std::unique_lock<std::mutex> lock(cu.mtx);
+      cu.cv.wait(lock, [this, &cu]() { return stop_ || !cu.queue.empty(); });
+      if (cu.queue.empty()) {
+        return;
+      }
+      pending = std::move(cu.queue.front());
+      cu.queue.pop_front();
+    }
+    auto status = status_t::ERROR;
+    try {
+      status = execute(cu_idx, pending.job);
+    } catch (...) {
+      // e.g. prepare throws, the command is not started.
+      pending.promise.set_exception(std::current_exception());
+      continue;
+    }
+    finish(cu_idx, pending, status);
+  }
+}
+
+CompletionReaper::status_t CompletionReaper::execute(size_t cu_idx,
+                                                     job_t& job) {
+  auto& cu = *cus_[cu_idx];
+  if (clock_t::now() >= job.deadline) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_COMPLETION_REAPER))
+        << "cu " << cu_idx << " deadline passed before the job is started";
+    return status_t::TIMEOUT;
+  }
+  auto stuck = false;
+  {
+    std::lock_guard<std::mutex> lock(cu.mtx);
+    stuck = cu.stuck;
+  }
+  if (stuck) {
+    if (backend_->wait(cu_idx, std::chrono::milliseconds(0)) ==
+        state_t::RUNNING) {
+      LOG_IF(INFO, ENV_PARAM(DEBUG_COMPLETION_REAPER))
+          << "cu " << cu_idx << " is stuck, the job is rejected";
+      return status_t::REJECTED;
+    }
+    LOG(WARNING) << "cu " << cu_idx << " recovered, the stuck command is done";
+    std::lock_guard<std::mutex> lock(cu.mtx);
+    cu.stuck = false;
+  }
+  job.prepare(cu_idx);
+  backend_->start(cu_idx);
+  auto start = clock_t::now();
+  auto expire = job.deadline;
+  if (expire - start > job.timeout) {
+    expire = start + job.timeout;
+  }
+  // the wait ends on completion, XRT has no event to multiplex, so the
+  // command is waited for with the time left, not in fixed slices.
+  auto state = state_t::RUNNING;
+  for (;;) {
+    auto left = std::chrono::ceil<std::chrono::milliseconds>(expire -
+                                                             clock_t::now());
+    state = backend_->wait(cu_idx, std::max(left, decltype(left)::zero()));
+    if (state != state_t::RUNNING || clock_t::now() >= expire) {
+      break;
+    }
+  }
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                clock_t::now() - start)
+                .count();
+  if (state == state_t::COMPLETED) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_COMPLETION_REAPER) >= 2)
+        << "cu " << cu_idx << " completed in " << us << "us";
+    return status_t::COMPLETED;
+  } else if (state == state_t::ERROR) {
+    LOG(WARNING) << "cu " << cu_idx << " failed in " << us << "us";
+    return status_t::ERROR;
+  }
+  auto aborted = backend_->abort(cu_idx);
+  LOG(WARNING) << "cu " << cu_idx << " timeout after " << us << "us"
+               << (aborted ? ", aborted" : ", cannot abort, marked stuck");
+  if (!aborted) {
+    std::lock_guard<std::mutex> lock(cu.mtx);
+    cu.stuck = true;
+  }
+  return status_t::TIMEOUT;
+}
+
+void CompletionReaper::finish(size_t cu_idx, pending_t& pending,
+                              status_t status) {
+  if (pending.job.on_done) {
+    pending.job.on_done(cu_idx, status);
+  }
+  pending.promise.set_value(status);
+}
+
+}  // namespace xir
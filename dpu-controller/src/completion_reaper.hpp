@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xir {
+
+/**
+ * @brief completion of commands on a set of compute units.
+ *
+ * A CU runs one command at a time, so every CU has a queue of submitted
+ * jobs and a completion thread. The thread prepares and starts the job at
+ * the head of the queue, waits for it with the time left to its deadline,
+ * and reports the status through the job's callback and the future returned
+ * by submit(). Submitting does not block on the device, any number of jobs
+ * may be in flight.
+ *
+ * A command which is not done at its deadline is aborted and reported as
+ * TIMEOUT. If the backend cannot abort it, the CU is marked stuck, the jobs
+ * behind it are not started and fail with REJECTED until the stuck command
+ * is found done.
+ */
+class CompletionReaper {
+ public:
+  // only COMPLETED and ERROR jobs were started, REJECTED ones were not, as
+  // the CU is stuck.
+  enum class status_t { COMPLETED, ERROR, TIMEOUT, CANCELLED, REJECTED };
+  enum class state_t { RUNNING, COMPLETED, ERROR };
+  using clock_t = std::chrono::steady_clock;
+
+  /// how commands are issued to the CUs, i.e. XRT or a mock in tests. Only
+  /// the completion thread of a CU calls the backend for that CU.
+  class Backend {
+   public:
+    explicit Backend() = default;
+    virtual ~Backend() = default;
+    Backend(const Backend& other) = delete;
+    Backend& operator=(const Backend& rhs) = delete;
+
+   public:
+    virtual size_t get_num_of_cu() const = 0;
+    virtual void start(size_t cu_idx) = 0;
+    /// wait at most `timeout` for the command on the CU, timeout may be 0.
+    virtual state_t wait(size_t cu_idx, std::chrono::milliseconds timeout) = 0;
+    /// abort the running command, true if the CU is idle afterwards.
+    virtual bool abort(size_t cu_idx) = 0;
+  };
+
+  struct job_t {
+    /// called on the completion thread right before the command is started.
+    std::function<void(size_t cu_idx)> prepare;
+    /// optional, called on the completion thread when the job is done,
+    /// before the next command is prepared on the CU.
+    std::function<void(size_t cu_idx, status_t status)> on_done;
+    /// the time the command may run once it is started on the CU.
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(10000);
+    /// a job still queued at its deadline is not started, the running
+    /// command is aborted at min(deadline, start + timeout).
+    clock_t::time_point deadline = clock_t::time_point::max();
+  };
+
+ public:
+  explicit CompletionReaper(std::unique_ptr<Backend> backend);
+  virtual ~CompletionReaper();
+  CompletionReaper(const CompletionReaper& other) = delete;
+  CompletionReaper& operator=(const CompletionReaper& rhs) = delete;
+
+ public:
+  std::future<status_t> submit(size_t cu_idx, job_t job);
+  /// the queued jobs of the CU are reported as CANCELLED, the running one
+  /// is not affected. returns the number of cancelled jobs.
+  size_t cancel(size_t cu_idx);
+  bool is_stuck(size_t cu_idx) const;
+  size_t get_num_of_cu() const;
+  Backend* get_backend() const { return backend_.get(); }
+
+ private:
+  struct pending_t {
+    job_t job;
+    std::promise<status_t> promise;
+  };
+  struct cu_t {
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<pending_t> queue;
+    bool stuck = false;
+    std::thread thread;
+  };
+  void reap(size_t cu_idx);
+  status_t execute(size_t cu_idx, job_t& job);
+  static void finish(size_t cu_idx, pending_t& pending, status_t status);
+
+ private:
+  std::unique_ptr<Backend> backend_;
+  std::vector<std::unique_ptr<cu_t>> cus_;
+  std::atomic<bool> stop_;
+};
+
+}  // namespace xir
@@ -19,7 +19,9 @@
 #include <ert.h>
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <bitset>
+#include <cstring>
 #include <iostream>
 #include <mutex>
 #include <vitis/ai/env_config.hpp>
@@ -30,12 +32,14 @@
 DEF_ENV_PARAM(DEBUG_DPU_CONTROLLER, "0");
 DEF_ENV_PARAM(DISABLE_DPU_CONTROLLER_XRT, "0");
 DEF_ENV_PARAM(XLNX_SHOW_DPU_COUNTER, "0");
+DEF_ENV_PARAM(XLNX_ENABLE_DPU_METRICS, "0");
 
 DEF_ENV_PARAM(DEBUG_AP_START_CU, "0");
 
 DpuControllerXrtEdge::DpuControllerXrtEdge(std::unique_ptr<xir::XrtCu>&& xrt_cu)
     : xir::DpuController{},  //
-      xrt_cu_{std::move(xrt_cu)} {
+      xrt_cu_{std::move(xrt_cu)},
+      ecmd_templates_(xrt_cu_->get_num_of_cu()) {
   for (size_t i = 0; i < get_num_of_dpus(); i++) {
     auto cu_device_id = xrt_cu_->get_device_id(i);
     auto cu_name = xrt_cu_->get_instance_name(i);
@@ -94,6 +98,45 @@ std::string DpuControllerXrtEdge::xdpu_get_counter(size_t device_core_id) {
   return str.str();
 }
 
+DpuControllerXrtEdge::Counter DpuControllerXrtEdge::read_counter(
+    size_t device_core_id) const {
+  auto read = [this, device_core_id](uint32_t addr) -> uint64_t {
+    return xrt_cu_->read_register(device_core_id, addr);
+  };
+  auto ret = Counter{};
+  ret.load_start = read(0x180);
+  ret.load_end = read(0x184);
+  ret.conv_start = read(0x188);
+  ret.conv_end = read(0x18C);
+  ret.save_start = read(0x190);
+  ret.save_end = read(0x194);
+  ret.misc_start = read(0x198);
+  ret.misc_end = read(0x19C);
+  ret.cycle = get_device_hwconuter(device_core_id);
+  return ret;
+}
+
+namespace {
+// run() is blocking, the counters are captured on the calling thread right
+// after the run is done, before another run on the same core is started.
+struct last_counter_t {
+  size_t device_core_id;
+  bool valid;
+  xir::DpuController::Counter counter;
+};
+}  // namespace
+static thread_local last_counter_t last_counter = {0u, false, {}};
+
+bool DpuControllerXrtEdge::get_last_counter(size_t device_core_id,
+                                            Counter& counter) const {
+  device_core_id = device_core_id % xrt_cu_->get_num_of_cu();
+  if (!last_counter.valid || last_counter.device_core_id != device_core_id) {
+    return false;
+  }
+  counter = last_counter.counter;
+  return true;
+}
+
 static std::string dump_gen_reg(const std::vector<uint64_t>& gen_reg) {
   std::ostringstream str;
   str << std::hex;
@@ -109,6 +152,86 @@ static bool check_reg_addr(uint64_t addr) {
   return false;
 }
 
+static void set_addr(std::vector<uint32_t>& data, size_t slot,
+                     size_t hi_offset, uint64_t addr) {
+  data[slot] = addr & 0xFFFFFFFF;
+  data[slot + hi_offset] = (addr >> 32) & 0xFFFFFFFF;
+}
+
+static void check_gen_reg(const std::vector<uint64_t>& gen_reg, size_t i) {
+  CHECK(check_reg_addr(gen_reg[i]))                             //
+      << "invalid gen_reg 0x" << std::hex << gen_reg[i]         //
+      << std::dec << " at reg_id=" << i                         //
+      << ", only the low 40bits of physical address are valid"  //
+      << ", high 24bits should be 0";
+}
+
+void DpuControllerXrtEdge::build_ecmd_template(ecmd_template_t& t,
+                                               size_t num_of_regs) {
+  if (ENV_PARAM(DEBUG_AP_START_CU)) {
+    // registers are written at their own word offset.
+    t.opcode = ERT_START_CU;
+    t.count = 39;  // 1 + rsz;
+    t.code_slot = XDPU_CONTROL_ADDR_INSTR_L / 4;
+    t.reg_slot = XDPU_CONTROL_ADDR_0_L / 4;
+    t.hi_offset = 1u;
+    t.reg_stride = 2u;
+    t.data.assign(
+        std::max((size_t)t.count, t.reg_slot + num_of_regs * t.reg_stride),
+        0u);
+    t.data[XDPU_CONTROL_AP] = 0x0;
+    t.data[XDPU_CONTROL_IER / 4] =
+        0x1;  // must enable this, otherwise, DPU can only used once.
+    t.data[XDPU_CONTROL_PROF_ENA / 4] = 0x1;
+    t.data[1] = 0x1;  // GLBL_IRQ_ENA(Global Interrupt Enable Register)
+    t.data[2] = 0x1;  // IP_IRQ_ENA(IP Interrupt Enable Register)
+    t.data[3] = 0x0;  // IP_IRQ_STS(IP Interrupt Status Register)
+    t.data[XDPU_CONTROL_HP / 4] = 0x07070f0f;
+  } else {
+    // (register offset, value) pairs.
+    t.opcode = ERT_EXEC_WRITE;
+    t.data.clear();
+    t.data.insert(t.data.end(), {0x40, 1});  // CLEAR INTERRUPT
+    t.data.insert(t.data.end(), {0x44, 1});  // PROF_EN= 0 or 1
+    t.data.insert(t.data.end(), {XDPU_CONTROL_HP, 0x07070f0f});
+    t.code_slot = t.data.size() + 1u;
+    t.data.insert(t.data.end(), {XDPU_CONTROL_ADDR_INSTR_L, 0u,
+                                 XDPU_CONTROL_ADDR_INSTR_H, 0u});
+    t.reg_slot = t.data.size() + 1u;
+    t.hi_offset = 2u;
+    t.reg_stride = 4u;
+    auto offset = XDPU_CONTROL_ADDR_0_L / 4;
+    for (auto i = 0u; i < num_of_regs; ++i) {
+      t.data.insert(t.data.end(),
+                    {(uint32_t)offset * 4, 0u, (uint32_t)(offset + 1) * 4, 0u});
+      offset = offset + 2;
+    }
+    t.count = (uint32_t)t.data.size() + 1u;
+  }
+  t.code = 0u;
+  t.gen_reg.assign(num_of_regs, 0u);
+}
+
+void DpuControllerXrtEdge::update_ecmd_template(
+    ecmd_template_t& t, uint64_t code, const std::vector<uint64_t>& gen_reg) {
+  auto num_of_regs = std::min(gen_reg.size(), (size_t)8u);
+  auto rebuild = t.data.empty() || t.gen_reg.size() != num_of_regs;
+  if (rebuild) {
+    build_ecmd_template(t, num_of_regs);
+  }
+  if (rebuild || t.code != code) {
+    set_addr(t.data, t.code_slot, t.hi_offset, code);
+    t.code = code;
+  }
+  for (auto i = 0u; i < num_of_regs; ++i) {
+    if (rebuild || t.gen_reg[i] != gen_reg[i]) {
+      check_gen_reg(gen_reg, i);
+      set_addr(t.data, t.reg_slot + i * t.reg_stride, t.hi_offset, gen_reg[i]);
+      t.gen_reg[i] = gen_reg[i];
+    }
+  }
+}
+
 void DpuControllerXrtEdge::run(size_t core_idx, const uint64_t code,
                                const std::vector<uint64_t>& gen_reg) {
   static std::vector<std::mutex> mutexes(xrt_cu_->get_num_of_cu());
@@ -123,70 +246,15 @@ void DpuControllerXrtEdge::run(size_t core_idx, const uint64_t code,
       << "core_idx " << core_idx << " "                    //
       << "gen_reg: " << dump_gen_reg(gen_reg) << std::dec  //
       ;
-  auto func = [code, &gen_reg](ert_start_kernel_cmd* ecmd) -> void {
-    if (ENV_PARAM(DEBUG_AP_START_CU)) {
-      // auto rsz = 66;
-      ecmd->state = ERT_CMD_STATE_NEW;
-      ecmd->opcode = ERT_START_CU;
-      ecmd->count = 39;  // 1 + rsz;
-      ecmd->data[XDPU_CONTROL_AP] = 0x0;
-      ecmd->data[XDPU_CONTROL_IER / 4] =
-          0x1;  // must enable this, otherwise, DPU can only used once.
-      ecmd->data[XDPU_CONTROL_PROF_ENA / 4] = 0x1;
-      ecmd->data[1] = 0x1;  // GLBL_IRQ_ENA(Global Interrupt Enable Register)
-      ecmd->data[2] = 0x1;  // IP_IRQ_ENA(IP Interrupt Enable Register)
-      ecmd->data[3] = 0x0;  // IP_IRQ_STS(IP Interrupt Status Register)
-
-      ecmd->data[XDPU_CONTROL_HP / 4] = 0x07070f0f;
-
-      ecmd->data[XDPU_CONTROL_ADDR_INSTR_L / 4] = code & 0xFFFFFFFF;
-      ecmd->data[XDPU_CONTROL_ADDR_INSTR_L / 4 + 1] = (code >> 32) & 0xFFFFFFFF;
-      auto offset = XDPU_CONTROL_ADDR_0_L / 4;
-      auto size = 8u;
-      for (auto i = 0u; i < gen_reg.size() && i < size; ++i) {
-        CHECK(check_reg_addr(gen_reg[i]))                             //
-            << "invalid gen_reg 0x" << std::hex << gen_reg[i]         //
-            << std::dec << " at reg_id=" << i                         //
-            << ", only the low 40bits of physical address are valid"  //
-            << ", high 24bits should be 0";
-        ecmd->data[offset] = gen_reg[i] & 0xFFFFFFFF;
-        ecmd->data[offset + 1] = (gen_reg[i] >> 32) & 0xFFFFFFFF;
-        offset = offset + 2;
-      }
-    } else {
-      ecmd->state = ERT_CMD_STATE_NEW;
-      ecmd->opcode = ERT_EXEC_WRITE;
-      auto p = ecmd->extra_cu_masks;
-
-      ecmd->data[p++] = 0x40;  // CLEAR INTERRUPT
-      ecmd->data[p++] = 1;
-      ecmd->data[p++] = 0x44;  // PROF_EN= 0 or 1
-      ecmd->data[p++] = 1;
-
-      ecmd->data[p++] = XDPU_CONTROL_HP;
-      ecmd->data[p++] = 0x07070f0f;
-
-      ecmd->data[p++] = XDPU_CONTROL_ADDR_INSTR_L;
-      ecmd->data[p++] = code & 0xFFFFFFFF;
-      ecmd->data[p++] = XDPU_CONTROL_ADDR_INSTR_H;
-      ecmd->data[p++] = (code >> 32) & 0xFFFFFFFF;
-
-      auto offset = XDPU_CONTROL_ADDR_0_L / 4;
-      auto size = 8u;
-      for (auto i = 0u; i < gen_reg.size() && i < size; ++i) {
-        CHECK(check_reg_addr(gen_reg[i]))                             //
-            << "invalid gen_reg 0x" << std::hex << gen_reg[i]         //
-            << std::dec << " at reg_id=" << i                         //
-            << ", only the low 40bits of physical address are valid"  //
-            << ", high 24bits should be 0";
-        ecmd->data[p++] = offset * 4;
-        ecmd->data[p++] = gen_reg[i] & 0xFFFFFFFF;
-        ecmd->data[p++] = (offset + 1) * 4;
-        ecmd->data[p++] = (gen_reg[i] >> 32) & 0xFFFFFFFF;
-        offset = offset + 2;
-      }
-      ecmd->count = p + 1;
-    }
+  last_counter.valid = false;
+  auto& t = ecmd_templates_[core_idx];
+  update_ecmd_template(t, code, gen_reg);
+  auto func = [&t](ert_start_kernel_cmd* ecmd) -> void {
+    ecmd->state = ERT_CMD_STATE_NEW;
+    ecmd->opcode = t.opcode;
+    auto p = t.opcode == ERT_EXEC_WRITE ? ecmd->extra_cu_masks : 0u;
+    memcpy(&ecmd->data[p], t.data.data(), t.data.size() * sizeof(uint32_t));
+    ecmd->count = p + t.count;
   };
 #ifndef _WIN32
   vitis::ai::trace::add_trace("dpu-controller", vitis::ai::trace::func_start,
@@ -196,6 +264,11 @@ void DpuControllerXrtEdge::run(size_t core_idx, const uint64_t code,
       core_idx, func,
       // on_success
       [core_idx, this]() -> void {
+        if (ENV_PARAM(XLNX_ENABLE_DPU_METRICS)) {
+          last_counter.device_core_id = core_idx;
+          last_counter.valid = true;
+          last_counter.counter = read_counter(core_idx);
+        }
         if (ENV_PARAM(XLNX_SHOW_DPU_COUNTER)) {
           std::cout << "core_idx = " << core_idx << " "
                     << xdpu_get_counter(core_idx) << std::endl;
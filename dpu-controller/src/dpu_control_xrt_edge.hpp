@@ -15,7 +15,9 @@
  * limitations under the License.
  */
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "./xrt_cu.hpp"
 #include "xir/dpu_controller.hpp"
@@ -39,11 +41,39 @@ class DpuControllerXrtEdge : public xir::DpuController {
   virtual std::string get_full_name(size_t device_core_id) const override;
   virtual std::string get_kernel_name(size_t device_core_id) const override;
   virtual std::string get_instance_name(size_t device_core_id) const override;
+  virtual bool get_last_counter(size_t device_core_id,
+                                Counter& counter) const override;
 
  private:
   std::string xdpu_get_counter(size_t device_core_id);
+  Counter read_counter(size_t device_core_id) const;
   virtual uint64_t get_device_hwconuter(size_t device_core_id) const override;
 
+ private:
+  // the ecmd payload of a core. static words are written once, and only
+  // the code and base address slots which changed since the previous run,
+  // e.g. another session is run on the same core, are patched.
+  struct ecmd_template_t {
+    uint32_t opcode;
+    // ecmd->count, without extra cu masks.
+    uint32_t count;
+    std::vector<uint32_t> data;
+    // slot of the low word of the code address and of gen_reg[0], the
+    // high word is `hi_offset` words behind, and gen_reg[i] is `reg_stride`
+    // words behind gen_reg[i-1].
+    size_t code_slot;
+    size_t reg_slot;
+    size_t hi_offset;
+    size_t reg_stride;
+    // values in `data` at the moment.
+    uint64_t code;
+    std::vector<uint64_t> gen_reg;
+  };
+  void build_ecmd_template(ecmd_template_t& t, size_t num_of_regs);
+  void update_ecmd_template(ecmd_template_t& t, uint64_t code,
+                            const std::vector<uint64_t>& gen_reg);
+
  private:
   std::unique_ptr<xir::XrtCu> xrt_cu_;
+  std::vector<ecmd_template_t> ecmd_templates_;
 };
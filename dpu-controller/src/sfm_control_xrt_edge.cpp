@@ -25,6 +25,8 @@
 DEF_ENV_PARAM(DEBUG_SFM_RUNNER, "0");
 DEF_ENV_PARAM(XLNX_ENABLE_HW_SMFC, "1");
 DEF_ENV_PARAM_2(XLNX_SMFC_BUFFER_SIZE, "5242880", size_t);
+// coalesce small requests from concurrent callers into one cu run.
+DEF_ENV_PARAM(XLNX_SFM_ENABLE_BATCH, "1");
 #include <ert.h>
 namespace {
 
@@ -64,10 +66,24 @@ SfmControllerXrtEdge::SfmControllerXrtEdge(size_t core_idx,
           ),
       xrt_cu_{std::move(xrt_cu)},
       workspace_{create_workspace(xrt_cu_.get())},
-      mutex_{} {
+      mutex_{},
+      combiner_{[this](const std::vector<request_t*>& batch,
+                       const request_t* request) {
+                  return accept(batch, request);
+                },
+                [this](const std::vector<request_t*>& batch) {
+                  run_batch(batch);
+                }},
+      num_of_requests_{0u},
+      num_of_runs_{0u} {
 }
 
-SfmControllerXrtEdge::~SfmControllerXrtEdge() {}
+SfmControllerXrtEdge::~SfmControllerXrtEdge() {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SFM_RUNNER))
+      << "core_idx " << core_idx_ << " "         //
+      << "requests " << num_of_requests_ << " "  //
+      << "cu runs " << num_of_runs_;
+}
 
 static size_t align(size_t a, size_t b) {
   if (a % b == 0) {
@@ -75,6 +91,31 @@ static size_t align(size_t a, size_t b) {
   }
   return (a / b + 1) * b;
 }
+
+// rows are exCls apart in the workspace and cls apart in user buffers.
+static void copy_rows_in(char* workspace, const int8_t* input,
+                         unsigned int cls, size_t exCls, unsigned int rows) {
+  if (cls == exCls) {
+    memcpy(workspace, input, rows * cls * sizeof(int8_t));
+    return;
+  }
+  for (auto i = 0u; i < rows; ++i) {
+    memcpy(&workspace[exCls * i], &input[cls * i], cls * sizeof(int8_t));
+  }
+}
+
+static void copy_rows_out(float* output, const char* workspace,
+                          unsigned int cls, size_t exCls, unsigned int rows) {
+  if (cls == exCls) {
+    memcpy(output, workspace, rows * cls * sizeof(float));
+    return;
+  }
+  for (auto i = 0u; i < rows; ++i) {
+    memcpy((char*)(&output[cls * i]),
+           &workspace[exCls * i * sizeof(float)], cls * sizeof(float));
+  }
+}
+
 void SfmControllerXrtEdge::run(const int8_t* input, float scale,
                                unsigned int cls, unsigned int group,
                                float* output) {
@@ -84,6 +125,79 @@ void SfmControllerXrtEdge::run(const int8_t* input, float scale,
       << (xrt_cu_ == nullptr ? std::string("N/A")
                              : std::to_string(xrt_cu_->get_num_of_cu()))
       << " ENV_PARAM(XLNX_ENABLE_HW_SMFC) = " << ENV_PARAM(XLNX_ENABLE_HW_SMFC);
+  num_of_requests_++;
+  if (ENV_PARAM(XLNX_SFM_ENABLE_BATCH) == 0 || !fits_in_one_run(cls, group)) {
+    run_direct(input, scale, cls, group, output);
+    return;
+  }
+  int fix_pos = -(int8_t)log2f(scale);
+  auto request = request_t{input, output, cls, group, fix_pos};
+  combiner_.submit(&request);
+}
+
+bool SfmControllerXrtEdge::fits_in_one_run(unsigned int cls,
+                                           unsigned int group) const {
+  auto exCls = align(cls, 4u);
+  auto input_aligned_size = align(exCls * group * sizeof(int8_t), page_size_);
+  auto output_aligned_size = align(exCls * group * sizeof(float), page_size_);
+  return group <= MAX_GROUP &&
+         input_aligned_size + output_aligned_size <= workspace_->size();
+}
+
+bool SfmControllerXrtEdge::accept(const std::vector<request_t*>& batch,
+                                  const request_t* request) const {
+  // requests with the same cls and fix_pos share one run as long as the
+  // rows fit in the workspace.
+  auto first = batch.front();
+  auto rows = request->group;
+  for (auto r : batch) {
+    rows += r->group;
+  }
+  return request->cls == first->cls && request->fix_pos == first->fix_pos &&
+         fits_in_one_run(request->cls, rows);
+}
+
+void SfmControllerXrtEdge::run_batch(const std::vector<request_t*>& batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto cls = batch.front()->cls;
+  auto fix_pos = batch.front()->fix_pos;
+  auto exCls = align(cls, 4u);
+  auto rows = 0u;
+  for (auto r : batch) {
+    rows += r->group;
+  }
+  auto split_offset = align(exCls * rows * sizeof(int8_t), page_size_);
+  auto workspace_input = workspace_->get_w<char>(0);
+  auto workspace_output = workspace_->get_r<char>(split_offset);
+  auto input_phy = workspace_->phy(0);
+  auto output_phy = input_phy + split_offset;
+  // gather all requests into one contiguous input, one run, then scatter
+  // the output rows back to each caller.
+  auto row = 0u;
+  for (auto r : batch) {
+    copy_rows_in(&workspace_input[exCls * row], r->input, cls, exCls,
+                 r->group);
+    row += r->group;
+  }
+  workspace_->sync_for_write(0, exCls * rows * sizeof(int8_t));
+  run_xrt_cu(core_idx_, input_phy, cls, rows, fix_pos, output_phy, 0u);
+  num_of_runs_++;
+  workspace_->sync_for_read(split_offset, exCls * rows * sizeof(float));
+  row = 0u;
+  for (auto r : batch) {
+    copy_rows_out(r->output, &workspace_output[exCls * row * sizeof(float)],
+                  cls, exCls, r->group);
+    row += r->group;
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SFM_RUNNER))
+      << "batch of " << batch.size() << " requests, "  //
+      << "cls " << cls << " "                          //
+      << "rows " << rows;
+}
+
+void SfmControllerXrtEdge::run_direct(const int8_t* input, float scale,
+                                      unsigned int cls, unsigned int group,
+                                      float* output) {
   std::lock_guard<std::mutex> lock(mutex_);
   auto exCls = align(cls, 4u);
   do {
@@ -124,14 +238,7 @@ void SfmControllerXrtEdge::run(const int8_t* input, float scale,
       auto this_output_size = this_batch * exCls * sizeof(float);
       // workspace_input and workspace_output are the actually position on
       // the physical address, they should be set or fetch by the align-rule.
-      if (cls == exCls) {
-        memcpy(workspace_input, r_input, this_input_size);
-      } else {
-        for (auto i = 0u; i < this_batch; ++i) {
-          memcpy(&workspace_input[exCls * i], &r_input[cls * i],
-                 cls * sizeof(int8_t));
-        }
-      }
+      copy_rows_in(workspace_input, r_input, cls, exCls, this_batch);
       workspace_->sync_for_write(0, this_input_size);
       auto xrt_cls = cls;
       auto xrt_batch = this_batch;
@@ -141,6 +248,7 @@ void SfmControllerXrtEdge::run(const int8_t* input, float scale,
       auto xrt_offset = offset;
       run_xrt_cu(core_idx_, xrt_input, xrt_cls, xrt_batch, xrt_fixpos,
                  xrt_output, xrt_offset);
+      num_of_runs_++;
       LOG_IF(INFO, ENV_PARAM(DEBUG_SFM_RUNNER))
           << "group " << group << " "                                //
           << "cls " << cls << " "                                    //
@@ -157,15 +265,7 @@ void SfmControllerXrtEdge::run(const int8_t* input, float scale,
           << "split_offset " << std::hex << "0x" << split_offset     //
           << std::dec;
       workspace_->sync_for_read(split_offset, this_output_size);
-      if (cls == exCls) {
-        memcpy(r_output, workspace_output, this_output_size);
-      } else {
-        for (auto i = 0u; i < this_batch; ++i) {
-          memcpy((char*)(&r_output[cls * i]),
-                 (char*)(&workspace_output[exCls * i * sizeof(float)]),
-                 cls * sizeof(float));
-        }
-      }
+      copy_rows_out(r_output, workspace_output, cls, exCls, this_batch);
       if (0) {
         CHECK(std::ofstream(std::string{"dump/softmax_"} + std::to_string(r) +
                             ".in")
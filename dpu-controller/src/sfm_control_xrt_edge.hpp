@@ -15,10 +15,13 @@
  * limitations under the License.
  */
 #pragma once
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include <xir/buffer_object.hpp>
 
+#include "./batch_combiner.hpp"
 #include "./softmax.hpp"
 #include "./xrt_cu.hpp"
 // #include "vart/dpu/device_scheduler.hpp"
@@ -45,6 +48,22 @@ class SfmControllerXrtEdge : public xir::SfmController {
                           const int scale, uint64_t output,
                           uint32_t offset) override;
 
+ private:
+  // a host request waiting for a batch, see combiner_.
+  struct request_t {
+    const int8_t* input;
+    float* output;
+    unsigned int cls;
+    unsigned int group;
+    int fix_pos;
+  };
+  void run_direct(const int8_t* input, float scale, unsigned int cls,
+                  unsigned int group, float* output);
+  bool fits_in_one_run(unsigned int cls, unsigned int group) const;
+  bool accept(const std::vector<request_t*>& batch,
+              const request_t* request) const;
+  void run_batch(const std::vector<request_t*>& batch);
+
  private:
   const size_t MAX_GROUP = 65535u;
   const size_t MAX_CLS = 1023u;
@@ -55,6 +74,12 @@ class SfmControllerXrtEdge : public xir::SfmController {
   std::unique_ptr<xir::XrtCu> xrt_cu_;
   std::unique_ptr<xir::BufferObject> workspace_;
   std::mutex mutex_;
+
+  // small requests from concurrent callers are coalesced into one cu run,
+  // the first waiting caller runs batches on behalf of the others.
+  xir::BatchCombiner<request_t> combiner_;
+  std::atomic<uint64_t> num_of_requests_;
+  std::atomic<uint64_t> num_of_runs_;
 };
 
 class SfmControllerXrtEdgeWithScheduler : public xir::SfmController {
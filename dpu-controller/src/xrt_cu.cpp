@@ -20,6 +20,7 @@
 #include <glog/logging.h>
 
 #include <UniLog/UniLog.hpp>
+#include <sstream>
 #include <vitis/ai/env_config.hpp>
 #include <vitis/ai/profiling.hpp>
 #include <vitis/ai/xxd.hpp>
@@ -30,6 +31,9 @@ DEF_ENV_PARAM(XLNX_XRT_CU_DRY_RUN, "0");
 
 namespace xir {
 
+static std::unique_ptr<CompletionReaper::Backend> create_xrt_backend(
+    const std::vector<my_bo_handle>& bo_handles);
+
 XrtCu::XrtCu(const std::string& cu_name)
     : cu_name_{cu_name}, handle_{xir::XrtDeviceHandle::get_instance()} {
   auto num_of_cus = handle_->get_num_of_cus(cu_name_);
@@ -65,6 +69,7 @@ XrtCu::XrtCu(const std::string& cu_name)
                      cu_full_name, cu_kernel_name, cu_instance_name});
     // init_cmd(idx);
   }
+  reaper_ = std::make_unique<CompletionReaper>(create_xrt_backend(bo_handles_));
 }
 
 XrtCu::~XrtCu() {
@@ -132,126 +137,154 @@ static std::string ert_state_to_string(ert_cmd_state state) {
   return state_str.at(state - 1);
 }
 
+static bool is_done(ert_cmd_state state) {
+  return state >= ERT_CMD_STATE_COMPLETED && state != ERT_CMD_STATE_TIMEOUT;
+}
+
+namespace {
+class XrtBackend : public CompletionReaper::Backend {
+ public:
+  explicit XrtBackend(const std::vector<my_bo_handle>& bo_handles)
+      : bo_handles_{bo_handles} {}
+  virtual ~XrtBackend() = default;
+
+  size_t get_num_of_cu() const override { return bo_handles_.size(); }
+
+  void start(size_t cu_idx) override {
+    if (!ENV_PARAM(XLNX_XRT_CU_DRY_RUN)) {
+      bo_handles_[cu_idx].run->start();
+    }
+  }
+
+  CompletionReaper::state_t wait(size_t cu_idx,
+                                 std::chrono::milliseconds timeout) override {
+    if (ENV_PARAM(XLNX_XRT_CU_DRY_RUN)) {
+      return CompletionReaper::state_t::COMPLETED;
+    }
+    auto& r = *bo_handles_[cu_idx].run;
+    // xrt::run::wait(0) waits forever.
+    auto state = timeout.count() > 0 ? r.wait(timeout) : r.state();
+    LOG_IF(INFO, ENV_PARAM(DEBUG_XRT_CU) >= 2)
+        << "wait state is " << ert_state_to_string(state)  //
+        << " in " << timeout.count() << "ms";
+    if (!is_done(state)) {
+      return CompletionReaper::state_t::RUNNING;
+    }
+    // as before, other final states finish the run as well, the caller
+    // decides how to treat them.
+    return state == ERT_CMD_STATE_COMPLETED
+               ? CompletionReaper::state_t::COMPLETED
+               : CompletionReaper::state_t::ERROR;
+  }
+
+  bool abort(size_t cu_idx) override {
+    auto state = bo_handles_[cu_idx].run->abort();
+    LOG_IF(INFO, ENV_PARAM(DEBUG_XRT_CU))
+        << "abort state is " << ert_state_to_string(state);
+    return is_done(state);
+  }
+
+ private:
+  const std::vector<my_bo_handle>& bo_handles_;
+};
+}  // namespace
+
+static std::unique_ptr<CompletionReaper::Backend> create_xrt_backend(
+    const std::vector<my_bo_handle>& bo_handles) {
+  return std::make_unique<XrtBackend>(bo_handles);
+}
+
 void XrtCu::run(size_t device_core_idx, XrtCu::prepare_ecmd_t prepare,
                 callback_t on_success, callback_t on_failure) {
-  UNI_LOG_CHECK(bo_handles_.size() > 0u, VART_XRT_DEVICE_BUSY)
-      << "no cu availabe. cu_name=" << cu_name_;
-  struct timespec tp;
-#ifdef _WIN32
-  uint64_t start = 0;  // TODO; implemented it on windows.
-#else
-  clock_gettime(CLOCK_MONOTONIC, &tp);
-  uint64_t start = tp2ns(&tp);
-#endif
-
-  device_core_idx = device_core_idx % bo_handles_.size();
-  auto ecmd = bo_handles_[device_core_idx].ecmd;
-  ecmd->type = ERT_CTRL;
-  ecmd->stat_enabled = 1;
-  prepare(ecmd);
-  LOG_IF(INFO, ENV_PARAM(DEBUG_XRT_CU))
-      << "sizeof(ecmd) " << sizeof(*ecmd) << " "                 //
-      << "ecmd->state " << ecmd->state << " "                    //
-      << "ecmd->cu_mask " << ecmd->cu_mask << " "                //
-      << "ecmd->extra_cu_masks " << ecmd->extra_cu_masks << " "  //
-      << "ecmd->count " << ecmd->count << " "                    //
-      << "ecmd->opcode " << ecmd->opcode << " "                  //
-      << "ecmd->type " << ecmd->type << " "                      //
-      << ((ENV_PARAM(DEBUG_XRT_CU) >= 2)
-              ? vitis::ai::xxd((unsigned char*)ecmd,
-                               (sizeof *ecmd) + ecmd->count * 4, 8, 1)
-              : std::string(""));
-  ;
   __TIC__(XRT_RUN)
-  bool is_done = false;
-  auto start_from_0 = std::chrono::steady_clock::now();
-  auto start_from = start_from_0;
-  auto state = ERT_CMD_STATE_NEW;
-  auto& r = *bo_handles_[device_core_idx].run;
-  if (ENV_PARAM(XLNX_XRT_CU_DRY_RUN)) {
-    is_done = true;
-    state = ERT_CMD_STATE_COMPLETED;
+  auto status = run_async(device_core_idx, std::move(prepare)).get();
+  __TOC__(XRT_RUN)
+  LOG_IF(WARNING, status != status_t::COMPLETED)
+      << "cu " << get_full_name(device_core_idx % bo_handles_.size())
+      << " device_core_idx=" << device_core_idx << ", status is "
+      << (int)status;
+  report(status, on_success, on_failure);
+}
+
+void XrtCu::report(status_t status, const callback_t& on_success,
+                   const callback_t& on_failure) {
+  if (status == status_t::COMPLETED) {
+    on_success();
   } else {
-    r.start();
-
-    start_from = std::chrono::steady_clock::now();
-    auto count = 1u;
-    while (!is_done) {
-      state = r.wait(1000);
-      LOG_IF(INFO, ENV_PARAM(DEBUG_XRT_CU) >= 2)
-          << "wait state is " << ert_state_to_string(state)  //
-          << " in " << count << "s";
-      if (state >= ERT_CMD_STATE_COMPLETED && state != ERT_CMD_STATE_TIMEOUT) {
-        is_done = true;
-      }
-      if (!is_done) {
-        auto now = std::chrono::steady_clock::now();
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      now - start_from)
-                      .count();
-        if (ms > ENV_PARAM(XLNX_DPU_TIMEOUT)) {
-          break;
-        }
-      }
-      count++;
-    }
-  };
-  if (!is_done) {
-#ifdef _WIN32
-    uint64_t end = 0;  // todo , implemented it on windows
-#else
-    clock_gettime(CLOCK_MONOTONIC, &tp);
-    uint64_t end = tp2ns(&tp);
-#endif
-    auto now = std::chrono::steady_clock::now();
-    auto ms =
-        std::chrono::duration_cast<std::chrono::milliseconds>(now - start_from)
-            .count();
-    LOG_IF(WARNING, !is_done)
-        << " cu timeout!"                                                   //
-        << " device_core_idx=" << device_core_idx                           //
-        << ", cu_name=" << bo_handles_[device_core_idx].cu_full_name        //
-        << ", ENV_PARAM(XLNX_DPU_TIMEOUT)=" << ENV_PARAM(XLNX_DPU_TIMEOUT)  //
-        << ", state is " << ert_state_to_string(state)                      //
-        << ", wait_time=" << ms                                             //
-        ;
-#ifndef _WIN32
-    print_timestamp(start, end, ert_start_kernel_timestamps(ecmd));
-#endif
+    on_failure();
+  }
+}
 
-  } else if (ENV_PARAM(DEBUG_XRT_CU)) {
+std::future<XrtCu::status_t> XrtCu::run_async(
+    size_t device_core_idx, XrtCu::prepare_ecmd_t prepare, on_done_t on_done,
+    std::chrono::milliseconds timeout,
+    CompletionReaper::clock_t::time_point deadline) {
+  UNI_LOG_CHECK(bo_handles_.size() > 0u, VART_XRT_DEVICE_BUSY)
+      << "no cu availabe. cu_name=" << cu_name_;
+  device_core_idx = device_core_idx % bo_handles_.size();
+  // the submission time and the start time in ns, CLOCK_MONOTONIC.
+  auto start = std::make_shared<std::array<uint64_t, 2>>();
+  auto now_ns = []() -> uint64_t {
 #ifdef _WIN32
-    uint64_t end = 0;  // todo: implemented on windows.
+    return 0u;  // TODO; implemented it on windows.
 #else
+    struct timespec tp;
     clock_gettime(CLOCK_MONOTONIC, &tp);
-    uint64_t end = tp2ns(&tp);
+    return tp2ns(&tp);
 #endif
-    auto now = std::chrono::steady_clock::now();
-    auto ms =
-        std::chrono::duration_cast<std::chrono::microseconds>(now - start_from)
-            .count();
-    auto ms0 = std::chrono::duration_cast<std::chrono::microseconds>(
-                   now - start_from_0)
-                   .count();
+  };
+  (*start)[0] = now_ns();
+  CompletionReaper::job_t job;
+  job.prepare = [this, prepare, start, now_ns](size_t idx) {
+    auto ecmd = bo_handles_[idx].ecmd;
+    ecmd->type = ERT_CTRL;
+    ecmd->stat_enabled = 1;
+    prepare(ecmd);
+    LOG_IF(INFO, ENV_PARAM(DEBUG_XRT_CU))
+        << "sizeof(ecmd) " << sizeof(*ecmd) << " "                 //
+        << "ecmd->state " << ecmd->state << " "                    //
+        << "ecmd->cu_mask " << ecmd->cu_mask << " "                //
+        << "ecmd->extra_cu_masks " << ecmd->extra_cu_masks << " "  //
+        << "ecmd->count " << ecmd->count << " "                    //
+        << "ecmd->opcode " << ecmd->opcode << " "                  //
+        << "ecmd->type " << ecmd->type << " "                      //
+        << ((ENV_PARAM(DEBUG_XRT_CU) >= 2)
+                ? vitis::ai::xxd((unsigned char*)ecmd,
+                                 (sizeof *ecmd) + ecmd->count * 4, 8, 1)
+                : std::string(""));
+    (*start)[1] = now_ns();
+  };
+  // called before the next command overwrites the ecmd and its timestamps.
+  job.on_done = [this, on_done, start, now_ns](size_t idx, status_t status) {
+    auto ecmd = bo_handles_[idx].ecmd;
+    auto timed_out = status == status_t::TIMEOUT;
+    if (timed_out || ENV_PARAM(DEBUG_XRT_CU)) {
+      uint64_t end = now_ns();
+      std::ostringstream str;
+      str << " device_core_idx=" << idx                                  //
+          << ", cu_name=" << bo_handles_[idx].cu_full_name               //
+          << ", ENV_PARAM(XLNX_DPU_TIMEOUT)=" << ENV_PARAM(XLNX_DPU_TIMEOUT)
+          << ", status is " << (int)status                               //
+          << ", wait_time=" << (end - (*start)[1]) / 1000 << "us"        //
+          << ", run_time=" << (end - (*start)[0]) / 1000 << "us"         //
+          ;
+      LOG_IF(WARNING, timed_out) << " cu timeout!" << str.str();
+      LOG_IF(INFO, !timed_out) << str.str();
 #ifndef _WIN32
-    auto c = ert_start_kernel_timestamps(ecmd);
-    LOG(INFO) << " device_core_idx=" << device_core_idx                     //
-              << ", cu_name=" << bo_handles_[device_core_idx].cu_full_name  //
-              << ", state is " << ert_state_to_string(state)                //
-              << ", wait_time = " << ms                                     //
-              << ", run_time = " << ms0                                     //
-              << ", ts0 = " << c->skc_timestamps[0]                         //
-              << ", ts1 = " << c->skc_timestamps[1]                         //
-        ;
-    print_timestamp(start, end, c);
+      if ((*start)[1] != 0u) {
+        print_timestamp((*start)[1], end, ert_start_kernel_timestamps(ecmd));
+      }
 #endif
-  }
-  __TOC__(XRT_RUN)
-  if (is_done) {
-    on_success();
-  } else {
-    on_failure();
-  }
+    }
+    if (on_done) {
+      on_done(status);
+    }
+  };
+  job.timeout = timeout.count() > 0
+                    ? timeout
+                    : std::chrono::milliseconds(ENV_PARAM(XLNX_DPU_TIMEOUT));
+  job.deadline = deadline;
+  return reaper_->submit(device_core_idx, std::move(job));
 }
 
 size_t XrtCu::get_num_of_cu() const { return bo_handles_.size(); }
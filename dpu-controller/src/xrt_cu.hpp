@@ -19,6 +19,7 @@
 #include <xrt/xrt_kernel.h>
 
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <functional>
 #include <memory>
@@ -26,6 +27,7 @@
 #include <type_traits>
 #include <vector>
 
+#include "./completion_reaper.hpp"
 #include "xir/xrt_device_handle.hpp"
 class ert_start_kernel_cmd;
 namespace xir {
@@ -49,10 +51,25 @@ class XrtCu {
   XrtCu& operator=(const XrtCu& rhs) = delete;
   using prepare_ecmd_t = std::function<void(ert_start_kernel_cmd*)>;
   using callback_t = std::function<void()>;
+  using status_t = CompletionReaper::status_t;
+  using on_done_t = std::function<void(status_t)>;
 
  public:
+  /// blocking, on_success or on_failure is called on the calling thread.
   void run(size_t core_idx, prepare_ecmd_t prepare, callback_t on_success,
            callback_t on_failure);
+  /// how run() reports a status: on_success only if the command completed,
+  /// on_failure if it failed, timed out, or was never started.
+  static void report(status_t status, const callback_t& on_success,
+                     const callback_t& on_failure);
+  /// queues the command on the completion thread of the core, `prepare` and
+  /// `on_done` are called on that thread. The command may run for `timeout`,
+  /// XLNX_DPU_TIMEOUT if it is 0, and is not started after `deadline`.
+  std::future<status_t> run_async(
+      size_t core_idx, prepare_ecmd_t prepare, on_done_t on_done = nullptr,
+      std::chrono::milliseconds timeout = std::chrono::milliseconds(0),
+      CompletionReaper::clock_t::time_point deadline =
+          CompletionReaper::clock_t::time_point::max());
 
   size_t get_num_of_cu() const;
   size_t get_device_id(size_t device_core_idx) const;
@@ -72,6 +89,7 @@ class XrtCu {
   std::string cu_name_;
   std::shared_ptr<xir::XrtDeviceHandle> handle_;
   std::vector<my_bo_handle> bo_handles_;
+  std::unique_ptr<CompletionReaper> reaper_;
 };
 
 }  // namespace xir
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include "../src/batch_combiner.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_THREADS, "8");
+DEF_ENV_PARAM(NUM_OF_REQUESTS, "200");
+DEF_ENV_PARAM(MAX_BATCH, "4");
+
+struct request_t {
+  int key;
+  int value;
+  bool bad;
+  int result;
+};
+
+// requests of the same key are batched, a batch holding a bad request
+// throws, every caller of the batch must see the exception and the callers
+// of later batches must not hang.
+int main(int argc, char* argv[]) {
+  auto max_batch = (size_t)ENV_PARAM(MAX_BATCH);
+  std::atomic<size_t> num_of_runs{0u};
+  std::atomic<size_t> largest_batch{0u};
+  std::atomic<bool> running{false};
+  auto overlapped = false;
+  auto combiner = xir::BatchCombiner<request_t>(
+      [max_batch](const std::vector<request_t*>& batch,
+                  const request_t* request) {
+        return batch.size() < max_batch && request->key == batch[0]->key;
+      },
+      [&](const std::vector<request_t*>& batch) {
+        overlapped |= running.exchange(true);
+        num_of_runs++;
+        auto size = largest_batch.load();
+        while (size < batch.size() &&
+               !largest_batch.compare_exchange_weak(size, batch.size())) {
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        auto bad = false;
+        for (auto r : batch) {
+          CHECK_EQ(r->key, batch[0]->key) << "mixed keys in a batch";
+          r->result = r->value * 2;
+          bad = bad || r->bad;
+        }
+        running = false;
+        if (bad) {
+          throw std::runtime_error("bad request");
+        }
+      });
+
+  auto num_of_threads = ENV_PARAM(NUM_OF_THREADS);
+  auto num_of_requests = ENV_PARAM(NUM_OF_REQUESTS);
+  std::atomic<int> fails{0};
+  std::atomic<int> num_of_errors{0};
+  std::vector<std::thread> threads;
+  for (auto t = 0; t < num_of_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (auto i = 0; i < num_of_requests; ++i) {
+        auto request = request_t{i % 2, t * num_of_requests + i, i % 50 == 7,
+                                 -1};
+        try {
+          combiner.submit(&request);
+          if (request.bad || request.result != request.value * 2) {
+            fails++;
+          }
+        } catch (const std::runtime_error&) {
+          num_of_errors++;
+          // either bad itself or batched with a bad one, it ran anyway
+          if (request.result != request.value * 2) {
+            fails++;
+          }
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  auto num_of_bad = num_of_threads * ((num_of_requests + 42) / 50);
+  auto total = (size_t)(num_of_threads * num_of_requests);
+  std::cout << "requests " << total << " "                        //
+            << "runs " << num_of_runs << " "                      //
+            << "largest batch " << largest_batch << " "           //
+            << "errors " << num_of_errors << " (bad " << num_of_bad
+            << ")" << std::endl;
+  auto ok = fails == 0 && !overlapped && num_of_errors >= num_of_bad &&
+            largest_batch <= max_batch &&
+            (num_of_threads == 1 || num_of_runs < total);
+  std::cout << (ok ? "test pass" : "test fail") << std::endl;
+  return ok ? 0 : 1;
+}
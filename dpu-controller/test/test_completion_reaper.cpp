@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <glog/logging.h>
+
+#include <atomic>
+#include <iostream>
+#include <random>
+
+#include "../src/completion_reaper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_CU, "4");
+DEF_ENV_PARAM(NUM_OF_THREADS, "8");
+DEF_ENV_PARAM(NUM_OF_JOBS, "1000");
+
+using xir::CompletionReaper;
+using status_t = CompletionReaper::status_t;
+using state_t = CompletionReaper::state_t;
+using clock_type = CompletionReaper::clock_t;
+using std::chrono::milliseconds;
+
+// a CU finishes a command `latency` after it is started. A command with a
+// negative latency never finishes, and is only aborted if `abortable`.
+class MockCu : public CompletionReaper::Backend {
+ public:
+  struct cu_t {
+    std::chrono::microseconds latency{0};
+    bool abortable = true;
+    bool running = false;
+    clock_type::time_point done_at;
+    size_t num_of_started = 0u;
+  };
+
+  explicit MockCu(size_t num_of_cu) : cus_(num_of_cu) {}
+  virtual ~MockCu() = default;
+
+  size_t get_num_of_cu() const override { return cus_.size(); }
+
+  void start(size_t cu_idx) override {
+    auto& cu = cus_[cu_idx];
+    CHECK(!cu.running) << "cu " << cu_idx << " is busy";
+    cu.running = true;
+    cu.num_of_started++;
+    cu.done_at = cu.latency.count() < 0 ? clock_type::time_point::max()
+                                        : clock_type::now() + cu.latency;
+  }
+
+  state_t wait(size_t cu_idx, milliseconds timeout) override {
+    auto& cu = cus_[cu_idx];
+    auto until = clock_type::now() + timeout;
+    std::this_thread::sleep_until(std::min(until, cu.done_at));
+    if (clock_type::now() < cu.done_at) {
+      return state_t::RUNNING;
+    }
+    cu.running = false;
+    return state_t::COMPLETED;
+  }
+
+  bool abort(size_t cu_idx) override {
+    auto& cu = cus_[cu_idx];
+    if (cu.abortable) {
+      cu.running = false;
+    }
+    return cu.abortable;
+  }
+
+  // only touched by the completion thread of the cu, i.e. in prepare().
+  cu_t& cu(size_t cu_idx) { return cus_[cu_idx]; }
+
+ private:
+  std::vector<cu_t> cus_;
+};
+
+static long elapsed_ms(clock_type::time_point from) {
+  return (long)std::chrono::duration_cast<milliseconds>(clock_type::now() -
+                                                        from)
+      .count();
+}
+
+// thousands of jobs in flight, submitted by several threads at once.
+static void test_many_in_flight() {
+  auto num_of_cu = (size_t)ENV_PARAM(NUM_OF_CU);
+  auto num_of_threads = (size_t)ENV_PARAM(NUM_OF_THREADS);
+  auto num_of_jobs = (size_t)ENV_PARAM(NUM_OF_JOBS);
+  auto backend = std::make_unique<MockCu>(num_of_cu);
+  auto mock = backend.get();
+  CompletionReaper reaper(std::move(backend));
+  std::vector<std::atomic<size_t>> done(num_of_cu);
+  std::atomic<size_t> prepared{0u};
+  std::vector<std::vector<std::future<status_t>>> futures(num_of_threads);
+  auto start = clock_type::now();
+  std::vector<std::thread> threads;
+  for (auto t = 0u; t < num_of_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      std::uniform_int_distribution<int> latency_us(0, 200);
+      for (auto i = 0u; i < num_of_jobs; ++i) {
+        auto cu_idx = (t + i) % num_of_cu;
+        auto latency = std::chrono::microseconds(latency_us(rng));
+        CompletionReaper::job_t job;
+        job.prepare = [mock, latency, &prepared](size_t idx) {
+          mock->cu(idx).latency = latency;
+          prepared++;
+        };
+        job.on_done = [&done](size_t idx, status_t status) {
+          CHECK(status == status_t::COMPLETED);
+          done[idx]++;
+        };
+        futures[t].emplace_back(reaper.submit(cu_idx, std::move(job)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  auto submitted_ms = elapsed_ms(start);
+  for (auto& fs : futures) {
+    for (auto& f : fs) {
+      CHECK(f.get() == status_t::COMPLETED);
+    }
+  }
+  auto total = num_of_threads * num_of_jobs;
+  CHECK_EQ(prepared.load(), total);
+  auto sum = 0u;
+  for (auto i = 0u; i < num_of_cu; ++i) {
+    CHECK_EQ(done[i].load(), mock->cu(i).num_of_started);
+    sum += done[i];
+  }
+  CHECK_EQ(sum, total);
+  std::cout << "many in flight: " << total << " jobs on " << num_of_cu
+            << " cus, submitted in " << submitted_ms << "ms, done in "
+            << elapsed_ms(start) << "ms" << std::endl;
+}
+
+// a stuck command times out at its deadline, not at the next poll.
+static void test_timeout() {
+  auto backend = std::make_unique<MockCu>(1u);
+  auto mock = backend.get();
+  CompletionReaper reaper(std::move(backend));
+  CompletionReaper::job_t job;
+  job.prepare = [mock](size_t idx) {
+    mock->cu(idx).latency = std::chrono::microseconds(-1);
+  };
+  job.timeout = milliseconds(30);
+  auto start = clock_type::now();
+  auto status = reaper.submit(0u, job).get();
+  auto ms = elapsed_ms(start);
+  CHECK(status == status_t::TIMEOUT);
+  CHECK_GE(ms, 30);
+  CHECK_LT(ms, 30 + 50) << "the timeout is not honoured in time";
+  CHECK(!reaper.is_stuck(0u));
+  // the cu is aborted and usable again.
+  job.prepare = [mock](size_t idx) {
+    mock->cu(idx).latency = std::chrono::microseconds(100);
+  };
+  CHECK(reaper.submit(0u, job).get() == status_t::COMPLETED);
+  std::cout << "timeout: " << ms << "ms" << std::endl;
+}
+
+// an absolute deadline covers the time in the queue as well.
+static void test_deadline() {
+  auto backend = std::make_unique<MockCu>(1u);
+  auto mock = backend.get();
+  CompletionReaper reaper(std::move(backend));
+  auto deadline = clock_type::now() + milliseconds(20);
+  CompletionReaper::job_t slow;
+  slow.prepare = [mock](size_t idx) {
+    mock->cu(idx).latency = std::chrono::microseconds(40000);
+  };
+  auto started = false;
+  CompletionReaper::job_t late;
+  late.prepare = [&started](size_t idx) { started = true; };
+  late.deadline = deadline;
+  auto f0 = reaper.submit(0u, slow);
+  auto f1 = reaper.submit(0u, late);
+  CHECK(f0.get() == status_t::COMPLETED);
+  CHECK(f1.get() == status_t::TIMEOUT);
+  CHECK(!started) << "a job is started after its deadline";
+  // the running command is aborted at the deadline as well.
+  slow.deadline = clock_type::now() + milliseconds(10);
+  auto start = clock_type::now();
+  CHECK(reaper.submit(0u, slow).get() == status_t::TIMEOUT);
+  CHECK_LT(elapsed_ms(start), 10 + 50);
+}
+
+// a command which cannot be aborted marks the cu stuck, until it is done.
+// jobs submitted meanwhile are rejected without being started.
+static void test_stuck() {
+  auto backend = std::make_unique<MockCu>(1u);
+  auto mock = backend.get();
+  CompletionReaper reaper(std::move(backend));
+  CompletionReaper::job_t job;
+  job.prepare = [mock](size_t idx) {
+    mock->cu(idx).latency = std::chrono::microseconds(50000);
+    mock->cu(idx).abortable = false;
+  };
+  job.timeout = milliseconds(10);
+  CHECK(reaper.submit(0u, job).get() == status_t::TIMEOUT);
+  CHECK(reaper.is_stuck(0u));
+  auto prepared = 0;
+  CompletionReaper::job_t next;
+  next.prepare = [&prepared](size_t idx) { prepared++; };
+  CHECK(reaper.submit(0u, next).get() == status_t::REJECTED);
+  CHECK_EQ(prepared, 0);
+  CHECK_EQ(mock->cu(0u).num_of_started, 1u);
+  std::this_thread::sleep_for(milliseconds(60));
+  CHECK(reaper.submit(0u, next).get() == status_t::COMPLETED);
+  CHECK_EQ(prepared, 1);
+  CHECK(!reaper.is_stuck(0u));
+}
+
+// queued jobs are cancelled, explicitly or when the reaper is destroyed.
+static void test_cancel() {
+  auto backend = std::make_unique<MockCu>(1u);
+  auto mock = backend.get();
+  std::vector<std::future<status_t>> futures;
+  std::atomic<int> cancelled{0};
+  {
+    CompletionReaper reaper(std::move(backend));
+    CompletionReaper::job_t job;
+    job.prepare = [mock](size_t idx) {
+      mock->cu(idx).latency = std::chrono::microseconds(20000);
+    };
+    job.on_done = [&cancelled](size_t idx, status_t status) {
+      cancelled += status == status_t::CANCELLED;
+    };
+    for (auto i = 0; i < 10; ++i) {
+      futures.emplace_back(reaper.submit(0u, job));
+    }
+    std::this_thread::sleep_for(milliseconds(5));
+    auto n = reaper.cancel(0u);
+    CHECK_EQ(n, 9u) << "only the running job is not cancelled";
+    for (auto i = 0; i < 10; ++i) {
+      futures.emplace_back(reaper.submit(0u, job));
+    }
+  }
+  CHECK(futures[0].get() == status_t::COMPLETED);
+  auto num_of_completed = 0;
+  for (auto i = 1u; i < futures.size(); ++i) {
+    num_of_completed += futures[i].get() == status_t::COMPLETED;
+  }
+  CHECK_EQ(cancelled.load() + num_of_completed, 19);
+  CHECK_GE(cancelled.load(), 9 + 8);
+}
+
+// a job whose prepare throws is not started, the future carries the error.
+static void test_exception() {
+  auto backend = std::make_unique<MockCu>(1u);
+  auto mock = backend.get();
+  CompletionReaper reaper(std::move(backend));
+  CompletionReaper::job_t job;
+  job.prepare = [](size_t idx) { throw std::runtime_error("bad ecmd"); };
+  auto f = reaper.submit(0u, job);
+  auto thrown = false;
+  try {
+    f.get();
+  } catch (const std::runtime_error& e) {
+    thrown = true;
+  }
+  CHECK(thrown);
+  CHECK_EQ(mock->cu(0u).num_of_started, 0u);
+  job.prepare = [](size_t idx) {};
+  CHECK(reaper.submit(0u, job).get() == status_t::COMPLETED);
+}
+
+int main(int argc, char* argv[]) {
+  test_many_in_flight();
+  test_timeout();
+  test_deadline();
+  test_stuck();
+  test_cancel();
+  test_exception();
+  std::cout << "test pass" << std::endl;
+  return 0;
+}
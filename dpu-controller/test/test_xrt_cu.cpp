@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// only a completed command is reported as a success by XrtCu::run(), a
+// command which failed, timed out, or was never started is a failure.
+#include <glog/logging.h>
+
+#include <iostream>
+
+#include "../src/xrt_cu.hpp"
+
+using status_t = xir::XrtCu::status_t;
+
+int main(int argc, char* argv[]) {
+  for (auto status : {status_t::COMPLETED, status_t::ERROR, status_t::TIMEOUT,
+                      status_t::CANCELLED, status_t::REJECTED}) {
+    auto num_of_successes = 0;
+    auto num_of_failures = 0;
+    xir::XrtCu::report(
+        status, [&num_of_successes]() { num_of_successes++; },
+        [&num_of_failures]() { num_of_failures++; });
+    auto completed = status == status_t::COMPLETED;
+    CHECK_EQ(num_of_successes, completed ? 1 : 0) << "status " << (int)status;
+    CHECK_EQ(num_of_failures, completed ? 0 : 1) << "status " << (int)status;
+  }
+  std::cout << "test pass" << std::endl;
+  return 0;
+}
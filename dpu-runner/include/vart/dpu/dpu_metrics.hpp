@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vart {
+namespace dpu {
+
+/// Process wide DPU metrics, collected by all DPU runners when
+/// XLNX_ENABLE_DPU_METRICS=1.
+///
+/// Metrics are aggregated per (device_core_id, subgraph) and per
+/// device_core_id. They can be read by get_subgraph_metrics() /
+/// get_core_metrics(), and are written to XLNX_DPU_METRICS_FILE every
+/// XLNX_DPU_METRICS_INTERVAL_MS and at exit if the file is set.
+class DpuMetrics {
+ public:
+  /// log2 histogram, bucket i holds values in [2^(i-1), 2^i).
+  class Histogram {
+   public:
+    void add(uint64_t value);
+    void merge(const Histogram& other);
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t min() const { return count_ == 0u ? 0u : min_; }
+    uint64_t max() const { return max_; }
+    double mean() const;
+    /// upper bound of the bucket holding the p-th percentile, p in [0, 100].
+    uint64_t percentile(double p) const;
+    const std::array<uint64_t, 65>& buckets() const { return buckets_; }
+
+   private:
+    std::array<uint64_t, 65> buckets_ = {};
+    uint64_t count_ = 0u;
+    uint64_t sum_ = 0u;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0u;
+  };
+
+  /// profiling registers of one run, see xir::DpuController::Counter.
+  struct Sample {
+    uint64_t load;  // load instructions finished
+    uint64_t conv;  // conv instructions finished
+    uint64_t save;  // save instructions finished
+    uint64_t misc;  // misc instructions finished
+    uint64_t cycle;
+  };
+
+  struct SubgraphMetrics {
+    size_t device_core_id;
+    std::string subgraph;
+    // operations of the subgraph, and the operations actually executed by
+    // the DPU after padding to its parallelism.
+    uint64_t workload;
+    uint64_t workload_on_arch;
+    uint64_t load;
+    uint64_t conv;
+    uint64_t save;
+    uint64_t misc;
+    Histogram cycle;
+    // host time of a DpuController::run(), including the interrupt wait.
+    Histogram run_us;
+    /// workload per second, based on XLNX_DPU_CLOCK_MHZ; 0 if the cycle
+    /// counter is not available.
+    double gops() const;
+    /// workload / (cycles * XLNX_DPU_PEAK_OPS_PER_CYCLE); 0 if unknown.
+    double mac_efficiency() const;
+  };
+
+  struct CoreMetrics {
+    size_t device_core_id;
+    Histogram cycle;
+    // host time of execute_async() of the runners on the core. DPU runners
+    // finish the job before execute_async() returns and wait() is a no-op,
+    // so it is the end to end latency including the input/output copies.
+    Histogram submit_us;
+  };
+
+ public:
+  static DpuMetrics& instance();
+  static bool is_enabled();
+
+ public:
+  DpuMetrics(const DpuMetrics& other) = delete;
+  DpuMetrics& operator=(const DpuMetrics& other) = delete;
+  ~DpuMetrics();
+
+ public:
+  /// sample is nullptr if the controller does not provide counters.
+  void add_subgraph_run(size_t device_core_id, const std::string& subgraph,
+                        uint64_t workload, uint64_t workload_on_arch,
+                        const Sample* sample, uint64_t run_us);
+  void add_submit(size_t device_core_id, uint64_t us);
+
+  std::vector<SubgraphMetrics> get_subgraph_metrics() const;
+  std::vector<CoreMetrics> get_core_metrics() const;
+  void reset();
+  /// one line per subgraph and per core, `key=value` separated by spaces.
+  void dump(std::ostream& out) const;
+  /// write the metrics to XLNX_DPU_METRICS_FILE, if it is set.
+  void export_to_file() const;
+
+ private:
+  DpuMetrics();
+  CoreMetrics& get_core(size_t device_core_id);
+  // called with mtx_ held.
+  bool is_export_due();
+
+ private:
+  mutable std::mutex mtx_;
+  std::map<std::pair<size_t, std::string>, SubgraphMetrics> subgraphs_;
+  std::map<size_t, CoreMetrics> cores_;
+  std::chrono::steady_clock::time_point last_export_;
+};
+
+}  // namespace dpu
+}  // namespace vart
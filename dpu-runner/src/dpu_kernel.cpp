@@ -94,14 +94,21 @@ void DpuKernel::initialize() {
 void DpuKernel::my_load_parameter() {
   LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
       << "loading parameter for " << subgraph_->get_graph()->get_name();
+  if (!is_parameter_loaded_by_kernel() &&
+      !ENV_PARAM(XLNX_ENABLE_DUMP_PARAMTER)) {
+    LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
+        << "parameters are not loaded by kernel, skip reading them";
+    return;
+  }
   // CHECK(subgraph_->has_attr("reg_id_to_parameter_value"))
   //     << "subgraph name:" << subgraph_->get_name();
-  auto reg_id_to_parameter_value = std::map<std::string, std::vector<char>>();
-  if (subgraph_->has_attr("reg_id_to_parameter_value")) {
-    reg_id_to_parameter_value =
-        subgraph_->get_attr<std::map<std::string, std::vector<char>>>(
-            "reg_id_to_parameter_value");
-  }
+  // parameters below are views of this map, so that the values are copied
+  // out of the subgraph only once.
+  const auto reg_id_to_parameter_value =
+      subgraph_->has_attr("reg_id_to_parameter_value")
+          ? subgraph_->get_attr<std::map<std::string, std::vector<char>>>(
+                "reg_id_to_parameter_value")
+          : std::map<std::string, std::vector<char>>();
 
   UNI_LOG_CHECK(subgraph_->has_attr("reg_id_to_context_type"),
                 VART_XMODEL_ERROR);
@@ -135,10 +142,10 @@ void DpuKernel::my_load_parameter() {
       LOG(INFO) << "dump parameter to " << filename;
     }
     parameters.emplace_back(reg_id, vart::dpu::RegType::XCONST,
-                            std::move(it_value->second));
+                            it_value->second.data(), it_value->second.size());
   }
   // CHECK_GT(total, 0u) << "no parameter loaded.";
-  if (total != 0u) {
+  if (total != 0u && is_parameter_loaded_by_kernel()) {
     load_parameter(parameters);
   }
 }
@@ -148,8 +155,8 @@ void DpuKernel::my_load_release_code() {
   UNI_LOG_CHECK(subgraph_->has_attr("mc_code"), VART_XMODEL_ERROR)
       << "subgraph_->get_name() " << subgraph_->get_name() << " "  //
       << "attrs: " << subgraph_->get_attrs()->debug_info();
-  auto& mc_code = subgraph_->get_attr<std::vector<char>>("mc_code");
-  load_code(DpuReg{"REG_CODE", RegType::CODE, mc_code});
+  const auto mc_code = subgraph_->get_attr<std::vector<char>>("mc_code");
+  load_code(DpuReg{"REG_CODE", RegType::CODE, mc_code.data(), mc_code.size()});
   super_layer_subgraph_.emplace_back(subgraph_);
 }
 
@@ -211,8 +218,10 @@ void DpuKernel::my_load_debug_code() {
         << "cannot find subg " << child_name;
     auto has_mc_code = (*child_subg)->has_attr("mc_code");
     if (has_mc_code) {
-      auto& mc_code = (*child_subg)->get_attr<std::vector<char>>("mc_code");
-      load_code(DpuReg{"REG_CODE", RegType::CODE, std::move(mc_code)});
+      const auto mc_code =
+          (*child_subg)->get_attr<std::vector<char>>("mc_code");
+      load_code(
+          DpuReg{"REG_CODE", RegType::CODE, mc_code.data(), mc_code.size()});
       super_layer_subgraph_.emplace_back(*child_subg);
     } else {
       LOG(INFO) << "child_name " << child_name << " has no mc_code";
@@ -48,6 +48,9 @@ class DpuKernel {
  protected:
   virtual void load_parameter(const std::vector<DpuReg>& parameters) = 0;
   virtual void load_code(const DpuReg& code) = 0;
+  // false if CONST regs are uploaded elsewhere, e.g. by the tensor buffer
+  // allocator, so that parameter values need not be read from the subgraph.
+  virtual bool is_parameter_loaded_by_kernel() const { return true; }
   // ret[id] id has no meansing
  public:
   // TODO clean it
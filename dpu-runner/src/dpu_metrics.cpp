@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "vart/dpu/dpu_metrics.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <vitis/ai/env_config.hpp>
+
+DEF_ENV_PARAM(XLNX_ENABLE_DPU_METRICS, "0");
+DEF_ENV_PARAM_2(XLNX_DPU_METRICS_FILE, "", std::string);
+DEF_ENV_PARAM(XLNX_DPU_METRICS_INTERVAL_MS, "10000");
+// used to convert cycles to time, 300MHz is the typical clock of DPUCZDX8G.
+DEF_ENV_PARAM(XLNX_DPU_CLOCK_MHZ, "300");
+// e.g. 4096 for B4096, 0 means the MAC efficiency is not reported.
+DEF_ENV_PARAM(XLNX_DPU_PEAK_OPS_PER_CYCLE, "0");
+
+namespace vart {
+namespace dpu {
+
+void DpuMetrics::Histogram::add(uint64_t value) {
+  auto idx = 0u;
+  for (auto v = value; v != 0u; v = v >> 1) {
+    idx++;
+  }
+  buckets_[idx]++;
+  count_++;
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void DpuMetrics::Histogram::merge(const Histogram& other) {
+  for (auto i = 0u; i < buckets_.size(); ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+double DpuMetrics::Histogram::mean() const {
+  return count_ == 0u ? 0.0 : (double)sum_ / (double)count_;
+}
+
+uint64_t DpuMetrics::Histogram::percentile(double p) const {
+  if (count_ == 0u) {
+    return 0u;
+  }
+  auto rank = (uint64_t)std::ceil(p / 100.0 * (double)count_);
+  rank = std::max(rank, (uint64_t)1u);
+  uint64_t n = 0u;
+  for (auto i = 0u; i < buckets_.size(); ++i) {
+    n += buckets_[i];
+    if (n >= rank) {
+      uint64_t upper =
+          i == 0u ? 0u : i >= 64u ? UINT64_MAX : ((uint64_t)1u << i) - 1u;
+      return std::min(upper, max_);
+    }
+  }
+  return max_;
+}
+
+double DpuMetrics::SubgraphMetrics::gops() const {
+  if (cycle.sum() == 0u) {
+    return 0.0;
+  }
+  // ops / (cycles / (MHz * 1e6)) / 1e9
+  return (double)workload * (double)cycle.count() *
+         (double)ENV_PARAM(XLNX_DPU_CLOCK_MHZ) / (double)cycle.sum() / 1000.0;
+}
+
+double DpuMetrics::SubgraphMetrics::mac_efficiency() const {
+  auto peak = ENV_PARAM(XLNX_DPU_PEAK_OPS_PER_CYCLE);
+  if (cycle.sum() == 0u || peak <= 0) {
+    return 0.0;
+  }
+  return (double)workload * (double)cycle.count() /
+         ((double)cycle.sum() * (double)peak);
+}
+
+DpuMetrics& DpuMetrics::instance() {
+  static DpuMetrics metrics;
+  return metrics;
+}
+
+bool DpuMetrics::is_enabled() { return ENV_PARAM(XLNX_ENABLE_DPU_METRICS); }
+
+DpuMetrics::DpuMetrics() : last_export_{std::chrono::steady_clock::now()} {}
+
+DpuMetrics::~DpuMetrics() { export_to_file(); }
+
+DpuMetrics::CoreMetrics& DpuMetrics::get_core(size_t device_core_id) {
+  auto it = cores_.find(device_core_id);
+  if (it == cores_.end()) {
+    it = cores_.emplace(device_core_id, CoreMetrics{}).first;
+    it->second.device_core_id = device_core_id;
+  }
+  return it->second;
+}
+
+bool DpuMetrics::is_export_due() {
+  if (ENV_PARAM(XLNX_DPU_METRICS_FILE).empty()) {
+    return false;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (now - last_export_ <
+      std::chrono::milliseconds(ENV_PARAM(XLNX_DPU_METRICS_INTERVAL_MS))) {
+    return false;
+  }
+  last_export_ = now;
+  return true;
+}
+
+void DpuMetrics::add_subgraph_run(size_t device_core_id,
+                                  const std::string& subgraph,
+                                  uint64_t workload, uint64_t workload_on_arch,
+                                  const Sample* sample, uint64_t run_us) {
+  auto due = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto key = std::make_pair(device_core_id, subgraph);
+    auto it = subgraphs_.find(key);
+    if (it == subgraphs_.end()) {
+      auto m = SubgraphMetrics{};
+      m.device_core_id = device_core_id;
+      m.subgraph = subgraph;
+      m.workload = workload;
+      m.workload_on_arch = workload_on_arch;
+      it = subgraphs_.emplace(std::move(key), std::move(m)).first;
+    }
+    auto& m = it->second;
+    m.run_us.add(run_us);
+    if (sample != nullptr) {
+      m.load += sample->load;
+      m.conv += sample->conv;
+      m.save += sample->save;
+      m.misc += sample->misc;
+      m.cycle.add(sample->cycle);
+      get_core(device_core_id).cycle.add(sample->cycle);
+    }
+    due = is_export_due();
+  }
+  if (due) {
+    export_to_file();
+  }
+}
+
+void DpuMetrics::add_submit(size_t device_core_id, uint64_t us) {
+  auto due = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    get_core(device_core_id).submit_us.add(us);
+    due = is_export_due();
+  }
+  if (due) {
+    export_to_file();
+  }
+}
+
+std::vector<DpuMetrics::SubgraphMetrics> DpuMetrics::get_subgraph_metrics()
+    const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto ret = std::vector<SubgraphMetrics>();
+  ret.reserve(subgraphs_.size());
+  for (const auto& m : subgraphs_) {
+    ret.emplace_back(m.second);
+  }
+  return ret;
+}
+
+std::vector<DpuMetrics::CoreMetrics> DpuMetrics::get_core_metrics() const {
+  std::lock_guard<std::mutex> lock(mtx_);
+  auto ret = std::vector<CoreMetrics>();
+  ret.reserve(cores_.size());
+  for (const auto& m : cores_) {
+    ret.emplace_back(m.second);
+  }
+  return ret;
+}
+
+void DpuMetrics::reset() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  subgraphs_.clear();
+  cores_.clear();
+}
+
+static void dump_histogram(std::ostream& out, const std::string& name,
+                           const DpuMetrics::Histogram& h) {
+  out << " " << name << "_count=" << h.count()  //
+      << " " << name << "_mean=" << h.mean()    //
+      << " " << name << "_min=" << h.min()      //
+      << " " << name << "_p50=" << h.percentile(50.0)
+      << " " << name << "_p99=" << h.percentile(99.0)
+      << " " << name << "_max=" << h.max();
+}
+
+void DpuMetrics::dump(std::ostream& out) const {
+  auto subgraphs = get_subgraph_metrics();
+  auto cores = get_core_metrics();
+  for (const auto& m : subgraphs) {
+    out << "subgraph"                                     //
+        << " device_core_id=" << m.device_core_id         //
+        << " name=" << m.subgraph                         //
+        << " workload=" << m.workload                     //
+        << " workload_on_arch=" << m.workload_on_arch     //
+        << " load=" << m.load                             //
+        << " conv=" << m.conv                             //
+        << " save=" << m.save                             //
+        << " misc=" << m.misc                             //
+        << " gops=" << m.gops()                           //
+        << " mac_efficiency=" << m.mac_efficiency();
+    dump_histogram(out, "cycle", m.cycle);
+    dump_histogram(out, "run_us", m.run_us);
+    out << "\n";
+  }
+  for (const auto& m : cores) {
+    out << "core"
+        << " device_core_id=" << m.device_core_id;
+    dump_histogram(out, "cycle", m.cycle);
+    dump_histogram(out, "submit_us", m.submit_us);
+    out << "\n";
+  }
+}
+
+void DpuMetrics::export_to_file() const {
+  const auto& filename = ENV_PARAM(XLNX_DPU_METRICS_FILE);
+  if (filename.empty()) {
+    return;
+  }
+  // write a complete snapshot and rename it, so that a reader never sees a
+  // partially written file.
+  auto tmp = filename + ".tmp";
+  {
+    std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+    if (!out) {
+      LOG(WARNING) << "cannot write dpu metrics to " << tmp;
+      return;
+    }
+    dump(out);
+  }
+  if (std::rename(tmp.c_str(), filename.c_str()) != 0) {
+    LOG(WARNING) << "cannot rename " << tmp << " to " << filename;
+  }
+}
+
+}  // namespace dpu
+}  // namespace vart
@@ -28,15 +28,39 @@ enum class RegType {
 struct DpuReg {
   explicit DpuReg(const std::string& name, RegType type,
                   const std::vector<char>& value)
-      : name_{name}, type_{type}, size_{value.size()}, value_(value) {}
+      : name_{name},
+        type_{type},
+        size_{value.size()},
+        value_(value),
+        data_{value_.data()} {}
+  // a view of the value, the caller keeps it alive until it is uploaded.
+  explicit DpuReg(const std::string& name, RegType type, const char* data,
+                  size_t size)
+      : name_{name}, type_{type}, size_{size}, value_{}, data_{data} {}
   explicit DpuReg(const std::string& name, size_t size)
-      : name_{name}, type_{RegType::DATA}, size_{size}, value_{} {}
+      : name_{name},
+        type_{RegType::DATA},
+        size_{size},
+        value_{},
+        data_{nullptr} {}
+  DpuReg(const DpuReg& other)
+      : name_{other.name_},
+        type_{other.type_},
+        size_{other.size_},
+        value_(other.value_),
+        data_{other.value_.empty() ? other.data_ : value_.data()} {}
+
+ public:
+  const char* data() const { return data_; }
 
  public:
   std::string name_;
   RegType type_;
   const size_t size_;
   const std::vector<char> value_;
+
+ private:
+  const char* const data_;
 };
 }  // namespace dpu
 }  // namespace vart
@@ -30,6 +30,8 @@
 #include <xir/util/tool_function.hpp>
 
 #include "../../runner/src/runner_helper.hpp"
+#include "vart/assistant/tensor_buffer_sync.hpp"
+#include "vart/dpu/dpu_metrics.hpp"
 #include "./my_openssl_md5.hpp"
 #include "dpu_kernel.hpp"
 #include "my_tensor.hpp"
@@ -641,26 +643,70 @@ void DpuRunnerBaseImp::after_run_dpu() {
   }
 }
 
+const DpuRunnerBaseImp::execution_plan_t&
+DpuRunnerBaseImp::get_execution_plan(size_t device_core_id) {
+  if (plan_ != nullptr && plan_->device_core_id == device_core_id) {
+    return *plan_;
+  }
+  auto kernel = session_->kernel_.get();
+  auto controller =
+      const_cast<const xir::DpuController*>(session_->get_dpu_controller());
+  auto plan = std::make_unique<execution_plan_t>();
+  plan->device_core_id = device_core_id;
+  plan->size_of_gen_regs = controller->get_size_of_gen_regs(device_core_id);
+  plan->fingerprint_ok = !ENV_PARAM(XLNX_ENABLE_FINGERPRINT_CHECK) ||
+                         check_fingerprint(session_->get_device_core_id());
+  plan->gen_reg_template =
+      build_gen_reg(kernel->get_parameter(device_core_id),
+                    session_->get_num_of_engines(), plan->size_of_gen_regs);
+  for (const auto& sg_and_code : kernel->get_code(device_core_id)) {
+    auto subgraph = sg_and_code.subgraph;
+    auto step = execution_plan_t::step_t{};
+    step.sg_and_code = sg_and_code;
+    step.name = subgraph->get_name();
+    step.layer_name = layer_name(step.name);
+    step.workload = subgraph->has_attr("workload")
+                        ? subgraph->get_attr<std::uint64_t>("workload")
+                        : 0u;
+    step.workload_on_arch =
+        subgraph->has_attr("workload_on_arch")
+            ? subgraph->get_attr<std::uint64_t>("workload_on_arch")
+            : 0u;
+    step.depth = subgraph->get_depth();
+    if (ENV_PARAM(XLNX_SHOW_DPU_COUNTER)) {
+      step.counter_log = "workload " + std::to_string(step.workload);
+      if (subgraph->has_attr("workload_on_arch")) {
+        step.counter_log +=
+            " workload_on_arch " + std::to_string(step.workload_on_arch);
+      }
+    }
+    plan->steps.emplace_back(std::move(step));
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
+      << "@" << (void*)this << " execution plan is built for device_core_id="
+      << device_core_id << " num_of_steps=" << plan->steps.size();
+  plan_ = std::move(plan);
+  return *plan_;
+}
+
 void DpuRunnerBaseImp::start_dpu2(size_t device_core_id) {
   if (ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) >= 3) {
     LOG(INFO) << "DEBUG_DPU_RUNNER_DRY_RUN = "
               << ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) << ", ignore running dpu";
     return;
   }
-  auto kernel = session_->kernel_.get();
-  auto sg_and_code = kernel->get_code(device_core_id);
-  auto gen_reg = build_gen_reg(
-      kernel->get_parameter(device_core_id), session_->get_num_of_engines(),
-      const_cast<const xir::DpuController*>(session_->get_dpu_controller())
-          ->get_size_of_gen_regs(device_core_id));
-  fill_gen_reg(device_core_id, gen_reg);
+  const auto& plan = get_execution_plan(device_core_id);
+  // only the workspace registers change between runs.
+  gen_reg_.assign(plan.gen_reg_template.begin(), plan.gen_reg_template.end());
+  fill_gen_reg(device_core_id, gen_reg_);
+  const auto& gen_reg = gen_reg_;
   if (ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) >= 2) {
     LOG(INFO) << "DEBUG_DPU_RUNNER_DRY_RUN = "
               << ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN) << ", ignore running dpu";
     return;
   }
-  for (auto idx = 0u; idx < sg_and_code.size(); ++idx) {
-    auto code = sg_and_code[idx].code_addr;
+  for (const auto& step : plan.steps) {
+    auto code = step.sg_and_code.code_addr;
     LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
         << "@" << (void*)this << " device_core_id=" << device_core_id  //
         << " DPU: "
@@ -669,53 +715,67 @@ void DpuRunnerBaseImp::start_dpu2(size_t device_core_id) {
         << session_->get_dpu_controller()->get_device_id(device_core_id)  //
         << " running dpu code " << std::hex << " 0x" << code << std::dec << " "
         << "gen_reg.size() " << gen_reg.size() << " "  //
-        << "gen_reg "
-        << to_string(gen_reg,
-                     session_->get_dpu_controller()->get_size_of_gen_regs(
-                         device_core_id))
-        << " "  //
+        << "gen_reg " << to_string(gen_reg, plan.size_of_gen_regs) << " "  //
         ;
     if (xlnx_enable_debug_dpu_data_mode()) {
-      prepare_envirnment(sg_and_code[idx], gen_reg, device_core_id);
+      prepare_envirnment(step.sg_and_code, gen_reg, device_core_id);
       before_run_dpu();
     }
 
     LOG_IF(INFO, ENV_PARAM(XLNX_SHOW_DPU_COUNTER))
-        << "subgraph name : "
-        << layer_name(sg_and_code[idx].subgraph->get_name());
+        << "subgraph name : " << step.layer_name;
     if (vitis::ai::trace::is_enabled()) {
-      auto workload =
-          sg_and_code[idx].subgraph->get_attr<std::uint64_t>("workload");
-      auto depth = sg_and_code[idx].subgraph->get_depth();
-      auto name = sg_and_code[idx].subgraph->get_name();
       auto batch = session_->get_num_of_engines();
       // MSVC NOTE: it is not safe to call template function across DLL.
 #if !_WIN32
-      vitis::ai::trace::add_trace("dpu-runner", name, batch, workload, depth);
+      vitis::ai::trace::add_trace("dpu-runner", step.name, batch,
+                                  step.workload, step.depth);
 #endif
     }
-    LOG_IF(FATAL, ENV_PARAM(XLNX_ENABLE_FINGERPRINT_CHECK) &&
-                      !check_fingerprint(session_->get_device_core_id()))
-        << "fingerprint check failure.";
+    LOG_IF(FATAL, !plan.fingerprint_ok) << "fingerprint check failure.";
     if (!ENV_PARAM(DEBUG_DPU_RUNNER_DRY_RUN)) {
       if (ENV_PARAM(XLNX_SHOW_DPU_COUNTER)) {
-        auto& subgraph = sg_and_code[idx].subgraph;
-        auto workload = subgraph->get_attr<std::uint64_t>("workload");
-        std::string log = "workload " + std::to_string(workload);
-        if (subgraph->has_attr("workload_on_arch")) {
-          auto arch = subgraph->get_attr<std::uint64_t>("workload_on_arch");
-          log += " workload_on_arch " + std::to_string(arch);
-        }
-        std::cout << log << std::endl;
+        std::cout << step.counter_log << std::endl;
+      }
+      if (!DpuMetrics::is_enabled()) {
+        session_->get_dpu_controller()->run(device_core_id, code, gen_reg);
+      } else {
+        auto controller = session_->get_dpu_controller();
+        auto start = std::chrono::steady_clock::now();
+        controller->run(device_core_id, code, gen_reg);
+        auto run_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+        auto counter = xir::DpuController::Counter{};
+        auto has_counter =
+            controller->get_last_counter(device_core_id, counter);
+        auto sample = DpuMetrics::Sample{counter.load_end, counter.conv_end,
+                                         counter.save_end, counter.misc_end,
+                                         counter.cycle};
+        DpuMetrics::instance().add_subgraph_run(
+            device_core_id, step.name, step.workload, step.workload_on_arch,
+            has_counter ? &sample : nullptr, (uint64_t)run_us);
       }
-      session_->get_dpu_controller()->run(device_core_id, code, gen_reg);
     }
     if (xlnx_enable_debug_dpu_data_mode()) {
       after_run_dpu();
       clear_environment();
     }
   }
+  // per inference sync statistics, see DEBUG_TENSOR_BUFFER_SYNC
+  vart::assistant::notify_device_write();
 }
+void DpuRunnerBaseImp::add_submit_metrics(
+    size_t device_core_id, std::chrono::steady_clock::time_point start) {
+  if (!DpuMetrics::is_enabled()) {
+    return;
+  }
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  DpuMetrics::instance().add_submit(device_core_id, (uint64_t)us);
+}
+
 bool DpuRunnerBaseImp::check_fingerprint(size_t device_core_id) {
   auto model_fingerprint = session_->kernel_->get_fingerprint();
   auto dpu_fingerprint =
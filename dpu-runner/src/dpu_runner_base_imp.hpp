@@ -15,7 +15,10 @@
  * limitations under the License.
  */
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vart/runner.hpp>
 #include <xir/device_memory.hpp>
 #include <xir/graph/graph.hpp>
@@ -58,6 +61,33 @@ class DpuRunnerBaseImp : public vart::Runner {
   static void copy_tensor_buffer(vart::TensorBuffer* tb_from,
                                  vart::TensorBuffer* tb_to, float scale);
   bool check_fingerprint(size_t device_core_id);
+  // host latency of execute_async(), only recorded when
+  // XLNX_ENABLE_DPU_METRICS=1.
+  void add_submit_metrics(size_t device_core_id,
+                          std::chrono::steady_clock::time_point start);
+
+ private:
+  // everything start_dpu2() needs which does not change between runs.
+  struct execution_plan_t {
+    struct step_t {
+      DpuKernel::SubgraphCode sg_and_code;
+      std::string name;
+      std::string layer_name;
+      std::uint64_t workload;
+      std::uint64_t workload_on_arch;
+      int depth;
+      // "workload ... workload_on_arch ..." for XLNX_SHOW_DPU_COUNTER
+      std::string counter_log;
+    };
+    size_t device_core_id;
+    size_t size_of_gen_regs;
+    bool fingerprint_ok;
+    std::vector<step_t> steps;
+    // gen_reg with parameter registers filled, workspace registers are
+    // filled by fill_gen_reg() on each run.
+    std::vector<uint64_t> gen_reg_template;
+  };
+  const execution_plan_t& get_execution_plan(size_t device_core_id);
 
  public:
   enum TensorType { INPUT, INTERNAL, OUTPUT };
@@ -104,6 +134,8 @@ class DpuRunnerBaseImp : public vart::Runner {
   std::shared_ptr<xir::DeviceMemory> device_memory_;
   const xir::Subgraph* subgraph_;
   std::vector<uint64_t> regs_;
+  std::unique_ptr<execution_plan_t> plan_;
+  std::vector<uint64_t> gen_reg_;
   //
   std::string tensor_output_dir_ = "unkown";
 };
@@ -19,6 +19,7 @@
 #include <glog/logging.h>
 
 #include <UniLog/UniLog.hpp>
+#include <atomic>
 #include <cmath>
 #include <fstream>
 #include <numeric>
@@ -68,16 +69,18 @@ size_t DpuSessionBaseImp::my_get_device_core_id(size_t cu_size,
     core_list.resize(cu_size);
     std::iota(core_list.begin(), core_list.end(), 0);
   }
-  static auto session_count = 0u;
+  // sessions may be created concurrently, see
+  // Runner::create_runners_with_attrs()
+  static std::atomic<size_t> session_count{0u};
   UNI_LOG_CHECK(core_list.size() > 0u, VART_DEVICE_BUSY)
       << "cannot create a dpu session, no core id is available";
 
-  auto device_core_id = core_list[(session_count) % core_list.size()];
+  auto device_core_id = size_t(0u);
   if (attrs) {
     auto device_id = 0u;
     if (!attrs->has_attr("__device_core_id__")) {
-      attrs->set_attr<size_t>("__device_core_id__", device_core_id);
-      session_count = session_count + 1u;
+      attrs->set_attr<size_t>("__device_core_id__",
+                              core_list[session_count++ % core_list.size()]);
     }
     device_core_id = attrs->get_attr<size_t>("__device_core_id__");
 
@@ -95,7 +98,7 @@ size_t DpuSessionBaseImp::my_get_device_core_id(size_t cu_size,
       attrs_->set_attr<size_t>("__batch__", get_max_user_batch(device_core_id));
     }
   } else {
-    session_count = session_count + 1u;
+    device_core_id = core_list[session_count++ % core_list.size()];
     UNI_LOG_CHECK(device_core_id < cu_size, VART_DEVICE_MISMATCH)
         << "Invaild device_core_id, device_core_id must < cu_size ( " << cu_size
         << " )";
@@ -81,11 +81,13 @@ DpuKernelDdr::~DpuKernelDdr() {
 void DpuKernelDdr::load_code(const vart::dpu::DpuReg& code) {
   size_t device_id = device_id_;
   std::string cu_name = cu_full_name_;
-  auto& mc_code = code.value_;
-  auto mc_code_size = mc_code.size();
+  auto mc_code = code.data();
+  auto mc_code_size = code.size_;
   codes_.emplace_back(create_buffer_object(mc_code_size, device_id, cu_name));
   auto& code_ = codes_.back();
 
+  // code is a view of the subgraph attr, patch a private copy.
+  auto patched_code = std::vector<char>();
   if (ENV_PARAM(XLNX_SHORT_CIRCUIT_DPU_CODE)) {
     LOG(WARNING) << "XLNX_SHORT_CIRCUIT_DPU_CODE=1 is applied, result might "
                     "not be correct, check "
@@ -93,17 +95,19 @@ void DpuKernelDdr::load_code(const vart::dpu::DpuReg& code) {
                  << " "
                  << "size " << code_->size() << " "  //
         ;
-    *((uint32_t*)(&code.value_[0])) =
+    patched_code.assign(mc_code, mc_code + mc_code_size);
+    *((uint32_t*)(&patched_code[0])) =
         0x72200000u;  // SINGLE DPU END INSTRUCTION
+    mc_code = patched_code.data();
   }
   if (!ENV_PARAM(XLNX_ENABLE_CODE_UPLODING)) {
     LOG(WARNING)
         << "code upload is cancelled because XLNX_ENABLE_CODE_UPLODING=1";
   } else {
-    code_->copy_from_host(&mc_code[0], mc_code.size(), 0u);
+    code_->copy_from_host(mc_code, mc_code_size, 0u);
   }
   LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
-      << "loading release code  " << mc_code.size() << " bytes to " << std::hex
+      << "loading release code  " << mc_code_size << " bytes to " << std::hex
       << "0x" << code_->phy() << std::dec;
   // << vitis::ai::xxd((unsigned char*)&mc_code[0], 160, 16, 2);
 }
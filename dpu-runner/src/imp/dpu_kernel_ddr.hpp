@@ -44,6 +44,10 @@ class DpuKernelDdr : public vart::dpu::DpuKernel {
   virtual void load_parameter(
       const std::vector<vart::dpu::DpuReg>& parameters) override;
   virtual void load_code(const vart::dpu::DpuReg& code) override;
+  // CONST regs are uploaded by the tensor buffer allocator.
+  virtual bool is_parameter_loaded_by_kernel() const override {
+    return false;
+  }
 
  public:
   virtual void initialize() override;
@@ -143,10 +143,10 @@ void DpuKernelHbm::load_parameter(
   for (const auto& reg : parameters) {
     auto reg_id = reg.name_;
     auto reg_size = reg.size_;
-    auto& weight_or_bias = reg.value_;
+    auto weight_or_bias = reg.data();
     // reg_id = "REG_0", "REG_1", or "REG_2" etc.
     // hw_reg_id = "W0", "W1"
-    CHECK(!weight_or_bias.empty()) << "empty parameter! reg_id=" << reg_id;
+    CHECK(reg_size != 0u) << "empty parameter! reg_id=" << reg_id;
     auto hw_reg_id = reg_id_to_hw_segment.find(reg_id);
     auto found_hw_reg_id = hw_reg_id != reg_id_to_hw_segment.end();
     CHECK(found_hw_reg_id) << "cannot find hw_reg_id! reg_id=" << reg_id;
@@ -160,10 +160,9 @@ void DpuKernelHbm::load_parameter(
         << " const_parameter_id=" << const_parameter_id
         << " allocated chunk = " << chunk->to_string();
     CHECK(chunk != nullptr) << " out of memory for parameter";
-    chunk->upload(device_memory_.get(), &weight_or_bias[0], 0ul,
-                  weight_or_bias.size());
+    chunk->upload(device_memory_.get(), weight_or_bias, 0ul, reg_size);
     parameter_chunks_[reg_id] = std::move(chunk);
-    total += weight_or_bias.size();
+    total += reg_size;
   }
   LOG_IF(WARNING, total == 0) << "zeros no parameter loaded";
   LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER))
@@ -176,20 +175,25 @@ void DpuKernelHbm::load_code(const vart::dpu::DpuReg& code) {  //
   {
     auto chunk = get_code_hbm_manager()->allocate(code.size_);
     CHECK(chunk != nullptr) << "out of memory for code";
+    auto mc_code = code.data();
+    // code is a view of the subgraph attr, patch a private copy.
+    auto patched_code = std::vector<char>();
     if (ENV_PARAM(XLNX_SHORT_CIRCUIT_DPU_CODE)) {
       LOG(WARNING) << "XLNX_SHORT_CIRCUIT_DPU_CODE=1 is applied, result might "
                       "not be correct, check "
                    << "offset " << chunk->get_offset() << " "
                    << "size " << chunk->get_size() << " "  //
           ;
-      *((uint32_t*)(&code.value_[0])) =
+      patched_code.assign(mc_code, mc_code + code.size_);
+      *((uint32_t*)(&patched_code[0])) =
           0x72200000u;  // SINGLE DPU END INSTRUCTION
+      mc_code = patched_code.data();
     }
     if (!ENV_PARAM(XLNX_ENABLE_CODE_UPLODING)) {
       LOG(WARNING)
           << "code upload is cancelled because XLNX_DISABLE_CODE_UPLODING=1";
     } else {
-      chunk->upload(device_memory_.get(), &code.value_[0], 0ul, code.size_);
+      chunk->upload(device_memory_.get(), mc_code, 0ul, code.size_);
     }
     code_chunks_.emplace_back(std::move(chunk));
   }
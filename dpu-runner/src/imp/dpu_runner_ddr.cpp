@@ -62,7 +62,38 @@ static void init_tensor_buffer(vart::TensorBuffer* tb, int is_output) {
 DpuRunnerDdr::DpuRunnerDdr(const std::vector<const xir::Tensor*> input_tensors,
                            const std::vector<const xir::Tensor*> output_tensors,
                            DpuSessionBaseImp* session)
-    : vart::dpu::DpuRunnerBaseImp(input_tensors, output_tensors, session) {
+    : vart::dpu::DpuRunnerBaseImp(input_tensors, output_tensors, session),
+      my_input_{},
+      num_of_batch_{
+          (int)session_->get_max_user_batch(session_->get_device_core_id())},
+      num_of_regs_{
+          const_cast<const xir::DpuController*>(session_->get_dpu_controller())
+              ->get_size_of_gen_regs(session_->get_device_core_id())},
+      num_of_reg_base_{0u},
+      reg_attrs_{},
+      reg_base_gen_reg_{} {
+  auto dpu_session = dynamic_cast<DpuSessionImp*>(session_);
+  UNI_LOG_CHECK(dpu_session != nullptr, VART_NULL_PTR)
+      << "session = " << (void*)session_;
+  // only tensors owned by the session are cached, tensors of the user might
+  // be destroyed and their addresses reused.
+  for (auto tbs : {dpu_session->get_inputs(), dpu_session->get_outputs(),
+                   dpu_session->get_reg_base()}) {
+    for (auto tb : tbs) {
+      auto tensor = tb->get_tensor();
+      if (tensor->has_attr("reg_id") && tensor->has_attr("ddr_addr") &&
+          tensor->has_attr("location") &&
+          tensor->get_attr<int>("location") == 1) {
+        reg_attrs_.emplace(tensor, get_reg_attr(tensor));
+      }
+    }
+  }
+  num_of_reg_base_ = dpu_session->get_reg_base().size();
+  for (auto reg : dpu_session->get_reg_base()) {
+    for_each_gen_reg(reg, [this](size_t reg_idx, uint64_t base) {
+      reg_base_gen_reg_.emplace_back(reg_idx, base);
+    });
+  }
   for (auto i = 0; i < ENV_PARAM(DEBUG_DPU_WARMUP); ++i) {
     if (0)
       for (auto tb : session_->get_inputs()) {
@@ -179,6 +210,7 @@ std::vector<vart::TensorBuffer*> DpuRunnerDdr::prepare_input(
 std::pair<uint32_t, int> DpuRunnerDdr::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
+  auto start = std::chrono::steady_clock::now();
   __TIC__(DPU_RUNNER_COPY_INPUT);
   UNI_LOG_CHECK(my_input_.empty(), VART_SIZE_MISMATCH);
   my_input_ = prepare_input(input, output);
@@ -190,6 +222,7 @@ std::pair<uint32_t, int> DpuRunnerDdr::execute_async(
   prepare_output(output);
   __TOC__(DPU_RUNNER_COPY_OUTPUT);
   my_input_.clear();
+  add_submit_metrics(session_->get_device_core_id(), start);
   return std::make_pair<uint32_t, int>(1u, 0);
 }
 
@@ -239,53 +272,66 @@ static int get_ddr_addr(const xir::Tensor* tensor) {
   return ret;
 }
 
+DpuRunnerDdr::reg_attr_t DpuRunnerDdr::get_reg_attr(
+    const xir::Tensor* tensor) const {
+  auto it = reg_attrs_.find(tensor);
+  if (it != reg_attrs_.end()) {
+    return it->second;
+  }
+  auto dims = tensor->get_shape();
+  UNI_LOG_CHECK(dims[0] <= num_of_batch_, VART_DPU_INFO_ERROR)
+      << ", tensor_name = " << tensor->get_name();
+  auto reg_id = get_reg_id(tensor);
+  UNI_LOG_CHECK(reg_id < MAX_REG_ID_SIZE, VART_DPU_INFO_ERROR)
+      << "reg_id = " << reg_id << ", tensor_name = " << tensor->get_name();
+  auto ddr_addr = get_ddr_addr(tensor);
+  auto base_reg_flag = tensor->get_name().find("__reg__") == 0;
+  auto reg_batch = base_reg_flag ? num_of_batch_ : dims[0];
+  return reg_attr_t{reg_id, ddr_addr, reg_batch};
+}
+
+void DpuRunnerDdr::for_each_gen_reg(
+    vart::TensorBuffer* reg, const std::function<void(size_t, uint64_t)>& f) {
+  auto attr = get_reg_attr(reg->get_tensor());
+  auto last_batch = reg->get_tensor()->get_shape()[0] - 1;
+  auto dim_idx =
+      std::vector<int32_t>(reg->get_tensor()->get_shape().size(), 0);
+  for (auto batch_idx = 0; batch_idx < attr.reg_batch; ++batch_idx) {
+    dim_idx[0] = std::min(batch_idx, last_batch);
+    uint64_t base;
+    size_t size;
+    std::tie(base, size) = reg->data_phy(dim_idx);
+    UNI_LOG_CHECK(size != 0u, VART_DPU_ALLOC_ERROR)
+        << "data_phy size is 0, please check!";
+    base = base - attr.ddr_addr;
+    auto reg_idx = batch_idx * num_of_regs_ + attr.reg_id;
+    LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER) >= 2)
+        << "set base reg: " << reg_idx                                 //
+        << " num_of_regs: " << num_of_regs_                            //
+        << " reg_id: " << attr.reg_id                                  //
+        << " batch_idx: " << batch_idx                                 //
+        << " num_of_batch " << num_of_batch_                           //
+        << " / " << last_batch                                         //
+        << " base = " << std::hex << "0x" << base << std::dec          //
+        << " ddr = " << std::hex << "0x" << attr.ddr_addr << std::dec  //
+        << " tensor " << reg->get_tensor()->to_string()                //
+        ;
+    f(reg_idx, base);
+  }
+}
+
 void DpuRunnerDdr::fill_gen_reg(size_t device_core_id,
                                 std::vector<uint64_t>& gen_reg) {
   UNI_LOG_CHECK(my_input_.size() != 0u, VART_SIZE_MISMATCH);
-  auto num_of_batch =
-      (int)session_->get_max_user_batch(session_->get_device_core_id());
-  auto num_of_regs =
-      const_cast<const xir::DpuController*>(session_->get_dpu_controller())
-          ->get_size_of_gen_regs(device_core_id);
-  auto& reg_base = my_input_;
-  for (auto reg_base_idx = 0u; reg_base_idx < reg_base.size(); ++reg_base_idx) {
-    auto& reg = reg_base[reg_base_idx];
-    auto dims = reg->get_tensor()->get_shape();
-    UNI_LOG_CHECK(dims[0] <= num_of_batch, VART_DPU_INFO_ERROR)
-        << ", tensor_name = " << reg->get_tensor()->get_name();
-    auto dim_idx = std::vector<int32_t>(dims.size(), 0);
-    auto reg_id = get_reg_id(reg->get_tensor());
-    UNI_LOG_CHECK(reg_id < MAX_REG_ID_SIZE, VART_DPU_INFO_ERROR)
-        << "reg_id = " << reg_id
-        << ", tensor_name = " << reg->get_tensor()->get_name();
-    int ddr_addr = get_ddr_addr(reg->get_tensor());
-    auto base_reg_flag = reg->get_tensor()->get_name().find("__reg__") == 0;
-    auto reg_batch = base_reg_flag ? num_of_batch : dims[0];
-    for (auto batch_idx = 0; batch_idx < reg_batch; ++batch_idx) {
-      auto idx2 = std::min(batch_idx, reg->get_tensor()->get_shape()[0] - 1);
-      dim_idx[0] = idx2;
-      uint64_t base;
-      size_t size;
-      std::tie(base, size) = reg->data_phy(dim_idx);
-      UNI_LOG_CHECK(size != 0u, VART_DPU_ALLOC_ERROR)
-          << "data_phy size is 0, please check!";
-      // move get_ddr_addr() out of this loop to improve perf;
-      // int ddr_addr = get_ddr_addr(reg->get_tensor());
-      base = base - ddr_addr;
-      auto reg_idx = batch_idx * num_of_regs + reg_id;
-      LOG_IF(INFO, ENV_PARAM(DEBUG_DPU_RUNNER) >= 2)
-          << "set base reg: " << reg_idx                            //
-          << " num_of_regs: " << num_of_regs                        //
-          << " reg_id: " << reg_id                                  //
-          << " batch_idx: " << batch_idx                            //
-          << " num_of_batch " << num_of_batch                       //
-          << " / " << (reg->get_tensor()->get_shape()[0] - 1)       //
-          << " base = " << std::hex << "0x" << base << std::dec     //
-          << " ddr = " << std::hex << "0x" << ddr_addr << std::dec  //
-          << " tensor " << reg->get_tensor()->to_string()           //
-          ;
+  for (const auto& reg_idx_and_base : reg_base_gen_reg_) {
+    gen_reg[reg_idx_and_base.first] = reg_idx_and_base.second;
+  }
+  // my_input_ starts with the session's reg backstores, see prepare_input(),
+  // only zero copy tensor buffers of the user are left.
+  for (auto i = num_of_reg_base_; i < my_input_.size(); ++i) {
+    for_each_gen_reg(my_input_[i], [&gen_reg](size_t reg_idx, uint64_t base) {
       gen_reg[reg_idx] = base;
-    }
+    });
   }
 }
 
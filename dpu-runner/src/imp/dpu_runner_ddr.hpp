@@ -14,7 +14,9 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <functional>
 #include <memory>
+#include <unordered_map>
 
 #include "../dpu_runner_base_imp.hpp"
 #include "./dpu_kernel_ddr.hpp"
@@ -58,8 +60,26 @@ class DpuRunnerDdr : public DpuRunnerBaseImp {
   void copy_data_for_output(vart::TensorBuffer* tb_to,
                             vart::TensorBuffer* tb_from);
 
+ private:
+  struct reg_attr_t {
+    size_t reg_id;
+    int ddr_addr;
+    int reg_batch;
+  };
+  reg_attr_t get_reg_attr(const xir::Tensor* tensor) const;
+  // calls f(index of gen_reg, base address) for every batch of a reg.
+  void for_each_gen_reg(vart::TensorBuffer* reg,
+                        const std::function<void(size_t, uint64_t)>& f);
+
  private:
   std::vector<vart::TensorBuffer*> my_input_;
+  const int num_of_batch_;
+  const size_t num_of_regs_;
+  size_t num_of_reg_base_;
+  // attrs of session owned tensors, resolved once at session creation.
+  std::unordered_map<const xir::Tensor*, reg_attr_t> reg_attrs_;
+  // gen_reg values of the session's reg backstores, they never move.
+  std::vector<std::pair<size_t, uint64_t>> reg_base_gen_reg_;
 };
 
 }  // namespace dpu
@@ -92,6 +92,7 @@ static int find_tensor_index(std::vector<vart::TensorBuffer*> tensor_buffers,
 std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
+  auto start = std::chrono::steady_clock::now();
   auto my_input_tensor_buffers = session_->get_inputs();
   auto my_output_tensor_buffers = session_->get_outputs();
   // CHECK_EQ(my_output_tensor_buffers.size(), output.size());
@@ -149,6 +150,7 @@ std::pair<uint32_t, int> DpuRunnerHbm::execute_async(
     }
     // end copy output
   }
+  add_submit_metrics(device_core_id_, start);
   return ret;
 }
 
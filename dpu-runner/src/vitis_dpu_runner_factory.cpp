@@ -19,11 +19,15 @@
 #include <glog/logging.h>
 
 #include <mutex>
+#include <vitis/ai/env_config.hpp>
 #include <xir/graph/subgraph.hpp>
 
 #include "./dpu_session.hpp"
 #include "vart/runner.hpp"
 #include "vart/runner_ext.hpp"
+// sessions are safe to create concurrently, set it to go back to creating
+// one runner at a time.
+DEF_ENV_PARAM(XLNX_SERIAL_RUNNER_CREATION, "0");
 namespace vart {
 namespace dpu {
 
@@ -117,7 +121,10 @@ extern "C" vart::Runner* create_runner(const xir::Subgraph* subgraph) {
 extern "C" vart::Runner* create_runner_with_attrs(const xir::Subgraph* subgraph,
                                                   xir::Attrs* attrs) {
   static std::mutex mtx;
-  std::lock_guard<std::mutex> lock(mtx);
+  auto lock = std::unique_lock<std::mutex>(mtx, std::defer_lock);
+  if (ENV_PARAM(XLNX_SERIAL_RUNNER_CREATION)) {
+    lock.lock();
+  }
   auto ret = vart::dpu::DpuRunnerFactory::create_dpu_runner(subgraph, attrs);
   return ret.release();
 }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// run a model and print the metrics collected by the DPU runner.
+//
+// usage: env XLNX_ENABLE_DPU_METRICS=1 test_dpu_metrics <xmodel> <kernel>
+// [count]
+//
+// XLNX_DPU_CLOCK_MHZ and XLNX_DPU_PEAK_OPS_PER_CYCLE are used to compute
+// gops and mac_efficiency, e.g. XLNX_DPU_PEAK_OPS_PER_CYCLE=4096 for B4096.
+#include <glog/logging.h>
+
+#include <iostream>
+#include <string>
+
+#include "vart/dpu/dpu_metrics.hpp"
+#include "vart/dpu/vitis_dpu_runner_factory.hpp"
+#include "vart/runner_ext.hpp"
+
+int main(int argc, char* argv[]) {
+  CHECK_GE(argc, 3) << "usage: " << argv[0] << " <xmodel> <kernel> [count]";
+  LOG_IF(WARNING, !vart::dpu::DpuMetrics::is_enabled())
+      << "XLNX_ENABLE_DPU_METRICS is not set, no metrics are collected.";
+  auto filename = std::string(argv[1]);
+  auto kernel = std::string(argv[2]);
+  auto count = argc > 3 ? std::stoi(argv[3]) : 100;
+  auto runner =
+      vart::dpu::DpuRunnerFactory::create_dpu_runner(filename, kernel);
+  auto r = dynamic_cast<vart::RunnerExt*>(runner.get());
+  auto input = r->get_inputs();
+  auto output = r->get_outputs();
+  for (auto i = 0; i < count; ++i) {
+    runner->execute_async(input, output);
+    runner->wait(0, -1);
+  }
+  auto& metrics = vart::dpu::DpuMetrics::instance();
+  metrics.dump(std::cout);
+  for (const auto& m : metrics.get_subgraph_metrics()) {
+    // a low conv/load ratio and a low efficiency hints a bandwidth bound
+    // subgraph.
+    LOG_IF(INFO, m.load != 0u)
+        << m.subgraph << " conv/load=" << (double)m.conv / (double)m.load
+        << " gops=" << m.gops() << " mac_efficiency=" << m.mac_efficiency();
+  }
+  return 0;
+}
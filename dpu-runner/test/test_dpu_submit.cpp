@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// measure the host side cost of submitting one inference, i.e. everything
+// except the DPU itself.
+//
+// usage: env XLNX_XRT_CU_DRY_RUN=1 test_dpu_submit <xmodel> <kernel> [count]
+//
+// DEBUG_DPU_RUNNER_DRY_RUN=2 stops right after the registers are filled,
+// which isolates the per-run cost of the runner from the controller.
+#include <glog/logging.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vitis/ai/env_config.hpp>
+
+#include "vart/dpu/vitis_dpu_runner_factory.hpp"
+#include "vart/runner_ext.hpp"
+DEF_ENV_PARAM(XLNX_XRT_CU_DRY_RUN, "0");
+
+int main(int argc, char* argv[]) {
+  CHECK_GE(argc, 3) << "usage: " << argv[0] << " <xmodel> <kernel> [count]";
+  LOG_IF(WARNING, !ENV_PARAM(XLNX_XRT_CU_DRY_RUN))
+      << "XLNX_XRT_CU_DRY_RUN is not set, the DPU time is included.";
+  auto filename = std::string(argv[1]);
+  auto kernel = std::string(argv[2]);
+  auto count = argc > 3 ? std::stoi(argv[3]) : 10000;
+  auto runner =
+      vart::dpu::DpuRunnerFactory::create_dpu_runner(filename, kernel);
+  auto r = dynamic_cast<vart::RunnerExt*>(runner.get());
+  auto input = r->get_inputs();
+  auto output = r->get_outputs();
+  // warm up, the first run builds the execution plan and the command
+  // template.
+  runner->execute_async(input, output);
+  runner->wait(0, -1);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < count; ++i) {
+    runner->execute_async(input, output);
+    runner->wait(0, -1);
+  }
+  auto end = std::chrono::steady_clock::now();
+  auto us = std::chrono::duration<double, std::micro>(end - start).count();
+  std::cout << "count=" << count << " submit=" << us / count
+            << "us/inference" << std::endl;
+  return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// measure cold-start latency and memory footprint of runner creation.
+//
+// usage: test_model_load <xmodel> <kernel> [num_of_runners] [parallel]
+//
+// with "parallel", <kernel> is a subgraph name and the runners are created
+// by vart::Runner::create_runners_with_attrs().
+#include <glog/logging.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <xir/attrs/attrs.hpp>
+#include <xir/graph/graph.hpp>
+
+#include "vart/dpu/vitis_dpu_runner_factory.hpp"
+#include "vart/runner.hpp"
+#include "vart/runner_ext.hpp"
+
+// returns the value in kB of a field of /proc/self/status, e.g. VmHWM
+static long read_proc_status_kb(const std::string& field) {
+  auto status = std::ifstream("/proc/self/status");
+  auto line = std::string();
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size() + 1, field + ":") == 0) {
+      return std::stol(line.substr(field.size() + 1));
+    }
+  }
+  return -1;
+}
+
+static void report(const std::string& what, double ms) {
+  std::cout << what << ": " << ms << " ms"                       //
+            << " VmRSS=" << read_proc_status_kb("VmRSS") << " kB"  //
+            << " VmHWM=" << read_proc_status_kb("VmHWM") << " kB"  //
+            << std::endl;
+}
+
+static double ms_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static const xir::Subgraph* find_subgraph(const xir::Graph* graph,
+                                          const std::string& name) {
+  for (auto s : graph->get_root_subgraph()->children_topological_sort()) {
+    if (s->get_name() == name) {
+      return s;
+    }
+  }
+  LOG(FATAL) << "cannot find subgraph " << name;
+  return nullptr;
+}
+
+int main(int argc, char* argv[]) {
+  CHECK_GE(argc, 3) << "usage: " << argv[0]
+                    << " <xmodel> <kernel> [num_of_runners] [parallel]";
+  auto filename = std::string(argv[1]);
+  auto kernel = std::string(argv[2]);
+  auto num_of_runners = argc > 3 ? std::stoi(argv[3]) : 1;
+  auto parallel = argc > 4 && std::string(argv[4]) == "parallel";
+  report("baseline", 0.0);
+  auto start_all = std::chrono::steady_clock::now();
+  auto runners = std::vector<std::unique_ptr<vart::Runner>>();
+  auto graph = std::unique_ptr<xir::Graph>();
+  auto attrs = std::vector<std::unique_ptr<xir::Attrs>>();
+  if (parallel) {
+    graph = xir::Graph::deserialize(filename);
+    auto attrs_ptrs = std::vector<xir::Attrs*>();
+    for (auto i = 0; i < num_of_runners; ++i) {
+      attrs.emplace_back(xir::Attrs::create());
+      attrs_ptrs.emplace_back(attrs.back().get());
+    }
+    auto start = std::chrono::steady_clock::now();
+    runners = vart::Runner::create_runners_with_attrs(
+        find_subgraph(graph.get(), kernel), attrs_ptrs);
+    report(std::to_string(num_of_runners) + " runners", ms_since(start));
+  } else {
+    for (auto i = 0; i < num_of_runners; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      runners.emplace_back(
+          vart::dpu::DpuRunnerFactory::create_dpu_runner(filename, kernel));
+      report("runner #" + std::to_string(i), ms_since(start));
+    }
+  }
+  // time to first inference, from the start of runner creation to the end
+  // of the first run.
+  auto r = dynamic_cast<vart::RunnerExt*>(runners[0].get());
+  auto v = r->execute_async(r->get_inputs(), r->get_outputs());
+  r->wait((int)v.first, -1);
+  report("first inference", ms_since(start_all));
+  return 0;
+}
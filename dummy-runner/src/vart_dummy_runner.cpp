@@ -55,18 +55,41 @@ class DummyRunner : public vart::RunnerExt {
   std::vector<std::unique_ptr<xir::Tensor>> outputs_;
   std::vector<std::unique_ptr<vart::TensorBuffer>> input_tensor_buffers_;
   std::vector<std::unique_ptr<vart::TensorBuffer>> output_tensor_buffers_;
+  int batch_size_;
+  int process_time_;
 };
 
+// attrs "dummy_runner_batch_sizes" and "dummy_runner_process_times" give one
+// value per runner created by the async runner, so that heterogeneous cores
+// can be simulated, e.g. {4, 1} and {8, 2} for a big core and a small core.
+static int get_per_runner_attr(xir::Attrs* attrs, const std::string& name,
+                               int default_value) {
+  if (attrs == nullptr || !attrs->has_attr(name)) {
+    return default_value;
+  }
+  auto values = attrs->get_attr<std::vector<int32_t>>(name);
+  CHECK(!values.empty()) << "attr " << name << " is empty";
+  auto idx = attrs->has_attr("async_runner_idx")
+                 ? attrs->get_attr<size_t>("async_runner_idx")
+                 : 0u;
+  return values[idx % values.size()];
+}
+
 DummyRunner::DummyRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
     : inputs_{}, outputs_{} {
+  batch_size_ = get_per_runner_attr(attrs, "dummy_runner_batch_sizes",
+                                    ENV_PARAM(DUMMY_RUNNER_BATCH_SIZE));
+  process_time_ = get_per_runner_attr(attrs, "dummy_runner_process_times",
+                                      ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME));
   LOG_IF(INFO, ENV_PARAM(DEBUG_DUMMY_RUNNER))
       << "@" << (void*)this << " dummy runner is created for subgraph "
-      << subgraph->get_name();
+      << subgraph->get_name() << " batch_size=" << batch_size_
+      << " process_time=" << process_time_ << "ms";
   auto input_set = subgraph->get_sorted_input_tensors();
   inputs_.reserve(input_set.size());
   for (auto b : input_set) {
     auto dims = b->get_shape();
-    dims[0] = ENV_PARAM(DUMMY_RUNNER_BATCH_SIZE);
+    dims[0] = batch_size_;
     auto x = xir::Tensor::create(b->get_name(), dims, b->get_data_type());
     x->set_attrs(b->get_attrs());
     for (auto op : b->get_producer()->get_fanout_ops()) {
@@ -87,7 +110,7 @@ DummyRunner::DummyRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
   outputs_.reserve(output_set.size());
   for (auto b : output_set) {
     auto dims = b->get_shape();
-    dims[0] = ENV_PARAM(DUMMY_RUNNER_BATCH_SIZE);
+    dims[0] = batch_size_;
     auto x = xir::Tensor::create(b->get_name(), dims, b->get_data_type());
     x->set_attrs(b->get_attrs());
     outputs_.emplace_back(std::move(x));
@@ -107,9 +130,8 @@ std::pair<uint32_t, int> DummyRunner::execute_async(
       << "@" << (void*)this << " start to run: "
       << " inputs= " << to_string(input) << " "    //
       << " outputs= " << to_string(output) << " "  //
-      << "processing time =" << ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME) << " ms";
-  std::this_thread::sleep_for(
-      std::chrono::milliseconds(ENV_PARAM(DUMMY_RUNNER_PROCESS_TIME)));
+      << "processing time =" << process_time_ << " ms";
+  std::this_thread::sleep_for(std::chrono::milliseconds(process_time_));
   return std::make_pair(0u, 0);
 }
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// usage: test_async_runner_priority <xmodel>
+//
+// creates two async runners over the same dummy runners, one for batch
+// traffic at priority 3 and one for interactive requests at priority 0.
+// while the batch runner floods the queue, the latency of interactive
+// requests is measured, then the deadline admission is checked. run with
+// XLNX_ASYNC_RUNNER_PERF=1 to see the statistics per priority class.
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vart/runner.hpp>
+#include <vart/runner_ext.hpp>
+#include <xir/graph/graph.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_RUNNERS, "2");
+DEF_ENV_PARAM(PROCESS_TIME, "4");
+DEF_ENV_PARAM(NUM_OF_BATCH_REQUESTS, "400");
+DEF_ENV_PARAM(NUM_OF_INTERACTIVE_REQUESTS, "30");
+
+struct request_t {
+  std::vector<std::unique_ptr<vart::TensorBuffer>> inputs;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> outputs;
+  std::pair<uint32_t, int> job;
+  std::chrono::steady_clock::time_point start;
+};
+
+static request_t submit(vart::Runner* runner) {
+  auto ret = request_t{
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors()),
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors()),
+      {},
+      std::chrono::steady_clock::now()};
+  ret.job =
+      runner->execute_async(vitis::ai::vector_unique_ptr_get(ret.inputs),
+                            vitis::ai::vector_unique_ptr_get(ret.outputs));
+  return ret;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static std::unique_ptr<vart::Runner> create_runner(const xir::Subgraph* s,
+                                                   int priority) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr("async", true);
+  attrs->set_attr("num_of_dpu_runners", (size_t)ENV_PARAM(NUM_OF_RUNNERS));
+  attrs->set_attr("lib", std::map<std::string, std::string>{
+                             {"DPU", "libvart-dummy-runner.so"}});
+  attrs->set_attr("dummy_runner_batch_sizes", std::vector<int32_t>{1});
+  attrs->set_attr("dummy_runner_process_times",
+                  std::vector<int32_t>{ENV_PARAM(PROCESS_TIME)});
+  attrs->set_attr("async_priority", priority);
+  return vart::Runner::create_runner_with_attrs(s, attrs.get());
+}
+
+static int set_run_attrs(vart::Runner* runner, int priority, int deadline) {
+  auto ext = dynamic_cast<vart::RunnerExt*>(runner);
+  CHECK(ext != nullptr) << "the async runner is not a RunnerExt";
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr("async_priority", priority);
+  attrs->set_attr("async_deadline_ms", deadline);
+  return ext->set_run_attrs(attrs);
+}
+
+int main(int argc, char* argv[]) {
+  auto graph = xir::Graph::deserialize(argv[1]);
+  auto root = graph->get_root_subgraph();
+  xir::Subgraph* s = nullptr;
+  for (auto c : root->get_children()) {
+    if (c->get_attr<std::string>("device") == "DPU") {
+      s = c;
+      break;
+    }
+  }
+  CHECK(s != nullptr) << "cannot find a DPU subgraph";
+  auto batch_runner = create_runner(s, 3);
+  auto interactive_runner = create_runner(s, 0);
+
+  // every runner is measured once before deadlines are predicted.
+  for (auto i = 0; i < ENV_PARAM(NUM_OF_RUNNERS); ++i) {
+    auto r = submit(interactive_runner.get());
+    interactive_runner->wait((int)r.job.first, -1);
+  }
+
+  auto batch_ms = 0.0;
+  std::atomic<bool> flooding{true};
+  auto flood = std::thread([&]() {
+    auto requests = std::vector<request_t>();
+    requests.reserve(ENV_PARAM(NUM_OF_BATCH_REQUESTS));
+    for (auto i = 0; i < ENV_PARAM(NUM_OF_BATCH_REQUESTS); ++i) {
+      requests.emplace_back(submit(batch_runner.get()));
+      CHECK_EQ(requests.back().job.second, 0) << "cannot create job";
+    }
+    for (auto& r : requests) {
+      batch_runner->wait((int)r.job.first, -1);
+      batch_ms += elapsed_ms(r.start);
+    }
+    batch_ms = batch_ms / requests.size();
+    flooding = false;
+  });
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(ENV_PARAM(PROCESS_TIME) * 4));
+
+  auto interactive_ms = 0.0;
+  for (auto i = 0; i < ENV_PARAM(NUM_OF_INTERACTIVE_REQUESTS); ++i) {
+    auto r = submit(interactive_runner.get());
+    CHECK_EQ(r.job.second, 0) << "cannot create job";
+    interactive_runner->wait((int)r.job.first, -1);
+    interactive_ms += elapsed_ms(r.start);
+  }
+  interactive_ms = interactive_ms / ENV_PARAM(NUM_OF_INTERACTIVE_REQUESTS);
+  auto overlapped = flooding.load();
+
+  // a deadline shorter than one run cannot be met, it is rejected at once.
+  CHECK_EQ(set_run_attrs(interactive_runner.get(), 0, 1), 0);
+  auto tight = submit(interactive_runner.get());
+  // a deadline of many runs is admitted and met.
+  CHECK_EQ(set_run_attrs(interactive_runner.get(), 0,
+                         ENV_PARAM(PROCESS_TIME) * 50),
+           0);
+  auto loose = submit(interactive_runner.get());
+  auto loose_ok = loose.job.second == 0 &&
+                  interactive_runner->wait((int)loose.job.first, -1) == 0 &&
+                  elapsed_ms(loose.start) < ENV_PARAM(PROCESS_TIME) * 50;
+  flood.join();
+
+  auto ok = overlapped && interactive_ms < batch_ms &&
+            tight.job.second != 0 && loose_ok;
+  std::cout << "interactive latency: " << interactive_ms << "ms"
+            << ", batch latency: " << batch_ms << "ms"
+            << (overlapped ? "" : " (the flood ended early)")
+            << ", tight deadline status: " << tight.job.second
+            << ", loose deadline: " << (loose_ok ? "met" : "missed")
+            << (ok ? " PASS" : " FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// usage: test_async_runner_schedule <xmodel>
+//
+// creates an async runner over dummy runners of different batch sizes and
+// latencies, e.g. a big core with batch 4 taking 8ms and a small core with
+// batch 1 taking 2ms, then measures a burst and a series of stragglers. run
+// with XLNX_ASYNC_RUNNER_PERF=1 to see per-runner utilization.
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vart/runner.hpp>
+#include <xir/graph/graph.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM_2(BATCH_SIZES, "4,1", std::string);
+DEF_ENV_PARAM_2(PROCESS_TIMES, "8,2", std::string);
+DEF_ENV_PARAM(NUM_OF_REQUESTS, "400");
+DEF_ENV_PARAM(NUM_OF_STRAGGLERS, "50");
+
+static std::vector<int32_t> parse_list(const std::string& str) {
+  auto ret = std::vector<int32_t>();
+  std::istringstream in(str);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    ret.push_back(std::stoi(item));
+  }
+  return ret;
+}
+
+struct request_t {
+  std::vector<std::unique_ptr<vart::TensorBuffer>> inputs;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> outputs;
+  std::pair<uint32_t, int> job;
+};
+
+static request_t submit(vart::Runner* runner) {
+  auto ret = request_t{
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors()),
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors()),
+      {}};
+  ret.job =
+      runner->execute_async(vitis::ai::vector_unique_ptr_get(ret.inputs),
+                            vitis::ai::vector_unique_ptr_get(ret.outputs));
+  CHECK_EQ(ret.job.second, 0) << "cannot create job";
+  return ret;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+int main(int argc, char* argv[]) {
+  auto graph = xir::Graph::deserialize(argv[1]);
+  auto root = graph->get_root_subgraph();
+  xir::Subgraph* s = nullptr;
+  for (auto c : root->get_children()) {
+    if (c->get_attr<std::string>("device") == "DPU") {
+      s = c;
+      break;
+    }
+  }
+  CHECK(s != nullptr) << "cannot find a DPU subgraph";
+  auto batch_sizes = parse_list(ENV_PARAM(BATCH_SIZES));
+  auto process_times = parse_list(ENV_PARAM(PROCESS_TIMES));
+  CHECK_EQ(batch_sizes.size(), process_times.size());
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr("async", true);
+  attrs->set_attr("num_of_dpu_runners", batch_sizes.size());
+  attrs->set_attr("lib", std::map<std::string, std::string>{
+                             {"DPU", "libvart-dummy-runner.so"}});
+  attrs->set_attr("dummy_runner_batch_sizes", batch_sizes);
+  attrs->set_attr("dummy_runner_process_times", process_times);
+  auto runner = vart::Runner::create_runner_with_attrs(s, attrs.get());
+
+  // every runner is measured once before the scheduler trusts its service
+  // time.
+  for (auto i = 0u; i < batch_sizes.size(); ++i) {
+    auto r = submit(runner.get());
+    runner->wait((int)r.job.first, -1);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  auto requests = std::vector<request_t>();
+  requests.reserve(ENV_PARAM(NUM_OF_REQUESTS));
+  for (auto i = 0; i < ENV_PARAM(NUM_OF_REQUESTS); ++i) {
+    requests.emplace_back(submit(runner.get()));
+  }
+  for (auto& r : requests) {
+    runner->wait((int)r.job.first, -1);
+  }
+  auto burst_ms = elapsed_ms(start);
+
+  start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < ENV_PARAM(NUM_OF_STRAGGLERS); ++i) {
+    auto r = submit(runner.get());
+    runner->wait((int)r.job.first, -1);
+  }
+  auto straggler_ms = elapsed_ms(start) / ENV_PARAM(NUM_OF_STRAGGLERS);
+
+  // a straggler should go to the runner with the shortest latency.
+  auto min_time = *std::min_element(process_times.begin(), process_times.end());
+  auto max_time = *std::max_element(process_times.begin(), process_times.end());
+  auto ok = min_time == max_time || straggler_ms < (min_time + max_time) / 2.0;
+  std::cout << "burst: " << ENV_PARAM(NUM_OF_REQUESTS) << " requests in "
+            << burst_ms << "ms, straggler latency: " << straggler_ms << "ms"
+            << (ok ? " PASS" : " FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
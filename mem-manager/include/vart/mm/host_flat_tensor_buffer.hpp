@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "vart/host_memory.hpp"
 #include "vart/tensor_buffer.hpp"
 
 #include <xir/tensor/tensor.hpp>
@@ -29,6 +30,9 @@ class HostFlatTensorBuffer : public TensorBuffer {
   explicit HostFlatTensorBuffer(const xir::Tensor* tensor);
   explicit HostFlatTensorBuffer(const xir::Tensor* tensor,
                                 std::vector<int32_t> strides);
+  explicit HostFlatTensorBuffer(const xir::Tensor* tensor,
+                                std::vector<int32_t> strides,
+                                const host_memory_policy_t& policy);
   virtual ~HostFlatTensorBuffer();
 
  public:
@@ -42,6 +46,7 @@ class HostFlatTensorBuffer : public TensorBuffer {
   const int32_t last_continued_dim;
 
  private:
+  std::unique_ptr<HostMemory> memory_;
   char* data_;
 };
 
@@ -88,19 +88,15 @@ static int32_t get_last_continued_dim(int32_t bit_width,
 }
 
 HostFlatTensorBuffer::HostFlatTensorBuffer(const xir::Tensor* tensor)
-    : TensorBuffer(tensor),
-      data_type(tensor_->get_data_type()),
-      shape(tensor_->get_shape()),
-      strides(get_strides(tensor_, true)),
-      last_continued_dim(
-          get_last_continued_dim(data_type.bit_width, shape, strides)) {
-  auto size =
-      static_cast<uint32_t>(std::ceil(shape.front() * strides.front() / 8.f));
-  data_ = new char[size];
-}
+    : HostFlatTensorBuffer(tensor, get_strides(tensor, true)) {}
 
 HostFlatTensorBuffer::HostFlatTensorBuffer(const xir::Tensor* tensor,
                                            std::vector<int32_t> strides)
+    : HostFlatTensorBuffer(tensor, strides, get_host_memory_policy()) {}
+
+HostFlatTensorBuffer::HostFlatTensorBuffer(const xir::Tensor* tensor,
+                                           std::vector<int32_t> strides,
+                                           const host_memory_policy_t& policy)
     : TensorBuffer(tensor),
       data_type(tensor_->get_data_type()),
       shape(tensor_->get_shape()),
@@ -109,13 +105,11 @@ HostFlatTensorBuffer::HostFlatTensorBuffer(const xir::Tensor* tensor,
           get_last_continued_dim(data_type.bit_width, shape, strides)) {
   auto size =
       static_cast<uint32_t>(std::ceil(shape.front() * strides.front() / 8.f));
-  data_ = new char[size];
+  memory_ = HostMemory::allocate(size, policy);
+  data_ = static_cast<char*>(memory_->data());
 }
 
-HostFlatTensorBuffer::~HostFlatTensorBuffer() {
-  delete[] data_;
-  data_ = nullptr;
-}
+HostFlatTensorBuffer::~HostFlatTensorBuffer() { data_ = nullptr; }
 
 static size_t size_of_element_in_bytes(size_t num_of_element,
                                        size_t bit_width) {
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "vart/runner.hpp"
+
+namespace xir {
+class Graph;
+}  // namespace xir
+
+namespace vart {
+
+/**
+ * @brief Runs all child subgraphs of an xmodel, e.g. DPU, CPU and softmax
+ * partitions, as a software pipeline.
+ *
+ * One runner is created for every child subgraph which is not a "USER"
+ * subgraph, in topological order, each runner is a stage. Tensors passed
+ * between stages are allocated once for every frame in flight. Every stage
+ * has its own thread, so that while frame N is in a CPU stage, frame N+1
+ * can be in a DPU stage.
+ *
+ * Inputs are the stage inputs which no stage produces, outputs are the
+ * stage outputs which no stage consumes. The batch size of a frame is the
+ * largest batch size of the stages, e.g. the core batch of a DPU stage.
+ * The batch size of every stage must divide it, a stage with a smaller
+ * batch size, e.g. a CPU stage, runs once per slice of the frame.
+ *
+ * A frame which fails in a stage skips the following stages. wait()
+ * returns the status of the failing runner, or rethrows the exception it
+ * threw. Only one thread can wait for a job at a time, wait() fails if
+ * another thread is waiting for it. execute_async() fails when the job id
+ * would be reused by a job which is not waited for.
+ *
+ * Sample code:
+ *
+ * @code
+   auto graph = xir::Graph::deserialize(xmodel);
+   auto attrs = xir::Attrs::create();
+   attrs->set_attr<size_t>("graph_runner_depth", 3u);
+   auto runner = vart::GraphRunner::create(graph.get(), attrs.get());
+   auto inputs = vart::alloc_cpu_flat_tensor_buffers(
+       runner->get_input_tensors());
+   ...
+   auto job = runner->execute_async(inputs, outputs);
+   runner->wait((int)job.first, -1);
+ * @endcode
+ */
+class GraphRunner : public Runner {
+ public:
+  struct stage_stat_t {
+    std::string subgraph_name;
+    std::string device;
+    uint64_t num_of_runs;
+    // time spent in the runner, i.e. execute_async() and wait()
+    uint64_t total_run_time_us;
+    uint64_t max_run_time_us;
+    // time a frame waits in front of the stage
+    uint64_t total_queue_time_us;
+  };
+
+ public:
+  /**
+   * @brief Factory function to create a graph runner.
+   *
+   * @param graph the xmodel, it must outlive the runner.
+   *
+   * @param attrs passed to the runner of every stage, e.g. attrs["lib"]
+   * overrides the runner library by device. attrs["graph_runner_depth"]
+   * is the max number of frames in flight, by default the number of
+   * stages. execute_async() blocks when that many frames are in flight.
+   *
+   * @return An instance of graph runner.
+   */
+  static std::unique_ptr<GraphRunner> create(const xir::Graph* graph,
+                                             xir::Attrs* attrs = nullptr);
+
+ public:
+  explicit GraphRunner() = default;
+  GraphRunner(const GraphRunner&) = delete;
+  GraphRunner& operator=(const GraphRunner& other) = delete;
+  virtual ~GraphRunner() = default;
+
+ public:
+  /// one element per stage, in the order of execution.
+  virtual std::vector<stage_stat_t> get_stage_stats() = 0;
+};
+
+}  // namespace vart
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "vart/tensor_buffer.hpp"
+
+namespace vitis {
+namespace ai {
+class ThreadPool;
+}  // namespace ai
+}  // namespace vitis
+
+namespace vart {
+
+/// Image preprocessing for a DPU input tensor.
+///
+/// Bilinear resize, optional BGR/RGB swap, mean/scale normalization and
+/// fix-point quantization with DPU rounding are fused into one pass over
+/// the output, which is written in the NHWC layout of the tensor, strides
+/// included. Source rows are resized horizontally once into a float row
+/// cache, the rest is a branch-free loop over the output row which the
+/// compiler vectorizes. Frames of a batch, and rows of a frame when there
+/// are fewer frames than threads, are split among a worker pool.
+class ImagePreprocessor {
+ public:
+  /// a packed 3-channel uint8 image, e.g. BGR as decoded by OpenCV.
+  /// stride is the number of bytes per row, 0 means width * 3.
+  struct frame_t {
+    const uint8_t* data;
+    int width;
+    int height;
+    int stride;
+  };
+
+ public:
+  /// tensor is an int8 NHWC tensor with 3 channels and attr "fix_point".
+  /// mean and scale are given in the channel order of the tensor, i.e.
+  /// after the swap, output = round((pixel - mean[c]) * scale[c] *
+  /// 2^fix_point). num_of_threads == 0 means
+  /// std::thread::hardware_concurrency().
+  explicit ImagePreprocessor(const xir::Tensor* tensor,
+                             const std::array<float, 3>& mean,
+                             const std::array<float, 3>& scale,
+                             bool swap_rb = false,
+                             size_t num_of_threads = 0u);
+  ~ImagePreprocessor();
+  ImagePreprocessor(const ImagePreprocessor& other) = delete;
+  ImagePreprocessor& operator=(const ImagePreprocessor& other) = delete;
+
+ public:
+  /// frames[i] goes to batch i of tensor_buffer, e.g. one of the runner's
+  /// get_inputs(). HOST_PHY tensor buffers are written in place and
+  /// flushed.
+  void run(const std::vector<frame_t>& frames,
+           vart::TensorBuffer* tensor_buffer) const;
+
+  /// one frame to one batch of the tensor, in the layout of the tensor.
+  void run(const frame_t& frame, int8_t* output) const;
+
+ private:
+  void run_rows(const frame_t& frame, int8_t* output, int row_begin,
+                int row_end) const;
+  template <typename TaskFunc>
+  void for_each_task(size_t num_of_tasks, TaskFunc&& func) const;
+
+ private:
+  int height_;
+  int width_;
+  // strides of H, W and C in bytes
+  size_t stride_h_;
+  size_t stride_w_;
+  size_t stride_c_;
+  size_t stride_n_;
+  bool swap_rb_;
+  // output = pixel * scale_row_[i] + bias_row_[i], i = x * 3 + c, so that
+  // the inner loop does not depend on the channel.
+  std::vector<float> scale_row_;
+  std::vector<float> bias_row_;
+  std::unique_ptr<vitis::ai::ThreadPool> pool_;
+  size_t num_of_threads_;
+};
+
+}  // namespace vart
@@ -149,6 +149,25 @@ class Runner : public BaseRunner<const std::vector<TensorBuffer*>&> {
   static std::unique_ptr<Runner> create_runner_with_attrs(
       const xir::Subgraph* subgraph, xir::Attrs* attrs);
 
+  /**
+   * @brief Factory function to create several runners of one subgraph,
+   * e.g. one per DPU core.
+   *
+   * The runner library is resolved once. The first runner is created
+   * alone, so that the state runners share, e.g. code and parameters, is
+   * loaded once. The other runners are created in parallel.
+   *
+   * @param subgraph  XIR Subgraph
+   *
+   * @param attrs one XIR attrs object per runner, they must outlive the
+   * runners. Do not pass the same object twice, otherwise the runners
+   * might all use the same device core.
+   *
+   * @return runners, the i-th runner is created with attrs[i].
+   */
+  static std::vector<std::unique_ptr<Runner>> create_runners_with_attrs(
+      const xir::Subgraph* subgraph, const std::vector<xir::Attrs*>& attrs);
+
   //# Overload method with model directory for DPUV1
   // brief create dpu runner by model_directory
   //
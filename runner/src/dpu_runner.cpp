@@ -27,7 +27,11 @@
 #include <glog/logging.h>
 
 #include <UniLog/UniLog.hpp>
+#include <chrono>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <mutex>
 #include <xir/graph/graph.hpp>
 #include <xir/graph/subgraph.hpp>
 
@@ -57,6 +61,32 @@ static std::string guess_plugin_name(const std::string& name) {
   return ret;
 }
 
+// open_plugin() and plugin_sym() go through the dynamic loader, which has a
+// global lock, and runners keep asking for the same few symbols. plugins
+// are never closed, so a resolved symbol stays valid.
+static void* find_plugin_sym(const std::string& libname,
+                             const std::string& symbol) {
+  static std::mutex mtx;
+  static std::map<std::pair<std::string, std::string>, void*> cache;
+  std::lock_guard<std::mutex> lock(mtx);
+  auto key = std::make_pair(libname, symbol);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  auto handle = vitis::ai::open_plugin(guess_plugin_name(libname),
+                                       vitis::ai::scope_t::PUBLIC);
+  UNI_LOG_CHECK(handle != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
+      << "cannot open library!"
+      << " lib=" << libname << ", error=" << vitis::ai::plugin_error(handle);
+  auto ret = vitis::ai::plugin_sym(handle, symbol);
+  UNI_LOG_CHECK(ret != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
+      << "cannot load symbol '" << symbol << "'!"
+      << " lib=" << libname << ", error=" << vitis::ai::plugin_error(handle);
+  cache.emplace(key, ret);
+  return ret;
+}
+
 #if USE_JSON_C
 // # Bring back older meta json read utility functions
 static std::string safe_read_string_with_default(
@@ -206,18 +236,7 @@ std::unique_ptr<Runner> Runner::create_runner(const xir::Subgraph* subgraph,
       << "Cannot find runner for mode " << mode
       << "! subgraph name: " << subgraph->get_name();
   typedef vart::Runner* (*INIT_FUN)(const xir::Subgraph* subgraph);
-  INIT_FUN init_fun = NULL;
-  auto handle = vitis::ai::open_plugin(guess_plugin_name(iter_lib->second),
-                                       vitis::ai::scope_t::PUBLIC);
-  UNI_LOG_CHECK(handle != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
-      << "cannot open library!"
-      << " lib=" << iter_lib->second
-      << ", error=" << vitis::ai::plugin_error(handle);
-  init_fun = (INIT_FUN)vitis::ai::plugin_sym(handle, "create_runner");
-  UNI_LOG_CHECK(init_fun != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
-      << "cannot load symbol 'create_runner'!"
-      << " lib=" << iter_lib->second
-      << ", error=" << vitis::ai::plugin_error(handle);
+  auto init_fun = (INIT_FUN)find_plugin_sym(iter_lib->second, "create_runner");
   return std::unique_ptr<vart::Runner>(init_fun(subgraph));
 }
 
@@ -262,7 +281,6 @@ std::unique_ptr<Runner> Runner::create_runner_with_attrs(
       << "! subgraph name: " << subgraph->get_name();
   typedef vart::Runner* (*INIT_FUN)(const xir::Subgraph* subgraph,
                                     xir::Attrs* attrs);
-  INIT_FUN init_fun = NULL;
   auto libname = iter_lib->second;
   // override the default runner defined in the subgraph via ATTRS
   // [code]
@@ -287,31 +305,16 @@ std::unique_ptr<Runner> Runner::create_runner_with_attrs(
           << "] in attrs, use default lib in the subgraph, i.e. " << libname;
     }
   }
-  auto handle = vitis::ai::open_plugin(guess_plugin_name(libname),
-                                       vitis::ai::scope_t::PUBLIC);
-  UNI_LOG_CHECK(handle != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
-      << "cannot open library!"
-      << " lib=" << libname << ", error=" << vitis::ai::plugin_error(handle);
   // finally we look up for the init function.
-  init_fun =
-      (INIT_FUN)vitis::ai::plugin_sym(handle, "create_runner_with_attrs");
-  UNI_LOG_CHECK(init_fun != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
-      << "cannot load symbol 'create_runner'!"
-      << " lib=" << iter_lib->second
-      << ", error=" << vitis::ai::plugin_error(handle);
+  auto init_fun =
+      (INIT_FUN)find_plugin_sym(libname, "create_runner_with_attrs");
   // attrs
   if (attrs && attrs->has_attr("interception")) {
     auto interception_lib = attrs->get_attr<std::string>("interception");
     typedef vart::Runner* (*INTERCEPT_INIT_FUN)(
         INIT_FUN fun, const xir::Subgraph* subgraph, xir::Attrs* attrs);
-    auto interception_handle = vitis::ai::open_plugin(
-        guess_plugin_name(interception_lib), vitis::ai::scope_t::PUBLIC);
-    UNI_LOG_CHECK(interception_handle != NULL, VART_RUNNER_CONSTRUCTION_FAIL)
-        << "cannot open library!"
-        << " lib=" << interception_lib
-        << ", error=" << vitis::ai::plugin_error(handle);
-    auto interception_fun = (INTERCEPT_INIT_FUN)vitis::ai::plugin_sym(
-        interception_handle, "create_runner_with_attrs");
+    auto interception_fun = (INTERCEPT_INIT_FUN)find_plugin_sym(
+        interception_lib, "create_runner_with_attrs");
     LOG_IF(INFO, ENV_PARAM(DEBUG_RUNNER))
         << "create runner via interception lib " << interception_lib;
     return std::unique_ptr<vart::Runner>(
@@ -321,6 +324,36 @@ std::unique_ptr<Runner> Runner::create_runner_with_attrs(
   return std::unique_ptr<vart::Runner>(init_fun(subgraph, attrs));
 }
 
+std::vector<std::unique_ptr<Runner>> Runner::create_runners_with_attrs(
+    const xir::Subgraph* subgraph, const std::vector<xir::Attrs*>& attrs) {
+  auto ret = std::vector<std::unique_ptr<Runner>>(attrs.size());
+  if (ret.empty()) {
+    return ret;
+  }
+  auto start = std::chrono::steady_clock::now();
+  // the first runner loads what the others share, they would only wait for
+  // it otherwise.
+  ret[0] = create_runner_with_attrs(subgraph, attrs[0]);
+  auto futures = std::vector<std::future<std::unique_ptr<Runner>>>();
+  futures.reserve(attrs.size() - 1u);
+  for (auto i = 1u; i < attrs.size(); ++i) {
+    futures.emplace_back(
+        std::async(std::launch::async, [subgraph, &attrs, i]() {
+          return create_runner_with_attrs(subgraph, attrs[i]);
+        }));
+  }
+  for (auto i = 1u; i < attrs.size(); ++i) {
+    ret[i] = futures[i - 1u].get();
+  }
+  auto end = std::chrono::steady_clock::now();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_RUNNER))
+      << ret.size() << " runners are created for " << subgraph->get_name()
+      << " in "
+      << std::chrono::duration<double, std::milli>(end - start).count()
+      << "ms";
+  return ret;
+}
+
 // default implements
 Runner::TensorFormat Runner::get_tensor_format() {
   return Runner::TensorFormat::NHWC;
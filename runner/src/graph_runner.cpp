@@ -0,0 +1,631 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/graph_runner.hpp"
+
+#include <glog/logging.h>
+
+#include <UniLog/UniLog.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <xir/attrs/attrs.hpp>
+#include <xir/graph/graph.hpp>
+#include <xir/graph/subgraph.hpp>
+#include <xir/tensor/tensor.hpp>
+
+#include "./runner_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/erl_msg_box.hpp"
+
+DEF_ENV_PARAM(DEBUG_GRAPH_RUNNER, "0");
+DEF_ENV_PARAM(XLNX_GRAPH_RUNNER_PERF, "0");
+// 0 means one frame in flight per stage, see attr "graph_runner_depth"
+DEF_ENV_PARAM(XLNX_GRAPH_RUNNER_DEPTH, "0");
+
+namespace {
+
+// where a tensor buffer of a stage comes from.
+struct source_t {
+  enum kind_t { GRAPH_INPUT, GRAPH_OUTPUT, INTERMEDIATE };
+  kind_t kind;
+  size_t index;
+};
+
+struct frame_t {
+  // a negative job id stops the stages.
+  int job_id;
+  size_t slot;
+  std::vector<vart::TensorBuffer*> inputs;
+  std::vector<vart::TensorBuffer*> outputs;
+  int status;
+  // thrown by a stage, rethrown by wait()
+  std::exception_ptr error;
+  // when the frame is sent to the current stage
+  int64_t send_time_us;
+};
+
+struct stage_t {
+  const xir::Subgraph* subgraph;
+  std::string device;
+  std::unique_ptr<xir::Attrs> attrs;
+  std::unique_ptr<vart::Runner> runner;
+  // dims[0] of the tensors of the runner, it runs batch_size_ / batch times
+  // per frame, on consecutive slices of the frame.
+  int batch;
+  std::vector<source_t> inputs;
+  std::vector<source_t> outputs;
+  std::unique_ptr<vitis::ai::ErlMsgBox<frame_t>> queue;
+  std::thread thread;
+  // only the stage thread updates them
+  std::atomic<uint64_t> num_of_runs{0};
+  std::atomic<uint64_t> total_run_time_us{0};
+  std::atomic<uint64_t> max_run_time_us{0};
+  std::atomic<uint64_t> total_queue_time_us{0};
+};
+
+class GraphRunnerImp : public vart::GraphRunner {
+ public:
+  explicit GraphRunnerImp(const xir::Graph* graph, xir::Attrs* attrs);
+  GraphRunnerImp(const GraphRunnerImp& other) = delete;
+  virtual ~GraphRunnerImp();
+
+ private:
+  virtual std::pair<uint32_t, int> execute_async(
+      const std::vector<vart::TensorBuffer*>& input,
+      const std::vector<vart::TensorBuffer*>& output) override;
+  virtual int wait(int jobid, int timeout) override;
+  virtual std::vector<const xir::Tensor*> get_input_tensors() override;
+  virtual std::vector<const xir::Tensor*> get_output_tensors() override;
+  virtual std::vector<stage_stat_t> get_stage_stats() override;
+
+ private:
+  struct job_t {
+    std::promise<int> promise;
+    std::future<int> future;
+    // only one thread waits for a job at a time, it erases the job.
+    bool waiting = false;
+  };
+
+ private:
+  void connect_stages();
+  void stage_main(size_t stage_idx);
+  int run_stage(stage_t& stage, const frame_t& frame);
+  void complete(std::unique_ptr<frame_t> frame);
+  size_t acquire_slot();
+  void release_slot(size_t slot);
+  int allocate_job_id();
+  std::string stage_stats_as_string();
+
+ private:
+  const xir::Graph* graph_;
+  std::vector<std::unique_ptr<stage_t>> stages_;
+  // the largest batch of the stages, i.e. the batch of a frame
+  int batch_size_;
+  // the tensors below with dims[0] = batch_size_
+  std::vector<std::unique_ptr<xir::Tensor>> tensors_;
+  std::vector<const xir::Tensor*> input_tensors_;
+  std::vector<const xir::Tensor*> output_tensors_;
+  std::vector<const xir::Tensor*> intermediate_tensors_;
+  // one set of intermediate tensor buffers per frame in flight
+  std::vector<std::vector<std::unique_ptr<vart::TensorBuffer>>> slots_;
+  std::vector<size_t> free_slots_;
+  std::mutex mtx_for_slots_;
+  std::condition_variable cv_for_free_slot_;
+  std::map<int, std::unique_ptr<job_t>> jobs_;
+  int next_job_id_;
+  std::mutex mtx_for_jobs_;
+  std::atomic<bool> running_;
+};
+
+static int64_t now_in_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static std::string get_device(const xir::Subgraph* subgraph) {
+  return subgraph->has_attr("device")
+             ? subgraph->get_attr<std::string>("device")
+             : std::string("CPU");
+}
+
+static std::unique_ptr<xir::Tensor> clone_with_batch(const xir::Tensor* tensor,
+                                                     int batch) {
+  auto shape = tensor->get_shape();
+  shape[0] = batch;
+  auto ret =
+      xir::Tensor::create(tensor->get_name(), shape, tensor->get_data_type());
+  ret->set_attrs(tensor->get_attrs());
+  return ret;
+}
+
+// a view of `tensor->get_shape()[0]` batches of tb from batch `first` on.
+// the batches of a HOST_PHY tensor buffer need not be contiguous, so only a
+// single batch of it can be viewed.
+static std::unique_ptr<vart::TensorBuffer> slice(vart::TensorBuffer* tb,
+                                                 const xir::Tensor* tensor,
+                                                 int first) {
+  UNI_LOG_CHECK(tensor->get_shape()[0] == 1 ||
+                    tb->get_location() ==
+                        vart::TensorBuffer::location_t::HOST_VIRT,
+                VART_TENSOR_BUFFER_UNSUPPORT_FORMAT)
+      << " cannot view " << tensor->get_shape()[0] << " batches of "
+      << tb->to_string();
+  auto idx = vart::get_index_zeros(tb->get_tensor());
+  idx[0] = first;
+  return std::make_unique<vart::CpuFlatTensorBuffer>(
+      (void*)tb->data(idx).first, tensor);
+}
+
+GraphRunnerImp::GraphRunnerImp(const xir::Graph* graph, xir::Attrs* attrs)
+    : graph_{graph}, batch_size_{1}, next_job_id_{0}, running_{true} {
+  auto start = std::chrono::steady_clock::now();
+  for (auto subgraph :
+       graph_->get_root_subgraph()->children_topological_sort()) {
+    auto device = get_device(subgraph);
+    if (device == "USER") {
+      continue;
+    }
+    auto stage = std::make_unique<stage_t>();
+    stage->subgraph = subgraph;
+    stage->device = device;
+    // runners must not share attrs, see AsyncRunnerImpl
+    stage->attrs = attrs ? xir::Attrs::clone(attrs) : xir::Attrs::create();
+    stage->runner =
+        vart::Runner::create_runner_with_attrs(subgraph, stage->attrs.get());
+    LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+        << "@" << (void*)this << " stage[" << stages_.size() << "] "
+        << device << " " << subgraph->get_name()
+        << " inputs=" << to_string(stage->runner->get_input_tensors())
+        << " outputs=" << to_string(stage->runner->get_output_tensors());
+    stages_.emplace_back(std::move(stage));
+  }
+  UNI_LOG_CHECK(!stages_.empty(), VART_RUNNER_CONSTRUCTION_FAIL)
+      << "no subgraph to run in graph " << graph_->get_name();
+  connect_stages();
+
+  size_t depth = ENV_PARAM(XLNX_GRAPH_RUNNER_DEPTH) > 0
+                     ? (size_t)ENV_PARAM(XLNX_GRAPH_RUNNER_DEPTH)
+                     : stages_.size();
+  if (attrs && attrs->has_attr("graph_runner_depth")) {
+    depth = attrs->get_attr<size_t>("graph_runner_depth");
+  }
+  depth = std::max<size_t>(depth, 1u);
+  // by default, intermediate pages are first touched by the producing stage
+  // and land on the node of its thread.
+  auto policy = vart::get_host_memory_policy(attrs);
+  slots_.resize(depth);
+  for (auto slot = 0u; slot < depth; ++slot) {
+    slots_[slot].reserve(intermediate_tensors_.size());
+    for (auto tensor : intermediate_tensors_) {
+      slots_[slot].emplace_back(
+          vart::alloc_cpu_flat_tensor_buffer(tensor, policy));
+    }
+    free_slots_.push_back(depth - 1u - slot);
+  }
+  for (auto i = 0u; i < stages_.size(); ++i) {
+    // never full, there are at most depth frames and a stop frame.
+    stages_[i]->queue =
+        std::make_unique<vitis::ai::ErlMsgBox<frame_t>>(depth + 1u);
+    stages_[i]->thread = std::thread([this, i]() { stage_main(i); });
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+      << "@" << (void*)this << " graph runner is created for "
+      << graph_->get_name() << " in "
+      << std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count()
+      << "ms: stages=" << stages_.size() << " depth=" << depth
+      << " inputs=" << to_string(input_tensors_)
+      << " outputs=" << to_string(output_tensors_)
+      << " intermediates=" << to_string(intermediate_tensors_);
+}
+
+GraphRunnerImp::~GraphRunnerImp() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_for_slots_);
+    cv_for_free_slot_.wait(
+        lock, [this]() { return free_slots_.size() == slots_.size(); });
+  }
+  running_ = false;
+  for (auto& stage : stages_) {
+    stage->queue->emplace_send(
+        frame_t{-1, 0u, {}, {}, 0, nullptr, now_in_us()});
+    stage->thread.join();
+  }
+  LOG_IF(INFO,
+         ENV_PARAM(DEBUG_GRAPH_RUNNER) || ENV_PARAM(XLNX_GRAPH_RUNNER_PERF))
+      << "GraphRunner@" << (void*)this << " " << graph_->get_name()
+      << " stages: " << stage_stats_as_string();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER) && !jobs_.empty())
+      << jobs_.size() << " jobs are not waited for";
+}
+
+// runners are connected by tensor names. a stage input produced by an
+// earlier stage is an intermediate tensor, otherwise it is a graph input.
+// a stage output consumed by any stage is an intermediate tensor,
+// otherwise it is a graph output. the batch of a stage divides the batch of
+// a frame, e.g. a DPU stage runs a frame of its core batch at once and a CPU
+// stage of batch 1 runs it batch by batch.
+void GraphRunnerImp::connect_stages() {
+  auto producers = std::map<std::string, const xir::Tensor*>();
+  auto consumed = std::set<std::string>();
+  for (auto& stage : stages_) {
+    for (auto tensor : stage->runner->get_input_tensors()) {
+      consumed.insert(tensor->get_name());
+    }
+  }
+  auto graph_inputs = std::map<std::string, size_t>();
+  auto intermediates = std::map<std::string, size_t>();
+  for (auto& stage : stages_) {
+    stage->batch = stage->runner->get_input_tensors().empty()
+                       ? stage->runner->get_output_tensors()[0]->get_shape()[0]
+                       : stage->runner->get_input_tensors()[0]->get_shape()[0];
+    batch_size_ = std::max(batch_size_, stage->batch);
+  }
+  auto check_batch_size = [this](stage_t& stage, const xir::Tensor* tensor) {
+    UNI_LOG_CHECK(tensor->get_shape()[0] == stage.batch &&
+                      batch_size_ % stage.batch == 0,
+                  VART_RUNNER_CONSTRUCTION_FAIL)
+        << " the batch of a stage must divide the batch of a frame:"
+        << " batch_size=" << batch_size_
+        << " subgraph=" << stage.subgraph->get_name()
+        << " tensor=" << tensor->get_name()
+        << " dims[0]=" << tensor->get_shape()[0];
+  };
+  auto add_tensor = [this](std::vector<const xir::Tensor*>& tensors,
+                           const xir::Tensor* tensor) {
+    tensors_.emplace_back(clone_with_batch(tensor, batch_size_));
+    tensors.push_back(tensors_.back().get());
+  };
+  for (auto& stage : stages_) {
+    for (auto tensor : stage->runner->get_input_tensors()) {
+      check_batch_size(*stage, tensor);
+      auto name = tensor->get_name();
+      auto producer = producers.find(name);
+      if (producer == producers.end()) {
+        auto it = graph_inputs.find(name);
+        if (it == graph_inputs.end()) {
+          it = graph_inputs.emplace(name, input_tensors_.size()).first;
+          add_tensor(input_tensors_, tensor);
+        }
+        stage->inputs.push_back(source_t{source_t::GRAPH_INPUT, it->second});
+        continue;
+      }
+      auto idx = intermediates.at(name);
+      // per batch
+      auto size = intermediate_tensors_[idx]->get_data_size() / batch_size_;
+      UNI_LOG_CHECK(tensor->get_data_size() / stage->batch <= size,
+                    VART_RUNNER_CONSTRUCTION_FAIL)
+          << " tensor " << name << " is larger than its producer: "
+          << tensor->get_data_size() / stage->batch << " vs " << size;
+      stage->inputs.push_back(source_t{source_t::INTERMEDIATE, idx});
+    }
+    for (auto tensor : stage->runner->get_output_tensors()) {
+      check_batch_size(*stage, tensor);
+      auto name = tensor->get_name();
+      UNI_LOG_CHECK(producers.emplace(name, tensor).second,
+                    VART_RUNNER_CONSTRUCTION_FAIL)
+          << " tensor " << name << " is produced by more than one subgraph";
+      if (consumed.count(name) == 0u) {
+        stage->outputs.push_back(
+            source_t{source_t::GRAPH_OUTPUT, output_tensors_.size()});
+        add_tensor(output_tensors_, tensor);
+        continue;
+      }
+      intermediates.emplace(name, intermediate_tensors_.size());
+      stage->outputs.push_back(
+          source_t{source_t::INTERMEDIATE, intermediate_tensors_.size()});
+      add_tensor(intermediate_tensors_, tensor);
+    }
+  }
+}
+
+size_t GraphRunnerImp::acquire_slot() {
+  std::unique_lock<std::mutex> lock(mtx_for_slots_);
+  cv_for_free_slot_.wait(lock, [this]() { return !free_slots_.empty(); });
+  auto ret = free_slots_.back();
+  free_slots_.pop_back();
+  return ret;
+}
+
+void GraphRunnerImp::release_slot(size_t slot) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_slots_);
+    free_slots_.push_back(slot);
+  }
+  cv_for_free_slot_.notify_all();
+}
+
+// a negative job id is returned if the next one, after wrapping around, is
+// still taken by a job which is not waited for.
+int GraphRunnerImp::allocate_job_id() {
+  std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+  auto job_id = next_job_id_;
+  if (jobs_.count(job_id) != 0u) {
+    LOG(WARNING) << "job id " << job_id << " is not waited for yet, "
+                 << jobs_.size() << " jobs are pending";
+    return -1;
+  }
+  next_job_id_ = next_job_id_ == std::numeric_limits<int>::max()
+                     ? 0
+                     : next_job_id_ + 1;
+  auto job = std::make_unique<job_t>();
+  job->future = job->promise.get_future();
+  jobs_[job_id] = std::move(job);
+  return job_id;
+}
+
+std::pair<uint32_t, int> GraphRunnerImp::execute_async(
+    const std::vector<vart::TensorBuffer*>& input,
+    const std::vector<vart::TensorBuffer*>& output) {
+  if (!running_) {
+    LOG(WARNING) << "runner is shutting down, reject new request";
+    return std::make_pair(0xFFFFFFFF, -1);
+  }
+  CHECK_EQ(input.size(), input_tensors_.size())
+      << "number of input tensor buffers mismatch";
+  CHECK_EQ(output.size(), output_tensors_.size())
+      << "number of output tensor buffers mismatch";
+  // blocks when there are too many frames in flight.
+  auto slot = acquire_slot();
+  auto job_id = allocate_job_id();
+  if (job_id < 0) {
+    release_slot(slot);
+    return std::make_pair(0xFFFFFFFF, -1);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER) >= 2)
+      << "job id " << job_id << " is submitted with slot " << slot;
+  stages_[0]->queue->emplace_send(
+      frame_t{job_id, slot, input, output, 0, nullptr, now_in_us()});
+  return std::make_pair((uint32_t)job_id, 0);
+}
+
+int GraphRunnerImp::wait(int jobid, int timeout) {
+  job_t* job = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    auto it = jobs_.find(jobid);
+    if (it == jobs_.end()) {
+      LOG_IF(WARNING, ENV_PARAM(DEBUG_GRAPH_RUNNER))
+          << "job is not found. job_id=" << jobid;
+      return -1;
+    }
+    if (it->second->waiting) {
+      LOG(WARNING) << "job is waited for by another thread. job_id=" << jobid;
+      return -1;
+    }
+    job = it->second.get();
+    job->waiting = true;
+  }
+  auto status = std::future_status::ready;
+  if (timeout < 0) {
+    job->future.wait();
+  } else {
+    status = job->future.wait_for(std::chrono::milliseconds(timeout));
+  }
+  if (status != std::future_status::ready) {
+    // the job is kept, so that it can be waited for again.
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    job->waiting = false;
+    return -1;
+  }
+  auto ret = -1;
+  auto error = std::exception_ptr();
+  try {
+    ret = job->future.get();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    jobs_.erase(jobid);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return ret;
+}
+
+std::vector<const xir::Tensor*> GraphRunnerImp::get_input_tensors() {
+  return input_tensors_;
+}
+
+std::vector<const xir::Tensor*> GraphRunnerImp::get_output_tensors() {
+  return output_tensors_;
+}
+
+int GraphRunnerImp::run_stage(stage_t& stage, const frame_t& frame) {
+  auto resolve = [this, &frame](const std::vector<source_t>& sources) {
+    auto ret = std::vector<vart::TensorBuffer*>();
+    ret.reserve(sources.size());
+    for (auto& s : sources) {
+      switch (s.kind) {
+        case source_t::GRAPH_INPUT:
+          ret.push_back(frame.inputs[s.index]);
+          break;
+        case source_t::GRAPH_OUTPUT:
+          ret.push_back(frame.outputs[s.index]);
+          break;
+        case source_t::INTERMEDIATE:
+          ret.push_back(slots_[frame.slot][s.index].get());
+          break;
+      }
+    }
+    return ret;
+  };
+  auto run = [&stage](const std::vector<vart::TensorBuffer*>& inputs,
+                      const std::vector<vart::TensorBuffer*>& outputs) {
+    auto job = stage.runner->execute_async(inputs, outputs);
+    if (job.second != 0) {
+      return job.second;
+    }
+    return stage.runner->wait((int)job.first, -1);
+  };
+  auto inputs = resolve(stage.inputs);
+  auto outputs = resolve(stage.outputs);
+  if (stage.batch == batch_size_) {
+    return run(inputs, outputs);
+  }
+  // the views below are HOST_VIRT, so the runner of the stage does not sync
+  // them. the syncs of a HOST_PHY tensor buffer apply to every batch.
+  auto batch_size = [](vart::TensorBuffer* tb) {
+    return tb->get_tensor()->get_data_size() /
+           tb->get_tensor()->get_shape()[0];
+  };
+  for (auto tb : inputs) {
+    if (tb->get_location() != vart::TensorBuffer::location_t::HOST_VIRT) {
+      tb->sync_for_read(0u, batch_size(tb));
+    }
+  }
+  auto input_tensors = stage.runner->get_input_tensors();
+  auto output_tensors = stage.runner->get_output_tensors();
+  for (auto first = 0; first < batch_size_; first += stage.batch) {
+    auto views = std::vector<std::unique_ptr<vart::TensorBuffer>>();
+    auto slice_all = [&views, first](
+                         const std::vector<vart::TensorBuffer*>& tbs,
+                         const std::vector<const xir::Tensor*>& tensors) {
+      auto ret = std::vector<vart::TensorBuffer*>();
+      for (auto i = 0u; i < tbs.size(); ++i) {
+        views.emplace_back(slice(tbs[i], tensors[i], first));
+        ret.push_back(views.back().get());
+      }
+      return ret;
+    };
+    auto status = run(slice_all(inputs, input_tensors),
+                      slice_all(outputs, output_tensors));
+    if (status != 0) {
+      return status;
+    }
+  }
+  for (auto tb : outputs) {
+    if (tb->get_location() != vart::TensorBuffer::location_t::HOST_VIRT) {
+      tb->sync_for_write(0u, batch_size(tb));
+    }
+  }
+  return 0;
+}
+
+void GraphRunnerImp::stage_main(size_t stage_idx) {
+  auto& stage = *stages_[stage_idx];
+  auto is_last = stage_idx + 1u == stages_.size();
+  while (true) {
+    auto frame = stage.queue->recv(std::chrono::milliseconds(1000));
+    if (frame == nullptr) {
+      continue;
+    }
+    if (frame->job_id < 0) {
+      break;
+    }
+    auto start = now_in_us();
+    stage.total_queue_time_us += start - frame->send_time_us;
+    // a failed frame is passed down without running, so that it is
+    // completed in order.
+    if (frame->status == 0) {
+      try {
+        frame->status = run_stage(stage, *frame);
+      } catch (std::exception& e) {
+        LOG(WARNING) << "stage " << stage.subgraph->get_name()
+                     << " throws: " << e.what();
+        frame->error = std::current_exception();
+        frame->status = -1;
+      } catch (...) {
+        frame->error = std::current_exception();
+        frame->status = -1;
+      }
+      LOG_IF(WARNING, frame->status != 0)
+          << "stage " << stage.subgraph->get_name() << " failed with "
+          << frame->status << ", job_id=" << frame->job_id;
+    }
+    auto end = now_in_us();
+    auto elapsed = (uint64_t)(end - start);
+    stage.num_of_runs++;
+    stage.total_run_time_us += elapsed;
+    if (elapsed > stage.max_run_time_us) {
+      stage.max_run_time_us = elapsed;
+    }
+    LOG_IF(INFO, ENV_PARAM(DEBUG_GRAPH_RUNNER) >= 3)
+        << "job id " << frame->job_id << " stage[" << stage_idx << "] "
+        << stage.device << " is done in " << elapsed << "us";
+    if (is_last) {
+      complete(std::move(frame));
+    } else {
+      frame->send_time_us = end;
+      stages_[stage_idx + 1u]->queue->send_ptr(std::move(frame));
+    }
+  }
+}
+
+void GraphRunnerImp::complete(std::unique_ptr<frame_t> frame) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_for_jobs_);
+    auto& promise = jobs_.at(frame->job_id)->promise;
+    if (frame->error) {
+      promise.set_exception(frame->error);
+    } else {
+      promise.set_value(frame->status);
+    }
+  }
+  release_slot(frame->slot);
+}
+
+std::vector<vart::GraphRunner::stage_stat_t>
+GraphRunnerImp::get_stage_stats() {
+  auto ret = std::vector<stage_stat_t>();
+  ret.reserve(stages_.size());
+  for (auto& stage : stages_) {
+    ret.push_back(stage_stat_t{stage->subgraph->get_name(), stage->device,
+                               stage->num_of_runs, stage->total_run_time_us,
+                               stage->max_run_time_us,
+                               stage->total_queue_time_us});
+  }
+  return ret;
+}
+
+std::string GraphRunnerImp::stage_stats_as_string() {
+  std::ostringstream str;
+  auto i = 0u;
+  for (auto& s : get_stage_stats()) {
+    auto runs = std::max<uint64_t>(s.num_of_runs, 1u);
+    str << "\n\tstage[" << i++ << "] " << s.device << " " << s.subgraph_name
+        << " runs=" << s.num_of_runs
+        << " avg=" << s.total_run_time_us / runs << "us"
+        << " max=" << s.max_run_time_us << "us"
+        << " queue=" << s.total_queue_time_us / runs << "us";
+  }
+  return str.str();
+}
+
+}  // namespace
+
+namespace vart {
+std::unique_ptr<GraphRunner> GraphRunner::create(const xir::Graph* graph,
+                                                 xir::Attrs* attrs) {
+  UNI_LOG_CHECK(graph != nullptr, VART_RUNNER_CONSTRUCTION_FAIL)
+      << "Invalid graph!";
+  return std::make_unique<GraphRunnerImp>(graph, attrs);
+}
+}  // namespace vart
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/image_preprocess.hpp"
+
+#include <glog/logging.h>
+
+#include <UniLog/UniLog.hpp>
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <xir/tensor/tensor.hpp>
+
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/thread_pool.hpp"
+
+DEF_ENV_PARAM(DEBUG_IMAGE_PREPROCESS, "0")
+
+namespace vart {
+
+ImagePreprocessor::ImagePreprocessor(const xir::Tensor* tensor,
+                                     const std::array<float, 3>& mean,
+                                     const std::array<float, 3>& scale,
+                                     bool swap_rb, size_t num_of_threads)
+    : swap_rb_{swap_rb}, pool_{}, num_of_threads_{} {
+  auto shape = tensor->get_shape();
+  UNI_LOG_CHECK(shape.size() == 4u && shape[3] == 3,
+                VART_TENSOR_BUFFER_UNSUPPORT_FORMAT)
+      << "only NHWC tensors with 3 channels are supported, tensor="
+      << tensor->get_name();
+  UNI_LOG_CHECK(tensor->get_data_type().bit_width == 8 &&
+                    tensor->has_attr("fix_point"),
+                VART_TENSOR_BUFFER_UNSUPPORT_FORMAT)
+      << "only int8 tensors with attr fix_point are supported, tensor="
+      << tensor->get_name();
+  height_ = shape[1];
+  width_ = shape[2];
+  stride_c_ = 1u;
+  stride_w_ = 3u;
+  stride_h_ = (size_t)width_ * stride_w_;
+  stride_n_ = (size_t)height_ * stride_h_;
+  if (tensor->has_attr("stride")) {
+    auto strides = tensor->get_attr<std::vector<std::int32_t>>("stride");
+    CHECK_EQ(strides.size(), 4u) << "tensor=" << tensor->get_name();
+    stride_n_ = strides[0];
+    stride_h_ = strides[1];
+    stride_w_ = strides[2];
+    stride_c_ = strides[3];
+  }
+  auto input_scale = std::exp2f((float)tensor->get_attr<int>("fix_point"));
+  scale_row_.resize((size_t)width_ * 3u);
+  bias_row_.resize((size_t)width_ * 3u);
+  for (auto i = 0u; i < scale_row_.size(); ++i) {
+    auto c = i % 3u;
+    scale_row_[i] = scale[c] * input_scale;
+    bias_row_[i] = -mean[c] * scale_row_[i];
+  }
+  num_of_threads_ = num_of_threads == 0u
+                        ? (size_t)std::thread::hardware_concurrency()
+                        : num_of_threads;
+  num_of_threads_ = std::max(num_of_threads_, (size_t)1u);
+  if (num_of_threads_ > 1u) {
+    // the calling thread takes one share of the tasks as well.
+    pool_ = vitis::ai::ThreadPool::create(num_of_threads_ - 1u);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_IMAGE_PREPROCESS))
+      << "@" << (void*)this << " image preprocessor created. tensor="
+      << tensor->get_name() << " " << width_ << "x" << height_
+      << " strides=" << stride_n_ << "," << stride_h_ << "," << stride_w_
+      << "," << stride_c_ << " swap_rb=" << swap_rb_
+      << " num_of_threads=" << num_of_threads_;
+}
+
+ImagePreprocessor::~ImagePreprocessor() {}
+
+template <typename TaskFunc>
+void ImagePreprocessor::for_each_task(size_t num_of_tasks,
+                                      TaskFunc&& func) const {
+  if (pool_ == nullptr || num_of_tasks <= 1u) {
+    for (size_t t = 0u; t < num_of_tasks; ++t) {
+      func(t);
+    }
+    return;
+  }
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_of_tasks - 1u);
+  for (size_t t = 1u; t < num_of_tasks; ++t) {
+    futures.emplace_back(pool_->async(func, t));
+  }
+  func(0u);
+  for (auto& f : futures) {
+    f.get();
+  }
+}
+
+namespace {
+// half-pixel centers, the same as cv::INTER_LINEAR
+struct interp_t {
+  int i0;
+  int i1;
+  float w;
+};
+
+static interp_t get_interp(int dst, int dst_size, int src_size) {
+  auto s = ((float)dst + 0.5f) * (float)src_size / (float)dst_size - 0.5f;
+  s = std::max(s, 0.0f);
+  auto i0 = std::min((int)s, src_size - 1);
+  auto i1 = std::min(i0 + 1, src_size - 1);
+  return interp_t{i0, i1, i0 == i1 ? 0.0f : s - (float)i0};
+}
+}  // namespace
+
+void ImagePreprocessor::run_rows(const frame_t& frame, int8_t* output,
+                                 int row_begin, int row_end) const {
+  auto n = (size_t)width_ * 3u;
+  auto src_stride = frame.stride == 0 ? frame.width * 3 : frame.stride;
+  // horizontal taps per output element, the channel swap is folded in.
+  auto x0 = std::vector<int>(n);
+  auto x1 = std::vector<int>(n);
+  auto wx = std::vector<float>(n);
+  for (auto x = 0; x < width_; ++x) {
+    auto interp = get_interp(x, width_, frame.width);
+    for (auto c = 0; c < 3; ++c) {
+      auto src_c = swap_rb_ ? 2 - c : c;
+      x0[x * 3 + c] = interp.i0 * 3 + src_c;
+      x1[x * 3 + c] = interp.i1 * 3 + src_c;
+      wx[x * 3 + c] = interp.w;
+    }
+  }
+  // the two source rows an output row is interpolated from, resized
+  // horizontally. consecutive output rows mostly share them.
+  float* rows[2];
+  auto buffer = std::vector<float>(n * 2u);
+  rows[0] = &buffer[0];
+  rows[1] = &buffer[n];
+  int row_idx[2] = {-1, -1};
+  auto fetch_row = [&](int src_y, int keep) -> const float* {
+    for (auto k = 0; k < 2; ++k) {
+      if (row_idx[k] == src_y) {
+        return rows[k];
+      }
+    }
+    auto k = row_idx[0] == keep ? 1 : 0;
+    auto src = frame.data + (size_t)src_y * src_stride;
+    auto dst = rows[k];
+    for (size_t i = 0u; i < n; ++i) {
+      auto a = (float)src[x0[i]];
+      dst[i] = a + ((float)src[x1[i]] - a) * wx[i];
+    }
+    row_idx[k] = src_y;
+    return dst;
+  };
+  auto dense = stride_c_ == 1u && stride_w_ == 3u;
+  auto tmp = std::vector<int8_t>(dense ? 0u : n);
+  auto scale = scale_row_.data();
+  auto bias = bias_row_.data();
+  for (auto y = row_begin; y < row_end; ++y) {
+    auto interp = get_interp(y, height_, frame.height);
+    auto r0 = fetch_row(interp.i0, interp.i1);
+    auto r1 = fetch_row(interp.i1, interp.i0);
+    auto w = interp.w;
+    auto out = dense ? output + (size_t)y * stride_h_ : tmp.data();
+    for (size_t i = 0u; i < n; ++i) {
+      auto v = r0[i] + (r1[i] - r0[i]) * w;
+      auto q = std::min(std::max(v * scale[i] + bias[i], -128.0f), 127.0f);
+      // DPU rounding, i.e. floor(q + 0.5), the operand of the conversion is
+      // not negative, so the truncation is a floor.
+      out[i] = (int8_t)((int)(q + 128.5f) - 128);
+    }
+    if (!dense) {
+      auto row = output + (size_t)y * stride_h_;
+      for (auto x = 0; x < width_; ++x) {
+        for (auto c = 0; c < 3; ++c) {
+          row[x * stride_w_ + c * stride_c_] = tmp[x * 3 + c];
+        }
+      }
+    }
+  }
+}
+
+void ImagePreprocessor::run(const frame_t& frame, int8_t* output) const {
+  auto num_of_chunks = std::min(num_of_threads_, (size_t)height_);
+  auto rows_per_chunk = (height_ + (int)num_of_chunks - 1) / (int)num_of_chunks;
+  for_each_task(num_of_chunks, [this, &frame, output, rows_per_chunk](
+                                   size_t chunk) {
+    auto begin = (int)chunk * rows_per_chunk;
+    run_rows(frame, output, begin, std::min(height_, begin + rows_per_chunk));
+  });
+}
+
+void ImagePreprocessor::run(const std::vector<frame_t>& frames,
+                            vart::TensorBuffer* tensor_buffer) const {
+  auto location = tensor_buffer->get_location();
+  UNI_LOG_CHECK(location == vart::TensorBuffer::location_t::HOST_VIRT ||
+                    location == vart::TensorBuffer::location_t::HOST_PHY,
+                VART_TENSOR_BUFFER_UNSUPPORT_FORMAT)
+      << "cannot write to a device only tensor buffer, location="
+      << vart::TensorBuffer::to_string(location);
+  auto batch = tensor_buffer->get_tensor()->get_shape()[0];
+  UNI_LOG_CHECK((int)frames.size() <= batch,
+                VART_TENSOR_BUFFER_INVALID_INDEX)
+      << "too many frames: " << frames.size() << " > batch " << batch;
+  auto outputs = std::vector<int8_t*>(frames.size());
+  for (auto i = 0u; i < frames.size(); ++i) {
+    outputs[i] = (int8_t*)tensor_buffer->data({(int)i, 0, 0, 0}).first;
+  }
+  // one frame per task if there are enough frames, otherwise frames are
+  // split into row chunks as well.
+  auto chunks_per_frame = std::max<size_t>(1u, frames.size());
+  chunks_per_frame = std::max<size_t>(1u, num_of_threads_ / chunks_per_frame);
+  chunks_per_frame = std::min(chunks_per_frame, (size_t)height_);
+  auto rows_per_chunk =
+      (height_ + (int)chunks_per_frame - 1) / (int)chunks_per_frame;
+  for_each_task(frames.size() * chunks_per_frame,
+                [this, &frames, &outputs, chunks_per_frame,
+                 rows_per_chunk](size_t task) {
+                  auto i = task / chunks_per_frame;
+                  auto begin = (int)(task % chunks_per_frame) * rows_per_chunk;
+                  run_rows(frames[i], outputs[i], begin,
+                           std::min(height_, begin + rows_per_chunk));
+                });
+  if (location == vart::TensorBuffer::location_t::HOST_PHY) {
+    tensor_buffer->sync_for_write(0u, stride_n_);
+  }
+}
+
+}  // namespace vart
@@ -194,24 +194,40 @@ static size_t tensor_real_size(const xir::Tensor* tensor) {
   return ret;
 }
 CpuFlatTensorBufferOwned::CpuFlatTensorBufferOwned(const xir::Tensor* tensor)
-    : CpuFlatTensorBuffer(nullptr, tensor), buffer_(tensor_real_size(tensor_)) {
-  data_ = (void*)&buffer_[0];
+    : CpuFlatTensorBufferOwned(tensor, get_host_memory_policy()) {}
+
+CpuFlatTensorBufferOwned::CpuFlatTensorBufferOwned(
+    const xir::Tensor* tensor, const host_memory_policy_t& policy)
+    : CpuFlatTensorBuffer(nullptr, tensor),
+      buffer_(HostMemory::allocate(tensor_real_size(tensor_), policy)) {
+  data_ = buffer_->data();
 }
 
 std::vector<std::unique_ptr<vart::TensorBuffer>> alloc_cpu_flat_tensor_buffers(
     const std::vector<const xir::Tensor*>& tensors) {
+  return alloc_cpu_flat_tensor_buffers(tensors, get_host_memory_policy());
+}
+
+std::unique_ptr<vart::TensorBuffer> alloc_cpu_flat_tensor_buffer(
+    const xir::Tensor* tensor) {
+  return alloc_cpu_flat_tensor_buffer(tensor, get_host_memory_policy());
+}
+
+std::vector<std::unique_ptr<vart::TensorBuffer>> alloc_cpu_flat_tensor_buffers(
+    const std::vector<const xir::Tensor*>& tensors,
+    const host_memory_policy_t& policy) {
   auto ret = std::vector<std::unique_ptr<vart::TensorBuffer>>(tensors.size());
   for (auto i = 0u; i < tensors.size(); ++i) {
     ret[i] = std::unique_ptr<vart::TensorBuffer>(
-        new CpuFlatTensorBufferOwned(tensors[i]));
+        new CpuFlatTensorBufferOwned(tensors[i], policy));
   }
   return ret;
 }
 
 std::unique_ptr<vart::TensorBuffer> alloc_cpu_flat_tensor_buffer(
-    const xir::Tensor* tensor) {
-  auto ret =
-      std::unique_ptr<vart::TensorBuffer>(new CpuFlatTensorBufferOwned(tensor));
+    const xir::Tensor* tensor, const host_memory_policy_t& policy) {
+  auto ret = std::unique_ptr<vart::TensorBuffer>(
+      new CpuFlatTensorBufferOwned(tensor, policy));
   return ret;
 }
 }  // namespace vart
@@ -17,6 +17,7 @@
 #pragma once
 #include <vector>
 
+#include "vart/host_memory.hpp"
 #include "vart/runner.hpp"
 #include "vitis/ai/dpu_runner.hpp"
 
@@ -47,6 +48,12 @@ std::vector<std::unique_ptr<vart::TensorBuffer>> alloc_cpu_flat_tensor_buffers(
     const std::vector<const xir::Tensor*>& tensors);
 std::unique_ptr<vart::TensorBuffer> alloc_cpu_flat_tensor_buffer(
     const xir::Tensor* tensor);
+// as above, with an explicit host memory placement, see host_memory.hpp
+std::vector<std::unique_ptr<vart::TensorBuffer>> alloc_cpu_flat_tensor_buffers(
+    const std::vector<const xir::Tensor*>& tensors,
+    const host_memory_policy_t& policy);
+std::unique_ptr<vart::TensorBuffer> alloc_cpu_flat_tensor_buffer(
+    const xir::Tensor* tensor, const host_memory_policy_t& policy);
 
 class CpuFlatTensorBuffer : public TensorBuffer {
  public:
@@ -64,9 +71,11 @@ class CpuFlatTensorBuffer : public TensorBuffer {
 class CpuFlatTensorBufferOwned : public CpuFlatTensorBuffer {
  public:
   explicit CpuFlatTensorBufferOwned(const xir::Tensor* tensor);
+  explicit CpuFlatTensorBufferOwned(const xir::Tensor* tensor,
+                                    const host_memory_policy_t& policy);
   virtual ~CpuFlatTensorBufferOwned() = default;
 
  private:
-  std::vector<char> buffer_;
+  std::unique_ptr<HostMemory> buffer_;
 };
 }  // namespace vart
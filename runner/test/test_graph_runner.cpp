@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// usage: test_graph_runner <xmodel>
+//
+// runs an xmodel with vart::GraphRunner, DPU subgraphs are run by dummy
+// runners, so no device is needed. frames are run once without overlap,
+// i.e. depth 1, and once pipelined. when pipelined, a frame should take
+// about as long as the slowest stage. the outputs of every frame must be the
+// same as running the subgraphs one by one on the same inputs, e.g. a DPU
+// subgraph of batch 4 followed by a CPU subgraph of batch 1. set
+// ALL_DUMMY=1 to run CPU subgraphs with dummy runners as well, and
+// XLNX_GRAPH_RUNNER_PERF=1 for details.
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <xir/attrs/attrs.hpp>
+#include <xir/graph/graph.hpp>
+#include <xir/graph/subgraph.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vart/graph_runner.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(ALL_DUMMY, "0");
+DEF_ENV_PARAM(NUM_OF_FRAMES, "50");
+DEF_ENV_PARAM(DEPTH, "0");
+
+struct frame_buffers_t {
+  std::vector<std::unique_ptr<vart::TensorBuffer>> inputs;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> outputs;
+};
+
+static double run_frames(vart::GraphRunner* runner,
+                         std::vector<frame_buffers_t>& frames) {
+  auto start = std::chrono::steady_clock::now();
+  auto jobs = std::vector<int>();
+  jobs.reserve(frames.size());
+  for (auto& frame : frames) {
+    auto job = runner->execute_async(
+        vitis::ai::vector_unique_ptr_get(frame.inputs),
+        vitis::ai::vector_unique_ptr_get(frame.outputs));
+    CHECK_EQ(job.second, 0) << "cannot create job";
+    jobs.push_back((int)job.first);
+  }
+  for (auto job : jobs) {
+    CHECK_EQ(runner->wait(job, -1), 0) << "job failed: " << job;
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         frames.size();
+}
+
+static char* data_of(vart::TensorBuffer* tb) {
+  return (char*)tb->data(vart::get_index_zeros(tb->get_tensor())).first;
+}
+
+static int batch_of(const std::vector<const xir::Tensor*>& inputs,
+                    const std::vector<const xir::Tensor*>& outputs) {
+  return (inputs.empty() ? outputs[0] : inputs[0])->get_shape()[0];
+}
+
+// runs the subgraphs one by one in topological order, as the stages of a
+// graph runner, tensors are passed between them by name. a subgraph with a
+// smaller batch than the graph runs once per slice, on copies of the slice.
+class SequentialRunner {
+ public:
+  SequentialRunner(const xir::Graph* graph, xir::Attrs* attrs) {
+    for (auto subgraph :
+         graph->get_root_subgraph()->children_topological_sort()) {
+      if (subgraph->has_attr("device") &&
+          subgraph->get_attr<std::string>("device") == "USER") {
+        continue;
+      }
+      attrs_.emplace_back(xir::Attrs::clone(attrs));
+      runners_.emplace_back(vart::Runner::create_runner_with_attrs(
+          subgraph, attrs_.back().get()));
+    }
+  }
+
+  // returns the graph outputs, in the order of output_tensors
+  std::vector<std::unique_ptr<vart::TensorBuffer>> run(
+      const std::vector<const xir::Tensor*>& input_tensors,
+      const std::vector<vart::TensorBuffer*>& inputs,
+      const std::vector<const xir::Tensor*>& output_tensors) {
+    struct buffer_t {
+      char* data;
+      size_t size_per_batch;
+    };
+    auto batch = batch_of(input_tensors, output_tensors);
+    auto buffers = std::map<std::string, buffer_t>();
+    for (auto i = 0u; i < input_tensors.size(); ++i) {
+      buffers[input_tensors[i]->get_name()] =
+          buffer_t{data_of(inputs[i]),
+                   (size_t)input_tensors[i]->get_data_size() / batch};
+    }
+    auto owned = std::map<std::string, std::vector<char>>();
+    for (auto& runner : runners_) {
+      auto stage_input_tensors = runner->get_input_tensors();
+      auto stage_output_tensors = runner->get_output_tensors();
+      auto stage_batch = batch_of(stage_input_tensors, stage_output_tensors);
+      for (auto tensor : stage_output_tensors) {
+        auto size_per_batch = (size_t)tensor->get_data_size() / stage_batch;
+        auto& buffer = owned[tensor->get_name()];
+        buffer.resize(size_per_batch * batch);
+        buffers[tensor->get_name()] = buffer_t{buffer.data(), size_per_batch};
+      }
+      auto stage_inputs =
+          vart::alloc_cpu_flat_tensor_buffers(stage_input_tensors);
+      auto stage_outputs =
+          vart::alloc_cpu_flat_tensor_buffers(stage_output_tensors);
+      for (auto first = 0; first < batch; first += stage_batch) {
+        for (auto i = 0u; i < stage_inputs.size(); ++i) {
+          auto& from = buffers.at(stage_input_tensors[i]->get_name());
+          memcpy(data_of(stage_inputs[i].get()),
+                 from.data + first * from.size_per_batch,
+                 stage_input_tensors[i]->get_data_size());
+        }
+        auto job = runner->execute_async(
+            vitis::ai::vector_unique_ptr_get(stage_inputs),
+            vitis::ai::vector_unique_ptr_get(stage_outputs));
+        CHECK_EQ(job.second, 0) << "cannot create job";
+        CHECK_EQ(runner->wait((int)job.first, -1), 0) << "job failed";
+        for (auto i = 0u; i < stage_outputs.size(); ++i) {
+          auto& to = buffers.at(stage_output_tensors[i]->get_name());
+          memcpy(to.data + first * to.size_per_batch,
+                 data_of(stage_outputs[i].get()),
+                 stage_output_tensors[i]->get_data_size());
+        }
+      }
+    }
+    auto ret = vart::alloc_cpu_flat_tensor_buffers(output_tensors);
+    for (auto i = 0u; i < output_tensors.size(); ++i) {
+      auto& from = owned.at(output_tensors[i]->get_name());
+      CHECK_EQ(from.size(), (size_t)output_tensors[i]->get_data_size());
+      memcpy(data_of(ret[i].get()), from.data(), from.size());
+    }
+    return ret;
+  }
+
+ private:
+  std::vector<std::unique_ptr<xir::Attrs>> attrs_;
+  std::vector<std::unique_ptr<vart::Runner>> runners_;
+};
+
+static void fill_inputs(frame_buffers_t& frame, uint32_t seed) {
+  std::mt19937 rng(seed);
+  for (auto& input : frame.inputs) {
+    auto data = data_of(input.get());
+    // small values, so that float inputs are neither nan nor inf
+    for (auto i = 0; i < input->get_tensor()->get_data_size(); ++i) {
+      data[i] = char(rng() % 64u);
+    }
+  }
+}
+
+// returns the number of frames whose outputs are different
+static int compare_with_sequential(vart::GraphRunner* runner,
+                                   SequentialRunner* sequential,
+                                   std::vector<frame_buffers_t>& frames) {
+  auto ret = 0;
+  for (auto f = 0u; f < frames.size(); ++f) {
+    auto& frame = frames[f];
+    auto expected = sequential->run(
+        runner->get_input_tensors(),
+        vitis::ai::vector_unique_ptr_get(frame.inputs),
+        runner->get_output_tensors());
+    auto same = true;
+    for (auto i = 0u; i < expected.size(); ++i) {
+      auto size = frame.outputs[i]->get_tensor()->get_data_size();
+      CHECK_EQ(expected[i]->get_tensor()->get_data_size(), size);
+      if (memcmp(data_of(expected[i].get()), data_of(frame.outputs[i].get()),
+                 size) != 0) {
+        std::cout << "frame " << f << " output "
+                  << frame.outputs[i]->get_tensor()->get_name()
+                  << " is different from the sequential run" << std::endl;
+        same = false;
+      }
+    }
+    ret += same ? 0 : 1;
+  }
+  return ret;
+}
+
+static double max_stage_time_ms(vart::GraphRunner* runner) {
+  auto ret = 0.0;
+  for (auto& s : runner->get_stage_stats()) {
+    std::cout << "\t" << s.device << " " << s.subgraph_name
+              << " runs=" << s.num_of_runs << " avg="
+              << s.total_run_time_us / std::max<uint64_t>(s.num_of_runs, 1u)
+              << "us max=" << s.max_run_time_us << "us queue="
+              << s.total_queue_time_us /
+                     std::max<uint64_t>(s.num_of_runs, 1u)
+              << "us" << std::endl;
+    ret = std::max(ret, s.total_run_time_us / 1000.0 /
+                            std::max<uint64_t>(s.num_of_runs, 1u));
+  }
+  return ret;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " <xmodel>" << std::endl;
+    return 1;
+  }
+  auto graph = xir::Graph::deserialize(argv[1]);
+  auto libs = std::map<std::string, std::string>{
+      {"DPU", "libvart-dummy-runner.so"}};
+  if (ENV_PARAM(ALL_DUMMY)) {
+    libs["CPU"] = "libvart-dummy-runner.so";
+  }
+  auto ms_per_frame = std::vector<double>();
+  auto bound_ms = 0.0;
+  auto num_of_stages = 0u;
+  auto num_of_diffs = 0;
+  for (auto depth : {1, ENV_PARAM(DEPTH)}) {
+    auto attrs = xir::Attrs::create();
+    attrs->set_attr("lib", libs);
+    if (depth > 0) {
+      attrs->set_attr<size_t>("graph_runner_depth", (size_t)depth);
+    }
+    auto runner = vart::GraphRunner::create(graph.get(), attrs.get());
+    num_of_stages = runner->get_stage_stats().size();
+    // the first frame loads whatever the runners load lazily.
+    auto warm_up = std::vector<frame_buffers_t>(1u);
+    auto frames = std::vector<frame_buffers_t>(ENV_PARAM(NUM_OF_FRAMES));
+    auto seed = 0u;
+    for (auto v : {&warm_up, &frames}) {
+      for (auto& frame : *v) {
+        frame.inputs =
+            vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+        frame.outputs =
+            vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+        fill_inputs(frame, seed++);
+      }
+    }
+    run_frames(runner.get(), warm_up);
+    ms_per_frame.push_back(run_frames(runner.get(), frames));
+    std::cout << (depth == 1 ? "sequential" : "pipelined") << ": "
+              << ms_per_frame.back() << "ms/frame" << std::endl;
+    bound_ms = max_stage_time_ms(runner.get());
+    auto sequential = SequentialRunner(graph.get(), attrs.get());
+    num_of_diffs += compare_with_sequential(runner.get(), &sequential, frames);
+  }
+  // a pipelined frame takes about as long as the slowest stage, allow 20%
+  // and 1ms for scheduling.
+  auto ok = num_of_stages < 2u || ms_per_frame[1] < bound_ms * 1.2 + 1.0;
+  ok = ok && num_of_diffs == 0;
+  std::cout << num_of_stages << " stages, speedup "
+            << ms_per_frame[0] / ms_per_frame[1] << ", " << num_of_diffs
+            << " frames different" << (ok ? " PASS" : " FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include <xir/tensor/tensor.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vart/image_preprocess.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(NUM_OF_LOOPS, "20");
+DEF_ENV_PARAM(NUM_OF_THREADS, "0");
+
+static const std::array<float, 3> MEAN = {104.0f, 107.0f, 123.0f};
+static const std::array<float, 3> SCALE = {1.0f, 1.0f, 1.0f};
+
+static std::vector<uint8_t> random_image(int width, int height, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  auto ret = std::vector<uint8_t>((size_t)width * height * 3u);
+  for (auto& x : ret) {
+    x = (uint8_t)dist(rng);
+  }
+  return ret;
+}
+
+static double src_coord(int dst, int dst_size, int src_size) {
+  return std::max(0.0, (dst + 0.5) * src_size / dst_size - 0.5);
+}
+
+// bilinear, half-pixel centers, i.e. cv::resize() with cv::INTER_LINEAR
+static double bilinear(const uint8_t* image, int width, int height, int x,
+                       int y, int c, int dst_w, int dst_h) {
+  auto sx = src_coord(x, dst_w, width);
+  auto sy = src_coord(y, dst_h, height);
+  auto x0 = std::min((int)sx, width - 1);
+  auto y0 = std::min((int)sy, height - 1);
+  auto x1 = std::min(x0 + 1, width - 1);
+  auto y1 = std::min(y0 + 1, height - 1);
+  auto fx = x0 == x1 ? 0.0 : sx - x0;
+  auto fy = y0 == y1 ? 0.0 : sy - y0;
+  auto at = [=](int xx, int yy) {
+    return (double)image[((size_t)yy * width + xx) * 3u + c];
+  };
+  return (at(x0, y0) * (1 - fx) + at(x1, y0) * fx) * (1 - fy) +
+         (at(x0, y1) * (1 - fx) + at(x1, y1) * fx) * fy;
+}
+
+// the per-pixel path of the resnet50 sample: resize, then a triple loop
+// into a host vector, then a copy into the input tensor buffer.
+static void run_legacy(const uint8_t* image, int width, int height,
+                       int dst_w, int dst_h, float input_scale,
+                       std::vector<uint8_t>& resized,
+                       std::vector<int8_t>& host, int8_t* output) {
+  for (int h = 0; h < dst_h; h++) {
+    for (int w = 0; w < dst_w; w++) {
+      for (int c = 0; c < 3; c++) {
+        resized[(h * dst_w + w) * 3 + c] = (uint8_t)std::lround(
+            bilinear(image, width, height, w, h, c, dst_w, dst_h));
+      }
+    }
+  }
+  for (int h = 0; h < dst_h; h++) {
+    for (int w = 0; w < dst_w; w++) {
+      for (int c = 0; c < 3; c++) {
+        host[h * dst_w * 3 + w * 3 + c] = (int8_t)(
+            (resized[(h * dst_w + w) * 3 + c] - MEAN[c]) * input_scale);
+      }
+    }
+  }
+  memcpy(output, host.data(), host.size());
+}
+
+template <typename F>
+static double measure_us(F&& f) {
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; ++i) {
+    f();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         loops;
+}
+
+static bool test_shape(int width, int height, int batch, int fix_point,
+                       bool swap_rb, bool padded) {
+  const int dst_w = 224;
+  const int dst_h = 224;
+  auto tensor = xir::Tensor::create("input", {batch, dst_h, dst_w, 3},
+                                    xir::DataType{xir::DataType::XINT, 8u});
+  tensor->set_attr<int>("fix_point", fix_point);
+  // e.g. channels padded to 4 bytes
+  auto channel_stride = padded ? 4 : 3;
+  if (padded) {
+    tensor->set_attr<std::vector<std::int32_t>>(
+        "stride", {dst_h * dst_w * 4, dst_w * 4, 4, 1});
+  }
+  auto tensor_buffer = vart::alloc_cpu_flat_tensor_buffer(tensor.get());
+  auto preprocessor = std::make_unique<vart::ImagePreprocessor>(
+      tensor.get(), MEAN, SCALE, swap_rb, (size_t)ENV_PARAM(NUM_OF_THREADS));
+
+  auto images = std::vector<std::vector<uint8_t>>();
+  auto frames = std::vector<vart::ImagePreprocessor::frame_t>();
+  for (auto i = 0; i < batch; ++i) {
+    images.emplace_back(random_image(width, height, i + width));
+    frames.push_back({images.back().data(), width, height, 0});
+  }
+  auto t_fused = measure_us([&]() {
+    preprocessor->run(frames, tensor_buffer.get());
+  });
+
+  auto input_scale = std::exp2f((float)fix_point);
+  auto ok = true;
+  for (auto i = 0; i < batch && ok; ++i) {
+    auto out = (int8_t*)tensor_buffer->data({i, 0, 0, 0}).first;
+    for (auto y = 0; y < dst_h && ok; ++y) {
+      for (auto x = 0; x < dst_w && ok; ++x) {
+        for (auto c = 0; c < 3; ++c) {
+          auto src_c = swap_rb ? 2 - c : c;
+          auto v = (bilinear(images[i].data(), width, height, x, y, src_c,
+                             dst_w, dst_h) -
+                    MEAN[c]) *
+                   SCALE[c] * input_scale;
+          auto expected = std::min(std::max(std::floor(v + 0.5), -128.0),
+                                   127.0);
+          auto actual = out[(y * dst_w + x) * channel_stride + c];
+          // float vs double
+          if (std::abs(actual - expected) > 1.0) {
+            LOG(ERROR) << "mismatch at batch=" << i << " y=" << y
+                       << " x=" << x << " c=" << c << " expected="
+                       << expected << " actual=" << (int)actual;
+            ok = false;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  auto resized = std::vector<uint8_t>(dst_h * dst_w * 3);
+  auto host = std::vector<int8_t>(dst_h * dst_w * 3);
+  auto legacy_output = std::vector<int8_t>(host.size() * batch);
+  auto t_legacy = measure_us([&]() {
+    for (auto i = 0; i < batch; ++i) {
+      run_legacy(images[i].data(), width, height, dst_w, dst_h, input_scale,
+                 resized, host, &legacy_output[i * host.size()]);
+    }
+  });
+
+  std::cout << width << "x" << height << " batch=" << batch
+            << " fix_point=" << fix_point << " swap_rb=" << swap_rb
+            << " padded=" << padded                 //
+            << " legacy=" << t_legacy << "us"       //
+            << " fused=" << t_fused << "us"         //
+            << " speedup=" << t_legacy / t_fused  //
+            << (ok ? " PASS" : " FAIL") << std::endl;
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  auto ok = true;
+  // camera frames
+  ok = test_shape(1920, 1080, 1, 0, false, false) && ok;
+  ok = test_shape(640, 480, 4, 1, false, false) && ok;
+  // already resized, upscaled, rgb and padded channels
+  ok = test_shape(224, 224, 1, 0, true, false) && ok;
+  ok = test_shape(100, 80, 1, 2, false, true) && ok;
+  return ok ? 0 : 1;
+}
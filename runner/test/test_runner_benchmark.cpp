@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// load generator for any vart::Runner.
+//
+// usage: test_runner_benchmark <xmodel> [output.json]
+//
+// BENCH_MODE=closed    BENCH_CLIENTS clients, each one submits the next
+//                      request as soon as the previous one is done.
+// BENCH_MODE=constant  requests arrive every 1/BENCH_RATE seconds,
+// BENCH_MODE=poisson   or with exponential inter-arrival times, and are
+//                      served by BENCH_CLIENTS workers.
+//
+// In open-loop modes, the latency is measured from the scheduled arrival
+// time, not from the moment a worker picks up the request, so the time a
+// request waits for a busy runner is not lost (coordinated omission).
+//
+// The runner is selected by BENCH_RUNNER_MODE (run, ref or sim), or
+// overridden by BENCH_LIB, e.g. BENCH_LIB=libvart-dummy-runner.so together
+// with DUMMY_RUNNER_PROCESS_TIME benchmarks the queueing without hardware.
+// BENCH_ASYNC=1 shares one async runner among all clients instead of
+// creating one runner per client.
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <xir/graph/graph.hpp>
+
+#include "../src/runner_helper.hpp"
+#include "vart/runner.hpp"
+#include "vart/runner_ext.hpp"
+#include "vitis/ai/bounded_queue.hpp"
+#include "vitis/ai/collection_helper.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM_2(BENCH_MODE, "closed", std::string);
+DEF_ENV_PARAM(BENCH_CLIENTS, "1");
+// requests per second, open-loop modes only.
+DEF_ENV_PARAM(BENCH_RATE, "100");
+DEF_ENV_PARAM(BENCH_WARMUP_MS, "1000");
+DEF_ENV_PARAM(BENCH_DURATION_MS, "10000");
+DEF_ENV_PARAM_2(BENCH_RUNNER_MODE, "run", std::string);
+DEF_ENV_PARAM_2(BENCH_LIB, "", std::string);
+DEF_ENV_PARAM_2(BENCH_SUBGRAPH, "", std::string);
+DEF_ENV_PARAM(BENCH_ASYNC, "0");
+DEF_ENV_PARAM(BENCH_ASYNC_RUNNERS, "4");
+DEF_ENV_PARAM(BENCH_SEED, "0");
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct client_t {
+  vart::Runner* runner;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> input_holder;
+  std::vector<std::unique_ptr<vart::TensorBuffer>> output_holder;
+  std::vector<vart::TensorBuffer*> input;
+  std::vector<vart::TensorBuffer*> output;
+  // latencies of requests scheduled after the warmup, in nanoseconds.
+  std::vector<int64_t> latency;
+  size_t num_of_errors = 0u;
+};
+}  // namespace
+
+static const xir::Subgraph* find_subgraph(const xir::Graph* graph) {
+  auto children = graph->get_root_subgraph()->children_topological_sort();
+  for (auto c : children) {
+    if (!ENV_PARAM(BENCH_SUBGRAPH).empty()) {
+      if (c->get_name() == ENV_PARAM(BENCH_SUBGRAPH)) {
+        return c;
+      }
+    } else if (c->has_attr("device") &&
+               c->get_attr<std::string>("device") == "DPU") {
+      return c;
+    }
+  }
+  LOG(FATAL) << "cannot find subgraph. BENCH_SUBGRAPH="
+             << ENV_PARAM(BENCH_SUBGRAPH);
+  return nullptr;
+}
+
+static std::unique_ptr<vart::Runner> create_runner(
+    const xir::Subgraph* subgraph) {
+  auto attrs = xir::Attrs::create();
+  attrs->set_attr("mode", ENV_PARAM(BENCH_RUNNER_MODE));
+  if (!ENV_PARAM(BENCH_LIB).empty()) {
+    attrs->set_attr("lib", std::map<std::string, std::string>{
+                               {subgraph->get_attr<std::string>("device"),
+                                ENV_PARAM(BENCH_LIB)}});
+  }
+  if (ENV_PARAM(BENCH_ASYNC)) {
+    attrs->set_attr("async", true);
+    attrs->set_attr("num_of_dpu_runners",
+                    (size_t)ENV_PARAM(BENCH_ASYNC_RUNNERS));
+  }
+  return vart::Runner::create_runner_with_attrs(subgraph, attrs.get());
+}
+
+static void init_client(client_t& c, vart::Runner* runner) {
+  c.runner = runner;
+  auto r = dynamic_cast<vart::RunnerExt*>(runner);
+  if (r != nullptr && !ENV_PARAM(BENCH_ASYNC)) {
+    // the buffers preferred by the runner, e.g. zero copy for DPU runners.
+    c.input = r->get_inputs();
+    c.output = r->get_outputs();
+    return;
+  }
+  c.input_holder =
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_input_tensors());
+  c.output_holder =
+      vart::alloc_cpu_flat_tensor_buffers(runner->get_output_tensors());
+  c.input = vitis::ai::vector_unique_ptr_get(c.input_holder);
+  c.output = vitis::ai::vector_unique_ptr_get(c.output_holder);
+}
+
+static void run_one(client_t& c, Clock::time_point scheduled,
+                    Clock::time_point warmup_end) {
+  auto job = c.runner->execute_async(c.input, c.output);
+  auto ok = job.second == 0 && c.runner->wait((int)job.first, -1) == 0;
+  auto done = Clock::now();
+  if (!ok) {
+    c.num_of_errors++;
+    return;
+  }
+  if (scheduled >= warmup_end) {
+    c.latency.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(done - scheduled)
+            .count());
+  }
+}
+
+static void closed_loop(std::vector<client_t>& clients,
+                        Clock::time_point warmup_end, Clock::time_point end) {
+  auto threads = std::vector<std::thread>();
+  for (auto& c : clients) {
+    threads.emplace_back([&c, warmup_end, end]() {
+      for (auto now = Clock::now(); now < end; now = Clock::now()) {
+        run_one(c, now, warmup_end);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+static size_t open_loop(std::vector<client_t>& clients,
+                        Clock::time_point start, Clock::time_point warmup_end,
+                        Clock::time_point end) {
+  auto poisson = ENV_PARAM(BENCH_MODE) == "poisson";
+  CHECK(poisson || ENV_PARAM(BENCH_MODE) == "constant")
+      << "unknown BENCH_MODE " << ENV_PARAM(BENCH_MODE);
+  CHECK_GT(ENV_PARAM(BENCH_RATE), 0);
+  // large enough that the generator never blocks, a blocked generator would
+  // hide the queueing delay.
+  vitis::ai::BoundedQueue<Clock::time_point> queue(1u << 22);
+  auto max_queue_depth = (size_t)0u;
+  auto workers = std::vector<std::thread>();
+  for (auto& c : clients) {
+    workers.emplace_back([&c, &queue, warmup_end]() {
+      for (;;) {
+        auto scheduled = Clock::time_point{};
+        queue.pop(scheduled);
+        if (scheduled == Clock::time_point::max()) {
+          break;
+        }
+        run_one(c, scheduled, warmup_end);
+      }
+    });
+  }
+  auto rng = std::mt19937_64(ENV_PARAM(BENCH_SEED));
+  auto mean_ns = 1.0e9 / (double)ENV_PARAM(BENCH_RATE);
+  auto interval = std::exponential_distribution<double>(1.0 / mean_ns);
+  auto next = (double)0.0;
+  for (;;) {
+    next += poisson ? interval(rng) : mean_ns;
+    auto scheduled = start + std::chrono::nanoseconds((int64_t)next);
+    if (scheduled >= end) {
+      break;
+    }
+    std::this_thread::sleep_until(scheduled);
+    queue.push(scheduled);
+    max_queue_depth = std::max(max_queue_depth, queue.size());
+  }
+  for (auto i = 0u; i < clients.size(); ++i) {
+    queue.push(Clock::time_point::max());
+  }
+  for (auto& t : workers) {
+    t.join();
+  }
+  return max_queue_depth;
+}
+
+static int64_t percentile(const std::vector<int64_t>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto rank = (size_t)std::ceil(p / 100.0 * (double)sorted.size());
+  rank = std::min(std::max(rank, (size_t)1u), sorted.size());
+  return sorted[rank - 1u];
+}
+
+int main(int argc, char* argv[]) {
+  CHECK_GE(argc, 2) << "usage: " << argv[0] << " <xmodel> [output.json]";
+  auto graph = xir::Graph::deserialize(argv[1]);
+  auto subgraph = find_subgraph(graph.get());
+  auto num_of_clients = (size_t)std::max(ENV_PARAM(BENCH_CLIENTS), 1);
+
+  auto runners = std::vector<std::unique_ptr<vart::Runner>>();
+  auto clients = std::vector<client_t>(num_of_clients);
+  for (auto i = 0u; i < num_of_clients; ++i) {
+    if (runners.empty() || !ENV_PARAM(BENCH_ASYNC)) {
+      runners.emplace_back(create_runner(subgraph));
+    }
+    init_client(clients[i], runners.back().get());
+  }
+  auto input_tensors = runners[0]->get_input_tensors();
+  auto batch = input_tensors.empty() ? 1 : input_tensors[0]->get_shape()[0];
+
+  auto start = Clock::now();
+  auto warmup_end =
+      start + std::chrono::milliseconds(ENV_PARAM(BENCH_WARMUP_MS));
+  auto end =
+      warmup_end + std::chrono::milliseconds(ENV_PARAM(BENCH_DURATION_MS));
+  auto max_queue_depth = (size_t)0u;
+  if (ENV_PARAM(BENCH_MODE) == "closed") {
+    closed_loop(clients, warmup_end, end);
+  } else {
+    max_queue_depth = open_loop(clients, start, warmup_end, end);
+  }
+  auto finished = Clock::now();
+
+  auto latency = std::vector<int64_t>();
+  auto num_of_errors = (size_t)0u;
+  for (auto& c : clients) {
+    latency.insert(latency.end(), c.latency.begin(), c.latency.end());
+    num_of_errors += c.num_of_errors;
+  }
+  std::sort(latency.begin(), latency.end());
+  auto sum = 0.0;
+  for (auto l : latency) {
+    sum += (double)l;
+  }
+  // requests scheduled in [warmup_end, end) are counted, in open-loop mode
+  // the last ones may complete after `end`.
+  auto seconds =
+      std::chrono::duration<double>(std::max(end, finished) - warmup_end)
+          .count();
+  if (ENV_PARAM(BENCH_MODE) == "closed") {
+    seconds = std::chrono::duration<double>(end - warmup_end).count();
+  }
+  auto us = [](double ns) { return ns / 1000.0; };
+
+  std::ostringstream json;
+  json << std::fixed << std::setprecision(3);
+  json << "{\n"
+       << "  \"xmodel\": \"" << argv[1] << "\",\n"
+       << "  \"subgraph\": \"" << subgraph->get_name() << "\",\n"
+       << "  \"runner_mode\": \"" << ENV_PARAM(BENCH_RUNNER_MODE) << "\",\n"
+       << "  \"lib\": \"" << ENV_PARAM(BENCH_LIB) << "\",\n"
+       << "  \"async\": " << (ENV_PARAM(BENCH_ASYNC) ? "true" : "false")
+       << ",\n"
+       << "  \"mode\": \"" << ENV_PARAM(BENCH_MODE) << "\",\n"
+       << "  \"clients\": " << num_of_clients << ",\n"
+       << "  \"target_rate\": "
+       << (ENV_PARAM(BENCH_MODE) == "closed" ? 0 : ENV_PARAM(BENCH_RATE))
+       << ",\n"
+       << "  \"batch\": " << batch << ",\n"
+       << "  \"warmup_s\": " << ENV_PARAM(BENCH_WARMUP_MS) / 1000.0 << ",\n"
+       << "  \"duration_s\": " << seconds << ",\n"
+       << "  \"requests\": " << latency.size() << ",\n"
+       << "  \"errors\": " << num_of_errors << ",\n"
+       << "  \"requests_per_second\": " << (double)latency.size() / seconds
+       << ",\n"
+       << "  \"frames_per_second\": "
+       << (double)latency.size() * batch / seconds << ",\n"
+       << "  \"max_queue_depth\": " << max_queue_depth << ",\n"
+       << "  \"latency_us\": {\n"
+       << "    \"mean\": " << (latency.empty() ? 0.0 : us(sum / latency.size()))
+       << ",\n"
+       << "    \"min\": " << us(percentile(latency, 0.0)) << ",\n"
+       << "    \"p50\": " << us(percentile(latency, 50.0)) << ",\n"
+       << "    \"p90\": " << us(percentile(latency, 90.0)) << ",\n"
+       << "    \"p99\": " << us(percentile(latency, 99.0)) << ",\n"
+       << "    \"p99.9\": " << us(percentile(latency, 99.9)) << ",\n"
+       << "    \"p99.99\": " << us(percentile(latency, 99.99)) << ",\n"
+       << "    \"max\": " << us(percentile(latency, 100.0)) << "\n"
+       << "  }\n"
+       << "}\n";
+  if (argc > 2) {
+    CHECK(std::ofstream(argv[2]) << json.str()) << "cannot write " << argv[2];
+  } else {
+    std::cout << json.str();
+  }
+  return num_of_errors == 0u ? 0 : 1;
+}
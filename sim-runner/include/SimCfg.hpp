@@ -93,6 +93,11 @@ class SimCfg {
   int get_ddr_dump_end_fast() const;
   bool get_ddr_dump_split() const;
   int get_ddr_dump_format() const;
+  bool get_dump_archive() const;
+  bool get_dump_archive_compress() const;
+  bool get_sim_cache() const;
+  std::string get_sim_cache_path() const;
+  int get_sim_cache_size() const;
   int get_layer_dump_format() const;
   bool get_dump_instr() const;
   bool get_debug_instr(int type) const;
@@ -165,6 +170,11 @@ class SimCfg {
   int ddr_dump_end_fast_;  // 0x10: <ori, now>=<ture, false>
   bool ddr_dump_split_;
   int ddr_dump_format_;
+  bool dump_archive_;
+  bool dump_archive_compress_;
+  bool sim_cache_;
+  std::string sim_cache_path_;
+  int sim_cache_size_;  // in MB
   bool dump_inst_;
   std::array<bool, SimCfg::DBG_INSTR_MAX> debug_inst_;
   bool gen_aie_data_{false};
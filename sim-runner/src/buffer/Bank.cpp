@@ -17,6 +17,7 @@
 #include "buffer/Bank.hpp"
 #include "SimCfg.hpp"
 #include "UniLog/UniLog.hpp"
+#include "util/DumpArchive.hpp"
 #include "util/Util.hpp"
 
 template <typename DType>
@@ -62,13 +63,13 @@ void Bank<DType>::Save(int inst_no, int fmt) {
                      Util::GetFileNameSuffix(fmt);
 
   if (fmt <= DATA_FMT_HEX_CONT_BIGEND) {
-    Util::SaveData(fmt, save_name, data_.data(), data_.size(), bank_w_);
+    DumpArchive::SaveData(fmt, save_name, data_.data(), data_.size(), bank_w_);
   } else if (fmt == DATA_FMT_HEX_CONT_SMALLEND_BANKADDR) {
-    Util::SaveHexContSmallEndBankAddr(
+    DumpArchive::SaveHexContSmallEndBankAddr(
         save_name, reinterpret_cast<const char*>(data_.data()),
         data_.size() * sizeof(DType), bank_w_ * sizeof(DType));
   } else if (fmt == DATA_FMT_HEX_CONT_BIGEND_BANKADDR) {
-    Util::SaveHexContBigEndBankAddr(
+    DumpArchive::SaveHexContBigEndBankAddr(
         save_name, reinterpret_cast<const char*>(data_.data()),
         data_.size() * sizeof(DType), bank_w_ * sizeof(DType));
   }
@@ -18,6 +18,7 @@
 #include <sstream>
 #include "SimCfg.hpp"
 #include "conf/ArchCfg.hpp"
+#include "util/DumpArchive.hpp"
 #include "util/Util.hpp"
 
 template <typename DType>
@@ -125,14 +126,15 @@ void Buffer<DType>::SaveAllBank(int fmt, int inst_no) {
     vector<DType> buf(size);
     bank->Read(0, size, buf.data());
     if (fmt <= DATA_FMT_HEX_CONT_BIGEND) {
-      Util::SaveData(fmt, save_name, buf.data(), buf.size(), width, SM_APPEND);
+      DumpArchive::SaveData(fmt, save_name, buf.data(), buf.size(), width,
+                            SM_APPEND);
     } else if (fmt == DATA_FMT_HEX_CONT_SMALLEND_BANKADDR) {
-      Util::SaveHexContSmallEndBankAddr(
+      DumpArchive::SaveHexContSmallEndBankAddr(
           save_name, reinterpret_cast<char*>(buf.data()),
           buf.size() * sizeof(DType), width * sizeof(DType), depth, idx, 0,
           SM_APPEND);
     } else if (fmt == DATA_FMT_HEX_CONT_BIGEND_BANKADDR) {
-      Util::SaveHexContBigEndBankAddr(
+      DumpArchive::SaveHexContBigEndBankAddr(
           save_name, reinterpret_cast<char*>(buf.data()),
           buf.size() * sizeof(DType), width * sizeof(DType), depth, idx, 0,
           SM_APPEND);
@@ -17,6 +17,7 @@
 #include "buffer/DDR.hpp"
 #include "SimCfg.hpp"
 #include "UniLog/UniLog.hpp"
+#include "util/DumpArchive.hpp"
 #include "util/Util.hpp"
 #include "xir/graph/subgraph.hpp"
 #include "xir/tensor/tensor.hpp"
@@ -49,6 +50,12 @@ uint64_t DDR::GetSize(int reg_id) const {
   return ddr_buf_.at(reg_id).size;
 }
 
+std::vector<int32_t> DDR::GetRegIDs() const {
+  std::vector<int32_t> ids;
+  for (auto& item : ddr_buf_) ids.push_back(item.first);
+  return ids;
+}
+
 void DDR::SaveReg(const std::string file) {
   ofstream ofs(file, std::ios::app);
   Util::ChkOpen(ofs, file);
@@ -99,23 +106,24 @@ void DDR::SaveDDR(std::string save_name, int fmt, bool skip) {
       auto data_dtype_size = buf.size() / sizeof(DPU_DATA_TYPE);
       auto line_size =
           (fmt == DATA_FMT_DEC) ? 1 : (hp_width_ / sizeof(DPU_DATA_TYPE));
-      Util::SaveData(fmt, save_name, data_dtype_ptr, data_dtype_size, line_size,
-                     SM_APPEND);
+      DumpArchive::SaveData(fmt, save_name, data_dtype_ptr, data_dtype_size,
+                            line_size, SM_APPEND);
     } else if (fmt == DATA_FMT_HEX_CONT_SMALLEND_DDRADDR) {
       if (saveDDRFast == 1) {
         saveRegUsedBlk(save_name, reg, fmt);
         saveRegUsedBlk(save_name + ".init", ddr_buf_init_.at(reg_id), fmt);
       } else {
-        Util::SaveHexContSmallEndDDRAddr(save_name, buf.data(), buf.size(),
-                                         hp_width_, 0, reg.id, SM_APPEND);
+        DumpArchive::SaveHexContSmallEndDDRAddr(save_name, buf.data(),
+                                                buf.size(), hp_width_, 0,
+                                                reg.id, SM_APPEND);
       }
     } else if (fmt == DATA_FMT_HEX_CONT_BIGEND_DDRADDR) {
       if (saveDDRFast == 1) {
         saveRegUsedBlk(save_name, reg, fmt);
         saveRegUsedBlk(save_name + ".init", ddr_buf_init_.at(reg_id), fmt);
       } else {
-        Util::SaveHexContBigEndDDRAddr(save_name, buf.data(), buf.size(),
-                                       hp_width_, 0, reg.id, SM_APPEND);
+        DumpArchive::SaveHexContBigEndDDRAddr(save_name, buf.data(), buf.size(),
+                                              hp_width_, 0, reg.id, SM_APPEND);
       }
     } else {
       UNI_LOG_FATAL(SIM_OUT_OF_RANGE) << "Not support fmt: " << fmt;
@@ -205,13 +213,14 @@ void DDR::saveRegUsedBlk(const string& save_name, const Reg& reg, int fmt) {
                             ? (reg.size - addr_offset)
                             : num_bytes;
     if (fmt == DATA_FMT_HEX_CONT_SMALLEND_DDRADDR) {
-      Util::SaveHexContSmallEndDDRAddr(save_name, buf.data() + addr_offset,
-                                       blk_size, hp_width, addr_offset, reg.id,
-                                       SM_APPEND);
+      DumpArchive::SaveHexContSmallEndDDRAddr(save_name,
+                                              buf.data() + addr_offset,
+                                              blk_size, hp_width, addr_offset,
+                                              reg.id, SM_APPEND);
     } else {
-      Util::SaveHexContBigEndDDRAddr(save_name, buf.data() + addr_offset,
-                                     blk_size, hp_width, addr_offset, reg.id,
-                                     SM_APPEND);
+      DumpArchive::SaveHexContBigEndDDRAddr(save_name, buf.data() + addr_offset,
+                                            blk_size, hp_width, addr_offset,
+                                            reg.id, SM_APPEND);
     }
   }
 }
@@ -253,15 +262,17 @@ void DDR::SaveDDR(
           reinterpret_cast<DPU_DATA_TYPE*>(buf.data() + ddr_offset);
       auto line_size =
           (fmt == DATA_FMT_DEC) ? 1 : (hp_width_ / sizeof(DPU_DATA_TYPE));
-      Util::SaveData(fmt, save_name, data_dtype_ptr,
-                     size / sizeof(DPU_DATA_TYPE), line_size, SM_APPEND);
+      DumpArchive::SaveData(fmt, save_name, data_dtype_ptr,
+                            size / sizeof(DPU_DATA_TYPE), line_size, SM_APPEND);
     } else if (fmt == DATA_FMT_HEX_CONT_SMALLEND_DDRADDR) {
-      Util::SaveHexContSmallEndDDRAddr(save_name, buf.data() + ddr_offset, size,
-                                       hp_width_, ddr_offset, reg_id,
-                                       SM_APPEND);
+      DumpArchive::SaveHexContSmallEndDDRAddr(save_name,
+                                              buf.data() + ddr_offset, size,
+                                              hp_width_, ddr_offset, reg_id,
+                                              SM_APPEND);
     } else if (fmt == DATA_FMT_HEX_CONT_BIGEND_DDRADDR) {
-      Util::SaveHexContBigEndDDRAddr(save_name, buf.data() + ddr_offset, size,
-                                     hp_width_, ddr_offset, reg_id, SM_APPEND);
+      DumpArchive::SaveHexContBigEndDDRAddr(save_name, buf.data() + ddr_offset,
+                                            size, hp_width_, ddr_offset, reg_id,
+                                            SM_APPEND);
     } else {
       UNI_LOG_FATAL(SIM_OUT_OF_RANGE) << "Not support fmt: " << fmt;
     }
@@ -47,6 +47,7 @@ class DDR {
  public:
   char* GetAddr(int reg_id, uint64_t offset, size_t* data_size = nullptr);
   uint64_t GetSize(int reg_id) const;
+  std::vector<int32_t> GetRegIDs() const;
   void SaveReg(const std::string file);
   void SaveDDR_cosim(std::string save_name, int fmt, bool skip = false);
   void SaveDDR(std::string save_name, int fmt, bool skip = false);
@@ -39,6 +39,11 @@ SimCfg::SimCfg(const std::string& config_fname) {
   ddr_dump_end_fast_ = 0x00;
   ddr_dump_split_ = true;
   ddr_dump_format_ = 0;
+  dump_archive_ = false;
+  dump_archive_compress_ = true;
+  sim_cache_ = false;
+  sim_cache_path_ = "./sim_cache";
+  sim_cache_size_ = 4096;
   dump_inst_ = false;
   debug_inst_ = {false, false, false, false, false, false, false, false, false};
   gen_aie_data_ = false;
@@ -95,6 +100,8 @@ SimCfg::SimCfg(const std::string& config_fname) {
         bank_init_file_ = item.second;
       else if (key == "debug_path")
         debug_path_ = item.second;
+      else if (key == "sim_cache_path")
+        sim_cache_path_ = item.second;
       else if (key == "isa_version")
         isa_version_ = item.second;
       else if (key == "run_mode")
@@ -112,6 +119,8 @@ SimCfg::SimCfg(const std::string& config_fname) {
         ddr_dump_format_ = stoi(item.second);
       else if (key == "batch_index")
         batch_index_ = stoi(item.second);
+      else if (key == "sim_cache_size")
+        sim_cache_size_ = stoi(item.second);
 
       else if (key == "bank_init")
         bank_init_ = Util::Str2Bool(item.second);
@@ -136,6 +145,12 @@ SimCfg::SimCfg(const std::string& config_fname) {
       }
       else if (key == "ddr_dump_split")
         ddr_dump_split_ = Util::Str2Bool(item.second);
+      else if (key == "dump_archive")
+        dump_archive_ = Util::Str2Bool(item.second);
+      else if (key == "dump_archive_compress")
+        dump_archive_compress_ = Util::Str2Bool(item.second);
+      else if (key == "sim_cache")
+        sim_cache_ = Util::Str2Bool(item.second);
       else if (key == "dump_inst")
         dump_inst_ = Util::Str2Bool(item.second);
 
@@ -352,6 +367,13 @@ void SimCfg::set_ddr_dump_end_fast(int val) { ddr_dump_end_fast_ = val; }
 bool SimCfg::get_ddr_dump_split() const { return ddr_dump_split_; }
 int SimCfg::get_layer_dump_format() const { return layer_dump_format_; }
 int SimCfg::get_ddr_dump_format() const { return ddr_dump_format_; }
+bool SimCfg::get_dump_archive() const { return dump_archive_; }
+bool SimCfg::get_dump_archive_compress() const {
+  return dump_archive_compress_;
+}
+bool SimCfg::get_sim_cache() const { return sim_cache_; }
+std::string SimCfg::get_sim_cache_path() const { return sim_cache_path_; }
+int SimCfg::get_sim_cache_size() const { return sim_cache_size_; }
 void SimCfg::set_batch_index(int idx) { batch_index_ = idx; }
 void SimCfg::set_debug_path(const std::string path) { debug_path_ = path; }
 
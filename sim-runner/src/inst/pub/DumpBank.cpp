@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 #include "DumpBank.hpp"
+#include "util/DumpArchive.hpp"
 
 std::set<DDRblock> DDRblock::usedBlocks;
 std::string DDRblock::subgraphName_ = "";
@@ -210,15 +211,15 @@ void DumpBank<T>::dump_bank_range() {
     // save bank's contents
     int line_size = (save_fmt_ <= DATA_FMT_DEC) ? 1 : bank_w;
     if (save_fmt_ <= DATA_FMT_HEX_CONT_BIGEND) {
-      Util::SaveData(save_fmt_, fname, buf.data(), buf.size(), line_size,
-                     SM_APPEND);
+      DumpArchive::SaveData(save_fmt_, fname, buf.data(), buf.size(), line_size,
+                            SM_APPEND);
     } else if (save_fmt_ == DATA_FMT_HEX_CONT_SMALLEND_BANKADDR) {
-      Util::SaveHexContSmallEndBankAddr(
+      DumpArchive::SaveHexContSmallEndBankAddr(
           fname, reinterpret_cast<const char*>(buf.data()),
           buf.size() * sizeof(DPU_DATA_TYPE), line_size * sizeof(DPU_DATA_TYPE),
           bank_h, bank_id, 0, SM_APPEND);
     } else if (save_fmt_ == DATA_FMT_HEX_CONT_BIGEND_BANKADDR) {
-      Util::SaveHexContBigEndBankAddr(
+      DumpArchive::SaveHexContBigEndBankAddr(
           fname, reinterpret_cast<const char*>(buf.data()),
           buf.size() * sizeof(DPU_DATA_TYPE), line_size * sizeof(DPU_DATA_TYPE),
           bank_h, bank_id, 0, SM_APPEND);
@@ -16,6 +16,7 @@
  */
 #include "DumpDDR.hpp"
 #include "buffer/DDR.hpp"
+#include "util/DumpArchive.hpp"
 #include "inst/InstTable.hpp"
 
 // constructor and deconstructor
@@ -270,14 +271,16 @@ void DumpDDR<dv>::dump_ddr_range() {
   if (save_fmt_ <= DATA_FMT_HEX_CONT_BIGEND) {
     auto line_size =
         (save_fmt_ == DATA_FMT_DEC) ? 1 : (hp_width_ / sizeof(DPU_DATA_TYPE));
-    Util::SaveData(save_fmt_, fname, data_dtype_ptr, data_dtype_size,
-                   line_size);
+    DumpArchive::SaveData(save_fmt_, fname, data_dtype_ptr, data_dtype_size,
+                          line_size);
   } else if (save_fmt_ == DATA_FMT_HEX_CONT_SMALLEND_DDRADDR) {
-    Util::SaveHexContSmallEndDDRAddr(fname, data_char_ptr, ddr_size_, hp_width_,
-                                     ddr_start_, ddr_reg_id_, SM_TRUNC);
+    DumpArchive::SaveHexContSmallEndDDRAddr(fname, data_char_ptr, ddr_size_,
+                                            hp_width_, ddr_start_, ddr_reg_id_,
+                                            SM_TRUNC);
   } else if (save_fmt_ == DATA_FMT_HEX_CONT_BIGEND_DDRADDR) {
-    Util::SaveHexContBigEndDDRAddr(fname, data_char_ptr, ddr_size_, hp_width_,
-                                   ddr_start_, ddr_reg_id_, SM_TRUNC);
+    DumpArchive::SaveHexContBigEndDDRAddr(fname, data_char_ptr, ddr_size_,
+                                          hp_width_, ddr_start_, ddr_reg_id_,
+                                          SM_TRUNC);
   } else {
     UNI_LOG_FATAL(SIM_OUT_OF_RANGE)
         << "Unsupported DDR dump format: " << save_fmt_ << "!";
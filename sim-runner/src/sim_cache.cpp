@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sim_cache.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "SimCfg.hpp"
+#include "UniLog/UniLog.hpp"
+#include "buffer/Buffer.hpp"
+#include "buffer/DDR.hpp"
+#include "conf/ArchCfg.hpp"
+#include "util/Util.hpp"
+
+namespace vart {
+namespace sim {
+
+// entry layout, integers are in host byte order:
+//   MAGIC, uint32 version, uint64 range num,
+//   range num x (int32 region id, uint64 offset, uint64 size, data)
+static const char MAGIC[8] = {'S', 'I', 'M', 'C', 'A', 'C', 'H', 'E'};
+static const uint32_t VERSION = 1;
+static const std::string SUFFIX = ".simc";
+
+template <typename T>
+static void put(std::vector<char>& out, const T& val) {
+  auto p = reinterpret_cast<const char*>(&val);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+static bool get(std::ifstream& f, T& val) {
+  return static_cast<bool>(f.read(reinterpret_cast<char*>(&val), sizeof(T)));
+}
+
+bool SimCache::is_enabled() const {
+  return SimCfg::Instance().get_sim_cache() &&
+         !SimCfg::Instance().get_debug_enable();
+}
+
+bool SimCache::begin_layer(const std::vector<std::string>& ac_code) {
+  if (!scanned_) scan_folder();
+  read_state(hashes_);
+  key_ = get_key(ac_code, hashes_);
+  if (load(key_ + SUFFIX)) {
+    stats_.hit++;
+    return true;
+  }
+  stats_.miss++;
+  return false;
+}
+
+void SimCache::end_layer() {
+  std::vector<uint64_t> after;
+  read_state(after);
+  store(key_ + SUFFIX, hashes_, after);
+}
+
+void SimCache::log_stats() const {
+  auto total = stats_.hit + stats_.miss;
+  UNI_LOG_INFO << "sim cache: hit " << stats_.hit << "/" << total
+               << " superlayers (" << (total ? 100 * stats_.hit / total : 0)
+               << "%), restored " << stats_.restored_size << " bytes, stored "
+               << stats_.stored_size << " bytes, evicted " << stats_.evicted
+               << " entries";
+}
+
+void SimCache::read_state(std::vector<uint64_t>& hashes) {
+  regions_.clear();
+  for (auto id : DDR::Instance().GetRegIDs()) {
+    if (DDR::Instance().GetSize(id) == 0) continue;
+    size_t size = 0;
+    auto data = DDR::Instance().GetAddr(id, 0, &size);
+    if (size == 0) continue;
+    regions_.push_back(Region{id, data, size});
+  }
+
+  bank_image_.clear();
+  auto& buffer = Buffer<DPU_DATA_TYPE>::Instance();
+  for (auto id = 0U; id <= buffer.GetBankIDMax(); id++) {
+    auto bank = buffer.GetBank(id);
+    if (bank == nullptr) continue;
+    auto ele_num = bank->GetH() * bank->GetW();
+    auto offset = bank_image_.size();
+    bank_image_.resize(offset + ele_num * sizeof(DPU_DATA_TYPE));
+    bank->Read(0, ele_num,
+               reinterpret_cast<DPU_DATA_TYPE*>(bank_image_.data() + offset));
+  }
+  regions_.push_back(
+      Region{BANK_REGION_ID, bank_image_.data(), bank_image_.size()});
+
+  hashes.clear();
+  for (auto& region : regions_) {
+    for (uint64_t pos = 0; pos < region.size; pos += BLOCK_SIZE) {
+      auto size = std::min<uint64_t>(BLOCK_SIZE, region.size - pos);
+      hashes.push_back(Util::HashBytes(region.data + pos, size));
+    }
+  }
+}
+
+void SimCache::write_banks() {
+  auto& buffer = Buffer<DPU_DATA_TYPE>::Instance();
+  uint64_t offset = 0;
+  for (auto id = 0U; id <= buffer.GetBankIDMax(); id++) {
+    auto bank = buffer.GetBank(id);
+    if (bank == nullptr) continue;
+    auto ele_num = bank->GetH() * bank->GetW();
+    bank->Write(0, ele_num,
+                reinterpret_cast<DPU_DATA_TYPE*>(bank_image_.data() + offset));
+    offset += ele_num * sizeof(DPU_DATA_TYPE);
+  }
+}
+
+std::string SimCache::get_key(const std::vector<std::string>& ac_code,
+                              const std::vector<uint64_t>& hashes) const {
+  auto& cfg = SimCfg::Instance();
+  std::string text = ArchCfg::Instance().get_param().SerializeAsString();
+  text += "isa " + std::to_string(cfg.get_isa_version()) + " hp_width " +
+          std::to_string(cfg.get_hp_width()) + " engine " +
+          std::to_string(cfg.get_tiling_engine_id()) + "\n";
+  // load/save relocate ddr addresses with these maps, sort them first
+  auto offsets = cfg.get_ddr_addr_offset_map();
+  for (auto& item : std::map<std::string, int32_t>(offsets.begin(),
+                                                   offsets.end())) {
+    text += "offset " + item.first + " " + std::to_string(item.second) + "\n";
+  }
+  auto rids = cfg.get_fake_rid_to_real_rid_map();
+  for (auto& item :
+       std::map<std::string, int32_t>(rids.begin(), rids.end())) {
+    text += "rid " + item.first + " " + std::to_string(item.second) + "\n";
+  }
+  for (auto& line : ac_code) text += line + "\n";
+  for (auto& region : regions_) {
+    text += "region " + std::to_string(region.id) + " " +
+            std::to_string(region.size) + "\n";
+  }
+  text.append(reinterpret_cast<const char*>(hashes.data()),
+              hashes.size() * sizeof(uint64_t));
+
+  // two independent 64-bit hashes, a false hit needs both to collide
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16)
+     << Util::HashBytes(text.data(), text.size()) << std::setw(16)
+     << Util::HashBytes(text.data(), text.size(), 0x2545f4914f6cdd1dULL);
+  return ss.str();
+}
+
+bool SimCache::load(const std::string& name) {
+  auto fname = SimCfg::Instance().get_sim_cache_path() + "/" + name;
+  std::ifstream f(fname, std::ios::binary);
+  if (!f.is_open()) return false;
+
+  char magic[sizeof(MAGIC)];
+  uint32_t version = 0;
+  uint64_t range_num = 0;
+  f.read(magic, sizeof(magic));
+  if (!get(f, version) || !get(f, range_num) ||
+      memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION) {
+    UNI_LOG_WARNING << "sim cache: ignore invalid entry " << fname;
+    return false;
+  }
+
+  // read and check every range before touching the state
+  struct Range {
+    Region* region;
+    uint64_t offset;
+    std::vector<char> data;
+  };
+  std::vector<Range> ranges(range_num);
+  for (auto& range : ranges) {
+    int32_t id;
+    uint64_t size;
+    if (!get(f, id) || !get(f, range.offset) || !get(f, size)) return false;
+    auto it = std::find_if(regions_.begin(), regions_.end(),
+                           [id](const Region& r) { return r.id == id; });
+    if (it == regions_.end() || range.offset + size > it->size) {
+      UNI_LOG_WARNING << "sim cache: ignore invalid entry " << fname;
+      return false;
+    }
+    range.region = &*it;
+    range.data.resize(size);
+    if (!f.read(range.data.data(), size)) return false;
+  }
+
+  auto bank_changed = false;
+  for (auto& range : ranges) {
+    memcpy(range.region->data + range.offset, range.data.data(),
+           range.data.size());
+    bank_changed |= (range.region->id == BANK_REGION_ID);
+    stats_.restored_size += range.data.size();
+  }
+  if (bank_changed) write_banks();
+
+  // refresh the entry for lru eviction
+  utime(fname.c_str(), nullptr);
+  if (entries_.count(name)) entries_.at(name).mtime = std::time(nullptr);
+  return true;
+}
+
+void SimCache::store(const std::string& name,
+                     const std::vector<uint64_t>& before,
+                     const std::vector<uint64_t>& after) {
+  // ddr regs were reallocated by the superlayer, nothing to compare with
+  if (before.size() != after.size()) return;
+
+  std::vector<char> body(MAGIC, MAGIC + sizeof(MAGIC));
+  put(body, VERSION);
+  put(body, uint64_t(0));
+  uint64_t range_num = 0;
+  uint64_t idx = 0;
+  for (auto& region : regions_) {
+    uint64_t block_num = (region.size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    // adjacent changed blocks are merged into one range
+    for (uint64_t b = 0; b < block_num;) {
+      if (before[idx + b] == after[idx + b]) {
+        b++;
+        continue;
+      }
+      auto start = b;
+      while (b < block_num && before[idx + b] != after[idx + b]) b++;
+      uint64_t offset = start * BLOCK_SIZE;
+      uint64_t size = std::min<uint64_t>(b * BLOCK_SIZE, region.size) - offset;
+      put(body, region.id);
+      put(body, offset);
+      put(body, size);
+      body.insert(body.end(), region.data + offset,
+                  region.data + offset + size);
+      range_num++;
+    }
+    idx += block_num;
+  }
+  memcpy(body.data() + sizeof(MAGIC) + sizeof(VERSION), &range_num,
+         sizeof(range_num));
+
+  // other processes may read the folder, publish the entry by rename
+  auto path = SimCfg::Instance().get_sim_cache_path();
+  auto fname = path + "/" + name;
+  auto tmp_name = fname + ".tmp" + std::to_string(getpid());
+  std::ofstream f(tmp_name, std::ios::binary | std::ios::trunc);
+  f.write(body.data(), body.size());
+  f.close();
+  if (!f || rename(tmp_name.c_str(), fname.c_str()) != 0) {
+    UNI_LOG_WARNING << "sim cache: failed to write " << fname;
+    unlink(tmp_name.c_str());
+    return;
+  }
+
+  if (entries_.count(name)) total_size_ -= entries_.at(name).size;
+  entries_[name] = Entry{body.size(), std::time(nullptr)};
+  total_size_ += body.size();
+  stats_.stored_size += body.size();
+
+  // the folder is shared, rescan it now and then to see others' entries
+  const uint64_t RESCAN_INTERVAL = 64;
+  auto capacity = static_cast<uint64_t>(SimCfg::Instance().get_sim_cache_size())
+                  << 20;
+  if (total_size_ > capacity || ++store_num_ % RESCAN_INTERVAL == 0) {
+    scan_folder();
+    evict();
+  }
+}
+
+void SimCache::scan_folder() {
+  auto path = SimCfg::Instance().get_sim_cache_path();
+  Util::ChkFolder(path, false);
+
+  entries_.clear();
+  total_size_ = 0;
+  auto dir = opendir(path.c_str());
+  UNI_LOG_CHECK(dir != nullptr, SIM_FILE_OPEN_FAILED)
+      << "sim cache: opendir error: " << path;
+  while (auto item = readdir(dir)) {
+    std::string name = item->d_name;
+    if (name.size() <= SUFFIX.size() ||
+        name.compare(name.size() - SUFFIX.size(), SUFFIX.size(), SUFFIX) != 0)
+      continue;
+    struct stat buf;
+    if (stat((path + "/" + name).c_str(), &buf) != 0) continue;
+    entries_[name] = Entry{static_cast<uint64_t>(buf.st_size),
+                           static_cast<int64_t>(buf.st_mtime)};
+    total_size_ += buf.st_size;
+  }
+  closedir(dir);
+  scanned_ = true;
+}
+
+void SimCache::evict() {
+  auto capacity = static_cast<uint64_t>(SimCfg::Instance().get_sim_cache_size())
+                  << 20;
+  if (total_size_ <= capacity) return;
+
+  std::vector<std::pair<int64_t, std::string>> lru;
+  for (auto& item : entries_) lru.emplace_back(item.second.mtime, item.first);
+  std::sort(lru.begin(), lru.end());
+
+  auto path = SimCfg::Instance().get_sim_cache_path();
+  for (auto& item : lru) {
+    if (total_size_ <= capacity) break;
+    unlink((path + "/" + item.second).c_str());
+    total_size_ -= entries_.at(item.second).size;
+    entries_.erase(item.second);
+    stats_.evicted++;
+  }
+}
+
+}  // namespace sim
+}  // namespace vart
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vart {
+namespace sim {
+
+/**
+ * @brief cross-run cache of simulated superlayers
+ * @details the machine state is the content of all ddr regs and banks, it is
+ * cut into blocks of BLOCK_SIZE bytes and hashed before a superlayer runs.
+ * the key of the superlayer is the hash of the arch config, its instructions
+ * and the block hashes. after a miss the blocks changed by the superlayer are
+ * stored under the key, a later hit writes them back instead of simulating.
+ * when every superlayer of a run hits, the output regs are restored without
+ * simulating anything, otherwise simulation resumes at the first miss.
+ *
+ * entries are files in a local folder which may be shared by several
+ * processes, the least recently used ones are removed when the folder grows
+ * over its size cap. the cache is off while debugging, since a hit skips the
+ * superlayer's dumps.
+ */
+class SimCache {
+ public:
+  static SimCache& Instance() {
+    static SimCache cache;
+    return cache;
+  }
+
+  bool is_enabled() const;
+
+  // returns true if the superlayer was restored from the cache, otherwise
+  // the caller simulates it and calls end_layer()
+  bool begin_layer(const std::vector<std::string>& ac_code);
+  void end_layer();
+
+  struct Stats {
+    uint64_t hit;
+    uint64_t miss;
+    uint64_t restored_size;
+    uint64_t stored_size;
+    uint64_t evicted;
+  };
+  Stats get_stats() const { return stats_; }
+  void log_stats() const;
+
+ public:
+  const static uint32_t BLOCK_SIZE = 4096;
+  // bank contents are hashed as one region with this id
+  const static int32_t BANK_REGION_ID = -1;
+
+ private:
+  SimCache() = default;
+  SimCache(const SimCache&) = delete;
+  SimCache& operator=(const SimCache&) = delete;
+
+  struct Region {
+    int32_t id;
+    char* data;
+    uint64_t size;
+  };
+  struct Entry {
+    uint64_t size;
+    int64_t mtime;
+  };
+
+  void read_state(std::vector<uint64_t>& hashes);
+  void write_banks();
+  std::string get_key(const std::vector<std::string>& ac_code,
+                     const std::vector<uint64_t>& hashes) const;
+  bool load(const std::string& name);
+  void store(const std::string& name, const std::vector<uint64_t>& before,
+             const std::vector<uint64_t>& after);
+  void scan_folder();
+  void evict();
+
+ private:
+  std::vector<Region> regions_;
+  std::vector<char> bank_image_;
+  std::vector<uint64_t> hashes_;
+  std::string key_;
+
+  bool scanned_{false};
+  std::unordered_map<std::string, Entry> entries_;
+  uint64_t total_size_{0};
+  uint64_t store_num_{0};
+  Stats stats_{0, 0, 0, 0, 0};
+};
+
+}  // namespace sim
+}  // namespace vart
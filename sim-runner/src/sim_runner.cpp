@@ -21,6 +21,8 @@
 #include "inst/pub/Layer.hpp"
 #include "inst/pub/ReadInst.hpp"
 #include "inst/xv2dpu/simUtil.hpp"
+#include "sim_cache.hpp"
+#include "util/DumpArchive.hpp"
 #include "vart/mm/host_flat_tensor_buffer.hpp"
 
 #include <cstring>
@@ -31,6 +33,17 @@
 namespace vart {
 namespace sim {
 
+// ddr and bank dumps go into one archive when dump_archive is set, the debug
+// folder has to exist before
+static void open_dump_archive() {
+  if (SimCfg::Instance().get_debug_enable() &&
+      SimCfg::Instance().get_dump_archive()) {
+    DumpArchive::Instance().Open(
+        SimCfg::Instance().get_debug_path() + "/dump_archive.bin",
+        SimCfg::Instance().get_dump_archive_compress());
+  }
+}
+
 SimRunner::SimRunner(const xir::Subgraph* subgraph)
     : Runner(), subgraph_(subgraph), layer_id_(0), batch_idx_(0) {
   UNI_LOG_CHECK(subgraph_->get_attr<std::string>("device") == "DPU",
@@ -51,6 +64,7 @@ SimRunner::SimRunner(const xir::Subgraph* subgraph)
   if (SimCfg::Instance().get_debug_enable()) {
     Util::ChkFolder(SimCfg::Instance().get_debug_path(), false);
   }
+  open_dump_archive();
 
   // initial weight/bias in ddr
   SimCfg::Instance().set_ddr_dump_end_fast(0x00);
@@ -72,6 +86,7 @@ SimRunner::SimRunner() : layer_id_(0), batch_idx_(0) {
   if (SimCfg::Instance().get_debug_enable()) {
     Util::ChkFolder(SimCfg::Instance().get_debug_path(), true);
   }
+  open_dump_archive();
   // set ISA version
   auto isa_version = ArchCfg::Instance().get_param().type();
   ArchCfg::Instance().init_white_lists();
@@ -110,6 +125,7 @@ void SimRunner::run_ac(const string& inst_file) {
                               SimCfg::Instance().get_ddr_dump_format());
     }
   }
+  DumpArchive::Instance().Flush();
 }
 
 vector<string> SimRunner::get_ac(const string& inst_file) {
@@ -489,6 +505,8 @@ void SimRunner::run() {
                            "batch_" + std::to_string(batch_idx_) + "_ddr_end";
     DDR::Instance().SaveDDR(ddr_file, SimCfg::Instance().get_ddr_dump_format());
   }
+  DumpArchive::Instance().Flush();
+  if (SimCache::Instance().is_enabled()) SimCache::Instance().log_stats();
 
   layer_id_ = 0;
 }
@@ -689,9 +707,16 @@ void SimRunner::run_superlayer(const xir::Subgraph* super) {
                             (batch_idx_ != 0));
   }
 
+  // the cache is off while debugging, nothing below has to be dumped
+  auto& cache = SimCache::Instance();
+  if (cache.is_enabled() && cache.begin_layer(ac_code)) {
+    layer_id_++;
+    return;
+  }
   Layer layer(0, layer_id_++, layer_dbg_path, ac_code);
   layer.set_layer_debug(is_layer_debug);
   layer.Run();
+  if (cache.is_enabled()) cache.end_layer();
 
   // dump output nodes' tensor
   if (SimCfg::Instance().get_debug_enable() &&
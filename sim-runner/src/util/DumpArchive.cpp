@@ -0,0 +1,511 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "DumpArchive.hpp"
+
+#include <set>
+
+// archive layout, integers are in host byte order:
+//   header : MAGIC, uint32 version
+//   block  : 'B', uint32 raw size, uint32 stored size, uint8 codec, payload
+//   record : 'R', Record, uint32 name size, name, uint64 block num, block ids
+// block ids count the blocks in file order, a record only refers to blocks
+// written before it.
+namespace {
+
+const char MAGIC[8] = {'D', 'P', 'U', 'D', 'U', 'M', 'P', '\0'};
+const uint32_t VERSION = 1;
+const char TAG_BLOCK = 'B';
+const char TAG_RECORD = 'R';
+
+enum Codec : uint8_t {
+  CODEC_RAW = 0,
+  CODEC_LZ = 1,
+};
+
+// byte oriented lz77 in the spirit of the lz4 block format: every sequence is
+// a token (high nibble literal length, low nibble match length - 4), literals,
+// a 16-bit offset and extra length bytes when a nibble is 15. the last sequence
+// only has literals.
+const int LZ_MIN_MATCH = 4;
+const int LZ_HASH_BITS = 16;
+const uint32_t LZ_MAX_OFFSET = 65535;
+
+void LzPutLength(vector<char>& out, uint64_t len) {
+  for (; len >= 255; len -= 255) out.push_back(static_cast<char>(255));
+  out.push_back(static_cast<char>(len));
+}
+
+void LzPutSequence(vector<char>& out, const char* literal, uint64_t lit_len,
+                   uint64_t match_len, uint32_t offset) {
+  auto lit_nibble = std::min<uint64_t>(lit_len, 15);
+  auto match_nibble =
+      match_len ? std::min<uint64_t>(match_len - LZ_MIN_MATCH, 15) : 0;
+  out.push_back(static_cast<char>((lit_nibble << 4) | match_nibble));
+  if (lit_nibble == 15) LzPutLength(out, lit_len - 15);
+  out.insert(out.end(), literal, literal + lit_len);
+  if (match_len == 0) return;
+  out.push_back(static_cast<char>(offset & 0xff));
+  out.push_back(static_cast<char>(offset >> 8));
+  if (match_nibble == 15) LzPutLength(out, match_len - LZ_MIN_MATCH - 15);
+}
+
+void LzCompress(const char* src, uint64_t size, vector<char>& out) {
+  out.clear();
+  out.reserve(size + size / 255 + 16);
+  vector<int64_t> table(1 << LZ_HASH_BITS, -1);
+  uint64_t anchor = 0;
+  uint64_t pos = 0;
+  while (pos + LZ_MIN_MATCH <= size) {
+    uint32_t seq;
+    memcpy(&seq, src + pos, sizeof(seq));
+    auto h = (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+    auto cand = table[h];
+    table[h] = pos;
+    if (cand < 0 || pos - cand > LZ_MAX_OFFSET ||
+        memcmp(src + cand, src + pos, LZ_MIN_MATCH) != 0) {
+      pos++;
+      continue;
+    }
+    uint64_t len = LZ_MIN_MATCH;
+    while (pos + len < size && src[cand + len] == src[pos + len]) len++;
+    LzPutSequence(out, src + anchor, pos - anchor, len,
+                  static_cast<uint32_t>(pos - cand));
+    pos += len;
+    anchor = pos;
+  }
+  LzPutSequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+bool LzGetLength(const char*& ip, const char* end, uint64_t& len) {
+  uint8_t b;
+  do {
+    if (ip == end) return false;
+    b = static_cast<uint8_t>(*ip++);
+    len += b;
+  } while (b == 255);
+  return true;
+}
+
+bool LzDecompress(const char* src, uint64_t size, char* dst, uint64_t raw_size) {
+  auto ip = src;
+  auto end = src + size;
+  uint64_t op = 0;
+  while (ip < end) {
+    auto token = static_cast<uint8_t>(*ip++);
+    uint64_t lit_len = token >> 4;
+    if (lit_len == 15 && !LzGetLength(ip, end, lit_len)) return false;
+    if (lit_len > static_cast<uint64_t>(end - ip) || lit_len > raw_size - op)
+      return false;
+    memcpy(dst + op, ip, lit_len);
+    ip += lit_len;
+    op += lit_len;
+    if (ip == end) break;
+
+    if (end - ip < 2) return false;
+    uint32_t offset = static_cast<uint8_t>(ip[0]) |
+                      (static_cast<uint32_t>(static_cast<uint8_t>(ip[1])) << 8);
+    ip += 2;
+    uint64_t match_len = token & 0xf;
+    if (match_len == 15 && !LzGetLength(ip, end, match_len)) return false;
+    match_len += LZ_MIN_MATCH;
+    if (offset == 0 || offset > op || match_len > raw_size - op) return false;
+    // matches may overlap their own output, copy byte by byte
+    for (uint64_t i = 0; i < match_len; i++, op++) dst[op] = dst[op - offset];
+  }
+  return op == raw_size;
+}
+
+template <typename T>
+void Put(vector<char>& out, const T& val) {
+  auto p = reinterpret_cast<const char*>(&val);
+  out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+bool Get(ifstream& f, T& val) {
+  return static_cast<bool>(f.read(reinterpret_cast<char*>(&val), sizeof(T)));
+}
+
+void MakeParentFolders(const string& fname) {
+  for (auto pos = fname.find('/', 1); pos != string::npos;
+       pos = fname.find('/', pos + 1)) {
+    auto folder = fname.substr(0, pos);
+    if (access(folder.c_str(), F_OK) != 0) Util::ChkFolder(folder);
+  }
+}
+
+}  // namespace
+
+DumpArchive& DumpArchive::Instance() {
+  static DumpArchive archive;
+  return archive;
+}
+
+DumpArchive::~DumpArchive() { Close(); }
+
+void DumpArchive::Open(const string& archive_name, bool compress) {
+  // the debug folder may have been recreated since the last Open
+  if (open_ && archive_name == archive_name_ &&
+      access(archive_name.c_str(), F_OK) == 0)
+    return;
+  Close();
+
+  f_.open(archive_name, std::ios::trunc | std::ios::binary | std::ios::out);
+  Util::ChkOpen(f_, archive_name);
+  f_.write(MAGIC, sizeof(MAGIC));
+  f_.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+
+  archive_name_ = archive_name;
+  auto pos = archive_name.find_last_of('/');
+  root_ = (pos == string::npos) ? "" : archive_name.substr(0, pos + 1);
+  compress_ = compress;
+  blocks_.clear();
+  block_num_ = 0;
+  stop_ = false;
+  writer_ = std::thread([this]() { WriterLoop(); });
+  open_ = true;
+}
+
+void DumpArchive::Flush() {
+  if (!open_) return;
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_.wait(lock, [this]() { return jobs_.empty() && !busy_; });
+  f_.flush();
+}
+
+void DumpArchive::Close() {
+  if (!open_) return;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  writer_.join();
+  f_.close();
+  blocks_.clear();
+  open_ = false;
+}
+
+void DumpArchive::Add(const string& save_name, Record rec, const char* data) {
+  auto name = save_name;
+  auto pos = string::npos;
+  if (!root_.empty() && name.compare(0, root_.size(), root_) == 0)
+    pos = name.find_first_not_of('/', root_.size());
+  rec.relative = (pos != string::npos);
+  if (rec.relative) name = name.substr(pos);
+
+  vector<char> record;
+  record.push_back(TAG_RECORD);
+  Put(record, rec);
+  Put(record, static_cast<uint32_t>(name.size()));
+  record.insert(record.end(), name.begin(), name.end());
+  uint64_t block_num = (rec.size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  Put(record, block_num);
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  for (uint64_t i = 0; i < block_num; i++) {
+    auto offset = i * BLOCK_SIZE;
+    auto size = std::min<uint64_t>(BLOCK_SIZE, rec.size - offset);
+    auto block = data + offset;
+
+    // two independent 64-bit hashes, a false match needs both to collide
+    BlockKey key{Util::HashBytes(block, size),
+                 Util::HashBytes(block, size, 0x2545f4914f6cdd1dULL), size};
+
+    auto it = blocks_.find(key);
+    if (it == blocks_.end()) {
+      it = blocks_.emplace(key, block_num_++).first;
+      cv_.wait(lock, [this]() { return pending_size_ < MAX_PENDING_SIZE; });
+      jobs_.push_back(Job{true, vector<char>(block, block + size)});
+      pending_size_ += size;
+      cv_.notify_all();
+    }
+    Put(record, it->second);
+  }
+  jobs_.push_back(Job{false, std::move(record)});
+  cv_.notify_all();
+}
+
+void DumpArchive::WriterLoop() {
+  vector<char> compressed;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+      if (jobs_.empty()) return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+      busy_ = true;
+    }
+
+    if (job.is_block) {
+      auto raw_size = static_cast<uint32_t>(job.bytes.size());
+      const char* payload = job.bytes.data();
+      uint32_t stored_size = raw_size;
+      uint8_t codec = CODEC_RAW;
+      if (compress_) {
+        LzCompress(job.bytes.data(), raw_size, compressed);
+        if (compressed.size() < raw_size) {
+          payload = compressed.data();
+          stored_size = compressed.size();
+          codec = CODEC_LZ;
+        }
+      }
+      f_.put(TAG_BLOCK);
+      f_.write(reinterpret_cast<const char*>(&raw_size), sizeof(raw_size));
+      f_.write(reinterpret_cast<const char*>(&stored_size), sizeof(stored_size));
+      f_.write(reinterpret_cast<const char*>(&codec), sizeof(codec));
+      f_.write(payload, stored_size);
+    } else {
+      f_.write(job.bytes.data(), job.bytes.size());
+    }
+    UNI_LOG_CHECK(f_.good(), SIM_FILE_OPEN_FAILED)
+        << "write dump archive failed: " << archive_name_;
+
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (job.is_block) pending_size_ -= job.bytes.size();
+      busy_ = false;
+    }
+    cv_.notify_all();
+  }
+}
+
+void DumpArchive::SaveHexContSmallEndBankAddr(const string& save_name,
+                                              const char* data, uint64_t size,
+                                              int line_size, int bank_height,
+                                              int bank_id, int bank_addr,
+                                              int mode) {
+  auto& archive = Instance();
+  if (!archive.IsOpen()) {
+    Util::SaveHexContSmallEndBankAddr(save_name, data, size, line_size,
+                                      bank_height, bank_id, bank_addr, mode);
+    return;
+  }
+  Record rec{};
+  rec.size = size;
+  rec.fmt = DATA_FMT_HEX_CONT_SMALLEND_BANKADDR;
+  rec.mode = mode;
+  rec.line_size = line_size;
+  rec.bank_height = bank_height;
+  rec.bank_id = bank_id;
+  rec.bank_addr = bank_addr;
+  archive.Add(save_name, rec, data);
+}
+
+void DumpArchive::SaveHexContBigEndBankAddr(const string& save_name,
+                                            const char* data, uint64_t size,
+                                            int line_size, int bank_height,
+                                            int bank_id, int bank_addr,
+                                            int mode) {
+  auto& archive = Instance();
+  if (!archive.IsOpen()) {
+    Util::SaveHexContBigEndBankAddr(save_name, data, size, line_size,
+                                    bank_height, bank_id, bank_addr, mode);
+    return;
+  }
+  Record rec{};
+  rec.size = size;
+  rec.fmt = DATA_FMT_HEX_CONT_BIGEND_BANKADDR;
+  rec.mode = mode;
+  rec.line_size = line_size;
+  rec.bank_height = bank_height;
+  rec.bank_id = bank_id;
+  rec.bank_addr = bank_addr;
+  archive.Add(save_name, rec, data);
+}
+
+void DumpArchive::SaveHexContSmallEndDDRAddr(const string& save_name,
+                                             const char* data, uint64_t size,
+                                             int line_size,
+                                             uint64_t addr_offset, int reg_id,
+                                             int mode) {
+  auto& archive = Instance();
+  if (!archive.IsOpen()) {
+    Util::SaveHexContSmallEndDDRAddr(save_name, data, size, line_size,
+                                     addr_offset, reg_id, mode);
+    return;
+  }
+  Record rec{};
+  rec.size = size;
+  rec.addr_offset = addr_offset;
+  rec.fmt = DATA_FMT_HEX_CONT_SMALLEND_DDRADDR;
+  rec.mode = mode;
+  rec.line_size = line_size;
+  rec.reg_id = reg_id;
+  archive.Add(save_name, rec, data);
+}
+
+void DumpArchive::SaveHexContBigEndDDRAddr(const string& save_name,
+                                           const char* data, uint64_t size,
+                                           int line_size, uint64_t addr_offset,
+                                           int reg_id, int mode) {
+  auto& archive = Instance();
+  if (!archive.IsOpen()) {
+    Util::SaveHexContBigEndDDRAddr(save_name, data, size, line_size,
+                                   addr_offset, reg_id, mode);
+    return;
+  }
+  Record rec{};
+  rec.size = size;
+  rec.addr_offset = addr_offset;
+  rec.fmt = DATA_FMT_HEX_CONT_BIGEND_DDRADDR;
+  rec.mode = mode;
+  rec.line_size = line_size;
+  rec.reg_id = reg_id;
+  archive.Add(save_name, rec, data);
+}
+
+void DumpArchive::RestoreRecord(const string& save_name, const Record& rec,
+                                const char* data, int mode) {
+  switch (rec.fmt) {
+    case DATA_FMT_HEX_CONT_SMALLEND_BANKADDR:
+      Util::SaveHexContSmallEndBankAddr(save_name, data, rec.size,
+                                        rec.line_size, rec.bank_height,
+                                        rec.bank_id, rec.bank_addr, mode);
+      return;
+    case DATA_FMT_HEX_CONT_BIGEND_BANKADDR:
+      Util::SaveHexContBigEndBankAddr(save_name, data, rec.size, rec.line_size,
+                                      rec.bank_height, rec.bank_id,
+                                      rec.bank_addr, mode);
+      return;
+    case DATA_FMT_HEX_CONT_SMALLEND_DDRADDR:
+      Util::SaveHexContSmallEndDDRAddr(save_name, data, rec.size,
+                                       rec.line_size, rec.addr_offset,
+                                       rec.reg_id, mode);
+      return;
+    case DATA_FMT_HEX_CONT_BIGEND_DDRADDR:
+      Util::SaveHexContBigEndDDRAddr(save_name, data, rec.size, rec.line_size,
+                                     rec.addr_offset, rec.reg_id, mode);
+      return;
+    default:
+      break;
+  }
+
+#define RESTORE_SAVE_DATA(T)                                              \
+  case DtypeCode<T>():                                                    \
+    Util::SaveData(rec.fmt, save_name, reinterpret_cast<const T*>(data),  \
+                   rec.size / sizeof(T), rec.line_size, mode);            \
+    return;
+
+  switch (rec.dtype) {
+    RESTORE_SAVE_DATA(int8_t)
+    RESTORE_SAVE_DATA(uint8_t)
+    RESTORE_SAVE_DATA(int16_t)
+    RESTORE_SAVE_DATA(uint16_t)
+    RESTORE_SAVE_DATA(int32_t)
+    RESTORE_SAVE_DATA(uint32_t)
+    RESTORE_SAVE_DATA(int64_t)
+    RESTORE_SAVE_DATA(uint64_t)
+    RESTORE_SAVE_DATA(float)
+    RESTORE_SAVE_DATA(double)
+    default:
+      UNI_LOG_FATAL(SIM_OUT_OF_RANGE)
+          << "Not support dump data type: " << rec.dtype << endl;
+  }
+#undef RESTORE_SAVE_DATA
+}
+
+uint64_t DumpArchive::Restore(const string& archive_name,
+                              const string& out_dir) {
+  ifstream f(archive_name, std::ios::binary);
+  Util::ChkOpen(f, archive_name);
+
+  char magic[sizeof(MAGIC)];
+  uint32_t version = 0;
+  f.read(magic, sizeof(magic));
+  UNI_LOG_CHECK(Get(f, version) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                    version == VERSION,
+                SIM_PARAMETER_FAILED)
+      << "not a dump archive: " << archive_name;
+
+  vector<std::streamoff> block_pos;
+  std::set<string> restored;
+  vector<char> stored;
+  vector<char> data;
+  uint64_t record_num = 0;
+  char tag;
+  while (f.get(tag)) {
+    if (tag == TAG_BLOCK) {
+      block_pos.push_back(f.tellg());
+      uint32_t raw_size, stored_size;
+      uint8_t codec;
+      UNI_LOG_CHECK(Get(f, raw_size) && Get(f, stored_size) && Get(f, codec),
+                    SIM_PARAMETER_FAILED)
+          << "truncated dump archive: " << archive_name;
+      f.seekg(stored_size, std::ios::cur);
+      continue;
+    }
+    UNI_LOG_CHECK(tag == TAG_RECORD, SIM_PARAMETER_FAILED)
+        << "corrupted dump archive: " << archive_name;
+
+    Record rec;
+    uint32_t name_size = 0;
+    uint64_t block_num = 0;
+    UNI_LOG_CHECK(Get(f, rec) && Get(f, name_size), SIM_PARAMETER_FAILED)
+        << "truncated dump archive: " << archive_name;
+    string name(name_size, '\0');
+    f.read(&name[0], name_size);
+    UNI_LOG_CHECK(Get(f, block_num), SIM_PARAMETER_FAILED)
+        << "truncated dump archive: " << archive_name;
+    vector<uint64_t> ids(block_num);
+    f.read(reinterpret_cast<char*>(ids.data()), block_num * sizeof(uint64_t));
+    UNI_LOG_CHECK(f.good(), SIM_PARAMETER_FAILED)
+        << "truncated dump archive: " << archive_name;
+    auto next = f.tellg();
+
+    // gather the record's blocks
+    data.resize(rec.size);
+    uint64_t offset = 0;
+    for (auto id : ids) {
+      UNI_LOG_CHECK(id < block_pos.size(), SIM_PARAMETER_FAILED)
+          << "corrupted dump archive: " << archive_name;
+      uint32_t raw_size, stored_size;
+      uint8_t codec;
+      f.seekg(block_pos[id]);
+      Get(f, raw_size);
+      Get(f, stored_size);
+      Get(f, codec);
+      UNI_LOG_CHECK(offset + raw_size <= rec.size, SIM_PARAMETER_FAILED)
+          << "corrupted dump archive: " << archive_name;
+      if (codec == CODEC_RAW) {
+        f.read(data.data() + offset, raw_size);
+      } else {
+        stored.resize(stored_size);
+        f.read(stored.data(), stored_size);
+        UNI_LOG_CHECK(LzDecompress(stored.data(), stored_size,
+                                   data.data() + offset, raw_size),
+                      SIM_PARAMETER_FAILED)
+            << "corrupted dump archive: " << archive_name;
+      }
+      offset += raw_size;
+    }
+    UNI_LOG_CHECK(f.good() && offset == rec.size, SIM_PARAMETER_FAILED)
+        << "corrupted dump archive: " << archive_name;
+    f.seekg(next);
+
+    // dumps are written into fresh files during simulation, so the first
+    // record of a file truncates it
+    if (rec.relative) name = out_dir + "/" + name;
+    auto mode = restored.insert(name).second ? SM_TRUNC : rec.mode;
+    MakeParentFolders(name);
+    RestoreRecord(name, rec, data.data(), mode);
+    record_num++;
+  }
+  return record_num;
+}
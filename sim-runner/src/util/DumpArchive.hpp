@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __DUMP_ARCHIVE_HPP__
+#define __DUMP_ARCHIVE_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <type_traits>
+
+#include "Util.hpp"
+
+// DumpArchive collects ddr and bank dumps into one binary file instead of
+// formatting every dump as text while simulating.
+//
+// a dump is cut into blocks of BLOCK_SIZE bytes, a block whose content is
+// already in the archive is referenced by its id instead of being written
+// again, so dumping an unchanged ddr region costs only a hash. new blocks are
+// compressed and written by a background thread. the legacy dump files are
+// rebuilt from the archive by Restore(), see test/dump_archive_reader.cpp.
+//
+// the Save* functions take the same parameters as their Util:: counterparts
+// and fall through to them when no archive is open.
+class DumpArchive {
+ public:
+  static DumpArchive& Instance();
+  ~DumpArchive();
+  DumpArchive(const DumpArchive&) = delete;
+  DumpArchive& operator=(const DumpArchive&) = delete;
+
+ public:
+  // dump file names under the archive's folder are recorded relative to it
+  void Open(const string& archive_name, bool compress = true);
+  // block until every queued dump is written
+  void Flush();
+  void Close();
+  bool IsOpen() const { return open_; }
+
+  template <typename T>
+  static void SaveData(int data_fmt, const string& save_name, const T* data,
+                       uint64_t size, int line_size = 16, int mode = SM_TRUNC);
+  static void SaveHexContSmallEndBankAddr(const string& save_name,
+                                          const char* data, uint64_t size,
+                                          int line_size = 16,
+                                          int bank_height = 2048,
+                                          int bank_id = 0, int bank_addr = 0,
+                                          int mode = SM_TRUNC);
+  static void SaveHexContBigEndBankAddr(const string& save_name,
+                                        const char* data, uint64_t size,
+                                        int line_size = 16,
+                                        int bank_height = 2048, int bank_id = 0,
+                                        int bank_addr = 0, int mode = SM_TRUNC);
+  static void SaveHexContSmallEndDDRAddr(const string& save_name,
+                                         const char* data, uint64_t size,
+                                         int line_size = 16,
+                                         uint64_t addr_offset = 0,
+                                         int reg_id = 0, int mode = SM_TRUNC);
+  static void SaveHexContBigEndDDRAddr(const string& save_name,
+                                       const char* data, uint64_t size,
+                                       int line_size = 16,
+                                       uint64_t addr_offset = 0, int reg_id = 0,
+                                       int mode = SM_TRUNC);
+
+  // write the legacy dump files recorded in archive_name, relative names are
+  // placed under out_dir. returns the number of dumps restored.
+  static uint64_t Restore(const string& archive_name, const string& out_dir);
+
+ public:
+  const static uint32_t BLOCK_SIZE = 64 * 1024;
+  // the simulation waits when this many bytes are queued for the writer
+  const static uint64_t MAX_PENDING_SIZE = 256 * 1024 * 1024;
+
+ private:
+  // parameters of one Util::Save* call, written as is into the archive
+  struct Record {
+    uint64_t size;  // in bytes
+    uint64_t addr_offset;
+    int32_t fmt;
+    int32_t mode;
+    int32_t dtype;
+    int32_t line_size;
+    int32_t bank_height;
+    int32_t bank_id;
+    int32_t bank_addr;
+    int32_t reg_id;
+    int32_t relative;
+    int32_t reserved;
+  };
+
+  struct BlockKey {
+    uint64_t h0;
+    uint64_t h1;
+    uint64_t size;
+    bool operator==(const BlockKey& other) const {
+      return h0 == other.h0 && h1 == other.h1 && size == other.size;
+    }
+  };
+  struct BlockKeyHash {
+    size_t operator()(const BlockKey& key) const { return key.h0; }
+  };
+
+  struct Job {
+    bool is_block;
+    vector<char> bytes;
+  };
+
+  template <typename T>
+  constexpr static int32_t DtypeCode() {
+    return (std::is_floating_point<T>::value << 5) |
+           (std::is_signed<T>::value << 4) | static_cast<int32_t>(sizeof(T));
+  }
+
+ private:
+  DumpArchive() = default;
+  void Add(const string& save_name, Record rec, const char* data);
+  void WriterLoop();
+  static void RestoreRecord(const string& save_name, const Record& rec,
+                            const char* data, int mode);
+
+ private:
+  std::atomic<bool> open_{false};
+  string archive_name_;
+  string root_;
+  bool compress_{true};
+  ofstream f_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<Job> jobs_;
+  uint64_t pending_size_{0};
+  bool busy_{false};
+  bool stop_{false};
+  std::thread writer_;
+
+  std::unordered_map<BlockKey, uint64_t, BlockKeyHash> blocks_;
+  uint64_t block_num_{0};
+};
+
+template <typename T>
+void DumpArchive::SaveData(int data_fmt, const string& save_name, const T* data,
+                           uint64_t size, int line_size, int mode) {
+  auto& archive = Instance();
+  if (!archive.IsOpen() || data_fmt > DATA_FMT_HEX_CONT_BIGEND) {
+    Util::SaveData(data_fmt, save_name, data, size, line_size, mode);
+    return;
+  }
+  UNI_LOG_CHECK(data != nullptr && size > 0, SIM_PARAMETER_FAILED);
+
+  Record rec{};
+  rec.size = size * sizeof(T);
+  rec.fmt = data_fmt;
+  rec.mode = mode;
+  rec.dtype = DtypeCode<T>();
+  rec.line_size = line_size;
+  archive.Add(save_name, rec, reinterpret_cast<const char*>(data));
+}
+
+#endif /* __DUMP_ARCHIVE_HPP__ */
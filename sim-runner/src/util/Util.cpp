@@ -855,6 +855,38 @@ string Util::GetFileNameSuffix(int fmt) {
   return suffix;
 }
 
+uint64_t Util::HashBytes(const char* data, uint64_t size, uint64_t seed) {
+  const uint64_t PRIME0 = 0x9e3779b185ebca87ULL;
+  const uint64_t PRIME1 = 0xc2b2ae3d27d4eb4fULL;
+  auto mix = [&](uint64_t h, uint64_t word) {
+    word *= PRIME1;
+    word = (word << 31) | (word >> 33);
+    h ^= word * PRIME0;
+    return ((h << 27) | (h >> 37)) * PRIME0 + PRIME1;
+  };
+
+  uint64_t h = seed ^ (size * PRIME0);
+  uint64_t pos = 0;
+  for (; pos + 8 <= size; pos += 8) {
+    uint64_t word;
+    memcpy(&word, data + pos, sizeof(word));
+    h = mix(h, word);
+  }
+  if (pos < size) {
+    uint64_t word = 0;
+    memcpy(&word, data + pos, size - pos);
+    h = mix(h, word);
+  }
+
+  // final avalanche
+  h ^= h >> 33;
+  h *= PRIME1;
+  h ^= h >> 29;
+  h *= PRIME0;
+  h ^= h >> 32;
+  return h;
+}
+
 string Util::Trim(const string& str) {
   auto tmp = str;
 
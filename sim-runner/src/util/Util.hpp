@@ -145,6 +145,9 @@ uint64_t AlignByN(uint64_t data, uint64_t align);
 
 string GetFileNameSuffix(int fmt);
 
+// 64-bit non-cryptographic hash, used to find unchanged dump/ddr contents
+uint64_t HashBytes(const char* data, uint64_t size, uint64_t seed = 0);
+
 template <typename T, typename... Args>
 std::unique_ptr<T> make_unique(Args&&... args) {
   return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "util/DumpArchive.hpp"
+
+// rebuild the legacy ddr/bank dump files from a dump archive, see
+// dump_archive in config/SIMCfg.txt
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    std::cout << "usage: " << argv[0] << " <dump_archive.bin> [out_dir]\n"
+              << "  out_dir defaults to the archive's folder" << std::endl;
+    return 1;
+  }
+  string archive_name = argv[1];
+  string out_dir = ".";
+  if (argc > 2) {
+    out_dir = argv[2];
+  } else if (archive_name.find_last_of('/') != string::npos) {
+    out_dir = archive_name.substr(0, archive_name.find_last_of('/'));
+  }
+  auto num = DumpArchive::Restore(archive_name, out_dir);
+  std::cout << "restored " << num << " dumps into " << out_dir << std::endl;
+  return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <random>
+
+#include "util/DumpArchive.hpp"
+
+// write the same dumps as text and through a dump archive, the restored files
+// must be identical to the text ones
+static void dump_all(const string& path) {
+  std::mt19937 gen(0);
+  vector<char> ddr(1 << 20, 0);
+  for (auto i = 0U; i < ddr.size() / 2; i++) ddr[i] = gen();
+  vector<int16_t> s16(1000);
+  for (auto i = 0U; i < s16.size(); i++) s16[i] = i * 37 - 5000;
+
+  for (auto fmt = 0; fmt <= DATA_FMT_HEX_CONT_BIGEND; fmt++) {
+    auto line_size = (fmt == DATA_FMT_DEC) ? 1 : 16;
+    auto name = path + "/ddr_" + to_string(fmt);
+    DumpArchive::SaveData(fmt, name, ddr.data(), ddr.size(), line_size,
+                          SM_APPEND);
+    // unchanged content, only referenced by the archive
+    DumpArchive::SaveData(fmt, name, ddr.data(), ddr.size(), line_size,
+                          SM_APPEND);
+    DumpArchive::SaveData(fmt, path + "/s16_" + to_string(fmt), s16.data(),
+                          s16.size(), 8);
+  }
+  ddr[12345] ^= 1;
+  DumpArchive::SaveHexContSmallEndDDRAddr(path + "/ddr_small", ddr.data(),
+                                          ddr.size() - 7, 16, 0x100, 3);
+  DumpArchive::SaveHexContBigEndDDRAddr(path + "/ddr_big", ddr.data(),
+                                        ddr.size(), 16, 0x100, 3);
+  DumpArchive::SaveHexContSmallEndBankAddr(path + "/bank_small", ddr.data(),
+                                           4096, 16, 64, 2, 5, SM_APPEND);
+  DumpArchive::SaveHexContSmallEndBankAddr(path + "/bank_small",
+                                           ddr.data() + 4096, 4096, 16, 64, 3,
+                                           0, SM_APPEND);
+  DumpArchive::SaveHexContBigEndBankAddr(path + "/bank_big", ddr.data(), 4099,
+                                         16, 64, 2, 5);
+}
+
+static bool same_file(const string& a, const string& b) {
+  ifstream fa(a, std::ios::binary);
+  ifstream fb(b, std::ios::binary);
+  if (!fa.is_open() || !fb.is_open()) return false;
+  std::string ca((std::istreambuf_iterator<char>(fa)),
+                 std::istreambuf_iterator<char>());
+  std::string cb((std::istreambuf_iterator<char>(fb)),
+                 std::istreambuf_iterator<char>());
+  return ca == cb;
+}
+
+int main() {
+  Util::ChkFolder("./dump_text", true);
+  Util::ChkFolder("./dump_archive", true);
+  Util::ChkFolder("./dump_restore", true);
+
+  dump_all("./dump_text");
+  DumpArchive::Instance().Open("./dump_archive/dump_archive.bin");
+  dump_all("./dump_archive");
+  DumpArchive::Instance().Close();
+  auto num = DumpArchive::Restore("./dump_archive/dump_archive.bin",
+                                  "./dump_restore");
+
+  auto ok = true;
+  for (auto name : {"ddr_0", "ddr_1", "ddr_2", "ddr_3", "s16_0", "s16_1",
+                    "s16_2", "s16_3", "ddr_small", "ddr_big", "bank_small",
+                    "bank_big"}) {
+    if (!same_file(string("./dump_text/") + name,
+                   string("./dump_restore/") + name)) {
+      std::cout << "mismatch: " << name << std::endl;
+      ok = false;
+    }
+  }
+  std::cout << "restored " << num << " dumps, archive size "
+            << Util::GetFileSize("./dump_archive/dump_archive.bin")
+            << " bytes, " << (ok ? "PASS" : "FAIL") << std::endl;
+  return ok ? 0 : 1;
+}
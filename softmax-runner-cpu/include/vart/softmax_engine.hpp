@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace vitis {
+namespace ai {
+class ThreadPool;
+}  // namespace ai
+}  // namespace vitis
+
+namespace vart {
+
+/// Softmax over int8 fixed-point rows.
+///
+/// For a fixed-point input x with fix_point p, softmax only depends on
+/// (max - x) which is an integer in [0, 255], so exp() is replaced by a
+/// 256-entry table built once per fix_point. Rows are independent and are
+/// split among a worker pool when the tensor is large enough.
+class SoftmaxEngine {
+ public:
+  /// num_of_threads == 0 means std::thread::hardware_concurrency().
+  explicit SoftmaxEngine(int fix_point, size_t num_of_threads = 0u);
+  ~SoftmaxEngine();
+  SoftmaxEngine(const SoftmaxEngine& other) = delete;
+  SoftmaxEngine& operator=(const SoftmaxEngine& other) = delete;
+
+ public:
+  int get_fix_point() const { return fix_point_; }
+
+  /// input and output are [rows, cls], contiguous.
+  void run(const int8_t* input, size_t rows, size_t cls, float* output) const;
+
+  /// fused softmax + top-k, output is [rows, k] of (class index, prob),
+  /// sorted by descending probability. k is clamped to cls.
+  void run_topk(const int8_t* input, size_t rows, size_t cls, size_t k,
+                std::pair<int, float>* output) const;
+
+  /// fused softmax + argmax, output is [rows].
+  void run_argmax(const int8_t* input, size_t rows, size_t cls,
+                  std::pair<int, float>* output) const;
+
+ private:
+  template <typename RowFunc>
+  void for_each_row(size_t rows, size_t cls, RowFunc&& func) const;
+  float row_sum(const int8_t* input, size_t cls, int8_t max) const;
+
+ private:
+  const int fix_point_;
+  // exp_table_[d] = exp(-d * 2^-fix_point), d = max - x
+  std::array<float, 256> exp_table_;
+  std::unique_ptr<vitis::ai::ThreadPool> pool_;
+  size_t num_of_threads_;
+};
+
+}  // namespace vart
@@ -16,8 +16,10 @@
  */
 
 #include <memory>
+#include <mutex>
 
 #include "vart/runner_ext.hpp"
+#include "vart/softmax_engine.hpp"
 #include "vart/tensor_buffer.hpp"
 #include "xir/sfm_controller.hpp"
 
@@ -39,8 +41,19 @@ class SoftmaxRunnerCPU : public vart::RunnerExt {
   virtual std::vector<vart::TensorBuffer*> get_inputs() override;
   virtual std::vector<vart::TensorBuffer*> get_outputs() override;
 
+ public:
+  /// fused softmax + top-k for classification heads. returns
+  /// [batch * rows * k] pairs of (class index, prob), k == 1 is argmax.
+  std::vector<std::pair<int, float>> topk(vart::TensorBuffer* input,
+                                          size_t k);
+
+ private:
+  std::shared_ptr<SoftmaxEngine> get_engine(int fix_point);
+
  private:
   std::unique_ptr<vart::TensorBuffer> input_;
   std::unique_ptr<vart::TensorBuffer> output_;
+  std::mutex mtx_;
+  std::shared_ptr<SoftmaxEngine> engine_;
 };
 }  // namespace vart
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace vitis {
+namespace ai {
+class ThreadPool;
+}  // namespace ai
+}  // namespace vitis
+
+namespace vart {
+class TensorBuffer;
+
+/// SSD post-processing on int8 fixed-point DPU outputs.
+///
+/// loc is [num_priors, 4] and conf is [num_priors, num_classes], both
+/// contiguous, class 0 is the background. Boxes are CENTER_SIZE coded with
+/// the variances in the prior boxes, as caffe SSD and the dpu-runner samples.
+///
+/// Prior boxes only depend on ssd_param_t, so they are generated once and
+/// shared by all engines of the same model. Class scores are computed with
+/// a 256-entry exp table as SoftmaxEngine, boxes are decoded only for the
+/// candidates which pass the confidence threshold, and NMS is run per class
+/// with the classes split among a worker pool.
+class SsdEngine {
+ public:
+  struct prior_box_param_t {
+    int layer_width;
+    int layer_height;
+    std::vector<float> min_sizes;
+    std::vector<float> max_sizes;
+    std::vector<float> aspect_ratios;
+    float offset = 0.5f;
+    /// 0 means image size / layer size.
+    float step_width = 0.0f;
+    float step_height = 0.0f;
+    bool flip = true;
+    bool clip = false;
+  };
+
+  struct ssd_param_t {
+    int image_width;
+    int image_height;
+    std::array<float, 4> variances = {0.1f, 0.1f, 0.2f, 0.2f};
+    /// one entry per mbox layer, in the order of the loc/conf outputs.
+    std::vector<prior_box_param_t> prior_boxes;
+    int num_classes;
+    /// one entry per class, conf_threshold[0] is ignored.
+    std::vector<float> conf_threshold;
+    unsigned int nms_top_k = 400u;
+    unsigned int keep_top_k = 200u;
+    float nms_threshold = 0.45f;
+    float eta = 1.0f;
+  };
+
+  /// coordinates are normalized to [0, 1].
+  struct bbox_t {
+    int label;
+    float score;
+    float x_min;
+    float y_min;
+    float x_max;
+    float y_max;
+  };
+
+  /// num_of_threads == 0 means std::thread::hardware_concurrency().
+  explicit SsdEngine(const ssd_param_t& param, int loc_fix_point,
+                     int conf_fix_point, size_t num_of_threads = 0u);
+  ~SsdEngine();
+  SsdEngine(const SsdEngine& other) = delete;
+  SsdEngine& operator=(const SsdEngine& other) = delete;
+
+ public:
+  size_t get_num_of_priors() const;
+
+  /// detections sorted by label, then by descending score.
+  std::vector<bbox_t> run(const int8_t* loc, const int8_t* conf) const;
+
+  /// same as above, reads the batch_idx-th frame of the output tensor
+  /// buffers in place. The buffers must be host accessible.
+  std::vector<bbox_t> run(vart::TensorBuffer* loc, vart::TensorBuffer* conf,
+                          size_t batch_idx) const;
+
+ private:
+  // xmin, ymin, xmax, ymax, center_x, center_y, width, height
+  using prior_t = std::array<float, 8>;
+  struct priors_t;
+  // xmin, ymin, xmax, ymax, area
+  using box_t = std::array<float, 5>;
+
+  template <typename TaskFunc>
+  void for_each_task(size_t num_of_tasks, TaskFunc&& func) const;
+  box_t decode(const int8_t* loc, int idx) const;
+  void nms(const int8_t* loc, std::vector<std::pair<float, int>>* candidates,
+           std::vector<std::pair<float, int>>* kept) const;
+
+ private:
+  const ssd_param_t param_;
+  std::shared_ptr<const priors_t> priors_;
+  float loc_scale_;
+  // conf_exp_table_[d] = exp(-d * 2^-conf_fix_point), d = max - x
+  std::array<float, 256> conf_exp_table_;
+  // size_exp_table_[i][x + 128] = exp(variances[2 + i] * x * loc_scale)
+  std::array<std::array<float, 256>, 2> size_exp_table_;
+  float min_conf_threshold_;
+  std::unique_ptr<vitis::ai::ThreadPool> pool_;
+  size_t num_of_threads_;
+};
+
+}  // namespace vart
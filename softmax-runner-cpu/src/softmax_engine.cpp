@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/softmax_engine.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/thread_pool.hpp"
+
+DEF_ENV_PARAM(DEBUG_SOFTMAX_ENGINE, "0")
+// below this number of elements, rows are computed by the calling thread.
+DEF_ENV_PARAM(XLNX_SOFTMAX_CPU_PARALLEL_THRESHOLD, "16384")
+
+namespace vart {
+
+static int8_t row_max(const int8_t* input, size_t cls) {
+  int8_t max = input[0];
+  for (size_t i = 1; i < cls; ++i) {
+    max = std::max(max, input[i]);
+  }
+  return max;
+}
+
+SoftmaxEngine::SoftmaxEngine(int fix_point, size_t num_of_threads)
+    : fix_point_{fix_point}, exp_table_{}, pool_{}, num_of_threads_{} {
+  auto scale = std::exp2f(-1.0f * (float)fix_point_);
+  for (auto d = 0u; d < exp_table_.size(); ++d) {
+    exp_table_[d] = std::exp(-1.0f * (float)d * scale);
+  }
+  num_of_threads_ = num_of_threads == 0u
+                        ? (size_t)std::thread::hardware_concurrency()
+                        : num_of_threads;
+  num_of_threads_ = std::max(num_of_threads_, (size_t)1u);
+  if (num_of_threads_ > 1u) {
+    // the calling thread takes one share of the rows as well.
+    pool_ = vitis::ai::ThreadPool::create(num_of_threads_ - 1u);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_ENGINE))
+      << "@" << (void*)this << " softmax engine created. fix_point="
+      << fix_point_ << " num_of_threads=" << num_of_threads_;
+}
+
+SoftmaxEngine::~SoftmaxEngine() {}
+
+template <typename RowFunc>
+void SoftmaxEngine::for_each_row(size_t rows, size_t cls,
+                                 RowFunc&& func) const {
+  auto num_of_chunks = std::min(num_of_threads_, rows);
+  if (pool_ == nullptr || num_of_chunks <= 1u ||
+      rows * cls < (size_t)ENV_PARAM(XLNX_SOFTMAX_CPU_PARALLEL_THRESHOLD)) {
+    for (size_t r = 0u; r < rows; ++r) {
+      func(r);
+    }
+    return;
+  }
+  auto rows_per_chunk = (rows + num_of_chunks - 1u) / num_of_chunks;
+  auto do_chunk = [&func, rows, rows_per_chunk](size_t chunk) {
+    auto begin = chunk * rows_per_chunk;
+    auto end = std::min(rows, begin + rows_per_chunk);
+    for (auto r = begin; r < end; ++r) {
+      func(r);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_of_chunks - 1u);
+  for (size_t chunk = 1u; chunk < num_of_chunks; ++chunk) {
+    futures.emplace_back(pool_->async(do_chunk, chunk));
+  }
+  do_chunk(0u);
+  for (auto& f : futures) {
+    f.get();
+  }
+}
+
+float SoftmaxEngine::row_sum(const int8_t* input, size_t cls,
+                             int8_t max) const {
+  float sum = 0.0f;
+  for (size_t i = 0; i < cls; ++i) {
+    sum += exp_table_[(uint8_t)(max - input[i])];
+  }
+  return sum;
+}
+
+void SoftmaxEngine::run(const int8_t* input, size_t rows, size_t cls,
+                        float* output) const {
+  for_each_row(rows, cls, [this, input, cls, output](size_t r) {
+    auto in = input + r * cls;
+    auto out = output + r * cls;
+    auto max = row_max(in, cls);
+    float sum = 0.0f;
+    for (size_t i = 0; i < cls; ++i) {
+      out[i] = exp_table_[(uint8_t)(max - in[i])];
+      sum += out[i];
+    }
+    auto inv_sum = 1.0f / sum;
+    for (size_t i = 0; i < cls; ++i) {
+      out[i] *= inv_sum;
+    }
+  });
+}
+
+void SoftmaxEngine::run_topk(const int8_t* input, size_t rows, size_t cls,
+                             size_t k, std::pair<int, float>* output) const {
+  auto real_k = std::min(k, cls);
+  for_each_row(rows, cls, [this, input, cls, k, real_k, output](size_t r) {
+    auto in = input + r * cls;
+    auto out = output + r * k;
+    auto max = row_max(in, cls);
+    auto inv_sum = 1.0f / row_sum(in, cls, max);
+    // softmax is monotonic, so ranking is done on the raw fixed-point
+    // values; ties are broken by the lower class index.
+    auto greater = [in](const std::pair<int, float>& a,
+                        const std::pair<int, float>& b) {
+      return in[a.first] > in[b.first] ||
+             (in[a.first] == in[b.first] && a.first < b.first);
+    };
+    // k is small for classification heads, keep out[0, n) sorted by
+    // insertion instead of maintaining a heap.
+    size_t n = 0u;
+    for (size_t i = 0; i < cls; ++i) {
+      auto candidate = std::make_pair((int)i, 0.0f);
+      if (n == real_k && !greater(candidate, out[n - 1])) {
+        continue;
+      }
+      auto pos = n < real_k ? n++ : n - 1;
+      for (; pos > 0 && greater(candidate, out[pos - 1]); --pos) {
+        out[pos] = out[pos - 1];
+      }
+      out[pos] = candidate;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      out[i].second =
+          exp_table_[(uint8_t)(max - in[out[i].first])] * inv_sum;
+    }
+    for (size_t i = n; i < k; ++i) {
+      out[i] = std::make_pair(-1, 0.0f);
+    }
+  });
+}
+
+void SoftmaxEngine::run_argmax(const int8_t* input, size_t rows, size_t cls,
+                               std::pair<int, float>* output) const {
+  for_each_row(rows, cls, [this, input, cls, output](size_t r) {
+    auto in = input + r * cls;
+    auto max = row_max(in, cls);
+    auto idx = std::find(in, in + cls, max) - in;
+    // exp_table_[0] == 1.0f
+    output[r] = std::make_pair((int)idx, 1.0f / row_sum(in, cls, max));
+  });
+}
+
+}  // namespace vart
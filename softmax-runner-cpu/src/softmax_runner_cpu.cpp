@@ -24,6 +24,7 @@
 #include "../src/runner_helper.hpp"
 #include "vart/assistant/tensor_buffer_allocator.hpp"
 #include "vart/runner_ext.hpp"
+#include "vart/softmax_engine.hpp"
 #include "vart/tensor_buffer.hpp"
 #include "vitis/ai/env_config.hpp"
 #include "xir/graph/subgraph.hpp"
@@ -32,33 +33,14 @@
 
 DEF_ENV_PARAM(DEBUG_SOFTMAX_RUNNER, "0")
 DEF_ENV_PARAM(DEBUG_TEST, "0");
+DEF_ENV_PARAM(XLNX_SOFTMAX_CPU_NUM_OF_THREADS, "0");
 
-void CPUCalcSoftmax(const int8_t* data, size_t size, float* result,
-                    float scale) {
-  assert(data && result);
-
-  float max = (float)(data[0] * scale);
-
-  std::vector<float> input(size);
-  input[0] = max;
-  for (size_t i = 1; i < size; i++) {
-    input[i] = data[i] * scale;
-    if (input[i] > max) max = input[i];
-  }
-
-  double sum = 0.0f;
-  for (size_t i = 0; i < size; i++) {
-    result[i] = exp(input[i] - max);
-    sum += result[i];
-  }
+namespace vart {
 
-  for (size_t i = 0; i < size; i++) {
-    result[i] /= sum;
-  }
+static bool is_host_phy(vart::TensorBuffer* tb) {
+  return tb->get_location() == TensorBuffer::location_t::HOST_PHY;
 }
 
-namespace vart {
-
 static std::vector<std::int32_t> reshape_tensor_to_three_dim(
     std::vector<std::int32_t> in) {
   CHECK_GE(in.size(), 2) << "input dimension is less than 2";
@@ -71,7 +53,7 @@ static std::vector<std::int32_t> reshape_tensor_to_three_dim(
 
 SoftmaxRunnerCPU::SoftmaxRunnerCPU(const xir::Subgraph* subgraph,
                                    xir::Attrs* attrs)
-    : input_{}, output_{} {
+    : input_{}, output_{}, engine_{} {
   LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
       << "@" << (void*)this << " softmax runner is created for subgraph "
       << subgraph->get_name();
@@ -110,6 +92,10 @@ SoftmaxRunnerCPU::SoftmaxRunnerCPU(const xir::Subgraph* subgraph,
       std::vector<const xir::Tensor*>{*outputTensors.begin()});
   input_ = std::move((tensor_buffers.first)[0]);
   output_ = std::move((tensor_buffers.second)[0]);
+  auto input_tensor = *input_set.begin();
+  if (input_tensor->has_attr("fix_point")) {
+    get_engine(input_tensor->template get_attr<int>("fix_point"));
+  }
 }
 
 SoftmaxRunnerCPU::~SoftmaxRunnerCPU() {}
@@ -139,21 +125,37 @@ std::pair<uint32_t, int> SoftmaxRunnerCPU::execute_async(
     CHECK_EQ(input_shape[i], output_shape[i]);
   }
 
-  auto cls = (uint32_t)input_shape[2];
-  auto softmaxOut = std::make_unique<float[]>(cls);
+  auto rows = (size_t)input_shape[1];
+  auto cls = (size_t)input_shape[2];
+  auto engine = get_engine(
+      input_buffer->get_tensor()->template get_attr<int>("fix_point"));
 
   std::vector<int> idx = vart::get_index_zeros(input_buffer->get_tensor());
-  for (auto b = 0; b < input_batch_size; ++b) {
-    idx[0] = b;
-    int8_t* data = (int8_t*)input_buffer->data(idx).first;
-
-    int fixpos =
-        input_buffer->get_tensor()->template get_attr<int>("fix_point");
-    float scale = std::exp2f(-1.0f * (float)fixpos);
-
-    CPUCalcSoftmax(data, cls, softmaxOut.get(), scale);
-    float* out_data = (float*)output[0]->data(idx).first;
-    for (uint32_t i = 0; i < cls; ++i) out_data[i] = softmaxOut[i];
+  auto batch_size = rows * cls;
+  // sync_for_read() and sync_for_write() cover every batch.
+  if (is_host_phy(input_buffer)) {
+    input_buffer->sync_for_read(0u, batch_size);
+  }
+  // every batch of a HOST_PHY tensor buffer is a buffer object of its own,
+  // the size data() returns might go past it.
+  auto in = input_buffer->data(idx);
+  auto out = output_buffer->data(idx);
+  if (input_buffer->get_location() == TensorBuffer::location_t::HOST_VIRT &&
+      output_buffer->get_location() == TensorBuffer::location_t::HOST_VIRT &&
+      in.second >= input_batch_size * batch_size &&
+      out.second >= input_batch_size * batch_size * sizeof(float)) {
+    // all batches are in one contiguous buffer, e.g. HostFlatTensorBuffer
+    engine->run((const int8_t*)in.first, input_batch_size * rows, cls,
+                (float*)out.first);
+  } else {
+    for (auto b = 0; b < input_batch_size; ++b) {
+      idx[0] = b;
+      engine->run((const int8_t*)input_buffer->data(idx).first, rows, cls,
+                  (float*)output_buffer->data(idx).first);
+    }
+  }
+  if (is_host_phy(output_buffer)) {
+    output_buffer->sync_for_write(0u, batch_size * sizeof(float));
   }
   LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
       << "@" << (void*)this << " start to run: "
@@ -164,6 +166,41 @@ std::pair<uint32_t, int> SoftmaxRunnerCPU::execute_async(
 
 int SoftmaxRunnerCPU::wait(int jobid, int timeout) { return 0; }
 
+std::vector<std::pair<int, float>> SoftmaxRunnerCPU::topk(
+    vart::TensorBuffer* input, size_t k) {
+  auto shape = reshape_tensor_to_three_dim(input->get_tensor()->get_shape());
+  auto rows = (size_t)shape[1];
+  auto cls = (size_t)shape[2];
+  auto engine =
+      get_engine(input->get_tensor()->template get_attr<int>("fix_point"));
+  auto ret = std::vector<std::pair<int, float>>((size_t)shape[0] * rows * k);
+  if (is_host_phy(input)) {
+    input->sync_for_read(0u, rows * cls);
+  }
+  std::vector<int> idx = vart::get_index_zeros(input->get_tensor());
+  for (auto b = 0; b < shape[0]; ++b) {
+    idx[0] = b;
+    auto out = &ret[(size_t)b * rows * k];
+    if (k == 1u) {
+      engine->run_argmax((const int8_t*)input->data(idx).first, rows, cls,
+                         out);
+    } else {
+      engine->run_topk((const int8_t*)input->data(idx).first, rows, cls, k,
+                       out);
+    }
+  }
+  return ret;
+}
+
+std::shared_ptr<SoftmaxEngine> SoftmaxRunnerCPU::get_engine(int fix_point) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  if (engine_ == nullptr || engine_->get_fix_point() != fix_point) {
+    engine_ = std::make_shared<SoftmaxEngine>(
+        fix_point, (size_t)ENV_PARAM(XLNX_SOFTMAX_CPU_NUM_OF_THREADS));
+  }
+  return engine_;
+}
+
 std::vector<const xir::Tensor*> SoftmaxRunnerCPU::get_input_tensors() {
   return {input_->get_tensor()};
 }
@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/ssd_engine.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "vart/tensor_buffer.hpp"
+#include "vitis/ai/env_config.hpp"
+#include "vitis/ai/thread_pool.hpp"
+#include "vitis/ai/weak.hpp"
+#include "xir/tensor/tensor.hpp"
+
+DEF_ENV_PARAM(DEBUG_SSD_ENGINE, "0")
+
+namespace vart {
+
+// the same prior boxes as PriorBoxes in dpu-runner/samples, ssd.cpp
+struct SsdEngine::priors_t {
+  explicit priors_t(const ssd_param_t& param);
+  std::vector<prior_t> boxes;
+};
+
+SsdEngine::priors_t::priors_t(const ssd_param_t& param) {
+  for (auto& layer : param.prior_boxes) {
+    auto step_w = layer.step_width;
+    auto step_h = layer.step_height;
+    if (step_w == 0.0f || step_h == 0.0f) {
+      step_w = (float)param.image_width / (float)layer.layer_width;
+      step_h = (float)param.image_height / (float)layer.layer_height;
+    }
+    std::vector<std::pair<float, float>> dims;
+    for (auto i = 0u; i < layer.min_sizes.size(); ++i) {
+      auto min_size = layer.min_sizes[i];
+      dims.emplace_back(min_size, min_size);
+      if (!layer.max_sizes.empty()) {
+        auto size = std::sqrt(min_size * layer.max_sizes[i]);
+        dims.emplace_back(size, size);
+      }
+      for (auto ar : layer.aspect_ratios) {
+        auto w = min_size * std::sqrt(ar);
+        auto h = min_size / std::sqrt(ar);
+        dims.emplace_back(w, h);
+        if (layer.flip) {
+          dims.emplace_back(h, w);
+        }
+      }
+    }
+    for (auto h = 0; h < layer.layer_height; ++h) {
+      for (auto w = 0; w < layer.layer_width; ++w) {
+        auto center_x = ((float)w + layer.offset) * step_w;
+        auto center_y = ((float)h + layer.offset) * step_h;
+        for (auto& d : dims) {
+          prior_t box;
+          box[0] = (center_x - d.first / 2.) / param.image_width;
+          box[1] = (center_y - d.second / 2.) / param.image_height;
+          box[2] = (center_x + d.first / 2.) / param.image_width;
+          box[3] = (center_y + d.second / 2.) / param.image_height;
+          if (layer.clip) {
+            for (auto i = 0; i < 4; ++i) {
+              box[i] = std::min(std::max(box[i], 0.0f), 1.0f);
+            }
+          }
+          box[4] = 0.5f * (box[0] + box[2]);
+          box[5] = 0.5f * (box[1] + box[3]);
+          box[6] = box[2] - box[0];
+          box[7] = box[3] - box[1];
+          boxes.push_back(box);
+        }
+      }
+    }
+  }
+}
+
+// prior boxes are shared by all engines with the same geometry.
+static std::string priors_key(const SsdEngine::ssd_param_t& param) {
+  std::ostringstream str;
+  str.precision(9);
+  str << param.image_width << "x" << param.image_height;
+  for (auto& layer : param.prior_boxes) {
+    str << ";" << layer.layer_width << "x" << layer.layer_height;
+    for (auto& v : {layer.min_sizes, layer.max_sizes, layer.aspect_ratios}) {
+      str << "[";
+      for (auto x : v) {
+        str << x << ",";
+      }
+      str << "]";
+    }
+    str << layer.offset << "," << layer.step_width << ","
+        << layer.step_height << "," << layer.flip << "," << layer.clip;
+  }
+  return str.str();
+}
+
+SsdEngine::SsdEngine(const ssd_param_t& param, int loc_fix_point,
+                     int conf_fix_point, size_t num_of_threads)
+    : param_{param},
+      priors_{},
+      loc_scale_{std::exp2f(-1.0f * (float)loc_fix_point)},
+      conf_exp_table_{},
+      size_exp_table_{},
+      min_conf_threshold_{},
+      pool_{},
+      num_of_threads_{} {
+  CHECK_GE(param_.num_classes, 2) << "background and at least one class";
+  CHECK_EQ(param_.conf_threshold.size(), (size_t)param_.num_classes);
+  priors_ = vitis::ai::WeakStore<std::string, priors_t>::create(
+      priors_key(param_), param_);
+  auto conf_scale = std::exp2f(-1.0f * (float)conf_fix_point);
+  for (auto d = 0u; d < conf_exp_table_.size(); ++d) {
+    conf_exp_table_[d] = std::exp(-1.0f * (float)d * conf_scale);
+  }
+  for (auto i = 0u; i < size_exp_table_.size(); ++i) {
+    for (auto x = -128; x < 128; ++x) {
+      size_exp_table_[i][x + 128] =
+          std::exp(param_.variances[2 + i] * ((float)x * loc_scale_));
+    }
+  }
+  min_conf_threshold_ = *std::min_element(param_.conf_threshold.begin() + 1,
+                                          param_.conf_threshold.end());
+  num_of_threads_ = num_of_threads == 0u
+                        ? (size_t)std::thread::hardware_concurrency()
+                        : num_of_threads;
+  num_of_threads_ = std::max(num_of_threads_, (size_t)1u);
+  if (num_of_threads_ > 1u) {
+    // the calling thread takes one share of the tasks as well.
+    pool_ = vitis::ai::ThreadPool::create(num_of_threads_ - 1u);
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SSD_ENGINE))
+      << "@" << (void*)this << " ssd engine created. priors@"
+      << (const void*)priors_.get() << " num_of_priors=" << get_num_of_priors()
+      << " num_classes=" << param_.num_classes
+      << " loc_fix_point=" << loc_fix_point
+      << " conf_fix_point=" << conf_fix_point
+      << " num_of_threads=" << num_of_threads_;
+}
+
+SsdEngine::~SsdEngine() {}
+
+size_t SsdEngine::get_num_of_priors() const { return priors_->boxes.size(); }
+
+template <typename TaskFunc>
+void SsdEngine::for_each_task(size_t num_of_tasks, TaskFunc&& func) const {
+  auto num_of_chunks = std::min(num_of_threads_, num_of_tasks);
+  if (pool_ == nullptr || num_of_chunks <= 1u) {
+    for (size_t t = 0u; t < num_of_tasks; ++t) {
+      func(t);
+    }
+    return;
+  }
+  // interleaved, so that a chunk does not get all the busy classes.
+  auto do_chunk = [&func, num_of_tasks, num_of_chunks](size_t chunk) {
+    for (auto t = chunk; t < num_of_tasks; t += num_of_chunks) {
+      func(t);
+    }
+  };
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_of_chunks - 1u);
+  for (size_t chunk = 1u; chunk < num_of_chunks; ++chunk) {
+    futures.emplace_back(pool_->async(do_chunk, chunk));
+  }
+  do_chunk(0u);
+  for (auto& f : futures) {
+    f.get();
+  }
+}
+
+// same arithmetic as SSDdetector::DecodeBBox in dpu-runner/samples, so that
+// the results are identical.
+SsdEngine::box_t SsdEngine::decode(const int8_t* loc, int idx) const {
+  auto& prior = priors_->boxes[idx];
+  auto& variances = param_.variances;
+  auto l = loc + idx * 4;
+  auto center_x =
+      variances[0] * ((float)l[0] * loc_scale_) * prior[6] + prior[4];
+  auto center_y =
+      variances[1] * ((float)l[1] * loc_scale_) * prior[7] + prior[5];
+  auto width = size_exp_table_[0][l[2] + 128] * prior[6];
+  auto height = size_exp_table_[1][l[3] + 128] * prior[7];
+  box_t box;
+  box[0] = center_x - width / 2.;
+  box[1] = center_y - height / 2.;
+  box[2] = center_x + width / 2.;
+  box[3] = center_y + height / 2.;
+  auto w = box[2] - box[0];
+  auto h = box[3] - box[1];
+  box[4] = w > 0.0f && h > 0.0f ? w * h : 0.0f;
+  return box;
+}
+
+void SsdEngine::nms(const int8_t* loc,
+                    std::vector<std::pair<float, int>>* candidates,
+                    std::vector<std::pair<float, int>>* kept) const {
+  // by descending score, ties by prior index as the stable sort in the
+  // samples. only the first nms_top_k are ordered.
+  auto greater = [](const std::pair<float, int>& a,
+                    const std::pair<float, int>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  };
+  auto n = std::min(candidates->size(), (size_t)param_.nms_top_k);
+  std::partial_sort(candidates->begin(), candidates->begin() + n,
+                    candidates->end(), greater);
+  // kept boxes as structure of arrays, the inner loop only touches the
+  // coordinates it needs until an overlap is found.
+  std::array<std::vector<float>, 5> kept_boxes;
+  for (auto& v : kept_boxes) {
+    v.reserve(n);
+  }
+  auto threshold = param_.nms_threshold;
+  for (auto i = 0u; i < n; ++i) {
+    // the remaining candidates have lower scores, they never survive
+    // keep_top_k.
+    if (param_.keep_top_k > 0u && kept->size() >= param_.keep_top_k) {
+      break;
+    }
+    auto idx = (*candidates)[i].second;
+    auto box = decode(loc, idx);
+    auto keep = true;
+    for (auto k = 0u; k < kept->size(); ++k) {
+      if (box[0] > kept_boxes[2][k] || box[2] < kept_boxes[0][k] ||
+          box[1] > kept_boxes[3][k] || box[3] < kept_boxes[1][k]) {
+        continue;
+      }
+      auto w = std::min(box[2], kept_boxes[2][k]) -
+               std::max(box[0], kept_boxes[0][k]);
+      auto h = std::min(box[3], kept_boxes[3][k]) -
+               std::max(box[1], kept_boxes[1][k]);
+      auto intersect = w > 0.0f && h > 0.0f ? w * h : 0.0f;
+      if (intersect <= 0.0f) {
+        continue;
+      }
+      auto overlap = intersect / (box[4] + kept_boxes[4][k] - intersect);
+      if (overlap > threshold) {
+        keep = false;
+        break;
+      }
+    }
+    if (!keep) {
+      continue;
+    }
+    kept->push_back((*candidates)[i]);
+    for (auto j = 0u; j < kept_boxes.size(); ++j) {
+      kept_boxes[j].push_back(box[j]);
+    }
+    if (param_.eta < 1.0f && threshold > 0.5f) {
+      threshold *= param_.eta;
+    }
+  }
+}
+
+std::vector<SsdEngine::bbox_t> SsdEngine::run(const int8_t* loc,
+                                              const int8_t* conf) const {
+  const auto num_of_priors = get_num_of_priors();
+  const auto num_classes = (size_t)param_.num_classes;
+
+  // 1. scores, every chunk of priors collects its candidates per class in
+  //    prior index order.
+  auto num_of_chunks = std::min(num_of_threads_, num_of_priors);
+  auto priors_per_chunk = (num_of_priors + num_of_chunks - 1u) / num_of_chunks;
+  std::vector<std::vector<std::vector<std::pair<float, int>>>> chunks(
+      num_of_chunks,
+      std::vector<std::vector<std::pair<float, int>>>(num_classes));
+  for_each_task(num_of_chunks, [&](size_t chunk) {
+    auto& candidates = chunks[chunk];
+    auto begin = chunk * priors_per_chunk;
+    auto end = std::min(num_of_priors, begin + priors_per_chunk);
+    for (auto i = begin; i < end; ++i) {
+      auto row = conf + i * num_classes;
+      auto max = *std::max_element(row, row + num_classes);
+      float sum = 0.0f;
+      for (size_t c = 0u; c < num_classes; ++c) {
+        sum += conf_exp_table_[(uint8_t)(max - row[c])];
+      }
+      // score > min_conf_threshold_ without the division
+      auto min_exp = min_conf_threshold_ * sum;
+      for (size_t c = 1u; c < num_classes; ++c) {
+        auto e = conf_exp_table_[(uint8_t)(max - row[c])];
+        if (e > min_exp) {
+          candidates[c].emplace_back(e / sum, (int)i);
+        }
+      }
+    }
+  });
+
+  // 2. per class nms.
+  std::vector<std::vector<std::pair<float, int>>> kept(num_classes);
+  for_each_task(num_classes - 1u, [&](size_t task) {
+    auto c = task + 1u;
+    std::vector<std::pair<float, int>> candidates;
+    for (auto& chunk : chunks) {
+      candidates.insert(candidates.end(), chunk[c].begin(), chunk[c].end());
+    }
+    nms(loc, &candidates, &kept[c]);
+  });
+
+  // 3. keep_top_k over all classes.
+  size_t num_det = 0u;
+  for (auto& k : kept) {
+    num_det += k.size();
+  }
+  if (param_.keep_top_k > 0u && num_det > param_.keep_top_k) {
+    std::vector<std::pair<float, int>> score_label;
+    score_label.reserve(num_det);
+    for (size_t c = 1u; c < num_classes; ++c) {
+      for (auto& k : kept[c]) {
+        score_label.emplace_back(k.first, (int)c);
+      }
+    }
+    std::nth_element(score_label.begin(),
+                     score_label.begin() + (param_.keep_top_k - 1u),
+                     score_label.end(),
+                     [](const std::pair<float, int>& a,
+                        const std::pair<float, int>& b) {
+                       return a.first > b.first;
+                     });
+    // every class is sorted by score, so it keeps a prefix. ties at the
+    // cut are resolved in label order.
+    auto min_score = score_label[param_.keep_top_k - 1u].first;
+    auto num_above = (size_t)std::count_if(
+        score_label.begin(), score_label.end(),
+        [min_score](const std::pair<float, int>& x) {
+          return x.first > min_score;
+        });
+    auto num_of_ties = param_.keep_top_k - num_above;
+    for (size_t c = 1u; c < num_classes; ++c) {
+      auto& k = kept[c];
+      auto n = 0u;
+      while (n < k.size() && k[n].first > min_score) {
+        ++n;
+      }
+      while (n < k.size() && k[n].first == min_score && num_of_ties > 0u) {
+        ++n;
+        --num_of_ties;
+      }
+      k.resize(n);
+    }
+  }
+
+  std::vector<bbox_t> results;
+  for (size_t c = 1u; c < num_classes; ++c) {
+    for (auto& k : kept[c]) {
+      if (k.first < param_.conf_threshold[c]) {
+        continue;
+      }
+      auto box = decode(loc, k.second);
+      auto clamp = [](float x) { return std::max(std::min(x, 1.0f), 0.0f); };
+      results.emplace_back(bbox_t{(int)c, k.first, clamp(box[0]),
+                                  clamp(box[1]), clamp(box[2]),
+                                  clamp(box[3])});
+    }
+  }
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SSD_ENGINE) >= 2)
+      << "@" << (void*)this << " num_det=" << num_det
+      << " results=" << results.size();
+  return results;
+}
+
+static const int8_t* frame_data(vart::TensorBuffer* tb, size_t batch_idx,
+                                size_t size_per_frame) {
+  auto tensor = tb->get_tensor();
+  auto shape = tensor->get_shape();
+  CHECK(tb->get_location() == vart::TensorBuffer::location_t::HOST_VIRT ||
+        tb->get_location() == vart::TensorBuffer::location_t::HOST_PHY)
+      << "tensor buffer is not host accessible. tensor=" << tensor->get_name();
+  CHECK_LT(batch_idx, (size_t)shape[0]) << "tensor=" << tensor->get_name();
+  CHECK_EQ((size_t)tensor->get_element_num() / shape[0], size_per_frame)
+      << "unexpected tensor size. tensor=" << tensor->get_name();
+  CHECK_EQ(tensor->get_data_type().bit_width, 8)
+      << "tensor=" << tensor->get_name();
+  std::vector<int> idx(shape.size(), 0);
+  idx[0] = (int)batch_idx;
+  auto data = tb->data(idx);
+  CHECK_GE(data.second, size_per_frame) << "tensor=" << tensor->get_name();
+  return reinterpret_cast<const int8_t*>(data.first);
+}
+
+std::vector<SsdEngine::bbox_t> SsdEngine::run(vart::TensorBuffer* loc,
+                                              vart::TensorBuffer* conf,
+                                              size_t batch_idx) const {
+  auto num_of_priors = get_num_of_priors();
+  return run(frame_data(loc, batch_idx, num_of_priors * 4u),
+             frame_data(conf, batch_idx, num_of_priors * param_.num_classes));
+}
+
+}  // namespace vart
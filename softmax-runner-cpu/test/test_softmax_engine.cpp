@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "vart/softmax_engine.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_TEST, "0");
+DEF_ENV_PARAM(NUM_OF_LOOPS, "100");
+DEF_ENV_PARAM(NUM_OF_THREADS, "0");
+
+// the per-row path used by SoftmaxRunnerCPU before SoftmaxEngine
+static void softmax_legacy(const int8_t* data, size_t size, float* result,
+                           float scale) {
+  float max = (float)(data[0] * scale);
+  std::vector<float> input(size);
+  input[0] = max;
+  for (size_t i = 1; i < size; i++) {
+    input[i] = data[i] * scale;
+    if (input[i] > max) max = input[i];
+  }
+  double sum = 0.0f;
+  for (size_t i = 0; i < size; i++) {
+    result[i] = exp(input[i] - max);
+    sum += result[i];
+  }
+  for (size_t i = 0; i < size; i++) {
+    result[i] /= sum;
+  }
+}
+
+static void run_legacy(const int8_t* input, size_t rows, size_t cls,
+                       int fix_point, float* output) {
+  for (size_t r = 0; r < rows; ++r) {
+    float scale = std::exp2f(-1.0f * (float)fix_point);
+    auto tmp = std::make_unique<float[]>(cls);
+    softmax_legacy(input + r * cls, cls, tmp.get(), scale);
+    for (size_t i = 0; i < cls; ++i) output[r * cls + i] = tmp[i];
+  }
+}
+
+template <typename F>
+static double measure_us(F&& f) {
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; ++i) {
+    f();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         loops;
+}
+
+static bool test_shape(const vart::SoftmaxEngine& engine, size_t rows,
+                       size_t cls) {
+  auto fix_point = engine.get_fix_point();
+  std::mt19937 rng(rows * cls);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  std::vector<int8_t> input(rows * cls);
+  for (auto& x : input) {
+    x = (int8_t)dist(rng);
+  }
+  std::vector<float> ref(rows * cls);
+  std::vector<float> out(rows * cls);
+
+  auto t_legacy = measure_us(
+      [&]() { run_legacy(input.data(), rows, cls, fix_point, ref.data()); });
+  auto t_engine =
+      measure_us([&]() { engine.run(input.data(), rows, cls, out.data()); });
+
+  auto ok = true;
+  for (size_t i = 0; i < rows * cls; ++i) {
+    if (std::abs(ref[i] - out[i]) > 1e-5f) {
+      LOG(ERROR) << "mismatch at " << i << " input=" << (int)input[i]
+                 << " ref=" << ref[i] << " out=" << out[i];
+      ok = false;
+      break;
+    }
+  }
+
+  const size_t k = 5u;
+  std::vector<std::pair<int, float>> topk(rows * k);
+  std::vector<std::pair<int, float>> argmax(rows);
+  auto t_topk = measure_us(
+      [&]() { engine.run_topk(input.data(), rows, cls, k, topk.data()); });
+  engine.run_argmax(input.data(), rows, cls, argmax.data());
+  for (size_t r = 0; r < rows && ok; ++r) {
+    auto row = &ref[r * cls];
+    for (size_t i = 0; i < std::min(k, cls); ++i) {
+      auto c = topk[r * k + i].first;
+      auto higher = 0u;
+      for (size_t j = 0; j < cls; ++j) {
+        higher += row[j] > row[c];
+      }
+      if (higher > i || std::abs(topk[r * k + i].second - row[c]) > 1e-5f) {
+        LOG(ERROR) << "topk mismatch row=" << r << " rank=" << i
+                   << " cls=" << c;
+        ok = false;
+        break;
+      }
+    }
+    if (argmax[r].first != topk[r * k].first ||
+        std::abs(argmax[r].second - topk[r * k].second) > 1e-6f) {
+      LOG(ERROR) << "argmax mismatch row=" << r;
+      ok = false;
+    }
+  }
+
+  std::cout << "rows=" << rows << " cls=" << cls  //
+            << " legacy=" << t_legacy << "us"     //
+            << " engine=" << t_engine << "us"     //
+            << " topk" << k << "=" << t_topk << "us"
+            << " speedup=" << t_legacy / t_engine
+            << (ok ? " PASS" : " FAIL") << std::endl;
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  auto ok = true;
+  for (auto fix_point : {2, 4, 6}) {
+    auto engine = std::make_unique<vart::SoftmaxEngine>(
+        fix_point, (size_t)ENV_PARAM(NUM_OF_THREADS));
+    std::cout << "fix_point=" << fix_point << std::endl;
+    // classification head, e.g. resnet50 with batch 1 and batch 8
+    ok = test_shape(*engine, 1u, 1000u) && ok;
+    ok = test_shape(*engine, 8u, 1000u) && ok;
+    // detection head, e.g. ssd 1917 prior boxes with 21 classes
+    ok = test_shape(*engine, 1917u, 21u) && ok;
+  }
+  return ok ? 0 : 1;
+}
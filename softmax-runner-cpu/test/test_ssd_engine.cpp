@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "vart/ssd_engine.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(DEBUG_TEST, "0");
+DEF_ENV_PARAM(NUM_OF_LOOPS, "20");
+DEF_ENV_PARAM(NUM_OF_THREADS, "0");
+
+using param_t = vart::SsdEngine::ssd_param_t;
+using bbox_t = vart::SsdEngine::bbox_t;
+
+// the post-processing of dpu-runner/samples/pose_detection/src/ssd.cpp,
+// CENTER_SIZE code type, without opencv.
+class LegacySsd {
+ public:
+  LegacySsd(const param_t& param, float loc_scale, float conf_scale)
+      : param_{param}, loc_scale_{loc_scale}, conf_scale_{conf_scale} {
+    for (auto& layer : param.prior_boxes) {
+      create_priors(layer);
+    }
+    nms_confidence_ = *std::min_element(param.conf_threshold.begin() + 1,
+                                        param.conf_threshold.end());
+  }
+
+  size_t num_of_priors() const { return priors_.size(); }
+
+  std::vector<bbox_t> run(const int8_t* loc, const int8_t* conf) {
+    auto num_classes = (size_t)param_.num_classes;
+    softmax_.resize(priors_.size() * num_classes);
+    for (size_t i = 0; i < priors_.size(); i++) {
+      softmax(&conf[i * num_classes], num_classes,
+              &softmax_[i * num_classes]);
+    }
+    return detect(loc, softmax_.data());
+  }
+
+ private:
+  void create_priors(const vart::SsdEngine::prior_box_param_t& layer) {
+    std::vector<std::pair<float, float>> boxes_dims;
+    for (auto i = 0u; i < layer.min_sizes.size(); ++i) {
+      boxes_dims.emplace_back(layer.min_sizes[i], layer.min_sizes[i]);
+      if (!layer.max_sizes.empty()) {
+        boxes_dims.emplace_back(
+            std::sqrt(layer.min_sizes[i] * layer.max_sizes[i]),
+            std::sqrt(layer.min_sizes[i] * layer.max_sizes[i]));
+      }
+      for (auto ar : layer.aspect_ratios) {
+        float w = layer.min_sizes[i] * std::sqrt(ar);
+        float h = layer.min_sizes[i] / std::sqrt(ar);
+        boxes_dims.emplace_back(w, h);
+        if (layer.flip) boxes_dims.emplace_back(h, w);
+      }
+    }
+    auto step = std::make_pair(layer.step_width, layer.step_height);
+    if (step.first == 0 || step.second == 0) {
+      step = std::make_pair(
+          static_cast<float>(param_.image_width) / layer.layer_width,
+          static_cast<float>(param_.image_height) / layer.layer_height);
+    }
+    for (int h = 0; h < layer.layer_height; ++h) {
+      for (int w = 0; w < layer.layer_width; ++w) {
+        float center_x = (w + layer.offset) * step.first;
+        float center_y = (h + layer.offset) * step.second;
+        for (auto& dims : boxes_dims) {
+          std::vector<float> box(12);
+          box[0] = (center_x - dims.first / 2.) / param_.image_width;
+          box[1] = (center_y - dims.second / 2.) / param_.image_height;
+          box[2] = (center_x + dims.first / 2.) / param_.image_width;
+          box[3] = (center_y + dims.second / 2.) / param_.image_height;
+          if (layer.clip) {
+            for (int i = 0; i < 4; ++i)
+              box[i] = std::min(std::max(box[i], 0.f), 1.f);
+          }
+          std::copy_n(param_.variances.begin(), 4, box.data() + 4);
+          box[8] = 0.5f * (box[0] + box[2]);
+          box[9] = 0.5f * (box[1] + box[3]);
+          box[10] = box[2] - box[0];
+          box[11] = box[3] - box[1];
+          priors_.push_back(std::move(box));
+        }
+      }
+    }
+  }
+
+  void softmax(const int8_t* data, size_t size, float* result) {
+    double sum = 0.0f;
+    for (size_t i = 0; i < size; i++) {
+      result[i] = std::exp(data[i] * conf_scale_);
+      sum += result[i];
+    }
+    for (size_t i = 0; i < size; i++) {
+      result[i] /= sum;
+    }
+  }
+
+  void decode_bbox(const int8_t (*bboxes)[4], int idx) {
+    std::vector<float> bbox(5, 0);
+    for (int i = 0; i < 4; ++i) bbox[i] = bboxes[idx][i] * loc_scale_;
+    auto& p = priors_[idx];
+    float cx = p[4] * bbox[0] * p[10] + p[8];
+    float cy = p[5] * bbox[1] * p[11] + p[9];
+    float w = std::exp(p[6] * bbox[2]) * p[10];
+    float h = std::exp(p[7] * bbox[3]) * p[11];
+    bbox[0] = cx - w / 2.;
+    bbox[1] = cy - h / 2.;
+    bbox[2] = cx + w / 2.;
+    bbox[3] = cy + h / 2.;
+    bbox_size(bbox);
+    decoded_bboxes_.emplace(idx, std::move(bbox));
+  }
+
+  static void bbox_size(std::vector<float>& bbox) {
+    float width = bbox[2] - bbox[0];
+    float height = bbox[3] - bbox[1];
+    bbox[4] = width > 0 && height > 0 ? width * height : 0.f;
+  }
+
+  float jaccard_overlap(int idx, int kept_idx) {
+    const std::vector<float>& bbox1 = decoded_bboxes_[idx];
+    const std::vector<float>& bbox2 = decoded_bboxes_[kept_idx];
+    if (bbox2[0] > bbox1[2] || bbox2[2] < bbox1[0] || bbox2[1] > bbox1[3] ||
+        bbox2[3] < bbox1[1]) {
+      return 0.f;
+    }
+    std::vector<float> intersect_bbox(5);
+    intersect_bbox[0] = std::max(bbox1[0], bbox2[0]);
+    intersect_bbox[1] = std::max(bbox1[1], bbox2[1]);
+    intersect_bbox[2] = std::min(bbox1[2], bbox2[2]);
+    intersect_bbox[3] = std::min(bbox1[3], bbox2[3]);
+    bbox_size(intersect_bbox);
+    float intersect_size = intersect_bbox[4];
+    return intersect_size <= 0
+               ? 0
+               : intersect_size / (bbox1[4] + bbox2[4] - intersect_size);
+  }
+
+  void get_score_index(const float* conf_data, int start_label,
+                       int num_classes,
+                       std::vector<std::vector<std::pair<float, int>>>* vec) {
+    for (auto label = start_label; label < start_label + num_classes;
+         ++label) {
+      auto& score_index_vec = (*vec)[label];
+      auto data = conf_data + label;
+      for (size_t i = 0; i < priors_.size(); ++i) {
+        if (*data > nms_confidence_) {
+          score_index_vec.emplace_back(*data, i);
+        }
+        data += param_.num_classes;
+      }
+      std::stable_sort(score_index_vec.begin(), score_index_vec.end(),
+                       [](const std::pair<float, int>& lhs,
+                          const std::pair<float, int>& rhs) {
+                         return lhs.first > rhs.first;
+                       });
+      if (param_.nms_top_k < score_index_vec.size()) {
+        score_index_vec.resize(param_.nms_top_k);
+      }
+    }
+  }
+
+  std::vector<bbox_t> detect(const int8_t* loc_data, const float* conf_data) {
+    decoded_bboxes_.clear();
+    auto num_classes = (unsigned)param_.num_classes;
+    auto bboxes = (const int8_t(*)[4])loc_data;
+    unsigned int num_det = 0;
+    std::vector<std::vector<int>> indices(num_classes);
+    std::vector<std::vector<std::pair<float, int>>> score_index_vec(
+        num_classes);
+    // GetMultiClassMaxScoreIndexMT with 2 threads
+    auto n = (int)num_classes - 1;
+    std::thread worker(&LegacySsd::get_score_index, this, conf_data, 1, n / 2,
+                       &score_index_vec);
+    get_score_index(conf_data, 1 + n / 2, n - n / 2, &score_index_vec);
+    worker.join();
+
+    for (auto c = 1u; c < num_classes; ++c) {
+      float adaptive_threshold = param_.nms_threshold;
+      for (auto& score_index : score_index_vec[c]) {
+        const int idx = score_index.second;
+        if (decoded_bboxes_.find(idx) == decoded_bboxes_.end()) {
+          decode_bbox(bboxes, idx);
+        }
+        bool keep = true;
+        for (auto kept_idx : indices[c]) {
+          if (jaccard_overlap(idx, kept_idx) > adaptive_threshold) {
+            keep = false;
+            break;
+          }
+        }
+        if (keep) {
+          indices[c].push_back(idx);
+        }
+        if (keep && param_.eta < 1 && adaptive_threshold > 0.5) {
+          adaptive_threshold *= param_.eta;
+        }
+      }
+      num_det += indices[c].size();
+    }
+
+    if (param_.keep_top_k > 0 && num_det > param_.keep_top_k) {
+      std::vector<std::tuple<float, int, int>> score_index_tuples;
+      for (auto label = 0u; label < num_classes; ++label) {
+        for (auto idx : indices[label]) {
+          auto score = conf_data[idx * num_classes + label];
+          score_index_tuples.emplace_back(score, label, idx);
+        }
+      }
+      std::sort(score_index_tuples.begin(), score_index_tuples.end(),
+                [](const std::tuple<float, int, int>& lhs,
+                   const std::tuple<float, int, int>& rhs) {
+                  return std::get<0>(lhs) > std::get<0>(rhs);
+                });
+      score_index_tuples.resize(param_.keep_top_k);
+      indices.clear();
+      indices.resize(num_classes);
+      for (auto& item : score_index_tuples) {
+        indices[std::get<1>(item)].push_back(std::get<2>(item));
+      }
+    }
+
+    std::vector<bbox_t> result;
+    for (auto label = 1u; label < indices.size(); ++label) {
+      for (auto idx : indices[label]) {
+        auto score = conf_data[idx * num_classes + label];
+        if (score < param_.conf_threshold[label]) {
+          continue;
+        }
+        auto& bbox = decoded_bboxes_[idx];
+        for (int i = 0; i < 4; ++i) {
+          bbox[i] = std::max(std::min(bbox[i], 1.f), 0.f);
+        }
+        result.emplace_back(
+            bbox_t{(int)label, score, bbox[0], bbox[1], bbox[2], bbox[3]});
+      }
+    }
+    return result;
+  }
+
+ private:
+  const param_t param_;
+  const float loc_scale_;
+  const float conf_scale_;
+  float nms_confidence_;
+  std::vector<std::vector<float>> priors_;
+  std::vector<float> softmax_;
+  std::map<int, std::vector<float>> decoded_bboxes_;
+};
+
+// ssd_person in dpu-runner/samples/pose_detection, PriorBoxes::Create()
+static param_t person_param(int num_classes) {
+  param_t param;
+  param.image_width = 640;
+  param.image_height = 360;
+  param.prior_boxes = {
+      {80, 45, {18, 30, 50}, {40, 60, 80}, {2}, 0.5f, 8, 8},
+      {40, 23, {72.0}, {160.0}, {2, 3}, 0.5f, 16, 16},
+      {20, 12, {160.0}, {240.0}, {2, 3}, 0.5f, 32, 32},
+      {10, 6, {240.0}, {320.0}, {2, 3}, 0.5f, 64, 64},
+      {8, 4, {320.0}, {400.0}, {2}, 0.5f, 100, 100},
+      {6, 2, {350.0}, {480.0}, {2}, 0.5f, 300, 300}};
+  param.num_classes = num_classes;
+  param.conf_threshold.assign(num_classes, 0.3f);
+  param.conf_threshold[0] = 0.0f;
+  param.nms_top_k = 400u;
+  param.keep_top_k = 200u;
+  param.nms_threshold = 0.5f;
+  return param;
+}
+
+// background everywhere, plus a number of objects, each of them is seen by
+// a cluster of neighbouring priors with noisy scores and offsets.
+static void make_outputs(size_t num_of_priors, int num_classes,
+                         int num_of_objects, std::vector<int8_t>* loc,
+                         std::vector<int8_t>* conf) {
+  std::mt19937 rng(num_of_priors * num_classes + num_of_objects);
+  std::uniform_int_distribution<int> noise(-6, 6);
+  std::uniform_int_distribution<int> offset(-20, 20);
+  loc->resize(num_of_priors * 4);
+  conf->resize(num_of_priors * num_classes);
+  for (auto& x : *loc) {
+    x = (int8_t)offset(rng);
+  }
+  for (size_t i = 0; i < num_of_priors; ++i) {
+    for (int c = 0; c < num_classes; ++c) {
+      (*conf)[i * num_classes + c] = (int8_t)(c == 0 ? 30 : noise(rng));
+    }
+  }
+  std::uniform_int_distribution<size_t> where(0u, num_of_priors - 64u);
+  std::uniform_int_distribution<int> label(1, num_classes - 1);
+  std::uniform_int_distribution<int> strength(20, 60);
+  for (auto o = 0; o < num_of_objects; ++o) {
+    auto first = where(rng);
+    auto c = label(rng);
+    for (auto i = first; i < first + 48u; ++i) {
+      (*conf)[i * num_classes + c] = (int8_t)strength(rng);
+    }
+  }
+}
+
+template <typename F>
+static double measure_us(F&& f) {
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; ++i) {
+    f();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         loops;
+}
+
+static bool same(const bbox_t& a, const bbox_t& b) {
+  return a.label == b.label && std::abs(a.score - b.score) < 1e-5f &&
+         std::abs(a.x_min - b.x_min) < 1e-5f &&
+         std::abs(a.y_min - b.y_min) < 1e-5f &&
+         std::abs(a.x_max - b.x_max) < 1e-5f &&
+         std::abs(a.y_max - b.y_max) < 1e-5f;
+}
+
+static bool test_case(int num_classes, int num_of_objects) {
+  auto param = person_param(num_classes);
+  const int loc_fix_point = 6;
+  const int conf_fix_point = 3;
+  auto engine = std::make_unique<vart::SsdEngine>(
+      param, loc_fix_point, conf_fix_point,
+      (size_t)ENV_PARAM(NUM_OF_THREADS));
+  LegacySsd legacy(param, std::exp2f(-loc_fix_point),
+                   std::exp2f(-conf_fix_point));
+  CHECK_EQ(engine->get_num_of_priors(), legacy.num_of_priors());
+
+  std::vector<int8_t> loc;
+  std::vector<int8_t> conf;
+  make_outputs(engine->get_num_of_priors(), num_classes, num_of_objects, &loc,
+               &conf);
+
+  std::vector<bbox_t> ref;
+  std::vector<bbox_t> out;
+  auto t_legacy =
+      measure_us([&]() { ref = legacy.run(loc.data(), conf.data()); });
+  auto t_engine =
+      measure_us([&]() { out = engine->run(loc.data(), conf.data()); });
+
+  // the sort in the legacy keep_top_k is not stable, compare as sets.
+  auto less = [](const bbox_t& a, const bbox_t& b) {
+    return std::make_tuple(a.label, -a.score, a.x_min, a.y_min) <
+           std::make_tuple(b.label, -b.score, b.x_min, b.y_min);
+  };
+  std::sort(ref.begin(), ref.end(), less);
+  std::sort(out.begin(), out.end(), less);
+  auto ok = ref.size() == out.size();
+  for (auto i = 0u; ok && i < ref.size(); ++i) {
+    if (!same(ref[i], out[i])) {
+      LOG(ERROR) << "mismatch at " << i << " label=" << ref[i].label << "/"
+                 << out[i].label << " score=" << ref[i].score << "/"
+                 << out[i].score;
+      ok = false;
+    }
+  }
+  LOG_IF(ERROR, ref.size() != out.size())
+      << "detections: legacy=" << ref.size() << " engine=" << out.size();
+
+  std::cout << "classes=" << num_classes << " priors="
+            << engine->get_num_of_priors()  //
+            << " objects=" << num_of_objects << " detections=" << out.size()
+            << " legacy=" << t_legacy << "us"  //
+            << " engine=" << t_engine << "us"  //
+            << " speedup=" << t_legacy / t_engine << (ok ? " PASS" : " FAIL")
+            << std::endl;
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  auto ok = true;
+  // ssd_person, ssd vehicle with 4 classes, and a voc-like 21 classes head
+  // on the same priors.
+  ok = test_case(2, 20) && ok;
+  ok = test_case(4, 40) && ok;
+  ok = test_case(21, 300) && ok;
+  return ok ? 0 : 1;
+}
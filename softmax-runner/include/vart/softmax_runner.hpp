@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <atomic>
 #include <memory>
 
 #include "vart/runner_ext.hpp"
@@ -22,6 +23,8 @@
 #include "xir/sfm_controller.hpp"
 
 namespace vart {
+class SoftmaxRunnerCPU;
+
 class SoftmaxRunner : public vart::RunnerExt {
  public:
   explicit SoftmaxRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs);
@@ -45,6 +48,7 @@ class SoftmaxRunner : public vart::RunnerExt {
   void start_controller(vart::TensorBuffer* input, vart::TensorBuffer* output);
   void finalize_output(vart::TensorBuffer* internal,
                        vart::TensorBuffer* output);
+  bool run_on_cpu(vart::TensorBuffer* input, vart::TensorBuffer* output) const;
 
  private:
   const size_t device_core_id_ =
@@ -52,5 +56,12 @@ class SoftmaxRunner : public vart::RunnerExt {
   std::shared_ptr<xir::SfmController> controller_;
   std::unique_ptr<vart::TensorBuffer> input_;
   std::unique_ptr<vart::TensorBuffer> output_;
+  // HOST_VIRT requests with fewer than offload_threshold_ elements per batch
+  // are not worth a cu run and two copies, they are computed by cpu_runner_
+  // instead. so are requests the sfm does not support.
+  size_t offload_threshold_;
+  std::unique_ptr<SoftmaxRunnerCPU> cpu_runner_;
+  std::atomic<uint64_t> num_of_sfm_runs_;
+  std::atomic<uint64_t> num_of_cpu_runs_;
 };
 }  // namespace vart
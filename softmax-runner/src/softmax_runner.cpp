@@ -23,6 +23,7 @@
 #include "../src/runner_helper.hpp"
 #include "vart/assistant/tensor_buffer_allocator.hpp"
 #include "vart/runner_ext.hpp"
+#include "vart/softmax_runner_cpu.hpp"
 #include "vart/tensor_buffer.hpp"
 #include "vitis/ai/env_config.hpp"
 #include "xir/graph/subgraph.hpp"
@@ -30,6 +31,8 @@
 #include "xir/tensor/tensor.hpp"
 DEF_ENV_PARAM(DEBUG_SOFTMAX_RUNNER, "0")
 DEF_ENV_PARAM(DEBUG_TEST, "0");
+// default of the "sfm_offload_threshold" attr, in elements per batch.
+DEF_ENV_PARAM(XLNX_SFM_OFFLOAD_THRESHOLD, "1024");
 
 namespace vart {
 
@@ -38,7 +41,11 @@ SoftmaxRunner::SoftmaxRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
        // TODO: one controller per runner.
       controller_{xir::SfmController::get_instance()},
       input_{},
-      output_{} {
+      output_{},
+      offload_threshold_{},
+      cpu_runner_{},
+      num_of_sfm_runs_{0u},
+      num_of_cpu_runs_{0u} {
   LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
       << "@" << (void*)this << " softmax runner is created for subgraph "
       << subgraph->get_name();
@@ -57,15 +64,33 @@ SoftmaxRunner::SoftmaxRunner(const xir::Subgraph* subgraph, xir::Attrs* attrs)
       std::vector<const xir::Tensor*>{*output_set.begin()});
   input_ = std::move((tensor_buffers.first)[0]);
   output_ = std::move((tensor_buffers.second)[0]);
+
+  offload_threshold_ =
+      attrs->has_attr("sfm_offload_threshold")
+          ? attrs->get_attr<size_t>("sfm_offload_threshold")
+          : (size_t)ENV_PARAM(XLNX_SFM_OFFLOAD_THRESHOLD);
+  cpu_runner_ = std::make_unique<SoftmaxRunnerCPU>(subgraph, attrs);
 }
 
-SoftmaxRunner::~SoftmaxRunner() {}
+SoftmaxRunner::~SoftmaxRunner() {
+  auto sfm = num_of_sfm_runs_.load();
+  auto total = sfm + num_of_cpu_runs_.load();
+  LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
+      << "@" << (void*)this << " offloaded " << sfm << "/" << total
+      << " runs to sfm (" << (total == 0u ? 0u : sfm * 100u / total)
+      << "%), offload_threshold=" << offload_threshold_;
+}
 
 std::pair<uint32_t, int> SoftmaxRunner::execute_async(
     const std::vector<vart::TensorBuffer*>& input,
     const std::vector<vart::TensorBuffer*>& output) {
   CHECK_EQ(input.size(), 1u) << "only support single input";
   CHECK_EQ(output.size(), 1u) << "only support single output";
+  if (run_on_cpu(input[0], output[0])) {
+    num_of_cpu_runs_++;
+    return cpu_runner_->execute_async(input, output);
+  }
+  num_of_sfm_runs_++;
   auto input_phy = prepare_input(input[0]);
   auto output_phy = prepare_output(output[0]);
   LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
@@ -171,6 +196,35 @@ static std::vector<std::int32_t> reshape_tensor_to_three_dim(
   return std::vector<std::int32_t>{in.front(), mid, in.back()};
 }
 
+static bool is_host_accessible(vart::TensorBuffer* tb) {
+  return tb->get_location() == TensorBuffer::location_t::HOST_VIRT ||
+         tb->get_location() == TensorBuffer::location_t::HOST_PHY;
+}
+
+static bool is_host_virt(vart::TensorBuffer* tb) {
+  return tb->get_location() == TensorBuffer::location_t::HOST_VIRT;
+}
+
+bool SoftmaxRunner::run_on_cpu(vart::TensorBuffer* input,
+                               vart::TensorBuffer* output) const {
+  // the cpu reads and writes through virtual addresses.
+  if (!is_host_accessible(input) || !is_host_accessible(output)) {
+    return false;
+  }
+  auto shape = reshape_tensor_to_three_dim(input->get_tensor()->get_shape());
+  auto group = (uint32_t)shape[1];
+  auto cls = (uint32_t)shape[2];
+  auto scale = std::exp2f(-1.0f * (float)get_fix_pos(input->get_tensor()));
+  if (!controller_->supported(scale, cls, group)) {
+    return true;
+  }
+  // small requests in HOST_VIRT buffers would be copied to and from the
+  // internal buffers for the sfm, HOST_PHY ones are zero copy and stay on
+  // the sfm, the cpu would have to sync them batch by batch.
+  return is_host_virt(input) && is_host_virt(output) &&
+         (size_t)group * cls < offload_threshold_;
+}
+
 void SoftmaxRunner::start_controller(vart::TensorBuffer* input,
                                      vart::TensorBuffer* output) {
   CHECK(input->get_location() != TensorBuffer::location_t::HOST_VIRT)
@@ -197,6 +251,13 @@ void SoftmaxRunner::start_controller(vart::TensorBuffer* input,
   auto batch_size = input_batch_size;
   auto offset = (uint32_t)0u;  // TODO: read from ENV_PARAM();
   auto fixpos = get_fix_pos(input->get_tensor());
+  // the sfm reads rows 4-byte aligned, when cls is aligned and the batches
+  // are back to back in memory, they are submitted as one run of
+  // n * group rows, up to the 65535 rows the sfm accepts in one run.
+  const auto max_rows = 65535u;
+  auto coalesce = cls % 4u == 0u;
+  std::pair<uint64_t, uint64_t> run_addr{0u, 0u};
+  auto run_rows = 0u;
   for (auto batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
     uint64_t input_addr = 0u;
     size_t input_size = 0u;
@@ -211,8 +272,22 @@ void SoftmaxRunner::start_controller(vart::TensorBuffer* input,
     LOG_IF(INFO, ENV_PARAM(DEBUG_SOFTMAX_RUNNER))
         << "batch_size: " << batch_size << "; group: " << group
         << "; cls: " << cls << "; offset: " << offset << "; fixpos: " << fixpos;
-    controller_->run_xrt_cu(device_core_id_, input_addr, cls, group, fixpos,
-                            output_addr, offset);
+    if (coalesce && run_rows > 0u && run_rows + group <= max_rows &&
+        input_addr == run_addr.first + (uint64_t)run_rows * cls &&
+        output_addr == run_addr.second + (uint64_t)run_rows * cls * 4u) {
+      run_rows += group;
+      continue;
+    }
+    if (run_rows > 0u) {
+      controller_->run_xrt_cu(device_core_id_, run_addr.first, cls, run_rows,
+                              fixpos, run_addr.second, offset);
+    }
+    run_addr = std::make_pair(input_addr, output_addr);
+    run_rows = group;
+  }
+  if (run_rows > 0u) {
+    controller_->run_xrt_cu(device_core_id_, run_addr.first, cls, run_rows,
+                            fixpos, run_addr.second, offset);
   }
 
   return;
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace xir {
+class Attrs;
+}  // namespace xir
+
+namespace vart {
+
+/**
+ * @brief where and how host tensor memory is placed.
+ *
+ * numa:
+ *  - FIRST_TOUCH: pages are not touched at allocation, each page lands on
+ *    the node of the thread which writes it first, i.e. the worker which
+ *    produces the tensor.
+ *  - LOCAL: pages are placed on the node of the allocating thread.
+ *  - BIND: pages are bound to `node`.
+ *
+ * page:
+ *  - NORMAL: 4 KiB pages.
+ *  - TRANSPARENT: 2 MiB aligned and advised for transparent hugepages.
+ *  - HUGETLB: explicit 2 MiB hugepages from the reserved pool, falls back to
+ *    TRANSPARENT when the pool is exhausted.
+ *
+ * Allocations below XLNX_HOST_MEM_MMAP_THRESHOLD come from the heap and the
+ * policy does not apply, hugepages are only used for sizes of at least one
+ * hugepage. On platforms without NUMA support the policy is ignored.
+ */
+struct host_memory_policy_t {
+  enum class numa_t { FIRST_TOUCH, LOCAL, BIND };
+  enum class page_t { NORMAL, TRANSPARENT, HUGETLB };
+  numa_t numa = numa_t::FIRST_TOUCH;
+  int node = -1;
+  page_t page = page_t::NORMAL;
+};
+
+/// the default policy from XLNX_HOST_MEM_NUMA, XLNX_HOST_MEM_NUMA_NODE and
+/// XLNX_HOST_MEM_HUGEPAGE, overridden by the attrs "host_mem_numa"
+/// (string, "first_touch", "local" or "bind"), "host_mem_numa_node" (int)
+/// and "host_mem_hugepage" (string, "none", "thp" or "hugetlb") if present.
+host_memory_policy_t get_host_memory_policy(const xir::Attrs* attrs = nullptr);
+
+std::string to_string(const host_memory_policy_t& policy);
+
+/// zero-initialized host memory allocated according to a policy.
+class HostMemory {
+ public:
+  static std::unique_ptr<HostMemory> allocate(
+      size_t size,
+      const host_memory_policy_t& policy = get_host_memory_policy(),
+      size_t align = 64u);
+
+ public:
+  explicit HostMemory() = default;
+  virtual ~HostMemory() = default;
+  HostMemory(const HostMemory& other) = delete;
+  HostMemory& operator=(const HostMemory& rhs) = delete;
+
+ public:
+  virtual void* data() const = 0;
+  virtual size_t size() const = 0;
+  /// true if the memory is backed by hugepages, or advised to be.
+  virtual bool is_hugepage() const = 0;
+  /// the node of the first page, -1 if unknown.
+  virtual int get_node() const = 0;
+};
+
+/// number of configured NUMA nodes, 1 if NUMA is not available.
+int get_num_of_numa_nodes();
+
+}  // namespace vart
@@ -18,14 +18,20 @@
 #include <assert.h>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 namespace vitis {
 namespace ai {
+// create() is thread-safe, concurrent callers wait for the instance being
+// constructed instead of creating their own. the mutex is recursive because
+// T's constructor may create other objects of the same kind.
 template <typename T>
 struct WeakSingleton {
   static std::weak_ptr<T> the_instance_;
+  static std::recursive_mutex the_mutex_;
   template <typename... Args>
   static std::shared_ptr<T> create(Args&&... args) {
+    std::lock_guard<std::recursive_mutex> lock(the_mutex_);
     std::shared_ptr<T> ret;
     if (the_instance_.expired()) {
       ret = std::make_shared<T>(std::forward<Args>(args)...);
@@ -38,6 +44,8 @@ struct WeakSingleton {
 };
 template <typename T>
 std::weak_ptr<T> WeakSingleton<T>::the_instance_;
+template <typename T>
+std::recursive_mutex WeakSingleton<T>::the_mutex_;
 
 // we don't support c++17 yet.
 template <class...>
@@ -72,11 +80,14 @@ struct invoke_initialize_if_possible<
   static void initialize(T* t) { t->initialize(); }
 };
 
+// thread-safe as WeakSingleton, see above.
 template <typename K, typename T>
 struct WeakStore {
   static std::unordered_map<K, std::weak_ptr<T>> the_store_;
+  static std::recursive_mutex the_mutex_;
   template <typename... Args>
   static std::shared_ptr<T> create(const K& key, Args&&... args) {
+    std::lock_guard<std::recursive_mutex> lock(the_mutex_);
     std::shared_ptr<T> ret;
     if (the_store_[key].expired()) {
       ret = create_1(std::forward<Args>(args)...);
@@ -104,6 +115,8 @@ struct WeakStore {
 };
 template <typename K, typename T>
 std::unordered_map<K, std::weak_ptr<T>> WeakStore<K, T>::the_store_;
+template <typename K, typename T>
+std::recursive_mutex WeakStore<K, T>::the_mutex_;
 
 }  // namespace ai
 }  // namespace vitis
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vart/host_memory.hpp"
+
+#include <glog/logging.h>
+
+#include <fstream>
+#include <sstream>
+#include <xir/attrs/attrs.hpp>
+
+#include "vitis/ai/env_config.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+DEF_ENV_PARAM(DEBUG_HOST_MEMORY, "0")
+DEF_ENV_PARAM_2(XLNX_HOST_MEM_NUMA, "first_touch", std::string)
+DEF_ENV_PARAM(XLNX_HOST_MEM_NUMA_NODE, "-1")
+DEF_ENV_PARAM_2(XLNX_HOST_MEM_HUGEPAGE, "none", std::string)
+DEF_ENV_PARAM_2(XLNX_HOST_MEM_MMAP_THRESHOLD, "1048576", size_t)
+
+namespace vart {
+
+static host_memory_policy_t::numa_t to_numa(const std::string& name) {
+  if (name == "first_touch") {
+    return host_memory_policy_t::numa_t::FIRST_TOUCH;
+  } else if (name == "local") {
+    return host_memory_policy_t::numa_t::LOCAL;
+  } else if (name == "bind") {
+    return host_memory_policy_t::numa_t::BIND;
+  }
+  LOG(FATAL) << "unknown numa policy " << name
+             << ", expect first_touch, local or bind";
+  return host_memory_policy_t::numa_t::FIRST_TOUCH;
+}
+
+static host_memory_policy_t::page_t to_page(const std::string& name) {
+  if (name == "none") {
+    return host_memory_policy_t::page_t::NORMAL;
+  } else if (name == "thp") {
+    return host_memory_policy_t::page_t::TRANSPARENT;
+  } else if (name == "hugetlb") {
+    return host_memory_policy_t::page_t::HUGETLB;
+  }
+  LOG(FATAL) << "unknown hugepage policy " << name
+             << ", expect none, thp or hugetlb";
+  return host_memory_policy_t::page_t::NORMAL;
+}
+
+host_memory_policy_t get_host_memory_policy(const xir::Attrs* attrs) {
+  host_memory_policy_t policy;
+  policy.numa = to_numa(ENV_PARAM(XLNX_HOST_MEM_NUMA));
+  policy.node = ENV_PARAM(XLNX_HOST_MEM_NUMA_NODE);
+  policy.page = to_page(ENV_PARAM(XLNX_HOST_MEM_HUGEPAGE));
+  if (attrs != nullptr) {
+    if (attrs->has_attr("host_mem_numa")) {
+      policy.numa = to_numa(attrs->get_attr<std::string>("host_mem_numa"));
+    }
+    if (attrs->has_attr("host_mem_numa_node")) {
+      policy.node = attrs->get_attr<int>("host_mem_numa_node");
+    }
+    if (attrs->has_attr("host_mem_hugepage")) {
+      policy.page = to_page(attrs->get_attr<std::string>("host_mem_hugepage"));
+    }
+  }
+  CHECK(policy.numa != host_memory_policy_t::numa_t::BIND || policy.node >= 0)
+      << "numa node is not set for the bind policy";
+  return policy;
+}
+
+std::string to_string(const host_memory_policy_t& policy) {
+  const char* numa[] = {"first_touch", "local", "bind"};
+  const char* page[] = {"none", "thp", "hugetlb"};
+  std::ostringstream str;
+  str << "{numa=" << numa[(int)policy.numa] << ",node=" << policy.node
+      << ",hugepage=" << page[(int)policy.page] << "}";
+  return str.str();
+}
+
+int get_num_of_numa_nodes() {
+  // e.g. "0-1"
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string line;
+  if (!std::getline(online, line) || line.empty()) {
+    return 1;
+  }
+  auto pos = line.find_last_of("-,");
+  return std::stoi(pos == std::string::npos ? line : line.substr(pos + 1)) + 1;
+}
+
+namespace {
+// small allocations, the policy does not apply.
+class HeapMemory : public HostMemory {
+ public:
+  HeapMemory(size_t size, size_t align)
+      : size_{size}, raw_{new char[size + align]()}, data_{raw_.get()} {
+    auto space = size + align;
+    CHECK(std::align(align, size, data_, space) != nullptr);
+  }
+  virtual ~HeapMemory() = default;
+
+  void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  bool is_hugepage() const override { return false; }
+  int get_node() const override { return -1; }
+
+ private:
+  size_t size_;
+  std::unique_ptr<char[]> raw_;
+  void* data_;
+};
+
+#if defined(__linux__)
+constexpr size_t HUGEPAGE_SIZE = 2u * 1024u * 1024u;
+constexpr int VART_MPOL_PREFERRED = 1;
+constexpr int VART_MPOL_BIND = 2;
+constexpr int VART_MPOL_F_NODE = 1 << 0;
+constexpr int VART_MPOL_F_ADDR = 1 << 1;
+
+static size_t round_up(size_t x, size_t align) {
+  return (x + align - 1u) / align * align;
+}
+
+static int current_node() {
+  unsigned cpu = 0u;
+  unsigned node = 0u;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return (int)node;
+}
+
+// pages are placed by the kernel, libnuma is not required.
+class MappedMemory : public HostMemory {
+ public:
+  MappedMemory(size_t size, const host_memory_policy_t& policy)
+      : size_{size}, length_{}, data_{nullptr}, is_hugepage_{false} {
+    auto page = policy.page;
+    if (size < HUGEPAGE_SIZE) {
+      page = host_memory_policy_t::page_t::NORMAL;
+    }
+    if (page == host_memory_policy_t::page_t::HUGETLB) {
+      length_ = round_up(size, HUGEPAGE_SIZE);
+      data_ = mmap(nullptr, length_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                       (21 << MAP_HUGE_SHIFT),
+                   -1, 0);
+      if (data_ == MAP_FAILED) {
+        LOG_IF(INFO, ENV_PARAM(DEBUG_HOST_MEMORY))
+            << "no hugetlb pages for " << length_
+            << " bytes, fall back to transparent hugepages";
+        data_ = nullptr;
+        page = host_memory_policy_t::page_t::TRANSPARENT;
+      } else {
+        is_hugepage_ = true;
+      }
+    }
+    if (page == host_memory_policy_t::page_t::TRANSPARENT) {
+      // over-map and trim, so that the range starts on a hugepage boundary.
+      length_ = round_up(size, HUGEPAGE_SIZE);
+      auto raw = mmap(nullptr, length_ + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      PCHECK(raw != MAP_FAILED) << "cannot mmap " << length_ << " bytes";
+      auto begin = (uintptr_t)raw;
+      auto aligned = round_up(begin, HUGEPAGE_SIZE);
+      if (aligned != begin) {
+        munmap(raw, aligned - begin);
+      }
+      auto tail = begin + HUGEPAGE_SIZE - aligned;
+      if (tail != 0u) {
+        munmap((void*)(aligned + length_), tail);
+      }
+      data_ = (void*)aligned;
+      is_hugepage_ = madvise(data_, length_, MADV_HUGEPAGE) == 0;
+    }
+    if (page == host_memory_policy_t::page_t::NORMAL) {
+      length_ = round_up(size, (size_t)sysconf(_SC_PAGESIZE));
+      data_ = mmap(nullptr, length_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      PCHECK(data_ != MAP_FAILED) << "cannot mmap " << length_ << " bytes";
+    }
+    if (policy.numa != host_memory_policy_t::numa_t::FIRST_TOUCH) {
+      bind(policy);
+      // fault the pages in now, on the selected node, instead of in the
+      // first inference.
+      auto step = page == host_memory_policy_t::page_t::HUGETLB
+                      ? HUGEPAGE_SIZE
+                      : (size_t)sysconf(_SC_PAGESIZE);
+      for (size_t offset = 0u; offset < length_; offset += step) {
+        ((volatile char*)data_)[offset] = 0;
+      }
+    }
+    LOG_IF(INFO, ENV_PARAM(DEBUG_HOST_MEMORY))
+        << "@" << data_ << " mapped " << length_ << " bytes for " << size
+        << " bytes, policy=" << to_string(policy)
+        << " hugepage=" << is_hugepage_;
+  }
+
+  virtual ~MappedMemory() { munmap(data_, length_); }
+
+  void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  bool is_hugepage() const override { return is_hugepage_; }
+  int get_node() const override {
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, data_,
+                VART_MPOL_F_NODE | VART_MPOL_F_ADDR) != 0) {
+      return -1;
+    }
+    return node;
+  }
+
+ private:
+  void bind(const host_memory_policy_t& policy) {
+    auto local = policy.numa == host_memory_policy_t::numa_t::LOCAL;
+    auto node = local ? current_node() : policy.node;
+    unsigned long mask[16] = {};
+    CHECK_LT((size_t)node, sizeof(mask) * 8u) << "invalid numa node";
+    mask[node / 64] = 1ul << (node % 64);
+    // LOCAL is a preference, BIND fails allocations if the node is full.
+    auto mode = local ? VART_MPOL_PREFERRED : VART_MPOL_BIND;
+    if (syscall(SYS_mbind, data_, length_, mode, mask, sizeof(mask) * 8u,
+                0) != 0) {
+      PLOG_IF(WARNING, ENV_PARAM(DEBUG_HOST_MEMORY))
+          << "mbind to node " << node << " failed, keep the default policy";
+    }
+  }
+
+ private:
+  size_t size_;
+  size_t length_;
+  void* data_;
+  bool is_hugepage_;
+};
+#endif
+}  // namespace
+
+std::unique_ptr<HostMemory> HostMemory::allocate(
+    size_t size, const host_memory_policy_t& policy, size_t align) {
+#if defined(__linux__)
+  // mmap returns page aligned memory.
+  if (size >= ENV_PARAM(XLNX_HOST_MEM_MMAP_THRESHOLD) &&
+      align <= (size_t)sysconf(_SC_PAGESIZE)) {
+    return std::make_unique<MappedMemory>(size, policy);
+  }
+#endif
+  return std::make_unique<HeapMemory>(size, align);
+}
+
+}  // namespace vart
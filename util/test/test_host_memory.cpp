@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "vart/host_memory.hpp"
+#include "vitis/ai/env_config.hpp"
+
+DEF_ENV_PARAM(SIZE_IN_MB, "256");
+DEF_ENV_PARAM(NUM_OF_LOOPS, "10");
+DEF_ENV_PARAM(NUM_OF_THREADS, "4");
+
+using policy_t = vart::host_memory_policy_t;
+
+// every thread copies its own slice, src and dst are first written by the
+// same threads, as a runner stage producing into a tensor buffer does.
+static double copy_bandwidth(char* dst, char* src, size_t size) {
+  auto num_of_threads = (size_t)ENV_PARAM(NUM_OF_THREADS);
+  auto slice = size / num_of_threads;
+  auto run = [&](auto&& func) {
+    std::vector<std::thread> threads;
+    for (auto t = 0u; t < num_of_threads; ++t) {
+      threads.emplace_back([&func, t, slice]() { func(t * slice, slice); });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+  };
+  run([&](size_t offset, size_t n) {
+    memset(src + offset, (int)offset, n);
+    memset(dst + offset, 0, n);
+  });
+  auto loops = ENV_PARAM(NUM_OF_LOOPS);
+  auto start = std::chrono::steady_clock::now();
+  for (auto i = 0; i < loops; ++i) {
+    run([&](size_t offset, size_t n) {
+      memcpy(dst + offset, src + offset, n);
+    });
+  }
+  auto end = std::chrono::steady_clock::now();
+  CHECK_EQ(memcmp(dst, src, slice * num_of_threads), 0);
+  auto seconds = std::chrono::duration<double>(end - start).count();
+  return (double)(slice * num_of_threads) * loops / seconds / 1e9;
+}
+
+static void report(const std::string& name, double bandwidth, bool hugepage,
+                   int node) {
+  std::cout << std::left << std::setw(56) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(2)
+            << bandwidth << " GB/s"
+            << " hugepage=" << hugepage << " node=" << node << std::endl;
+}
+
+static void bench_policy(const std::string& name, const policy_t& policy,
+                         size_t size) {
+  auto src = vart::HostMemory::allocate(size, policy);
+  auto dst = vart::HostMemory::allocate(size, policy);
+  CHECK_EQ((uintptr_t)src->data() % 64u, 0u);
+  CHECK_EQ(((char*)src->data())[size - 1], 0) << "not zero-initialized";
+  auto bandwidth =
+      copy_bandwidth((char*)dst->data(), (char*)src->data(), size);
+  report(name + " " + vart::to_string(policy), bandwidth,
+         src->is_hugepage() && dst->is_hugepage(), dst->get_node());
+}
+
+int main(int argc, char* argv[]) {
+  auto size = (size_t)ENV_PARAM(SIZE_IN_MB) * 1024u * 1024u;
+  auto num_of_nodes = vart::get_num_of_numa_nodes();
+  std::cout << "size=" << ENV_PARAM(SIZE_IN_MB) << "MB"
+            << " threads=" << ENV_PARAM(NUM_OF_THREADS)
+            << " numa_nodes=" << num_of_nodes << std::endl;
+
+  {
+    // the allocation used by CpuFlatTensorBufferOwned before the policy,
+    // zeroed by the allocating thread.
+    std::vector<char> src(size);
+    std::vector<char> dst(size);
+    report("std::vector", copy_bandwidth(dst.data(), src.data(), size),
+           false, -1);
+  }
+
+  for (auto page : {policy_t::page_t::NORMAL, policy_t::page_t::TRANSPARENT,
+                    policy_t::page_t::HUGETLB}) {
+    policy_t policy;
+    policy.page = page;
+    policy.numa = policy_t::numa_t::FIRST_TOUCH;
+    bench_policy("first touch", policy, size);
+    policy.numa = policy_t::numa_t::LOCAL;
+    bench_policy("local", policy, size);
+    for (auto node = 0; node < num_of_nodes; ++node) {
+      policy.numa = policy_t::numa_t::BIND;
+      policy.node = node;
+      bench_policy("bind", policy, size);
+    }
+  }
+
+  // small sizes come from the heap, alignment is honoured.
+  auto small = vart::HostMemory::allocate(1000u, policy_t(), 4096u);
+  CHECK_EQ((uintptr_t)small->data() % 4096u, 0u);
+  CHECK(!small->is_hugepage());
+  return 0;
+}
@@ -67,8 +67,6 @@ static std::map<const std::string, std::vector<size_t>*> init_addr_map{
     {"u50_cu1", &U50_DDR_INIT_ADDR_CU1},
     {"u25_cu0", &U25_DDR_INIT_ADDR_CU0}};
 
-std::mutex XrnnController::mutex_;
-
 MODEL_TYPE XrnnController::get_model_type(const std::string& model_name) {
   return model_type_map.count(model_name) == 1 ? model_type_map[model_name]
                                                : UNKOWN;
@@ -144,10 +142,7 @@ std::vector<uint32_t> XrnnController::get_reg_data(int frame,
   return regs_array;
 }
 
-std::string XrnnController::get_board_name() {
-  auto kernel_name = xrt_cu_->get_kernel_name(idx_);
-  return kernel_name.find("slr") != kernel_name.npos ? "u50" : "u25";
-}
+std::string XrnnController::get_board_name() { return board_name_; }
 
 std::string XrnnController::get_addr_name() {
   std::string board = get_board_name();
@@ -166,53 +161,59 @@ size_t XrnnController::get_base_addr(unsigned batch_num) {
 
 int XrnnController::get_batch_size() { return batch_; }
 
-XrnnController::XrnnController(size_t device_core_id,
-                               const std::string& model_type,
-                               std::unique_ptr<xir::XrtCu>&& xrt_cu)
-    : idx_{device_core_id},
-      xrt_cu_{std::move(xrt_cu)},
-      memory_{vitis::ai::WeakStore<size_t, xir::DeviceMemory>::create(
-          xrt_cu_->get_device_id(idx_), xrt_cu_->get_device_id(idx_))} {
-  CHECK(model_type.empty() == 0);
-  model_type_ = get_model_type(model_type);
-  CHECK(model_type_ != UNKOWN);
-
-  auto kernel_name = xrt_cu_->get_kernel_name(idx_);
-  if (kernel_name.find("slr") != kernel_name.npos)
-    batch_ = device_core_id == 0 ? 3 : 4;
-  else
-    batch_ = 1;
+int XrnnController::get_num_of_slots() {
+  return board_name_ == "u50" ? 1 : 16;
 }
 
-void XrnnController::run(char* in, uint64_t isize, char* out, uint64_t osize,
-                         int batch, int frame, int thread_index) {
-  CHECK(batch <= batch_) << "Invalid Batch Size";
-
-  LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER)) << "device_core_id " << idx_;
+const std::vector<uint32_t>& XrnnController::get_cached_reg_data(
+    int frame, int thread_index) {
+  // the register set only depends on (frame, thread_index) for a given cu,
+  // std::map never invalidates references on insertion.
+  std::lock_guard<std::mutex> lock(reg_mtx_);
+  auto key = std::make_pair(frame, thread_index);
+  auto it = reg_cache_.find(key);
+  if (it == reg_cache_.end()) {
+    it = reg_cache_.emplace(key, get_reg_data(frame, thread_index)).first;
+  }
+  return it->second;
+}
 
-  std::vector<uint32_t> reg_data = get_reg_data(frame, thread_index);
+size_t XrnnController::get_slot_addr(unsigned batch_num, size_t region,
+                                     int thread_index) {
+  return get_base_addr(batch_num) + region + thread_index * THREAD_STEP;
+}
 
-  // for(unsigned i=0; i<reg_data.size(); i++){
-  //   LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-  //     << std::hex << i*4 << " --  "
-  //     << std::hex << reg_data[i];
-  // }
+size_t XrnnController::get_output_region() {
+  // openie leaves its result in the vector region.
+  return model_type_ == OPENIE ? ADDR(VECTOR) : ADDR(RESL);
+}
 
+void XrnnController::upload_inputs(const char* in, uint64_t isize, int batch,
+                                   int thread_index) {
   for (auto i = 0; i < batch; i++) {
-    auto base_addr = get_base_addr(i);
-
+    auto addr = get_slot_addr(i, ADDR(VECTOR), thread_index);
     LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-        << "vetor input addr: " << std::hex
-        << (base_addr + ADDR(VECTOR) + thread_index * THREAD_STEP);
+        << "vetor input addr: " << std::hex << addr;
+    memory_->upload((void*)(in + i * isize), addr, (size_t)isize);
+  }
+}
 
-    memory_->upload(
-        (void*)(in + i * isize),
-        (size_t)(base_addr + ADDR(VECTOR) + thread_index * THREAD_STEP),
-        (size_t)isize);
+void XrnnController::download_outputs(char* out, uint64_t osize, int batch,
+                                      int thread_index) {
+  LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
+      << "get result len: " << osize << "(0x" << std::hex << osize
+      << ") for type " << model_type_;
+  for (auto i = 0; i < batch; i++) {
+    auto addr = get_slot_addr(i, get_output_region(), thread_index);
+    LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
+        << "result output addr: " << std::hex << addr;
+    memory_->download((void*)(out + i * osize), addr, (size_t)osize);
   }
+}
 
-  // mutex_.lock();
-  auto func = [=](ert_start_kernel_cmd* ecmd) -> void {
+void XrnnController::compute(const std::vector<uint32_t>& reg_data,
+                             int thread_index) {
+  auto func = [&reg_data](ert_start_kernel_cmd* ecmd) -> void {
     auto rsz = (0x2e0 / 4 + 1) + 1;  // regmap array size
     ecmd->count = 1 + rsz;
 
@@ -232,46 +233,132 @@ void XrnnController::run(char* in, uint64_t isize, char* out, uint64_t osize,
         LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
             << "xrnn excute done! "
             << "device_core_id = " << idx_ << " thread = " << thread_index;
-
-        if (model_type_ == OPENIE) {
-          LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-              << "get result len: " << osize << "(0x" << std::hex << osize
-              << ") for type " << model_type_;
-
-          for (auto i = 0; i < batch; i++) {
-            auto base_addr = get_base_addr(i);
-            LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-                << "result output addr: " << std::hex
-                << (base_addr + ADDR(VECTOR) + thread_index * THREAD_STEP);
-            memory_->download(
-                (void*)(out + i * osize),
-                (size_t)(base_addr + ADDR(VECTOR) + thread_index * THREAD_STEP),
-                (size_t)osize);
-          }
-        } else {
-          LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-              << "get result len: " << osize << "(0x" << std::hex << osize
-              << ") for type " << model_type_;
-
-          for (auto i = 0; i < batch; i++) {
-            auto base_addr = get_base_addr(i);
-            LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
-                << "result output addr: " << std::hex
-                << (base_addr + ADDR(RESL) + thread_index * THREAD_STEP);
-            memory_->download(
-                (void*)(out + i * osize),
-                (size_t)(base_addr + ADDR(RESL) + thread_index * THREAD_STEP),
-                (size_t)osize);
-          }
-        }
       },
       // on failure
       [=]() -> void {
         LOG(FATAL) << "xrnn controller timeout! "
                    << "device_core_id = " << idx_ << "\n";
       });
+}
+
+static uint64_t elapsed_us(std::chrono::steady_clock::time_point from) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - from)
+      .count();
+}
+
+void XrnnController::run_pipelined(const std::vector<XrnnJob>& jobs,
+                                   int frame, int thread_index) {
+  auto start = std::chrono::steady_clock::now();
+  auto slot = [thread_index](size_t i) {
+    return 2 * thread_index + (int)(i % 2);
+  };
+  if (!transfer_pool_) {
+    for (auto& job : jobs) {
+      run(job.in, job.isize, job.out, job.osize, job.batch, frame,
+          thread_index);
+    }
+    return;
+  }
+  CHECK_LT(slot(1), get_num_of_slots()) << "Invalid thread index";
+  for (auto& job : jobs) {
+    CHECK(job.batch <= batch_) << "Invalid Batch Size";
+  }
+  uint64_t upload_us = 0u;
+  uint64_t compute_us = 0u;
+  uint64_t download_us = 0u;
+  auto transfer = [&](size_t i) {
+    // job i - 1 and job i + 1 use the same slot, so the download has to
+    // finish before the upload overwrites the region.
+    if (i >= 1u) {
+      auto t = std::chrono::steady_clock::now();
+      auto& prev = jobs[i - 1];
+      download_outputs(prev.out, prev.osize, prev.batch, slot(i - 1));
+      download_us += elapsed_us(t);
+    }
+    if (i + 1 < jobs.size()) {
+      auto t = std::chrono::steady_clock::now();
+      auto& next = jobs[i + 1];
+      upload_inputs(next.in, next.isize, next.batch, slot(i + 1));
+      upload_us += elapsed_us(t);
+    }
+  };
+  if (!jobs.empty()) {
+    auto t = std::chrono::steady_clock::now();
+    upload_inputs(jobs[0].in, jobs[0].isize, jobs[0].batch, slot(0));
+    upload_us += elapsed_us(t);
+  }
+  for (auto i = 0u; i < jobs.size(); ++i) {
+    auto& reg_data = get_cached_reg_data(frame, slot(i));
+    auto io = transfer_pool_->async(transfer, i);
+    auto t = std::chrono::steady_clock::now();
+    compute(reg_data, slot(i));
+    compute_us += elapsed_us(t);
+    io.get();
+  }
+  if (!jobs.empty()) {
+    auto t = std::chrono::steady_clock::now();
+    auto& last = jobs.back();
+    download_outputs(last.out, last.osize, last.batch, slot(jobs.size() - 1));
+    download_us += elapsed_us(t);
+  }
+  auto total_us = elapsed_us(start);
+  LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER))
+      << "pipelined " << jobs.size() << " jobs: "
+      << "upload " << upload_us << "us "
+      << "compute " << compute_us << "us "
+      << "download " << download_us << "us "
+      << "total " << total_us << "us";
+  std::lock_guard<std::mutex> lock(stats_mtx_);
+  stats_.jobs += jobs.size();
+  stats_.upload_us += upload_us;
+  stats_.compute_us += compute_us;
+  stats_.download_us += download_us;
+  stats_.total_us += total_us;
+}
+
+XrnnStageStats XrnnController::get_stage_stats() {
+  std::lock_guard<std::mutex> lock(stats_mtx_);
+  return stats_;
+}
+
+XrnnController::XrnnController(size_t device_core_id,
+                               const std::string& model_type,
+                               std::unique_ptr<xir::XrtCu>&& xrt_cu)
+    : idx_{device_core_id},
+      xrt_cu_{std::move(xrt_cu)},
+      memory_{vitis::ai::WeakStore<size_t, xir::DeviceMemory>::create(
+          xrt_cu_->get_device_id(idx_), xrt_cu_->get_device_id(idx_))},
+      stats_{} {
+  CHECK(model_type.empty() == 0);
+  model_type_ = get_model_type(model_type);
+  CHECK(model_type_ != UNKOWN);
+
+  auto kernel_name = xrt_cu_->get_kernel_name(idx_);
+  if (kernel_name.find("slr") != kernel_name.npos) {
+    board_name_ = "u50";
+    batch_ = device_core_id == 0 ? 3 : 4;
+  } else {
+    board_name_ = "u25";
+    batch_ = 1;
+  }
+  if (get_num_of_slots() > 1) {
+    // one worker is enough, the runners serialize the jobs of a cu
+    transfer_pool_ = vitis::ai::ThreadPool::create(1u);
+  }
+}
+
+void XrnnController::run(char* in, uint64_t isize, char* out, uint64_t osize,
+                         int batch, int frame, int thread_index) {
+  CHECK(batch <= batch_) << "Invalid Batch Size";
+
+  LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_CONTROLLER)) << "device_core_id " << idx_;
+
+  auto& reg_data = get_cached_reg_data(frame, thread_index);
 
-  // mutex_.unlock();
+  upload_inputs(in, isize, batch, thread_index);
+  compute(reg_data, thread_index);
+  download_outputs(out, osize, batch, thread_index);
 }
 
 XrnnController::~XrnnController() {}
@@ -21,6 +21,7 @@
 #include "xir/device_memory.hpp"
 
 #include "model_config.hpp"
+#include "vitis/ai/thread_pool.hpp"
 
 #include <string>
 #include <map>
@@ -38,6 +39,24 @@ namespace xrnn {
 
 enum MODEL_TYPE {SENTIMENT, SATISFACTION, OPENIE, UNKOWN=255};
 
+// one frame group for XrnnController::run_pipelined
+struct XrnnJob {
+  char* in;
+  uint64_t isize;
+  char* out;
+  uint64_t osize;
+  int batch;
+};
+
+// accumulated wall time of each pipeline stage, in microseconds
+struct XrnnStageStats {
+  uint64_t jobs;
+  uint64_t upload_us;
+  uint64_t compute_us;
+  uint64_t download_us;
+  uint64_t total_us;
+};
+
 
 class XrnnController {
 public:
@@ -54,13 +73,33 @@ public:
   void run(char* in, uint64_t isize,
            char* out, uint64_t osize,
            int batch, int frame, int thread_index);
+  // run jobs with ping-pong device regions: slot (2 * thread_index + i % 2)
+  // holds job i, so the transfers of job i - 1 and job i + 1 overlap the
+  // compute of job i. all jobs share the same frame. the transfers run on
+  // a worker owned by the controller. boards with a single slot, i.e. u50,
+  // run the jobs one by one.
+  void run_pipelined(const std::vector<XrnnJob>& jobs, int frame,
+                     int thread_index);
+  XrnnStageStats get_stage_stats();
   std::string get_board_name();
   int get_batch_size();
+  // number of thread_index regions of a cu, u50 only has the first one, its
+  // instructions are written with the addresses of slot 0 by update()
+  int get_num_of_slots();
   
 private:
   MODEL_TYPE get_model_type(const std::string& model_name);
   std::string get_model_name(MODEL_TYPE model_type);
   std::vector<uint32_t> get_reg_data(int frame, int thread_index);
+  const std::vector<uint32_t>& get_cached_reg_data(int frame,
+                                                   int thread_index);
+  size_t get_slot_addr(unsigned batch_num, size_t region, int thread_index);
+  size_t get_output_region();
+  void upload_inputs(const char* in, uint64_t isize, int batch,
+                     int thread_index);
+  void download_outputs(char* out, uint64_t osize, int batch,
+                        int thread_index);
+  void compute(const std::vector<uint32_t>& reg_data, int thread_index);
   size_t get_base_addr(unsigned batch_num);
   std::string get_addr_name();
 
@@ -71,8 +110,16 @@ private:
 
   MODEL_TYPE model_type_;
   int batch_ = 1;
+  std::string board_name_;
+
+  std::mutex reg_mtx_;
+  std::map<std::pair<int, int>, std::vector<uint32_t>> reg_cache_;
+
+  std::mutex stats_mtx_;
+  XrnnStageStats stats_;
 
-  static std::mutex mutex_;
+  // transfers of run_pipelined, created on boards with ping-pong slots
+  std::unique_ptr<vitis::ai::ThreadPool> transfer_pool_;
 };
 
 } // namespace xrnn
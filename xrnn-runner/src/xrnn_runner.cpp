@@ -31,6 +31,7 @@ DEF_ENV_PARAM(XRNN_RUNNER_MAX_THREADS, "16");
 DEF_ENV_PARAM(XRNN_RUNNER_MAX_CUS, "32");
 DEF_ENV_PARAM(XRNN_RUNNER_MAX_MONITOR, "16");
 DEF_ENV_PARAM(DEBUG_XRNN_RUNNER, "0")
+DEF_ENV_PARAM(XRNN_ENABLE_PIPELINE, "0");
 
 #define MAX_CUS 32
 
@@ -121,7 +122,12 @@ void xrnnRunner::init_with_subgraph_attr(const xir::Subgraph* subgraph)
                                 std::make_unique<xir::XrtCu>(device_));
  
   index_ = count_[device_core_id_]++;
-  cu_parallel_ = xrnn_->get_board_name() == "u50"?1:16;
+  cu_parallel_ = xrnn_->get_num_of_slots();
+  if (ENV_PARAM(XRNN_ENABLE_PIPELINE)) {
+    // each thread owns a pair of ping-pong slots, u50 has a single slot and
+    // runs the jobs one by one
+    cu_parallel_ = std::max(1, cu_parallel_ / 2);
+  }
   LOG_IF(INFO, ENV_PARAM(DEBUG_XRNN_RUNNER))
     << cu_parallel_ << " support in a single cu";
    
@@ -246,9 +252,25 @@ std::pair<uint32_t, int> xrnnRunner::execute_async(
   std::mutex &m = cu_mtx_[imutex];
   m.lock();
 
-  xrnn_->run((char*)input_addr, input_size, 
-    (char*)output_addr, output_size,
-    batch, frames, index_%cu_parallel_);
+  // the input batch may be larger than the cu batch, it is then split into
+  // frame groups of the cu batch size.
+  auto cu_batch = xrnn_->get_batch_size();
+  if (ENV_PARAM(XRNN_ENABLE_PIPELINE)) {
+    std::vector<vart::xrnn::XrnnJob> jobs;
+    for (auto b = 0; b < batch; b += cu_batch) {
+      jobs.emplace_back(vart::xrnn::XrnnJob{
+          (char*)input_addr + b * input_size, input_size,
+          (char*)output_addr + b * output_size, output_size,
+          std::min(cu_batch, batch - b)});
+    }
+    xrnn_->run_pipelined(jobs, frames, index_%cu_parallel_);
+  } else {
+    for (auto b = 0; b < batch; b += cu_batch) {
+      xrnn_->run((char*)input_addr + b * input_size, input_size,
+        (char*)output_addr + b * output_size, output_size,
+        std::min(cu_batch, batch - b), frames, index_%cu_parallel_);
+    }
+  }
 
   m.unlock();
 
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 Xilinx, Inc.
+ * Copyright (C) 2023 – 2024 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// compare XrnnController::run with XrnnController::run_pipelined.
+//
+// set XLNX_XRT_CU_DRY_RUN=1 to skip the cu, only the host side and the
+// device memory transfers are then timed and results are not compared.
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "vitis/ai/env_config.hpp"
+#include "xrnn_controller.hpp"
+
+DEF_ENV_PARAM(XLNX_XRT_CU_DRY_RUN, "0");
+DEF_ENV_PARAM(NUM_OF_JOBS, "16");
+DEF_ENV_PARAM(NUM_OF_FRAMES, "25");
+DEF_ENV_PARAM(INPUT_SIZE, "8192");
+DEF_ENV_PARAM(OUTPUT_SIZE, "8192");
+DEF_ENV_PARAM_2(MODEL_TYPE, "satisfaction", std::string);
+
+int main(int argc, char* argv[]) {
+  auto xrnn = std::make_unique<vart::xrnn::XrnnController>(
+      0u, ENV_PARAM(MODEL_TYPE), std::make_unique<xir::XrtCu>("xrnn"));
+  auto batch = xrnn->get_batch_size();
+  auto num_of_jobs = ENV_PARAM(NUM_OF_JOBS);
+  size_t isize = ENV_PARAM(INPUT_SIZE);
+  size_t osize = ENV_PARAM(OUTPUT_SIZE);
+
+  std::vector<char> input(num_of_jobs * batch * isize);
+  for (auto i = 0u; i < input.size(); ++i) {
+    input[i] = (char)(i % 127);
+  }
+  std::vector<char> out_seq(num_of_jobs * batch * osize);
+  std::vector<char> out_pipe(num_of_jobs * batch * osize);
+
+  std::vector<vart::xrnn::XrnnJob> jobs;
+  for (auto i = 0; i < num_of_jobs; ++i) {
+    jobs.emplace_back(vart::xrnn::XrnnJob{&input[i * batch * isize], isize,
+                                          &out_pipe[i * batch * osize], osize,
+                                          batch});
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (auto i = 0; i < num_of_jobs; ++i) {
+    xrnn->run(&input[i * batch * isize], isize, &out_seq[i * batch * osize],
+              osize, batch, ENV_PARAM(NUM_OF_FRAMES), 0);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  xrnn->run_pipelined(jobs, ENV_PARAM(NUM_OF_FRAMES), 0);
+  auto t2 = std::chrono::steady_clock::now();
+
+  auto stats = xrnn->get_stage_stats();
+  auto us = [](std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+  };
+  std::cout << "jobs " << num_of_jobs << " batch " << batch << "\n"
+            << "sequential: " << us(t1 - t0) << "us\n"
+            << "pipelined: " << us(t2 - t1) << "us"
+            << " (upload " << stats.upload_us << "us"
+            << ", compute " << stats.compute_us << "us"
+            << ", download " << stats.download_us << "us)" << std::endl;
+
+  if (!ENV_PARAM(XLNX_XRT_CU_DRY_RUN)) {
+    auto ok = std::memcmp(out_seq.data(), out_pipe.data(), out_seq.size()) == 0;
+    std::cout << (ok ? "result match" : "result mismatch") << std::endl;
+    return ok ? 0 : 1;
+  }
+  return 0;
+}